@@ -43,14 +43,23 @@ typedef struct fnt_method_list {
 typedef struct fnt_method {
     char name[FNT_MAX_NAME_LENGTH];
     void *handle;
+    unsigned int capabilities;
     int (*init)(void **handle, int dimensions);
     int (*free)(void **handle);
+    int (*reset)(void *handle);
     int (*info)();
     int (*hparam_set)(void *handle, char *id, void *value_ptr);
     int (*hparam_get)(void *handle, char *id, void *value_ptr);
     int (*next)(void *handle, fnt_vect_t *vec);
+    int (*next_view)(void *handle, fnt_vect_t **vec);
+    int (*next_batch)(void *handle, fnt_vect_t *vecs, int *tickets, int capacity, int *count);
     int (*value)(void *handle, fnt_vect_t *vec, double value);
+    int (*value_ticket)(void *handle, int ticket, double value);
     int (*value_gradient)(void *handle, fnt_vect_t *vec, double value, fnt_vect_t *gradient);
+    int (*value_residual)(void *handle, fnt_vect_t *vec, fnt_vect_t *residual, fnt_vect_t *jacobian);
+    int (*sample)(void *handle, int which, fnt_vect_t *point, double *value);
+    int (*warm_start)(void *handle, fnt_vect_t *points, double *values, int count);
+    int (*minimize)(void *handle, fnt_objective_t objective, void *user);
     int (*done)(void *handle);
     int (*result)(void *handle, char *id, void *value_ptr);
 } fnt_method_t;
@@ -76,6 +85,9 @@ typedef struct fnt_context {
     /* loaded method, NULL otherwise */
     fnt_method_t method;
 
+    /* buffer lent by fnt_next_view for methods without their own */
+    fnt_vect_t view;
+
     /* list of upcoming inputs that are needed */
     vector_queue_node_t *inputs_head;
 } context_t;
@@ -128,6 +140,7 @@ int fnt_method_list_add(context_t *ctx, fnt_method_list_entry_t *entry) {
             return FNT_FAILURE;
         }
         ctx->methods_list.entries = ptr;
+        ctx->methods_list.capacity = new_size;
     }
 
     int pos = ctx->methods_list.count;
@@ -153,6 +166,59 @@ int fnt_method_list_print(context_t *ctx) {
 }
 
 
+fnt_method_descriptor_t *fnt_method_descriptor(void *dl_handle, char *filename) {
+    if( dl_handle == NULL ) { return NULL; }
+
+    /* a single lookup provides every entry point */
+    fnt_method_descriptor_t *desc = dlsym(dl_handle, FNT_METHOD_DESCRIPTOR_SYMBOL);
+    if( desc == NULL ) {
+        ERROR("ERROR: No %s in '%s'.\n", FNT_METHOD_DESCRIPTOR_SYMBOL, filename);
+        return NULL;
+    }
+
+    if( desc->abi_version != FNT_METHOD_ABI_VERSION ) {
+        ERROR("ERROR: '%s' was built for method ABI version %d, expected %d.\n", filename, desc->abi_version, FNT_METHOD_ABI_VERSION);
+        return NULL;
+    }
+
+    if( desc->name == NULL
+        || desc->init == NULL
+        || desc->free == NULL
+        || desc->next == NULL
+        || desc->value == NULL
+        || desc->done == NULL ) {
+        ERROR("ERROR: '%s' does not have all required methods.\n", filename);
+        if( desc->name == NULL )
+            ERROR("\tMISSING name(char*, int)\n");
+        if( desc->init == NULL )
+            ERROR("\tMISSING init(void**, int)\n");
+        if( desc->free == NULL )
+            ERROR("\tMISSING free(void**)\n");
+        if( desc->next == NULL )
+            ERROR("\tMISSING next(void*, fnt_vect_t*)\n");
+        if( desc->value == NULL )
+            ERROR("\tMISSING value(void*, fnt_vect_t*, double)\n");
+        if( desc->done == NULL )
+            ERROR("\tMISSING done(void*)\n");
+        return NULL;
+    }
+
+    /* advertised capabilities must be backed by entry points */
+    if( (desc->capabilities & FNT_METHOD_CAP_GRADIENT)
+        && desc->value_gradient == NULL ) {
+        ERROR("ERROR: '%s' claims gradient support, but has no value_gradient.\n", filename);
+        return NULL;
+    }
+    if( (desc->capabilities & FNT_METHOD_CAP_RESIDUAL)
+        && desc->value_residual == NULL ) {
+        ERROR("ERROR: '%s' claims residual support, but has no value_residual.\n", filename);
+        return NULL;
+    }
+
+    return desc;
+}
+
+
 int fnt_register_method(context_t *ctx, char *filename) {
 
     /* open object file */
@@ -162,24 +228,27 @@ int fnt_register_method(context_t *ctx, char *filename) {
         return FNT_FAILURE;
     }
 
-    /* extract name function */
-    int (*fnt_method_name)(char *, int) = dlsym(dl_handle, "method_name");
-    if( fnt_method_name == NULL ) {
-        ERROR("ERROR: No fnt_method_name in '%s'.\n", filename);
+    /* extract method descriptor */
+    fnt_method_descriptor_t *desc = fnt_method_descriptor(dl_handle, filename);
+    if( desc == NULL ) {
         dlclose(dl_handle);
         return FNT_FAILURE;
     }
     char name[FNT_MAX_NAME_LENGTH];
-    fnt_method_name(name, FNT_MAX_NAME_LENGTH);
+    if( desc->name(name, FNT_MAX_NAME_LENGTH) != FNT_SUCCESS ) {
+        ERROR("ERROR: Method name in '%s' is too long.\n", filename);
+        dlclose(dl_handle);
+        return FNT_FAILURE;
+    }
 
     /* set up list entry */
-    fnt_method_list_entry_t *entry = calloc(1,sizeof(fnt_method_list_entry_t));
-    snprintf(entry->name, sizeof(entry->name), "%s", name);
-    snprintf(entry->path, sizeof(entry->path), "%s", filename);
+    fnt_method_list_entry_t entry;
+    snprintf(entry.name, sizeof(entry.name), "%s", name);
+    snprintf(entry.path, sizeof(entry.path), "%s", filename);
 
     /* add method entry to list of available methods */
-    fnt_method_list_add(ctx, entry);
-    INFO("\tfound method '%s' in '%s'.\n", entry->name, filename);
+    fnt_method_list_add(ctx, &entry);
+    INFO("\tfound method '%s' in '%s'.\n", entry.name, filename);
 
     dlclose(dl_handle);
 
@@ -246,37 +315,38 @@ int fnt_method_load(context_t *ctx, char *filename) {
 
     INFO("Loading method from '%s'.\n", filename);
 
-    /* assign function pointers */
-    ctx->dl_handle = dl_handle;
-    int (*method_name)(char *, int) = dlsym(dl_handle, "method_name");
-    method_name(ctx->method.name, sizeof(ctx->method.name));
-    ctx->method.init = dlsym(dl_handle, "method_init");
-    ctx->method.free = dlsym(dl_handle, "method_free");
-    ctx->method.info = dlsym(dl_handle, "method_info");
-    ctx->method.hparam_get = dlsym(dl_handle, "method_hparam_get");
-    ctx->method.hparam_set = dlsym(dl_handle, "method_hparam_set");
-    ctx->method.next = dlsym(dl_handle, "method_next");
-    ctx->method.value = dlsym(dl_handle, "method_value");
-    ctx->method.value_gradient = dlsym(dl_handle, "method_value_gradient");
-    ctx->method.done = dlsym(dl_handle, "method_done");
-    ctx->method.result = dlsym(dl_handle, "method_result");
-
-    if( ctx->method.next == NULL
-        || ctx->method.value == NULL
-        || ctx->method.done == NULL ) {
-        ERROR("ERROR: '%s' does not have all required methods.\n", filename);
-        if( ctx->method.next == NULL )
-            ERROR("\tMISSING method_next(void*, fnt_vect_t*)\n");
-        if( ctx->method.value == NULL )
-            ERROR("\tMISSING method_value(void*, fnt_vect_t*, double)\n");
-        if( ctx->method.done == NULL )
-            ERROR("\tMISSING method_done(void*)\n");
+    /* validate descriptor before using any entry points */
+    fnt_method_descriptor_t *desc = fnt_method_descriptor(dl_handle, filename);
+    if( desc == NULL ) {
         memset(&ctx->method, '\0', sizeof(ctx->method));
-        dlclose(dl_handle); ctx->dl_handle = dl_handle = NULL;
+        dlclose(dl_handle); dl_handle = NULL;
 
         return FNT_FAILURE;
     }
 
+    /* assign function pointers */
+    ctx->dl_handle = dl_handle;
+    desc->name(ctx->method.name, sizeof(ctx->method.name));
+    ctx->method.capabilities = desc->capabilities;
+    ctx->method.init = desc->init;
+    ctx->method.free = desc->free;
+    ctx->method.reset = desc->reset;
+    ctx->method.info = desc->info;
+    ctx->method.hparam_get = desc->hparam_get;
+    ctx->method.hparam_set = desc->hparam_set;
+    ctx->method.next = desc->next;
+    ctx->method.next_view = desc->next_view;
+    ctx->method.next_batch = desc->next_batch;
+    ctx->method.value = desc->value;
+    ctx->method.value_ticket = desc->value_ticket;
+    ctx->method.value_gradient = desc->value_gradient;
+    ctx->method.value_residual = desc->value_residual;
+    ctx->method.sample = desc->sample;
+    ctx->method.warm_start = desc->warm_start;
+    ctx->method.minimize = desc->minimize;
+    ctx->method.done = desc->done;
+    ctx->method.result = desc->result;
+
     return FNT_SUCCESS;
 }
 
@@ -332,6 +402,13 @@ int fnt_set_method(void *context, char *name, int dimensions) {
 
             if( ret == FNT_SUCCESS ) {
                 INFO("Initialized method '%s' for %i dimensional inputs.\n", ctx->method.name, dimensions);
+
+                /* allocate buffer to lend when the method has none */
+                if( ctx->method.next_view == NULL
+                    && fnt_vect_calloc(&ctx->view, dimensions) != FNT_VEC_SUCCESS ) {
+                    ERROR("ERROR: Failed to allocate view for method '%s'.\n", ctx->method.name);
+                    return FNT_FAILURE;
+                }
             } else if( ret == FNT_FAILURE ) {
                 ERROR("ERROR: Initialization of method '%s' failed..\n", ctx->method.name);
                 continue;   /* keep looking for one that might work */
@@ -346,6 +423,184 @@ int fnt_set_method(void *context, char *name, int dimensions) {
 }
 
 
+int fnt_reset(void *context) {
+    context_t *ctx = (context_t*)context;
+    if( ctx == NULL )               { return FNT_FAILURE; }
+    if( ctx->method.init == NULL )  { return FNT_FAILURE; }
+
+    int ret = FNT_FAILURE;
+    if( ctx->method.reset != NULL ) {
+        ret = ctx->method.reset(ctx->method.handle);
+    } else {
+        /* reinitialize, keeping the loaded module */
+        WARN("WARN: Method '%s' cannot reset in place, hyper-parameters will revert to defaults.\n", ctx->method.name);
+        ret = ctx->method.free(&ctx->method.handle);
+        if( ret == FNT_SUCCESS ) {
+            ret = ctx->method.init(&ctx->method.handle, ctx->dim);
+        }
+    }
+
+    if( ret == FNT_SUCCESS ) {
+        DEBUG("DEBUG: Reset method '%s'.\n", ctx->method.name);
+    } else if( ret == FNT_FAILURE ) {
+        ERROR("ERROR: Failed to reset method '%s'.\n", ctx->method.name);
+    }
+
+    return ret;
+}
+
+
+int fnt_capabilities(void *context, unsigned int *capabilities) {
+    context_t *ctx = (context_t*)context;
+    if( ctx == NULL )               { return FNT_FAILURE; }
+    if( capabilities == NULL )      { return FNT_FAILURE; }
+
+    if( ctx->method.name[0] == '\0' ) {
+        ERROR("ERROR: Called %s before setting method.\n", __FUNCTION__);
+        return FNT_FAILURE;
+    }
+
+    *capabilities = ctx->method.capabilities;
+
+    return FNT_SUCCESS;
+}
+
+
+int fnt_dimensions(void *context, int *dimensions) {
+    context_t *ctx = (context_t*)context;
+    if( ctx == NULL )               { return FNT_FAILURE; }
+    if( dimensions == NULL )        { return FNT_FAILURE; }
+
+    if( ctx->method.name[0] == '\0' ) {
+        ERROR("ERROR: Called %s before setting method.\n", __FUNCTION__);
+        return FNT_FAILURE;
+    }
+
+    *dimensions = ctx->dim;
+
+    return FNT_SUCCESS;
+}
+
+
+int fnt_warm_start_points(void *context, fnt_vect_t *points, double *values, int count) {
+    context_t *ctx = (context_t*)context;
+    if( ctx == NULL )       { return FNT_FAILURE; }
+    if( points == NULL )    { return FNT_FAILURE; }
+    if( count < 1 )         { return FNT_FAILURE; }
+
+    if( ctx->method.warm_start == NULL ) {
+        ERROR("ERROR: Method '%s' cannot be warm started.\n", ctx->method.name);
+        return FNT_FAILURE;
+    }
+    for(int i=0; i<count; ++i) {
+        if( points[i].n != (size_t)ctx->dim ) {
+            ERROR("ERROR: Warm start point %d has %zu dimensions, expected %d.\n", i, points[i].n, ctx->dim);
+            return FNT_FAILURE;
+        }
+    }
+
+    /* hand points over best first, vectors are shallow copies */
+    int *order = calloc(count, sizeof(int));
+    fnt_vect_t *sorted_points = calloc(count, sizeof(fnt_vect_t));
+    double *sorted_values = NULL;
+    if( values != NULL ) { sorted_values = calloc(count, sizeof(double)); }
+    if( order == NULL || sorted_points == NULL
+        || (values != NULL && sorted_values == NULL) ) {
+        ERROR("calloc: %s\n", strerror(errno));
+        free(order); free(sorted_points); free(sorted_values);
+        return FNT_FAILURE;
+    }
+
+    /* insertion sort by value, point sets are small */
+    for(int i=0; i<count; ++i) {
+        int j = i;
+        while( values != NULL && j > 0 && values[order[j-1]] > values[i] ) {
+            order[j] = order[j-1];
+            --j;
+        }
+        order[j] = i;
+    }
+    for(int i=0; i<count; ++i) {
+        sorted_points[i] = points[order[i]];
+        if( values != NULL ) { sorted_values[i] = values[order[i]]; }
+    }
+
+    int ret = ctx->method.warm_start(ctx->method.handle, sorted_points, sorted_values, count);
+    if( ret == FNT_SUCCESS ) {
+        INFO("Warm started method '%s' with %d points.\n", ctx->method.name, count);
+    } else {
+        ERROR("ERROR: Failed to warm start method '%s'.\n", ctx->method.name);
+    }
+
+    free(order); free(sorted_points); free(sorted_values);
+
+    return ret;
+}
+
+
+int fnt_warm_start(void *context, void *source) {
+    context_t *ctx = (context_t*)context;
+    context_t *src = (context_t*)source;
+    if( ctx == NULL )       { return FNT_FAILURE; }
+    if( src == NULL )       { return FNT_FAILURE; }
+
+    if( src->method.sample == NULL ) {
+        ERROR("ERROR: Method '%s' cannot report its points.\n", src->method.name);
+        return FNT_FAILURE;
+    }
+    if( src->dim != ctx->dim ) {
+        ERROR("ERROR: Cannot warm start %d dimensional method from %d dimensional one.\n", ctx->dim, src->dim);
+        return FNT_FAILURE;
+    }
+
+    /* collect every point the source currently holds */
+    int count = 0;
+    int capacity = 0;
+    fnt_vect_t *points = NULL;
+    double *values = NULL;
+    int ret = FNT_SUCCESS;
+    for(;;) {
+        if( count == capacity ) {
+            capacity = capacity ? capacity * 2 : 16;
+            fnt_vect_t *new_points = realloc(points, capacity * sizeof(fnt_vect_t));
+            double *new_values = realloc(values, capacity * sizeof(double));
+            if( new_points != NULL ) { points = new_points; }
+            if( new_values != NULL ) { values = new_values; }
+            if( new_points == NULL || new_values == NULL ) {
+                ERROR("realloc: %s\n", strerror(errno));
+                ret = FNT_FAILURE;
+                break;
+            }
+        }
+
+        if( fnt_vect_calloc(&points[count], src->dim) != FNT_VEC_SUCCESS ) {
+            ret = FNT_FAILURE;
+            break;
+        }
+        if( src->method.sample(src->method.handle, count, &points[count], &values[count]) != FNT_SUCCESS ) {
+            fnt_vect_free(&points[count]);
+            break;
+        }
+        ++count;
+    }
+
+    if( ret == FNT_SUCCESS && count == 0 ) {
+        ERROR("ERROR: Method '%s' holds no points to warm start from.\n", src->method.name);
+        ret = FNT_FAILURE;
+    }
+    if( ret == FNT_SUCCESS ) {
+        DEBUG("DEBUG: Warm starting '%s' from %d points of '%s'.\n", ctx->method.name, count, src->method.name);
+        ret = fnt_warm_start_points(ctx, points, values, count);
+    }
+
+    for(int i=0; i<count; ++i) { fnt_vect_free(&points[i]); }
+    free(points);
+    free(values);
+
+    return ret;
+}
+
+
 int fnt_free(void **context) {
     if( context == NULL )   { return FNT_FAILURE; }
     context_t *ctx = (context_t*)*context;
@@ -363,7 +618,10 @@ int fnt_free(void **context) {
     }
 
     fnt_method_list_free(&ctx->methods_list);
-    dlclose(ctx->dl_handle);    ctx->dl_handle = NULL;
+    fnt_vect_free(&ctx->view);
+    if( ctx->dl_handle != NULL ) {
+        dlclose(ctx->dl_handle);    ctx->dl_handle = NULL;
+    }
 
     if( ret == FNT_SUCCESS ) {
         free(*context); *context = ctx = NULL;
@@ -449,6 +707,86 @@ int fnt_next(void *context, fnt_vect_t *vec) {
 }
 
 
+int fnt_next_view(void *context, fnt_vect_t **vec) {
+    context_t *ctx = (context_t*)context;
+    if( ctx == NULL )               { return FNT_FAILURE; }
+    if( ctx->method.next == NULL )  { return FNT_FAILURE; }
+    if( vec == NULL )               { return FNT_FAILURE; }
+
+    int ret = FNT_FAILURE;
+    if( ctx->method.next_view != NULL ) {
+        /* method lends its own buffer */
+        ret = ctx->method.next_view(ctx->method.handle, vec);
+    } else {
+        /* fill the context's buffer and lend that */
+        ret = ctx->method.next(ctx->method.handle, &ctx->view);
+        *vec = &ctx->view;
+    }
+
+    if( ret == FNT_SUCCESS ) {
+        if( fnt_verbose_level >= FNT_DEBUG ) {
+            fnt_vect_println(*vec, "DEBUG: Borrowed next input vector: ", NULL);
+        }
+    } else if( ret == FNT_FAILURE ) {
+        ERROR("ERROR: Failed to retrieve next input vector.\n");
+    }
+
+    return ret;
+}
+
+
+int fnt_next_batch(void *context, fnt_vect_t *vecs, int *tickets, int capacity, int *count) {
+    context_t *ctx = (context_t*)context;
+    if( ctx == NULL )               { return FNT_FAILURE; }
+    if( ctx->method.next == NULL )  { return FNT_FAILURE; }
+    if( vecs == NULL )              { return FNT_FAILURE; }
+    if( tickets == NULL )           { return FNT_FAILURE; }
+    if( count == NULL )             { return FNT_FAILURE; }
+    if( capacity < 1 )              { return FNT_FAILURE; }
+
+    int ret = FNT_FAILURE;
+    if( ctx->method.next_batch != NULL ) {
+        ret = ctx->method.next_batch(ctx->method.handle, vecs, tickets, capacity, count);
+    } else {
+        /* one input at a time, its value is passed on by fnt_set_value_ticket */
+        ret = ctx->method.next(ctx->method.handle, &vecs[0]);
+        tickets[0] = 0;
+        *count = ret == FNT_SUCCESS ? 1 : 0;
+    }
+
+    if( ret == FNT_SUCCESS ) {
+        DEBUG("DEBUG: Retrieved batch of %d input vectors.\n", *count);
+    } else if( ret == FNT_FAILURE ) {
+        *count = 0;
+        ERROR("ERROR: Failed to retrieve next batch of input vectors.\n");
+    }
+
+    return ret;
+}
+
+
+int fnt_set_value_ticket(void *context, int ticket, fnt_vect_t *vec, double value) {
+    context_t *ctx = (context_t*)context;
+    if( ctx == NULL )               { return FNT_FAILURE; }
+
+    int ret = FNT_FAILURE;
+    if( ctx->method.value_ticket != NULL ) {
+        ret = ctx->method.value_ticket(ctx->method.handle, ticket, value);
+    } else {
+        if( vec == NULL || vec->v == NULL ) { return FNT_FAILURE; }
+        ret = ctx->method.value(ctx->method.handle, vec, value);
+    }
+
+    if( ret == FNT_SUCCESS ) {
+        DEBUG("DEBUG: Set value of objective function for ticket %d to %g.\n", ticket, value);
+    } else if( ret == FNT_FAILURE ) {
+        ERROR("ERROR: Failed to set objective value for ticket %d.\n", ticket);
+    }
+
+    return ret;
+}
+
+
 int fnt_set_value(void *context, fnt_vect_t *vec, double value) {
     context_t *ctx = (context_t*)context;
     if( ctx == NULL )               { return FNT_FAILURE; }
@@ -478,8 +816,9 @@ int fnt_set_value_gradient(void *context, fnt_vect_t *vec, double value, fnt_vec
     if( vec == NULL )               { return FNT_FAILURE; }
     if( gradient == NULL )          { return FNT_FAILURE; }
 
-    /* fall back to non-gradient function, if gradient version not supplied. */
-    if( ctx->method.value_gradient == NULL ) {
+    /* fall back to non-gradient function, if gradients are not used. */
+    if( !(ctx->method.capabilities & FNT_METHOD_CAP_GRADIENT)
+        || ctx->method.value_gradient == NULL ) {
         return fnt_set_value(context, vec, value);
     }
 
@@ -499,6 +838,79 @@ int fnt_set_value_gradient(void *context, fnt_vect_t *vec, double value, fnt_vec
 }
 
 
+int fnt_set_value_residual(void *context, fnt_vect_t *vec, fnt_vect_t *residual, fnt_vect_t *jacobian) {
+    context_t *ctx = (context_t*)context;
+    if( ctx == NULL )               { return FNT_FAILURE; }
+    if( vec == NULL )               { return FNT_FAILURE; }
+    if( residual == NULL )          { return FNT_FAILURE; }
+
+    /* other methods minimize half the squared norm of the residual */
+    if( !(ctx->method.capabilities & FNT_METHOD_CAP_RESIDUAL)
+        || ctx->method.value_residual == NULL ) {
+        double norm = 0.0;
+        fnt_vect_l2norm(residual, &norm);
+        return fnt_set_value(context, vec, 0.5 * norm * norm);
+    }
+
+    if( jacobian != NULL && jacobian->n != residual->n * vec->n ) {
+        ERROR("ERROR: Jacobian has %zu elements, expected %zu.\n", jacobian->n, residual->n * vec->n);
+        return FNT_FAILURE;
+    }
+
+    int ret = ctx->method.value_residual(ctx->method.handle, vec, residual, jacobian);
+
+    if( ret == FNT_SUCCESS ) {
+        if( fnt_verbose_level >= FNT_DEBUG ) {
+            DEBUG("DEBUG: Set residual");
+            fnt_vect_print(vec, " for input ", "%.2f");
+            DEBUG(".\n");
+        }
+    } else if( ret == FNT_FAILURE ) {
+        ERROR("ERROR: Failed to set residual for input vector.\n");
+    }
+
+    return ret;
+}
+
+
+int fnt_minimize(void *context, fnt_objective_t objective, void *user) {
+    context_t *ctx = (context_t*)context;
+    if( ctx == NULL )               { return FNT_FAILURE; }
+    if( ctx->method.next == NULL )  { return FNT_FAILURE; }
+    if( objective == NULL )         { return FNT_FAILURE; }
+
+    int ret = FNT_FAILURE;
+    if( ctx->method.minimize != NULL ) {
+        /* method drives the loop itself */
+        ret = ctx->method.minimize(ctx->method.handle, objective, user);
+    } else {
+        /* call entry points directly, they were checked when loaded */
+        fnt_method_t *method = &ctx->method;
+        void *handle = method->handle;
+        while( (ret = method->done(handle)) == FNT_CONTINUE ) {
+            fnt_vect_t *x = &ctx->view;
+            if( method->next_view != NULL ) {
+                ret = method->next_view(handle, &x);
+            } else {
+                ret = method->next(handle, x);
+            }
+            if( ret != FNT_SUCCESS ) { break; }
+
+            ret = method->value(handle, x, objective(x, user));
+            if( ret != FNT_SUCCESS ) { break; }
+        }
+    }
+
+    if( ret != FNT_DONE ) {
+        ERROR("ERROR: Method '%s' stopped before completion.\n", ctx->method.name);
+        return FNT_FAILURE;
+    }
+    DEBUG("DEBUG: Method '%s' has finished.\n", ctx->method.name);
+
+    return FNT_SUCCESS;
+}
+
+
 int fnt_done(void *context) {
     context_t *ctx = (context_t*)context;
     if( ctx == NULL )               { return FNT_FAILURE; }
@@ -9,6 +9,11 @@
 
 #include "fnt_util.h"
 #include "fnt_vect.h"
+#include "fnt_method.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
 
 /** \brief Creates an opaque context handle.
  * \param context Pointer to a void* to be assigned to the context.
@@ -36,6 +41,51 @@ int fnt_verbose(int verbosity);
  */
 int fnt_set_method(void *context, char *name, int dimensions);
 
+/** \brief Return the loaded method to its initial state.
+ * Hyper-parameters, allocated buffers and the loaded method are kept, so
+ * the context can be reused for another problem of the same dimension
+ * without reloading or reallocating.  Methods that cannot reset in place are
+ * reinitialized, which restores their default hyper-parameters.
+ * \param context FNT context for method.
+ * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
+ */
+int fnt_reset(void *context);
+
+/** \brief Report the capabilities of the loaded method.
+ * \param context FNT context for method.
+ * \param capabilities Set to a bitwise or of FNT_METHOD_CAP_* flags.
+ * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
+ */
+int fnt_capabilities(void *context, unsigned int *capabilities);
+
+/** \brief Report the number of input dimensions of the loaded method.
+ * \param context FNT context for method.
+ * \param dimensions Set to the length of input vectors.
+ * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
+ */
+int fnt_dimensions(void *context, int *dimensions);
+
+/** \brief Seed the loaded method with the points held by another context.
+ * The source may use a different method, but must have the same number of
+ * dimensions.  Values already computed by the source are not requested
+ * again.  Must be called before the first fnt_next, or after fnt_reset.
+ * \param context FNT context to be seeded.
+ * \param source FNT context whose current points are used.
+ * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
+ */
+int fnt_warm_start(void *context, void *source);
+
+/** \brief Seed the loaded method with previously evaluated points.
+ * Points need not be ordered, the best are preferred when the method holds
+ * fewer than count points.
+ * \param context FNT context to be seeded.
+ * \param points Array of count input vectors.
+ * \param values Array of count objective values, or NULL if not evaluated.
+ * \param count Number of points.
+ * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
+ */
+int fnt_warm_start_points(void *context, fnt_vect_t *points, double *values, int count);
+
 /** \brief Frees an FNT context.
  * \param context Pointer to the void* to be freed.
  * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
@@ -68,14 +118,47 @@ int fnt_hparam_get(void *context, char *id, void *value_ptr);
  */
 int fnt_next(void *context, fnt_vect_t *vec);
 
+/** \brief Borrow the next input vector to try from the method.
+ * The vector is owned by the method and must be treated as read-only.  It
+ * remains valid until the next call to fnt_set_value, fnt_next or
+ * fnt_next_view.  Passing it back to fnt_set_value lets the method keep its
+ * buffer without copying.
+ * \param context FNT context for method.
+ * \param vec Set to point at the next input vector.
+ * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
+ */
+int fnt_next_view(void *context, fnt_vect_t **vec);
+
+/** \brief Retrieve a batch of input vectors that can be evaluated concurrently.
+ * Methods without batch support hand out a single vector.  count is zero
+ * when every available input is still awaiting its value.
+ * \param context FNT context for method.
+ * \param vecs Array of capacity allocated vectors to be filled.
+ * \param tickets Array of capacity tickets, one per vector handed out.
+ * \param capacity Maximum number of vectors to hand out.
+ * \param count Set to the number of vectors handed out.
+ * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
+ */
+int fnt_next_batch(void *context, fnt_vect_t *vecs, int *tickets, int capacity, int *count);
+
 /** \brief Provide the value of the objective function for input vector.
  * \param context FNT context for method.
- * \param vec Pointer to the input vector (i.e. v).
+ * \param vec Pointer to the input vector (i.e. v), or the view lent by fnt_next_view.
  * \param value Value of objective function (i.e., f(v)).
  * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
  */
 int fnt_set_value(void *context, fnt_vect_t *vec, double value);
 
+/** \brief Provide the value of the objective function for a batch member.
+ * Values may be reported in any order.
+ * \param context FNT context for method.
+ * \param ticket Ticket handed out with the vector by fnt_next_batch.
+ * \param vec The vector handed out with ticket.
+ * \param value Value of objective function at vec.
+ * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
+ */
+int fnt_set_value_ticket(void *context, int ticket, fnt_vect_t *vec, double value);
+
 /** \brief Provide the value and gradient of the objective function for input vector.
  * \param context FNT context for method.
  * \param vec Pointer to the input vector (i.e. v).
@@ -85,6 +168,31 @@ int fnt_set_value(void *context, fnt_vect_t *vec, double value);
  */
 int fnt_set_value_gradient(void *context, fnt_vect_t *vec, double value, fnt_vect_t *gradient);
 
+/** \brief Provide the residual of a system of equations for input vector.
+ * Methods that do not solve systems are given half the squared norm of the
+ * residual as the value to minimize.  Residuals for inputs from
+ * fnt_next_batch are matched by vec, which must hold the input as returned.
+ * \param context FNT context for method.
+ * \param vec Pointer to the input vector (i.e. x).
+ * \param residual Residual vector (i.e., r(x)), zero at a solution.
+ * \param jacobian Derivatives of the residual, element i*n+j holding
+ *      dr_i/dx_j, or NULL if not available.
+ * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
+ */
+int fnt_set_value_residual(void *context, fnt_vect_t *vec, fnt_vect_t *residual, fnt_vect_t *jacobian);
+
+/** \brief Run the loaded method to completion against an objective function.
+ * This is a fast path for cheap objectives, equivalent to looping over
+ * fnt_done, fnt_next_view and fnt_set_value, but without per-step checks,
+ * logging or copies.  Methods may drive the loop themselves.  Results are
+ * available from fnt_result afterwards.
+ * \param context FNT context for method.
+ * \param objective Function evaluated at every input the method needs.
+ * \param user Pointer passed through to objective, may be NULL.
+ * \return FNT_SUCCESS once the method is done, FNT_FAILURE otherwise.
+ */
+int fnt_minimize(void *context, fnt_objective_t objective, void *user);
+
 /** \brief Check if method had completed.
  * \param context FNT context to be checked.
  * \return FNT_DONE when complete, zero otherwise.
@@ -99,4 +207,135 @@ int fnt_done(void *context);
  */
 int fnt_result(void *context, char *name, void *value_ptr);
 
+/* MARK: Concurrent evaluation */
+
+/** \brief Create a lock-free front-end for evaluating inputs on many threads.
+ * Workers pull inputs with fnt_async_take and push values with
+ * fnt_async_put, neither blocks.  Whichever thread finds work to do acts as
+ * the single consumer, feeding values to the method in batches and queueing
+ * new inputs.  The context must not be used directly until the front-end
+ * reports FNT_DONE, results are then available from fnt_result.
+ * \param async Pointer to a void* to be assigned to the front-end.
+ * \param context FNT context with a method already set.
+ * \param capacity Maximum number of inputs being evaluated at once.
+ * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
+ */
+int fnt_async_init(void **async, void *context, int capacity);
+
+/** \brief Free a front-end created by fnt_async_init, keeping its context.
+ * \param async Pointer to the void* to be freed.
+ * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
+ */
+int fnt_async_free(void **async);
+
+/** \brief Take an input to evaluate, safe to call from any thread.
+ * \param async Front-end created by fnt_async_init.
+ * \param vec Set to the input, valid until its value is put.
+ * \param ticket Set to the ticket to put the value with.
+ * \return FNT_SUCCESS when an input was taken, FNT_CONTINUE when none is
+ *      ready yet, FNT_DONE when the method has finished, FNT_FAILURE on error.
+ */
+int fnt_async_take(void *async, fnt_vect_t **vec, int *ticket);
+
+/** \brief Report the value for a taken input, safe to call from any thread.
+ * \param async Front-end created by fnt_async_init.
+ * \param ticket Ticket returned with the input by fnt_async_take.
+ * \param value Value of the objective function at the input.
+ * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
+ */
+int fnt_async_put(void *async, int ticket, double value);
+
+
+/* MARK: Work-stealing scheduler */
+
+/** \brief Task run by the scheduler. */
+typedef void (*fnt_task_fn_t)(void *arg);
+
+/** \brief Start a pool of workers that steal tasks from one another.
+ * \param sched Pointer to a void* to be assigned to the scheduler.
+ * \param workers Number of worker threads, or 0 for one per processor.
+ * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
+ */
+int fnt_sched_init(void **sched, int workers);
+
+/** \brief Stop the workers and free the scheduler.
+ * Tasks that have not started are dropped.
+ * \param sched Pointer to the void* to be freed.
+ * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
+ */
+int fnt_sched_free(void **sched);
+
+/** \brief Queue a task, safe to call from any thread including tasks.
+ * \param sched Scheduler created by fnt_sched_init.
+ * \param group Counter, zero initialized by the caller, that is
+ *      incremented now and decremented when the task completes.
+ * \param fn Function to run.
+ * \param arg Passed to fn.
+ * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
+ */
+int fnt_sched_spawn(void *sched, int *group, fnt_task_fn_t fn, void *arg);
+
+/** \brief Wait for every task in group to complete.
+ * The caller runs other tasks while waiting, so tasks may spawn and wait
+ * on nested groups without tying up workers.
+ * \param sched Scheduler created by fnt_sched_init.
+ * \param group Counter passed to fnt_sched_spawn.
+ * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
+ */
+int fnt_sched_wait(void *sched, int *group);
+
+/** \brief Run a context to completion, evaluating each batch on the scheduler.
+ * May itself be called from a task, e.g. one run of a multi-start search.
+ * objective must be safe to call concurrently.
+ * \param sched Scheduler created by fnt_sched_init.
+ * \param context FNT context with a method already set.
+ * \param objective Function evaluated at every input the method needs.
+ * \param user Pointer passed through to objective, may be NULL.
+ * \return FNT_SUCCESS once the method is done, FNT_FAILURE otherwise.
+ */
+int fnt_sched_minimize(void *sched, void *context, fnt_objective_t objective, void *user);
+
+/* MARK: Worker processes */
+
+/** \brief Fork a pool of processes that evaluate objective.
+ * For objectives that are not thread-safe, each worker is a separate
+ * process sharing only a ring of input slots with the caller.  Workers
+ * that die are restarted and their inputs evaluated again.
+ * \param procs Pointer to a void* to be assigned to the pool.
+ * \param workers Number of processes, or 0 for one per processor.
+ * \param dimensions Length of every input vector.
+ * \param objective Function evaluated in the worker processes.
+ * \param user Pointer passed through to objective, may be NULL.
+ * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
+ */
+int fnt_procs_init(void **procs, int workers, int dimensions, fnt_objective_t objective, void *user);
+
+/** \brief Stop the workers and free the pool.
+ * Waits for evaluations in progress to finish.
+ * \param procs Pointer to the void* to be freed.
+ * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
+ */
+int fnt_procs_free(void **procs);
+
+/** \brief Number of workers restarted after dying.
+ * \param procs Pool created by fnt_procs_init.
+ * \param restarts Set to the number of restarts so far.
+ * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
+ */
+int fnt_procs_restarts(void *procs, int *restarts);
+
+/** \brief Run a context to completion, evaluating inputs in the workers.
+ * Methods that hand out batches keep every worker busy, others are
+ * evaluated one input at a time.  Fails if one input kills several workers.
+ * \param procs Pool created by fnt_procs_init.
+ * \param context FNT context with a method already set, for as many
+ *      dimensions as the pool was started with.
+ * \return FNT_SUCCESS once the method is done, FNT_FAILURE otherwise.
+ */
+int fnt_procs_minimize(void *procs, void *context);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
 #endif /* FNT_H */
@@ -0,0 +1,396 @@
+/*
+ * fnt.hpp
+ * fnt: Numerical Toolbox
+ *
+ * Copyright (c) 2024 Bryan Franklin. All rights reserved.
+ */
+#ifndef FNT_HPP
+#define FNT_HPP
+
+/* Header only C++17 wrapper around the C interface in fnt.h.  Every member
+ * is inline and forwards straight to the C call, failures are reported by
+ * throwing fnt::error. */
+
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "fnt.h"
+
+namespace fnt {
+
+/* MARK: Errors */
+
+/** \brief Thrown when an underlying fnt_* call returns FNT_FAILURE. */
+class error : public std::runtime_error {
+public:
+    using std::runtime_error::runtime_error;
+};
+
+
+namespace detail {
+
+inline void check(int ret, const char *call) {
+    if( ret == FNT_FAILURE ) {
+        throw error(std::string(call) + " failed");
+    }
+}
+
+/* the C interface predates const, but never modifies names or ids */
+inline char *str(const char *s) { return const_cast<char*>(s); }
+
+/* call f(0), ..., f(N-1) without a loop */
+template<class F, std::size_t... I>
+constexpr void unroll(F &&f, std::index_sequence<I...>) {
+    (f(I), ...);
+}
+
+template<std::size_t N, class F>
+constexpr void unroll(F &&f) {
+    unroll(std::forward<F>(f), std::make_index_sequence<N>{});
+}
+
+} /* namespace detail */
+
+
+/* MARK: Vectors */
+
+/** Dimension used for vectors whose length is only known at run time. */
+constexpr std::size_t dynamic = 0;
+
+/** \brief Vector of N doubles stored in place.
+ * Aggregate, so fnt::vec<2> x{{1.0, 2.0}} works and the arithmetic below is
+ * unrolled at compile time.
+ */
+template<std::size_t N = dynamic>
+struct vec {
+    static_assert(N > 0, "use fnt::vec<fnt::dynamic> for run time lengths");
+
+    double v[N];
+
+    static constexpr std::size_t size() { return N; }
+
+    constexpr double &operator[](std::size_t i)             { return v[i]; }
+    constexpr const double &operator[](std::size_t i) const { return v[i]; }
+
+    constexpr double *data()                { return v; }
+    constexpr const double *data() const    { return v; }
+    constexpr double *begin()               { return v; }
+    constexpr double *end()                 { return v + N; }
+    constexpr const double *begin() const   { return v; }
+    constexpr const double *end() const     { return v + N; }
+
+    /** \brief Non-owning fnt_vect_t over this vector's storage. */
+    fnt_vect_t view() const { return fnt_vect_t{ const_cast<double*>(v), N }; }
+};
+
+
+/** \brief Vector whose length is chosen at run time. */
+template<>
+struct vec<dynamic> {
+    std::vector<double> v;
+
+    vec() = default;
+    explicit vec(std::size_t n) : v(n, 0.0) {}
+
+    std::size_t size() const { return v.size(); }
+
+    double &operator[](std::size_t i)               { return v[i]; }
+    const double &operator[](std::size_t i) const   { return v[i]; }
+
+    double *data()                  { return v.data(); }
+    const double *data() const      { return v.data(); }
+    double *begin()                 { return v.data(); }
+    double *end()                   { return v.data() + v.size(); }
+    const double *begin() const     { return v.data(); }
+    const double *end() const       { return v.data() + v.size(); }
+
+    fnt_vect_t view() const { return fnt_vect_t{ const_cast<double*>(v.data()), v.size() }; }
+};
+
+
+template<std::size_t N>
+constexpr vec<N> operator+(const vec<N> &a, const vec<N> &b) {
+    vec<N> r{};
+    detail::unroll<N>([&](std::size_t i) { r.v[i] = a.v[i] + b.v[i]; });
+    return r;
+}
+
+template<std::size_t N>
+constexpr vec<N> operator-(const vec<N> &a, const vec<N> &b) {
+    vec<N> r{};
+    detail::unroll<N>([&](std::size_t i) { r.v[i] = a.v[i] - b.v[i]; });
+    return r;
+}
+
+template<std::size_t N>
+constexpr vec<N> operator*(double s, const vec<N> &a) {
+    vec<N> r{};
+    detail::unroll<N>([&](std::size_t i) { r.v[i] = s * a.v[i]; });
+    return r;
+}
+
+template<std::size_t N>
+constexpr double dot(const vec<N> &a, const vec<N> &b) {
+    double sum = 0.0;
+    detail::unroll<N>([&](std::size_t i) { sum += a.v[i] * b.v[i]; });
+    return sum;
+}
+
+template<std::size_t N>
+inline double l2norm(const vec<N> &a) { return std::sqrt(dot(a, a)); }
+
+template<std::size_t N>
+inline double dist(const vec<N> &a, const vec<N> &b) { return l2norm(a - b); }
+
+
+namespace detail {
+
+template<class T> struct is_vec : std::false_type {};
+template<std::size_t N> struct is_vec<vec<N>> : std::true_type {};
+
+} /* namespace detail */
+
+
+/* MARK: Ask/tell iteration */
+
+/** \brief Input vector handed out by a context, awaiting its value.
+ * The storage is borrowed from the method and is only valid until tell.
+ */
+class trial {
+public:
+    trial(void *ctx, fnt_vect_t *x) : ctx_(ctx), x_(x) {}
+
+    std::size_t size() const                    { return x_->n; }
+    double operator[](std::size_t i) const      { return x_->v[i]; }
+    const double *data() const                  { return x_->v; }
+    const double *begin() const                 { return x_->v; }
+    const double *end() const                   { return x_->v + x_->n; }
+
+    /** \brief Underlying vector, for use with fnt_problems.h and friends. */
+    fnt_vect_t *vect() const                    { return x_; }
+
+    /** \brief Report the objective value for this input. */
+    void tell(double value) const {
+        detail::check(fnt_set_value(ctx_, x_, value), "fnt_set_value");
+    }
+
+private:
+    void *ctx_;
+    fnt_vect_t *x_;
+};
+
+
+/** \brief Range yielding trials until the method is done.
+ * Each trial must be told its value before the loop advances.
+ */
+class trials {
+public:
+    class iterator {
+    public:
+        explicit iterator(void *ctx) : ctx_(ctx) {}
+
+        trial operator*() const { return trial(ctx_, x_); }
+
+        iterator &operator++() {
+            advance();
+            return *this;
+        }
+
+        bool operator!=(const iterator &other) const { return x_ != other.x_; }
+        bool operator==(const iterator &other) const { return x_ == other.x_; }
+
+    private:
+        friend class trials;
+
+        void advance() {
+            if( fnt_done(ctx_) != FNT_CONTINUE
+                || fnt_next_view(ctx_, &x_) != FNT_SUCCESS ) {
+                x_ = nullptr;
+            }
+        }
+
+        void *ctx_;
+        fnt_vect_t *x_ = nullptr;
+    };
+
+    explicit trials(void *ctx) : ctx_(ctx) {}
+
+    iterator begin() const {
+        iterator it(ctx_);
+        it.advance();
+        return it;
+    }
+    iterator end() const { return iterator(ctx_); }
+
+private:
+    void *ctx_;
+};
+
+
+/* MARK: Contexts */
+
+/** \brief Owns an FNT context and the method loaded into it. */
+class context {
+public:
+    /** \brief Create a context, registering the methods found in path. */
+    explicit context(const char *path) {
+        int ret = fnt_init(&ctx_, detail::str(path));
+        if( ret == FNT_FAILURE ) {
+            fnt_free(&ctx_);
+            throw error("fnt_init failed");
+        }
+    }
+
+    /** \brief Create a context and load a method for dimensions inputs. */
+    context(const char *path, const char *method, int dimensions) : context(path) {
+        set_method(method, dimensions);
+    }
+
+    ~context() {
+        if( ctx_ != nullptr ) { fnt_free(&ctx_); }
+    }
+
+    context(const context&) = delete;
+    context &operator=(const context&) = delete;
+
+    context(context &&other) noexcept
+        : ctx_(std::exchange(other.ctx_, nullptr)), dim_(other.dim_) {}
+
+    context &operator=(context &&other) noexcept {
+        if( this != &other ) {
+            if( ctx_ != nullptr ) { fnt_free(&ctx_); }
+            ctx_ = std::exchange(other.ctx_, nullptr);
+            dim_ = other.dim_;
+        }
+        return *this;
+    }
+
+    /** \brief Underlying handle, for calls the wrapper does not cover. */
+    void *get() const { return ctx_; }
+
+    int dimensions() const { return dim_; }
+
+    void set_method(const char *name, int dimensions) {
+        detail::check(fnt_set_method(ctx_, detail::str(name), dimensions), "fnt_set_method");
+        dim_ = dimensions;
+    }
+
+    void reset() { detail::check(fnt_reset(ctx_), "fnt_reset"); }
+
+    unsigned int capabilities() const {
+        unsigned int caps = FNT_METHOD_CAP_NONE;
+        detail::check(fnt_capabilities(ctx_, &caps), "fnt_capabilities");
+        return caps;
+    }
+
+    void warm_start(const context &source) {
+        detail::check(fnt_warm_start(ctx_, source.ctx_), "fnt_warm_start");
+    }
+
+    /** \brief Set a hyper-parameter.
+     * Integral values are passed as int, floating point values as double and
+     * vectors as fnt_vect_t, matching what methods expect.  Vectors keep their
+     * own length, as not every vector hyper-parameter has one element per
+     * dimension.
+     */
+    template<class T>
+    void set(const char *id, const T &value) {
+        if constexpr( std::is_integral_v<T> ) {
+            int v = static_cast<int>(value);
+            detail::check(fnt_hparam_set(ctx_, detail::str(id), &v), "fnt_hparam_set");
+        } else if constexpr( std::is_floating_point_v<T> ) {
+            double v = static_cast<double>(value);
+            detail::check(fnt_hparam_set(ctx_, detail::str(id), &v), "fnt_hparam_set");
+        } else if constexpr( detail::is_vec<T>::value ) {
+            fnt_vect_t v = value.view();
+            detail::check(fnt_hparam_set(ctx_, detail::str(id), &v), "fnt_hparam_set");
+        } else {
+            static_assert(detail::is_vec<T>::value, "unsupported hyper-parameter type");
+        }
+    }
+
+    /** \brief Retrieve a hyper-parameter of type int, double or fnt::vec.
+     * A fnt::vec<fnt::dynamic> has one element per dimension unless length
+     * is given.
+     */
+    template<class T>
+    T get(const char *id, std::size_t length = 0) const {
+        return fetch<T>(fnt_hparam_get, id, "fnt_hparam_get", length);
+    }
+
+    /** \brief Retrieve a result of type int, double or fnt::vec.
+     * Results such as a packed Hessian are not one element per dimension,
+     * pass their length for a fnt::vec<fnt::dynamic>.
+     */
+    template<class T>
+    T result(const char *name, std::size_t length = 0) const {
+        return fetch<T>(fnt_result, name, "fnt_result", length);
+    }
+
+    bool done() const { return fnt_done(ctx_) != FNT_CONTINUE; }
+
+    /** \brief Ask for the next input, filling x. */
+    template<std::size_t N>
+    void next(vec<N> &x) {
+        check_size(x.size());
+        fnt_vect_t v = x.view();
+        detail::check(fnt_next(ctx_, &v), "fnt_next");
+    }
+
+    /** \brief Tell the method the objective value at x. */
+    template<std::size_t N>
+    void tell(const vec<N> &x, double value) {
+        check_size(x.size());
+        fnt_vect_t v = x.view();
+        detail::check(fnt_set_value(ctx_, &v, value), "fnt_set_value");
+    }
+
+    /** \brief Range of trials for use in a range-based for loop. */
+    fnt::trials trials() { return fnt::trials(ctx_); }
+
+private:
+    void check_size(std::size_t n) const {
+        if( n != static_cast<std::size_t>(dim_) ) {
+            throw error("vector length does not match method dimensions");
+        }
+    }
+
+    template<class T>
+    T fetch(int (*call)(void*, char*, void*), const char *id, const char *what,
+            std::size_t length) const {
+        if constexpr( std::is_integral_v<T> ) {
+            int v = 0;
+            detail::check(call(ctx_, detail::str(id), &v), what);
+            return static_cast<T>(v);
+        } else if constexpr( std::is_floating_point_v<T> ) {
+            double v = 0.0;
+            detail::check(call(ctx_, detail::str(id), &v), what);
+            return static_cast<T>(v);
+        } else if constexpr( std::is_same_v<T, vec<dynamic>> ) {
+            T x(length > 0 ? length : static_cast<std::size_t>(dim_));
+            fnt_vect_t v = x.view();
+            detail::check(call(ctx_, detail::str(id), &v), what);
+            return x;
+        } else if constexpr( detail::is_vec<T>::value ) {
+            T x{};
+            fnt_vect_t v = x.view();
+            detail::check(call(ctx_, detail::str(id), &v), what);
+            return x;
+        } else {
+            static_assert(detail::is_vec<T>::value, "unsupported value type");
+        }
+    }
+
+    void *ctx_ = nullptr;
+    int dim_ = 0;
+};
+
+} /* namespace fnt */
+
+#endif /* FNT_HPP */
@@ -0,0 +1,232 @@
+/*
+ * fnt_async.c
+ * fnt: Numerical Toolbox
+ *
+ * Copyright (c) 2024 Bryan Franklin. All rights reserved.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "fnt.h"
+#include "fnt_queue.h"
+#include "fnt_util.h"
+#include "fnt_vect.h"
+
+/* MARK: Internal structures */
+
+typedef struct fnt_async {
+    void *context;
+    int batch;              /* method hands out several inputs at once */
+    int capacity;           /* number of slots */
+
+    /* slot table, one slot per input handed to the workers */
+    fnt_vect_t *inputs;
+    int *method_tickets;
+
+    /* consumer only, guarded by pumping */
+    int *free_slots;        /* stack of unused slots */
+    int free_count;
+    int outstanding;
+    fnt_vect_t *batch_vecs;
+    int *batch_tickets;
+    int *batch_slots;
+
+    /* slots ready for workers, and (slot, value) records from them */
+    fnt_queue_t pending;
+    fnt_queue_t results;
+
+    int pumping;            /* set while a thread acts as the consumer */
+    int done;
+    int failed;
+} fnt_async_t;
+
+
+/* MARK: Internal functions */
+
+/* Feed results to the method and queue new inputs.  Only one thread runs
+ * this at a time, the others return immediately rather than wait. */
+static int fnt_async_pump(fnt_async_t *a) {
+    if( __atomic_exchange_n(&a->pumping, 1, __ATOMIC_ACQUIRE) ) {
+        return FNT_CONTINUE;
+    }
+
+    /* drain every result that is ready */
+    int slot = 0;
+    double value = 0.0;
+    while( fnt_queue_pop(&a->results, &slot, &value) == FNT_SUCCESS ) {
+        if( fnt_set_value_ticket(a->context, a->method_tickets[slot],
+                &a->inputs[slot], value) != FNT_SUCCESS ) {
+            __atomic_store_n(&a->failed, 1, __ATOMIC_RELEASE);
+        }
+        a->free_slots[a->free_count++] = slot;
+        --a->outstanding;
+    }
+
+    /* refill with as many inputs as the method can hand out */
+    int status = fnt_done(a->context);
+    if( status == FNT_CONTINUE && a->free_count > 0
+        && (a->batch || a->outstanding == 0) ) {
+
+        /* vectors alias the buffers of the topmost free slots */
+        int n = a->batch ? a->free_count : 1;
+        for(int k=0; k<n; ++k) {
+            a->batch_slots[k] = a->free_slots[a->free_count-1-k];
+            a->batch_vecs[k] = a->inputs[a->batch_slots[k]];
+        }
+
+        int count = 0;
+        if( fnt_next_batch(a->context, a->batch_vecs, a->batch_tickets, n, &count) != FNT_SUCCESS ) {
+            /* handing out inputs can itself finish the method */
+            status = fnt_done(a->context);
+            if( status != FNT_DONE )    { status = FNT_FAILURE; }
+            count = 0;
+        } else if( count == 0 ) {
+            status = fnt_done(a->context);
+        }
+        for(int k=0; k<count; ++k) {
+            slot = a->batch_slots[k];
+            a->method_tickets[slot] = a->batch_tickets[k];
+            fnt_queue_push(&a->pending, slot, 0.0);
+        }
+        a->free_count -= count;
+        a->outstanding += count;
+        DEBUG("DEBUG: Queued %d inputs, %d outstanding.\n", count, a->outstanding);
+    }
+
+    if( status == FNT_FAILURE ) {
+        __atomic_store_n(&a->failed, 1, __ATOMIC_RELEASE);
+    } else if( status == FNT_DONE && a->outstanding == 0 ) {
+        __atomic_store_n(&a->done, 1, __ATOMIC_RELEASE);
+    }
+
+    __atomic_store_n(&a->pumping, 0, __ATOMIC_RELEASE);
+
+    return FNT_SUCCESS;
+}
+
+
+static int fnt_async_status(fnt_async_t *a) {
+    if( __atomic_load_n(&a->failed, __ATOMIC_ACQUIRE) ) { return FNT_FAILURE; }
+    if( __atomic_load_n(&a->done, __ATOMIC_ACQUIRE) )   { return FNT_DONE; }
+
+    return FNT_CONTINUE;
+}
+
+
+/* MARK: User callable functions */
+
+int fnt_async_init(void **async, void *context, int capacity) {
+    if( async == NULL )     { return FNT_FAILURE; }
+    if( context == NULL )   { return FNT_FAILURE; }
+    if( capacity < 1 )      { return FNT_FAILURE; }
+
+    unsigned int capabilities = FNT_METHOD_CAP_NONE;
+    int dimensions = 0;
+    if( fnt_capabilities(context, &capabilities) != FNT_SUCCESS
+        || fnt_dimensions(context, &dimensions) != FNT_SUCCESS ) {
+        return FNT_FAILURE;
+    }
+
+    fnt_async_t *a = calloc(1, sizeof(fnt_async_t));
+    if( a == NULL )         { return FNT_FAILURE; }
+    a->context = context;
+    a->batch = (capabilities & FNT_METHOD_CAP_BATCH) != 0;
+    a->capacity = capacity;
+
+    a->inputs = calloc(capacity, sizeof(fnt_vect_t));
+    a->method_tickets = calloc(capacity, sizeof(int));
+    a->free_slots = calloc(capacity, sizeof(int));
+    a->batch_vecs = calloc(capacity, sizeof(fnt_vect_t));
+    a->batch_tickets = calloc(capacity, sizeof(int));
+    a->batch_slots = calloc(capacity, sizeof(int));
+    int ret = FNT_SUCCESS;
+    if( a->inputs == NULL || a->method_tickets == NULL || a->free_slots == NULL
+        || a->batch_vecs == NULL || a->batch_tickets == NULL || a->batch_slots == NULL ) {
+        ERROR("ERROR: Failed to allocate %d evaluation slots.\n", capacity);
+        ret = FNT_FAILURE;
+    }
+    for(int i=0; ret == FNT_SUCCESS && i<capacity; ++i) {
+        if( fnt_vect_calloc(&a->inputs[i], dimensions) != FNT_VEC_SUCCESS ) {
+            ret = FNT_FAILURE;
+        }
+        a->free_slots[i] = capacity - 1 - i;
+    }
+    a->free_count = capacity;
+
+    if( ret == FNT_SUCCESS
+        && (fnt_queue_init(&a->pending, capacity) != FNT_SUCCESS
+         || fnt_queue_init(&a->results, capacity) != FNT_SUCCESS) ) {
+        ret = FNT_FAILURE;
+    }
+
+    *async = a;
+    if( ret != FNT_SUCCESS ) {
+        fnt_async_free(async);
+        return FNT_FAILURE;
+    }
+
+    return FNT_SUCCESS;
+}
+
+
+int fnt_async_free(void **async) {
+    if( async == NULL )     { return FNT_FAILURE; }
+    fnt_async_t *a = (fnt_async_t*)*async;
+    if( a == NULL )         { return FNT_FAILURE; }
+
+    if( a->inputs != NULL ) {
+        for(int i=0; i<a->capacity; ++i) { fnt_vect_free(&a->inputs[i]); }
+    }
+    free(a->inputs);
+    free(a->method_tickets);
+    free(a->free_slots);
+    free(a->batch_vecs);
+    free(a->batch_tickets);
+    free(a->batch_slots);
+    fnt_queue_free(&a->pending);
+    fnt_queue_free(&a->results);
+
+    free(a); *async = NULL;
+
+    return FNT_SUCCESS;
+}
+
+
+int fnt_async_take(void *async, fnt_vect_t **vec, int *ticket) {
+    fnt_async_t *a = (fnt_async_t*)async;
+    if( a == NULL )         { return FNT_FAILURE; }
+    if( vec == NULL )       { return FNT_FAILURE; }
+    if( ticket == NULL )    { return FNT_FAILURE; }
+
+    int slot = 0;
+    if( fnt_queue_pop(&a->pending, &slot, NULL) != FNT_SUCCESS ) {
+        /* nothing queued, try to produce more */
+        fnt_async_pump(a);
+        if( fnt_queue_pop(&a->pending, &slot, NULL) != FNT_SUCCESS ) {
+            return fnt_async_status(a);
+        }
+    }
+
+    *vec = &a->inputs[slot];
+    *ticket = slot;
+
+    return FNT_SUCCESS;
+}
+
+
+int fnt_async_put(void *async, int ticket, double value) {
+    fnt_async_t *a = (fnt_async_t*)async;
+    if( a == NULL )                             { return FNT_FAILURE; }
+    if( ticket < 0 || ticket >= a->capacity )   { return FNT_FAILURE; }
+
+    /* cannot be full, there are never more results than slots */
+    if( fnt_queue_push(&a->results, ticket, value) != FNT_SUCCESS ) {
+        ERROR("ERROR: Result queue overflow for ticket %d.\n", ticket);
+        return FNT_FAILURE;
+    }
+
+    fnt_async_pump(a);
+
+    return FNT_SUCCESS;
+}
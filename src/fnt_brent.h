@@ -0,0 +1,325 @@
+/*
+ * fnt_brent.h
+ * fnt: Numerical Toolbox
+ *
+ * Copyright (c) 2024 Bryan Franklin. All rights reserved.
+ */
+#ifndef FNT_BRENT_H
+#define FNT_BRENT_H
+
+#include <math.h>
+#include "fnt_util.h"
+
+/* Brent's local minimizer and a line search built on it, for methods that
+ * need one dimensional minimizations without loading brents-localmin as a
+ * separate method.  Both are driven the same way as a method, ask for the
+ * point to evaluate, then report its value:
+ *
+ *  fnt_line_start(&ls, f_x, step, eps, t);
+ *  while( fnt_line_next(&ls, &s) == FNT_CONTINUE ) {
+ *      ... evaluate f at x + s * d ...
+ *      fnt_line_value(&ls, f);
+ *  }
+ *  ... x + ls.best_s * d has value ls.best_f ...
+ */
+
+/* MARK: Brent's local minimizer */
+
+typedef enum fnt_brent_state {
+    fnt_brent_initial, fnt_brent_starting, fnt_brent_running, fnt_brent_done
+} fnt_brent_state_t;
+
+typedef struct fnt_brent {
+    fnt_brent_state_t state;
+
+    /* interval, golden ratio constant and tolerances */
+    double a;
+    double b;
+    double c;
+    double eps;
+    double t;
+
+    double u;
+    double v;
+    double w;
+    double x;
+    double fu;
+    double fv;
+    double fw;
+    double fx;
+
+    double e;
+    double d;
+} fnt_brent_t;
+
+
+/* Start a search for a local minimum in [a, b], within eps * |x| + t. */
+static inline int fnt_brent_start(fnt_brent_t *br, double a, double b, double eps, double t) {
+    if( br == NULL )        { return FNT_FAILURE; }
+
+    br->state = fnt_brent_initial;
+    br->a = a;
+    br->b = b;
+    br->eps = eps;
+    br->t = t;
+
+    br->c = (3.0 - sqrt(5.0)) / 2.0;
+    br->v = br->w = br->x = br->u = a + br->c * (b - a);
+    br->fu = br->fv = br->fw = br->fx = 0.0;
+    br->e = 0.0;
+    br->d = 0.0;  /* from errata */
+
+    DEBUG("Initializing by requesting f(x) = f(%g).\n", br->x);
+
+    return FNT_SUCCESS;
+}
+
+
+/* The abscissa whose value is needed next. */
+static inline double fnt_brent_point(fnt_brent_t *br) {
+    return br->state == fnt_brent_initial ? br->x : br->u;
+}
+
+
+/* Report fu = f(u) for the requested point u.
+ * Returns FNT_DONE once x holds the local minimum, FNT_CONTINUE otherwise. */
+static inline int fnt_brent_value(fnt_brent_t *br, double u, double fu) {
+    double a = br->a;
+    double b = br->b;
+    double c = br->c;
+    double v = br->v;
+    double w = br->w;
+    double x = br->x;
+    double fv = br->fv;
+    double fw = br->fw;
+    double fx = br->fx;
+    double e = br->e;
+    double d = br->d;
+
+    if( br->state == fnt_brent_done )   { return FNT_DONE; }
+
+    if( br->state == fnt_brent_initial ) {
+        v  = w = x = u;
+        fv = fw = fx = fu;
+
+        DEBUG("Got initial value f(x) = f(%g) = %g.\n", x, fx);
+
+        DEBUG("Setting state to starting.\n");
+        br->state = fnt_brent_starting;
+    }
+
+    if( br->state == fnt_brent_running ) {
+        /* skip this on the first iteration,
+         * as it is the end of the original loop. */
+        DEBUG("Updating with f(u) = f(%g) = %g.\n", u, fu);
+
+        /* Update a, b, v, w, and x */
+        if( fu <= fx ) {
+                                        /* FORTRAN: 130 */
+            if( u < x ) { b = x; } else { a = x; }
+            /* FORTRAN: 140 */
+            v = w;  fv = fw;    w = x;  fw = fx;    x = u;  fx = fu;
+        } else {
+            /* FORTRAN: 150 */          /* FORTRAN: 160 */
+            if( u < x ) { a = u; } else { b = u; }
+            /* FORTRAN: 170 */
+            if( fu <= fw || w == x ) {
+                v = w;  fv = fw;    w = u;  fw = fu;
+            } else {
+                /* FORTRAN: 180 */
+                v = u;  fv = fu;
+            }
+        }
+    } else {
+        DEBUG("Setting state to running.\n");
+        br->state = fnt_brent_running;
+    }
+
+    /* ALGOL: loop */
+    /* FORTRAN: 10 */
+    double m = 0.5 * (a + b);
+    double tol = br->eps * fabs(x) + br->t;
+    double t2 = 2.0 * tol;
+
+    /* Check stopping criterion */
+    if( fabs(x - m) > t2 - 0.5 * (b - a) ) {
+        double p, q, r;
+        p = q = r = 0;
+        if( fabs(e) > tol ) {
+            DEBUG("Fitting a parabola.\n");
+            /* Fit parabola */
+            r = (x - w) * (fx -fv);     q = (x - v) * (fx - fw);
+            p = (x - v) * q - (x - w) * r;      q = 2 * (q - r);
+                                         /* FORTRAN: 20 */
+            if( q > 0 ) { p = -p; } else { q = -q; }
+            /* FORTRAN: 30 */
+            r = e;      e = d;
+        }
+        /* FORTRAN: 40 */
+        if( fabs(p) < fabs(0.5 * q * r) && p > q * (a - x) && p < q * (b-x) ) {
+            DEBUG("Parabolic interpolation.\n");
+            /* A "parabolic interpolation" step */
+            d = p / q;      u = x + d;
+            /* f must not be evaluated too close to a or b */
+                                                        /* FORTRAN: 50 */
+            if( u - a < t2 || b - u < t2 ) { d = (x < m) ? tol : -tol; }
+        } else {
+            DEBUG("Golden section step.\n");
+            /* A "golden section" step */
+            /* FORTRAN: 60 & 70 */          /* FORTRAN: 80 */
+            e = ((x < m) ? b : a) - x;      d = c * e;
+        }
+        /* f must not be evaluated too close to x */
+        /* FORTRAN: 90 100 & 110 */
+        u = x + ((fabs(d) >= tol ? d : (d > 0 ? tol : -tol)));
+
+        DEBUG("Requesting f(u) = f(%g).\n", u);
+        /* FORTRAN: 120 is external to this function. */
+    } else {
+        /* FORTRAN: 190 */
+        DEBUG("Setting state to done.\n");
+        br->state = fnt_brent_done;
+    }
+
+    br->a = a;
+    br->b = b;
+    br->u = u;
+    br->v = v;
+    br->w = w;
+    br->x = x;
+    br->fu = fu;
+    br->fv = fv;
+    br->fw = fw;
+    br->fx = fx;
+    br->e = e;
+    br->d = d;
+
+    return br->state == fnt_brent_done ? FNT_DONE : FNT_CONTINUE;
+}
+
+
+/* MARK: Line search */
+
+#define FNT_LINE_GOLD       1.618034
+#define FNT_LINE_EXPAND     50
+
+typedef enum fnt_line_state {
+    fnt_line_probe, fnt_line_reverse, fnt_line_bracket, fnt_line_brent,
+    fnt_line_done
+} fnt_line_state_t;
+
+/* Minimizes phi(s) = f(x + s d) given phi(0), first bracketing a minimum by
+ * golden ratio expansion from s = step, then narrowing it with Brent. */
+typedef struct fnt_line {
+    fnt_line_state_t state;
+    double eps;
+    double t;
+    int expansions;
+
+    /* bracket s1 < s2 < s3 (or reversed) with phi(s2) below both ends */
+    double s1, s2, s3;
+    double f1, f2, f3;
+    fnt_brent_t brent;
+
+    /* best point seen, including s = 0 */
+    double best_s;
+    double best_f;
+} fnt_line_t;
+
+
+static inline int fnt_line_start(fnt_line_t *ls, double f0, double step, double eps, double t) {
+    if( ls == NULL )        { return FNT_FAILURE; }
+    if( step == 0.0 )       { return FNT_FAILURE; }
+
+    ls->state = fnt_line_probe;
+    ls->eps = eps;
+    ls->t = t;
+    ls->expansions = 0;
+    ls->s1 = 0.0;           ls->f1 = f0;
+    ls->s2 = step;
+    ls->best_s = 0.0;       ls->best_f = f0;
+
+    return FNT_SUCCESS;
+}
+
+
+/* Step s whose value is needed, FNT_DONE once best_s is final. */
+static inline int fnt_line_next(fnt_line_t *ls, double *s) {
+    switch( ls->state ) {
+        case fnt_line_probe:    *s = ls->s2;    break;
+        case fnt_line_reverse:  *s = ls->s1;    break;
+        case fnt_line_bracket:  *s = ls->s3;    break;
+        case fnt_line_brent:    *s = fnt_brent_point(&ls->brent);   break;
+        case fnt_line_done:     return FNT_DONE;
+    }
+
+    return FNT_CONTINUE;
+}
+
+
+static inline void fnt_line_narrow(fnt_line_t *ls) {
+    double lo = fmin(ls->s1, ls->s3), hi = fmax(ls->s1, ls->s3);
+    fnt_brent_start(&ls->brent, lo, hi, ls->eps, ls->t);
+    ls->state = fnt_line_brent;
+}
+
+
+static inline int fnt_line_value(fnt_line_t *ls, double f) {
+    double s = 0.0;
+    if( fnt_line_next(ls, &s) == FNT_DONE ) { return FNT_DONE; }
+    if( f < ls->best_f )    { ls->best_s = s;   ls->best_f = f; }
+
+    switch( ls->state ) {
+        case fnt_line_probe:
+            ls->f2 = f;
+            if( ls->f2 >= ls->f1 ) {
+                /* uphill, try the other side of 0 */
+                ls->s3 = ls->s2;    ls->f3 = ls->f2;
+                ls->s2 = ls->s1;    ls->f2 = ls->f1;
+                ls->s1 = -ls->s3;
+                ls->state = fnt_line_reverse;
+            } else {
+                ls->s3 = ls->s2 + FNT_LINE_GOLD * (ls->s2 - ls->s1);
+                ls->state = fnt_line_bracket;
+            }
+            break;
+
+        case fnt_line_reverse:
+            ls->f1 = f;
+            if( ls->f1 >= ls->f2 ) {
+                fnt_line_narrow(ls);
+            } else {
+                /* downhill towards negative steps */
+                ls->s3 = ls->s2;    ls->f3 = ls->f2;
+                ls->s2 = ls->s1;    ls->f2 = ls->f1;
+                ls->s1 = ls->s3;    ls->f1 = ls->f3;
+                ls->s3 = ls->s2 + FNT_LINE_GOLD * (ls->s2 - ls->s1);
+                ls->state = fnt_line_bracket;
+            }
+            break;
+
+        case fnt_line_bracket:
+            ls->f3 = f;
+            if( ls->f3 >= ls->f2 || ++ls->expansions >= FNT_LINE_EXPAND ) {
+                fnt_line_narrow(ls);
+            } else {
+                ls->s1 = ls->s2;    ls->f1 = ls->f2;
+                ls->s2 = ls->s3;    ls->f2 = ls->f3;
+                ls->s3 = ls->s2 + FNT_LINE_GOLD * (ls->s2 - ls->s1);
+            }
+            break;
+
+        case fnt_line_brent:
+            if( fnt_brent_value(&ls->brent, s, f) == FNT_DONE ) {
+                ls->state = fnt_line_done;
+            }
+            break;
+
+        case fnt_line_done:
+            break;
+    }
+
+    return ls->state == fnt_line_done ? FNT_DONE : FNT_CONTINUE;
+}
+
+#endif /* FNT_BRENT_H */
@@ -0,0 +1,260 @@
+/*
+ * fnt_coro.h
+ * fnt: Numerical Toolbox
+ *
+ * Copyright (c) 2024 Bryan Franklin. All rights reserved.
+ */
+#ifndef FNT_CORO_H
+#define FNT_CORO_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "fnt_util.h"
+#include "fnt_vect.h"
+
+/* Stackless coroutines for writing method logic as a straight-line loop.
+ *
+ * A method supplies a body function that queues the points it needs with
+ * fnt_coro_push, then suspends with FNT_CORO_YIELD.  The body is resumed
+ * once every queued point has a value, and can read them from values[]
+ * until it queues the next point.  The helpers below implement next,
+ * next_batch, value, value_ticket and done on top of that, so a method only
+ * forwards its entry points to them.
+ *
+ * Locals in the body do not survive a yield, keep loop counters and other
+ * state in the method's own structure.  FNT_CORO_YIELD may not be used
+ * inside a switch statement of the body.
+ *
+ *  static int my_body(void *self) {
+ *      my_t *ptr = self;
+ *      FNT_CORO_BEGIN(&ptr->co);
+ *      for(ptr->i=0; ptr->i<ptr->n; ++ptr->i) {
+ *          fnt_vect_copy(fnt_coro_push(&ptr->co), &ptr->x[ptr->i]);
+ *      }
+ *      FNT_CORO_YIELD(&ptr->co);
+ *      ... use ptr->co.values[0..n-1] ...
+ *      FNT_CORO_END(&ptr->co);
+ *  }
+ */
+
+/* MARK: Type definitions */
+
+#define FNT_CORO_FINISHED   -1
+
+typedef int (*fnt_coro_body_t)(void *self);
+
+typedef struct fnt_coro {
+    int line;           /* resume point in body, FNT_CORO_FINISHED when done */
+    fnt_coro_body_t body;
+    void *self;
+
+    /* points queued by the body, in order */
+    int capacity;
+    int count;
+    int issued;         /* handed out by next */
+    int received;       /* values received */
+    int collected;      /* body resumed since the batch completed */
+    fnt_vect_t *points;
+    double *values;
+    unsigned char *told;
+} fnt_coro_t;
+
+
+/* MARK: Body macros */
+
+#define FNT_CORO_BEGIN(co)  switch( (co)->line ) { case 0:
+
+#define FNT_CORO_YIELD(co) \
+    do { \
+        (co)->line = __LINE__; \
+        return FNT_CONTINUE; \
+        case __LINE__:; \
+    } while(0)
+
+#define FNT_CORO_END(co) \
+    } \
+    (co)->line = FNT_CORO_FINISHED; \
+    return FNT_DONE
+
+
+/* MARK: Setup */
+
+static inline int fnt_coro_init(fnt_coro_t *co, fnt_coro_body_t body, void *self, int capacity, int dimensions) {
+    if( co == NULL )        { return FNT_FAILURE; }
+    if( body == NULL )      { return FNT_FAILURE; }
+    if( capacity < 1 )      { return FNT_FAILURE; }
+
+    memset(co, '\0', sizeof(*co));
+    co->body = body;
+    co->self = self;
+    co->capacity = capacity;
+
+    co->points = (fnt_vect_t*)calloc(capacity, sizeof(fnt_vect_t));
+    co->values = (double*)calloc(capacity, sizeof(double));
+    co->told = (unsigned char*)calloc(capacity, sizeof(unsigned char));
+    if( co->points == NULL || co->values == NULL || co->told == NULL ) {
+        ERROR("calloc failed for %d queued points.\n", capacity);
+        free(co->points); free(co->values); free(co->told);
+        memset(co, '\0', sizeof(*co));
+        return FNT_FAILURE;
+    }
+    for(int i=0; i<capacity; ++i) {
+        if( fnt_vect_calloc(&co->points[i], dimensions) != FNT_VEC_SUCCESS ) {
+            for(int j=0; j<i; ++j) { fnt_vect_free(&co->points[j]); }
+            free(co->points); free(co->values); free(co->told);
+            memset(co, '\0', sizeof(*co));
+            return FNT_FAILURE;
+        }
+    }
+
+    return FNT_SUCCESS;
+}
+
+
+static inline int fnt_coro_free(fnt_coro_t *co) {
+    if( co == NULL )        { return FNT_FAILURE; }
+
+    for(int i=0; i<co->capacity; ++i) {
+        fnt_vect_free(&co->points[i]);
+    }
+    free(co->points);
+    free(co->values);
+    free(co->told);
+    memset(co, '\0', sizeof(*co));
+
+    return FNT_SUCCESS;
+}
+
+
+/* Restart the body from the beginning, dropping any queued points. */
+static inline int fnt_coro_reset(fnt_coro_t *co) {
+    if( co == NULL )        { return FNT_FAILURE; }
+
+    co->line = 0;
+    co->count = co->issued = co->received = co->collected = 0;
+    memset(co->told, '\0', co->capacity * sizeof(unsigned char));
+
+    return FNT_SUCCESS;
+}
+
+
+/* MARK: Used by the body */
+
+/* Queue a point, returning the vector to fill or NULL if the batch is full. */
+static inline fnt_vect_t *fnt_coro_push(fnt_coro_t *co) {
+    if( co->collected ) {
+        /* values of the previous batch are no longer needed */
+        co->count = co->issued = co->received = co->collected = 0;
+        memset(co->told, '\0', co->capacity * sizeof(unsigned char));
+    }
+    if( co->count >= co->capacity ) {
+        ERROR("ERROR: Coroutine batch is full (%d points).\n", co->capacity);
+        return NULL;
+    }
+
+    return &co->points[co->count++];
+}
+
+
+/* MARK: Used by method entry points */
+
+/* Run the body until it queues points or finishes. */
+static inline int fnt_coro_resume(fnt_coro_t *co) {
+    while( co->line != FNT_CORO_FINISHED && co->received == co->count ) {
+        if( co->count > 0 ) { co->collected = 1; }
+
+        int ret = co->body(co->self);
+        if( ret == FNT_FAILURE ) {
+            ERROR("ERROR: Coroutine body failed.\n");
+            return FNT_FAILURE;
+        }
+        if( ret == FNT_DONE )   { co->line = FNT_CORO_FINISHED; }
+
+        /* a body that yields without queueing anything is resumed at once */
+        if( co->collected ) { co->count = co->issued = co->received = 0; }
+    }
+
+    return FNT_SUCCESS;
+}
+
+
+static inline int fnt_coro_next(fnt_coro_t *co, fnt_vect_t *vec) {
+    if( fnt_coro_resume(co) != FNT_SUCCESS )    { return FNT_FAILURE; }
+
+    if( co->issued >= co->count ) {
+        ERROR("ERROR: No points left to hand out, values are still outstanding.\n");
+        return FNT_FAILURE;
+    }
+
+    return fnt_vect_copy(vec, &co->points[co->issued++]);
+}
+
+
+/* Hand out every queued point not yet handed out, up to capacity.  count is
+ * zero while all queued points are awaiting values. */
+static inline int fnt_coro_next_batch(fnt_coro_t *co, fnt_vect_t *vecs, int *tickets, int capacity, int *count) {
+    if( fnt_coro_resume(co) != FNT_SUCCESS )    { return FNT_FAILURE; }
+
+    int n = 0;
+    while( n < capacity && co->issued < co->count ) {
+        if( fnt_vect_copy(&vecs[n], &co->points[co->issued]) != FNT_VEC_SUCCESS ) {
+            return FNT_FAILURE;
+        }
+        tickets[n++] = co->issued++;
+    }
+    *count = n;
+
+    return FNT_SUCCESS;
+}
+
+
+/* Record the value of a handed out point, resuming the body when the batch
+ * is complete.  Tickets are only valid until then. */
+static inline int fnt_coro_value_ticket(fnt_coro_t *co, int ticket, double value) {
+    if( ticket < 0 || ticket >= co->issued || co->told[ticket] ) {
+        ERROR("ERROR: Ticket %d is not outstanding.\n", ticket);
+        return FNT_FAILURE;
+    }
+
+    co->values[ticket] = value;
+    co->told[ticket] = 1;
+    ++co->received;
+
+    return fnt_coro_resume(co);
+}
+
+
+/* Record a value for the oldest outstanding point. */
+static inline int fnt_coro_value(fnt_coro_t *co, double value) {
+    for(int i=0; i<co->issued; ++i) {
+        if( !co->told[i] ) {
+            return fnt_coro_value_ticket(co, i, value);
+        }
+    }
+
+    ERROR("ERROR: Value received, but no points are outstanding.\n");
+
+    return FNT_FAILURE;
+}
+
+
+/* Find the oldest outstanding point equal to vec, for values that arrive
+ * without a ticket.  Returns its ticket, or -1 if there is none. */
+static inline int fnt_coro_find(fnt_coro_t *co, fnt_vect_t *vec) {
+    for(int i=0; i<co->issued; ++i) {
+        if( co->told[i] || co->points[i].n != vec->n )  { continue; }
+        if( memcmp(co->points[i].v, vec->v, vec->n * sizeof(double)) == 0 ) {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+
+static inline int fnt_coro_done(fnt_coro_t *co) {
+    return co->line == FNT_CORO_FINISHED ? FNT_DONE : FNT_CONTINUE;
+}
+
+#endif /* FNT_CORO_H */
@@ -0,0 +1,98 @@
+/*
+ * fnt_method.h
+ * fnt: Numerical Toolbox
+ *
+ * Copyright (c) 2024 Bryan Franklin. All rights reserved.
+ */
+#ifndef FNT_METHOD_H
+#define FNT_METHOD_H
+
+#include "fnt_vect.h"
+
+/* MARK: Plugin ABI constants */
+
+/* Bumped whenever the layout of fnt_method_descriptor_t changes. */
+#define FNT_METHOD_ABI_VERSION      7
+
+/* Name of the single symbol every method plugin must export. */
+#define FNT_METHOD_DESCRIPTOR_SYMBOL    "fnt_method_descriptor"
+
+/* Capability flags advertised by a method. */
+#define FNT_METHOD_CAP_NONE         0x0
+#define FNT_METHOD_CAP_BATCH        0x1     /* hands out several inputs at once */
+#define FNT_METHOD_CAP_GRADIENT     0x2     /* makes use of gradients */
+#define FNT_METHOD_CAP_CHECKPOINT   0x4     /* state can be saved and restored */
+#define FNT_METHOD_CAP_THREAD_SAFE  0x8     /* entry points may be called concurrently */
+#define FNT_METHOD_CAP_RESIDUAL     0x10    /* solves systems from residual vectors */
+
+
+/* MARK: Callback types */
+
+/** \brief Objective function evaluated by fnt_minimize.
+ * \param x Input vector, owned by the method and only valid during the call.
+ * \param user Pointer passed through from fnt_minimize.
+ * \return Value of the objective function at x.
+ */
+typedef double (*fnt_objective_t)(fnt_vect_t *x, void *user);
+
+
+/* MARK: Plugin descriptor */
+
+/** \brief Table of entry points exported by a method plugin.
+ * Required entries are name, init, free, next, value and done, all others
+ * may be NULL.
+ *
+ * next_view lends the caller a pointer to the method's own buffer instead of
+ * filling a caller supplied vector.  When that same pointer is later passed
+ * to value, the method may keep the buffer without copying it.
+ *
+ * reset returns the method to the state init left it in, but keeps
+ * hyper-parameters and allocated buffers so the context can be reused.
+ *
+ * sample reports the which-th point the method currently holds (simplex
+ * vertex, population member, ...) with its value, failing once which is out
+ * of range.  warm_start seeds a freshly initialized or reset method with
+ * points ordered by increasing value; their values are taken as known and
+ * are not requested again.  values may be NULL, in which case only the
+ * location of the points is used.
+ *
+ * minimize runs the method to completion, calling objective for every input
+ * it needs.  It must request the same inputs, in the same order, as the
+ * next/value loop would, and returns FNT_DONE once done reports it.
+ *
+ * next_batch hands out every input that can be evaluated independently, up
+ * to capacity, each with a ticket.  value_ticket reports the value for a
+ * ticket, in any order.  Methods providing them set FNT_METHOD_CAP_BATCH,
+ * fnt_coro.h implements both for methods written as coroutines.
+ *
+ * value_residual reports the residual vector of a system of equations at
+ * vec, with its Jacobian stored row-major (element i*n+j is the derivative
+ * of residual i with respect to x_j) or NULL if not available.  Methods
+ * providing it set FNT_METHOD_CAP_RESIDUAL.
+ */
+typedef struct fnt_method_descriptor {
+    int abi_version;
+    unsigned int capabilities;
+
+    int (*name)(char *name, int size);
+    int (*init)(void **handle, int dimensions);
+    int (*free)(void **handle);
+    int (*reset)(void *handle);
+    int (*info)();
+    int (*hparam_set)(void *handle, char *id, void *value_ptr);
+    int (*hparam_get)(void *handle, char *id, void *value_ptr);
+    int (*next)(void *handle, fnt_vect_t *vec);
+    int (*next_view)(void *handle, fnt_vect_t **vec);
+    int (*next_batch)(void *handle, fnt_vect_t *vecs, int *tickets, int capacity, int *count);
+    int (*value)(void *handle, fnt_vect_t *vec, double value);
+    int (*value_ticket)(void *handle, int ticket, double value);
+    int (*value_gradient)(void *handle, fnt_vect_t *vec, double value, fnt_vect_t *gradient);
+    int (*value_residual)(void *handle, fnt_vect_t *vec, fnt_vect_t *residual, fnt_vect_t *jacobian);
+    int (*sample)(void *handle, int which, fnt_vect_t *point, double *value);
+    int (*warm_start)(void *handle, fnt_vect_t *points, double *values, int count);
+    int (*minimize)(void *handle, fnt_objective_t objective, void *user);
+    int (*done)(void *handle);
+    int (*result)(void *handle, char *id, void *value_ptr);
+} fnt_method_descriptor_t;
+
+#endif /* FNT_METHOD_H */
@@ -0,0 +1,479 @@
+/*
+ * fnt_procs.c
+ * fnt: Numerical Toolbox
+ *
+ * Copyright (c) 2024 Bryan Franklin. All rights reserved.
+ */
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <sys/eventfd.h>
+#endif /* __linux__ */
+
+#include "fnt.h"
+#include "fnt_util.h"
+#include "fnt_vect.h"
+
+#ifndef MAP_ANONYMOUS
+#define MAP_ANONYMOUS MAP_ANON
+#endif /* MAP_ANONYMOUS */
+
+/* MARK: Internal constants */
+
+#define FNT_PROCS_SLOTS     4       /* ring slots per worker */
+#define FNT_PROCS_POLL_MS   50      /* how often to look for dead workers */
+#define FNT_PROCS_RETRIES   3       /* crashes allowed per input */
+
+/* slot states, a state >= 0 is the index of the worker evaluating it */
+#define FNT_SLOT_FREE       -3
+#define FNT_SLOT_QUEUED     -2
+#define FNT_SLOT_DONE       -1
+
+/* MARK: Internal structures */
+
+typedef struct fnt_procs_slot {
+    int state;
+    int ticket;             /* method ticket of the input */
+    int attempts;           /* workers that died evaluating it */
+    double value;
+} fnt_procs_slot_t;
+
+
+/* Lives in memory shared with every worker, inputs follow the slots. */
+typedef struct fnt_procs_shared {
+    int shutdown;
+    fnt_procs_slot_t slots[];
+} fnt_procs_shared_t;
+
+
+typedef struct fnt_procs {
+    int workers;
+    int capacity;
+    int dimensions;
+    fnt_objective_t objective;
+    void *user;
+    pid_t *pids;
+    int restarts;
+
+    fnt_procs_shared_t *shared;
+    size_t shared_size;
+    double *inputs;
+
+    /* eventfd, or a pipe where eventfd is unavailable; [0] is read from */
+    int work_fd[2];         /* one token per queued input */
+    int done_fd[2];         /* posted by workers as values arrive */
+} fnt_procs_t;
+
+
+/* MARK: Signalling */
+
+static int fnt_procs_signal_open(int fds[2], int semaphore) {
+#ifdef __linux__
+    int fd = eventfd(0, semaphore ? EFD_SEMAPHORE : 0);
+    if( fd < 0 )            { return FNT_FAILURE; }
+    fds[0] = fds[1] = fd;
+#else
+    (void)semaphore;
+    if( pipe(fds) != 0 )    { return FNT_FAILURE; }
+#endif /* __linux__ */
+
+    return FNT_SUCCESS;
+}
+
+
+static void fnt_procs_signal_close(int fds[2]) {
+    if( fds[0] >= 0 )                       { close(fds[0]); }
+    if( fds[1] >= 0 && fds[1] != fds[0] )   { close(fds[1]); }
+    fds[0] = fds[1] = -1;
+}
+
+
+static void fnt_procs_post(int fds[2], int count) {
+#ifdef __linux__
+    uint64_t n = (uint64_t)count;
+    while( write(fds[1], &n, sizeof(n)) < 0 && errno == EINTR ) { }
+#else
+    char bytes[64];
+    memset(bytes, '\0', sizeof(bytes));
+    while( count > 0 ) {
+        int chunk = count < (int)sizeof(bytes) ? count : (int)sizeof(bytes);
+        ssize_t written = write(fds[1], bytes, chunk);
+        if( written < 0 && errno == EINTR ) { continue; }
+        if( written <= 0 )                  { break; }
+        count -= (int)written;
+    }
+#endif /* __linux__ */
+}
+
+
+/* Block until one token can be taken. */
+static int fnt_procs_take(int fds[2]) {
+    ssize_t got = 0;
+#ifdef __linux__
+    uint64_t n = 0;
+    while( (got = read(fds[0], &n, sizeof(n))) < 0 && errno == EINTR ) { }
+#else
+    char byte = 0;
+    while( (got = read(fds[0], &byte, 1)) < 0 && errno == EINTR ) { }
+#endif /* __linux__ */
+
+    return got > 0 ? FNT_SUCCESS : FNT_FAILURE;
+}
+
+
+/* Take every token posted so far without blocking. */
+static void fnt_procs_drain(int fds[2]) {
+    char buf[64];
+    while( read(fds[0], buf, sizeof(buf)) > 0 ) { }
+}
+
+
+/* MARK: Workers */
+
+static void fnt_procs_worker(fnt_procs_t *p, int index) {
+    fnt_procs_slot_t *slots = p->shared->slots;
+    fnt_vect_t x;
+    x.n = p->dimensions;
+
+    while( fnt_procs_take(p->work_fd) == FNT_SUCCESS ) {
+        if( __atomic_load_n(&p->shared->shutdown, __ATOMIC_ACQUIRE) ) {
+            break;
+        }
+
+        /* a spare token may find nothing queued, then just wait again */
+        for(int i=0; i<p->capacity; ++i) {
+            int expected = FNT_SLOT_QUEUED;
+            if( !__atomic_compare_exchange_n(&slots[i].state, &expected, index,
+                    0, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED) ) {
+                continue;
+            }
+
+            x.v = &p->inputs[i * p->dimensions];
+            slots[i].value = p->objective(&x, p->user);
+            __atomic_store_n(&slots[i].state, FNT_SLOT_DONE, __ATOMIC_RELEASE);
+            fnt_procs_post(p->done_fd, 1);
+            break;
+        }
+    }
+
+    /* skip atexit handlers and stdio buffers inherited from the parent */
+    _exit(0);
+}
+
+
+static int fnt_procs_spawn(fnt_procs_t *p, int index) {
+    /* anything buffered would otherwise be written by the child too */
+    fflush(NULL);
+
+    pid_t pid = fork();
+    if( pid < 0 ) {
+        ERROR("ERROR: Failed to fork worker %d.\n", index);
+        return FNT_FAILURE;
+    }
+    if( pid == 0 ) {
+        fnt_procs_worker(p, index);
+    }
+    p->pids[index] = pid;
+
+    return FNT_SUCCESS;
+}
+
+
+/* Restart workers that have died, queueing the inputs they held again. */
+static int fnt_procs_reap(fnt_procs_t *p) {
+    fnt_procs_slot_t *slots = p->shared->slots;
+    int ret = FNT_SUCCESS;
+
+    for(int i=0; i<p->workers; ++i) {
+        int status = 0;
+        if( p->pids[i] <= 0 || waitpid(p->pids[i], &status, WNOHANG) != p->pids[i] ) {
+            continue;
+        }
+        WARN("WARN: Worker %d (pid %d) died, restarting it.\n", i, (int)p->pids[i]);
+        p->pids[i] = 0;
+
+        int requeued = 0;
+        for(int j=0; j<p->capacity; ++j) {
+            int expected = i;
+            if( !__atomic_compare_exchange_n(&slots[j].state, &expected, FNT_SLOT_QUEUED,
+                    0, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED) ) {
+                continue;
+            }
+            if( ++slots[j].attempts >= FNT_PROCS_RETRIES ) {
+                ERROR("ERROR: Input for ticket %d crashed %d workers, giving up.\n",
+                        slots[j].ticket, slots[j].attempts);
+                ret = FNT_FAILURE;
+            }
+            ++requeued;
+        }
+
+        if( fnt_procs_spawn(p, i) != FNT_SUCCESS ) {
+            return FNT_FAILURE;
+        }
+        ++p->restarts;
+
+        /* one extra covers a token taken just before the worker died */
+        fnt_procs_post(p->work_fd, requeued + 1);
+    }
+
+    return ret;
+}
+
+
+/* Wait for a value to arrive, or for a worker to die. */
+static int fnt_procs_wait(fnt_procs_t *p) {
+    struct pollfd pfd;
+    pfd.fd = p->done_fd[0];
+    pfd.events = POLLIN;
+    pfd.revents = 0;
+
+    if( poll(&pfd, 1, FNT_PROCS_POLL_MS) > 0 ) {
+        fnt_procs_drain(p->done_fd);
+    }
+
+    return fnt_procs_reap(p);
+}
+
+
+/* Drop queued inputs and wait out those being evaluated, leaving every
+ * slot free for the next run. */
+static void fnt_procs_settle(fnt_procs_t *p) {
+    fnt_procs_slot_t *slots = p->shared->slots;
+
+    for(;;) {
+        int busy = 0;
+        for(int i=0; i<p->capacity; ++i) {
+            int state = __atomic_load_n(&slots[i].state, __ATOMIC_ACQUIRE);
+            if( state == FNT_SLOT_QUEUED || state == FNT_SLOT_DONE ) {
+                __atomic_compare_exchange_n(&slots[i].state, &state, FNT_SLOT_FREE,
+                        0, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED);
+            }
+            if( __atomic_load_n(&slots[i].state, __ATOMIC_ACQUIRE) != FNT_SLOT_FREE ) {
+                ++busy;
+            }
+        }
+        if( busy == 0 ) { break; }
+        fnt_procs_wait(p);
+    }
+}
+
+
+/* MARK: User callable functions */
+
+int fnt_procs_init(void **procs, int workers, int dimensions, fnt_objective_t objective, void *user) {
+    if( procs == NULL )     { return FNT_FAILURE; }
+    if( objective == NULL ) { return FNT_FAILURE; }
+    if( dimensions < 1 )    { return FNT_FAILURE; }
+
+    if( workers < 1 ) {
+        workers = (int)sysconf(_SC_NPROCESSORS_ONLN);
+        if( workers < 1 )   { workers = 1; }
+    }
+
+    fnt_procs_t *p = calloc(1, sizeof(fnt_procs_t));
+    if( p == NULL )         { return FNT_FAILURE; }
+    p->workers = workers;
+    p->capacity = workers * FNT_PROCS_SLOTS;
+    p->dimensions = dimensions;
+    p->objective = objective;
+    p->user = user;
+    p->work_fd[0] = p->work_fd[1] = -1;
+    p->done_fd[0] = p->done_fd[1] = -1;
+    *procs = p;
+
+    p->pids = calloc(workers, sizeof(pid_t));
+    if( p->pids == NULL ) {
+        fnt_procs_free(procs);
+        return FNT_FAILURE;
+    }
+
+    /* shared before forking, so every worker maps the same pages */
+    p->shared_size = sizeof(fnt_procs_shared_t)
+                   + p->capacity * sizeof(fnt_procs_slot_t)
+                   + (size_t)p->capacity * dimensions * sizeof(double);
+    void *shared = mmap(NULL, p->shared_size, PROT_READ | PROT_WRITE,
+                        MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if( shared == MAP_FAILED ) {
+        ERROR("ERROR: Failed to map %lu bytes of shared memory.\n", (unsigned long)p->shared_size);
+        fnt_procs_free(procs);
+        return FNT_FAILURE;
+    }
+    p->shared = (fnt_procs_shared_t*)shared;
+    p->inputs = (double*)&p->shared->slots[p->capacity];
+    for(int i=0; i<p->capacity; ++i) {
+        p->shared->slots[i].state = FNT_SLOT_FREE;
+    }
+
+    if( fnt_procs_signal_open(p->work_fd, 1) != FNT_SUCCESS
+        || fnt_procs_signal_open(p->done_fd, 0) != FNT_SUCCESS ) {
+        ERROR("ERROR: Failed to create worker signals.\n");
+        fnt_procs_free(procs);
+        return FNT_FAILURE;
+    }
+    /* only the parent reads values, and never blocks doing so */
+    fcntl(p->done_fd[0], F_SETFL, fcntl(p->done_fd[0], F_GETFL) | O_NONBLOCK);
+
+    for(int i=0; i<workers; ++i) {
+        if( fnt_procs_spawn(p, i) != FNT_SUCCESS ) {
+            fnt_procs_free(procs);
+            return FNT_FAILURE;
+        }
+    }
+    INFO("Started %d worker processes.\n", workers);
+
+    return FNT_SUCCESS;
+}
+
+
+int fnt_procs_free(void **procs) {
+    if( procs == NULL )     { return FNT_FAILURE; }
+    fnt_procs_t *p = (fnt_procs_t*)*procs;
+    if( p == NULL )         { return FNT_FAILURE; }
+
+    if( p->shared != NULL && p->pids != NULL ) {
+        __atomic_store_n(&p->shared->shutdown, 1, __ATOMIC_RELEASE);
+        fnt_procs_post(p->work_fd, p->workers);
+        for(int i=0; i<p->workers; ++i) {
+            if( p->pids[i] > 0 ) {
+                while( waitpid(p->pids[i], NULL, 0) < 0 && errno == EINTR ) { }
+            }
+        }
+    }
+
+    fnt_procs_signal_close(p->work_fd);
+    fnt_procs_signal_close(p->done_fd);
+    if( p->shared != NULL ) {
+        munmap(p->shared, p->shared_size);
+    }
+    free(p->pids);
+
+    free(p); *procs = NULL;
+
+    return FNT_SUCCESS;
+}
+
+
+int fnt_procs_restarts(void *procs, int *restarts) {
+    fnt_procs_t *p = (fnt_procs_t*)procs;
+    if( p == NULL )         { return FNT_FAILURE; }
+    if( restarts == NULL )  { return FNT_FAILURE; }
+
+    *restarts = p->restarts;
+
+    return FNT_SUCCESS;
+}
+
+
+int fnt_procs_minimize(void *procs, void *context) {
+    fnt_procs_t *p = (fnt_procs_t*)procs;
+    if( p == NULL )         { return FNT_FAILURE; }
+    if( context == NULL )   { return FNT_FAILURE; }
+
+    unsigned int capabilities = FNT_METHOD_CAP_NONE;
+    int dimensions = 0;
+    if( fnt_capabilities(context, &capabilities) != FNT_SUCCESS
+        || fnt_dimensions(context, &dimensions) != FNT_SUCCESS ) {
+        return FNT_FAILURE;
+    }
+    if( dimensions != p->dimensions ) {
+        ERROR("ERROR: Method has %d dimensions, workers were started for %d.\n",
+                dimensions, p->dimensions);
+        return FNT_FAILURE;
+    }
+    /* methods without batches only ever have one input outstanding */
+    int batch = (capabilities & FNT_METHOD_CAP_BATCH) != 0;
+
+    fnt_vect_t *vecs = calloc(p->capacity, sizeof(fnt_vect_t));
+    int *tickets = calloc(p->capacity, sizeof(int));
+    int *batch_slots = calloc(p->capacity, sizeof(int));
+    if( vecs == NULL || tickets == NULL || batch_slots == NULL ) {
+        free(vecs); free(tickets); free(batch_slots);
+        return FNT_FAILURE;
+    }
+
+    fnt_procs_slot_t *slots = p->shared->slots;
+    int outstanding = 0;
+    int ret = FNT_SUCCESS;
+    for(;;) {
+        int status = fnt_done(context);
+        if( status == FNT_FAILURE )                     { ret = FNT_FAILURE; break; }
+        if( status == FNT_DONE && outstanding == 0 )    { break; }
+
+        /* hand the method free slots to fill, the vectors alias shared memory */
+        if( status == FNT_CONTINUE && (batch || outstanding == 0) ) {
+            int n = 0;
+            for(int i=0; i<p->capacity && (batch || n == 0); ++i) {
+                if( __atomic_load_n(&slots[i].state, __ATOMIC_ACQUIRE) != FNT_SLOT_FREE ) {
+                    continue;
+                }
+                batch_slots[n] = i;
+                vecs[n].v = &p->inputs[i * p->dimensions];
+                vecs[n].n = p->dimensions;
+                ++n;
+            }
+
+            int count = 0;
+            if( n > 0 && fnt_next_batch(context, vecs, tickets, n, &count) != FNT_SUCCESS ) {
+                /* handing out inputs can itself finish the method */
+                if( fnt_done(context) == FNT_DONE ) { continue; }
+                ret = FNT_FAILURE;
+                break;
+            }
+            for(int k=0; k<count; ++k) {
+                fnt_procs_slot_t *slot = &slots[batch_slots[k]];
+                slot->ticket = tickets[k];
+                slot->attempts = 0;
+                __atomic_store_n(&slot->state, FNT_SLOT_QUEUED, __ATOMIC_RELEASE);
+            }
+            if( count > 0 ) {
+                fnt_procs_post(p->work_fd, count);
+                outstanding += count;
+            }
+            if( outstanding == 0 ) {
+                if( fnt_done(context) == FNT_DONE ) { continue; }
+                ERROR("ERROR: Method handed out no inputs.\n");
+                ret = FNT_FAILURE;
+                break;
+            }
+        }
+
+        if( fnt_procs_wait(p) != FNT_SUCCESS ) {
+            ret = FNT_FAILURE;
+            break;
+        }
+
+        /* pass on every value that has arrived */
+        for(int i=0; i<p->capacity && ret == FNT_SUCCESS; ++i) {
+            if( __atomic_load_n(&slots[i].state, __ATOMIC_ACQUIRE) != FNT_SLOT_DONE ) {
+                continue;
+            }
+            fnt_vect_t x;
+            x.v = &p->inputs[i * p->dimensions];
+            x.n = p->dimensions;
+            if( status == FNT_CONTINUE
+                && fnt_set_value_ticket(context, slots[i].ticket, &x, slots[i].value) != FNT_SUCCESS ) {
+                ret = FNT_FAILURE;
+            }
+            __atomic_store_n(&slots[i].state, FNT_SLOT_FREE, __ATOMIC_RELEASE);
+            --outstanding;
+        }
+        if( ret != FNT_SUCCESS )    { break; }
+    }
+
+    fnt_procs_settle(p);
+    free(vecs);
+    free(tickets);
+    free(batch_slots);
+
+    return ret;
+}
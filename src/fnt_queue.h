@@ -0,0 +1,139 @@
+/*
+ * fnt_queue.h
+ * fnt: Numerical Toolbox
+ *
+ * Copyright (c) 2024 Bryan Franklin. All rights reserved.
+ */
+#ifndef FNT_QUEUE_H
+#define FNT_QUEUE_H
+
+#include <stdint.h>
+#include <stdlib.h>
+#include "fnt_util.h"
+
+/* Bounded lock-free queue of (ticket, value) records.
+ *
+ * This is Dmitry Vyukov's bounded MPMC queue: every cell carries a sequence
+ * number, so producers and consumers each claim a position with a single
+ * compare-and-swap and never wait on one another.  It serves both as the
+ * multi-producer queue results are pushed onto, and as the multi-consumer
+ * queue pending inputs are pulled from.
+ *
+ * Atomics use the __atomic builtins of GCC and Clang, keeping the tree C99.
+ */
+
+#define FNT_QUEUE_CACHE_LINE    64
+
+/* MARK: Type definitions */
+
+typedef struct fnt_queue_cell {
+    size_t sequence;
+    int ticket;
+    double value;
+} fnt_queue_cell_t;
+
+typedef struct fnt_queue {
+    fnt_queue_cell_t *cells;
+    size_t mask;
+    char pad0[FNT_QUEUE_CACHE_LINE];
+    size_t enqueue_pos;
+    char pad1[FNT_QUEUE_CACHE_LINE];
+    size_t dequeue_pos;
+    char pad2[FNT_QUEUE_CACHE_LINE];
+} fnt_queue_t;
+
+
+/* MARK: Setup */
+
+/* capacity is rounded up to a power of two */
+static inline int fnt_queue_init(fnt_queue_t *q, size_t capacity) {
+    if( q == NULL )     { return FNT_FAILURE; }
+
+    size_t size = 2;
+    while( size < capacity )    { size <<= 1; }
+
+    q->cells = (fnt_queue_cell_t*)calloc(size, sizeof(fnt_queue_cell_t));
+    if( q->cells == NULL )      { return FNT_FAILURE; }
+    for(size_t i=0; i<size; ++i) {
+        __atomic_store_n(&q->cells[i].sequence, i, __ATOMIC_RELAXED);
+    }
+    q->mask = size - 1;
+    __atomic_store_n(&q->enqueue_pos, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&q->dequeue_pos, 0, __ATOMIC_RELAXED);
+
+    return FNT_SUCCESS;
+}
+
+
+static inline int fnt_queue_free(fnt_queue_t *q) {
+    if( q == NULL )     { return FNT_FAILURE; }
+
+    free(q->cells); q->cells = NULL;
+
+    return FNT_SUCCESS;
+}
+
+
+/* MARK: Operations */
+
+/* \return FNT_SUCCESS, or FNT_CONTINUE when the queue is full. */
+static inline int fnt_queue_push(fnt_queue_t *q, int ticket, double value) {
+    fnt_queue_cell_t *cell;
+    size_t pos = __atomic_load_n(&q->enqueue_pos, __ATOMIC_RELAXED);
+
+    for(;;) {
+        cell = &q->cells[pos & q->mask];
+        size_t seq = __atomic_load_n(&cell->sequence, __ATOMIC_ACQUIRE);
+        intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+
+        if( diff == 0 ) {
+            if( __atomic_compare_exchange_n(&q->enqueue_pos, &pos, pos + 1,
+                    1, __ATOMIC_RELAXED, __ATOMIC_RELAXED) ) {
+                break;
+            }
+            /* pos was reloaded by the failed exchange */
+        } else if( diff < 0 ) {
+            return FNT_CONTINUE;
+        } else {
+            pos = __atomic_load_n(&q->enqueue_pos, __ATOMIC_RELAXED);
+        }
+    }
+
+    cell->ticket = ticket;
+    cell->value = value;
+    __atomic_store_n(&cell->sequence, pos + 1, __ATOMIC_RELEASE);
+
+    return FNT_SUCCESS;
+}
+
+
+/* \return FNT_SUCCESS, or FNT_CONTINUE when the queue is empty. */
+static inline int fnt_queue_pop(fnt_queue_t *q, int *ticket, double *value) {
+    fnt_queue_cell_t *cell;
+    size_t pos = __atomic_load_n(&q->dequeue_pos, __ATOMIC_RELAXED);
+
+    for(;;) {
+        cell = &q->cells[pos & q->mask];
+        size_t seq = __atomic_load_n(&cell->sequence, __ATOMIC_ACQUIRE);
+        intptr_t diff = (intptr_t)seq - (intptr_t)(pos + 1);
+
+        if( diff == 0 ) {
+            if( __atomic_compare_exchange_n(&q->dequeue_pos, &pos, pos + 1,
+                    1, __ATOMIC_RELAXED, __ATOMIC_RELAXED) ) {
+                break;
+            }
+        } else if( diff < 0 ) {
+            return FNT_CONTINUE;
+        } else {
+            pos = __atomic_load_n(&q->dequeue_pos, __ATOMIC_RELAXED);
+        }
+    }
+
+    if( ticket )    { *ticket = cell->ticket; }
+    if( value )     { *value = cell->value; }
+    __atomic_store_n(&cell->sequence, pos + q->mask + 1, __ATOMIC_RELEASE);
+
+    return FNT_SUCCESS;
+}
+
+#endif /* FNT_QUEUE_H */
@@ -0,0 +1,506 @@
+/*
+ * fnt_sched.c
+ * fnt: Numerical Toolbox
+ *
+ * Copyright (c) 2024 Bryan Franklin. All rights reserved.
+ */
+#include <pthread.h>
+#include <sched.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "fnt.h"
+#include "fnt_util.h"
+#include "fnt_vect.h"
+
+/* MARK: Internal constants */
+
+#define FNT_SCHED_DEQUE_SIZE    4096    /* tasks per worker, power of two */
+#define FNT_SCHED_BATCH         64      /* inputs requested per batch */
+#define FNT_SCHED_SPIN          64      /* failed steal rounds before parking */
+#define FNT_SCHED_CACHE_LINE    64
+
+/* MARK: Internal structures */
+
+typedef struct fnt_task {
+    fnt_task_fn_t fn;
+    void *arg;
+    int *group;
+    struct fnt_task *next;  /* injection list only */
+} fnt_task_t;
+
+
+/* Chase-Lev deque, see Le et al., "Correct and Efficient Work-Stealing for
+ * Weak Memory Models", PPoPP 2013.  Only the owner pushes and pops at
+ * bottom, any worker steals from top. */
+typedef struct fnt_deque {
+    int64_t top;
+    char pad0[FNT_SCHED_CACHE_LINE];
+    int64_t bottom;
+    char pad1[FNT_SCHED_CACHE_LINE];
+    fnt_task_t *tasks[FNT_SCHED_DEQUE_SIZE];
+} fnt_deque_t;
+
+
+typedef struct fnt_worker {
+    struct fnt_sched *sched;
+    int index;
+    pthread_t thread;
+    uint32_t rng;           /* picks steal victims */
+    fnt_deque_t deque;
+} fnt_worker_t;
+
+
+typedef struct fnt_sched {
+    int count;
+    int started;
+    fnt_worker_t *workers;
+
+    /* tasks spawned from threads outside the pool */
+    pthread_mutex_t inject_lock;
+    fnt_task_t *inject_head;
+    int inject_count;
+
+    /* idle threads park on wake, which is broadcast whenever epoch moves */
+    pthread_mutex_t park_lock;
+    pthread_cond_t wake;
+    unsigned epoch;
+    int sleepers;
+
+    int shutdown;
+} fnt_sched_t;
+
+
+/* worker the calling thread belongs to, NULL outside the pool */
+static __thread fnt_worker_t *fnt_sched_self = NULL;
+
+
+/* MARK: Deque operations */
+
+static int fnt_deque_push(fnt_deque_t *d, fnt_task_t *task) {
+    int64_t b = __atomic_load_n(&d->bottom, __ATOMIC_RELAXED);
+    int64_t t = __atomic_load_n(&d->top, __ATOMIC_ACQUIRE);
+    if( b - t >= FNT_SCHED_DEQUE_SIZE ) {
+        return FNT_FAILURE;
+    }
+
+    __atomic_store_n(&d->tasks[b & (FNT_SCHED_DEQUE_SIZE-1)], task, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    __atomic_store_n(&d->bottom, b + 1, __ATOMIC_RELAXED);
+
+    return FNT_SUCCESS;
+}
+
+
+static fnt_task_t *fnt_deque_pop(fnt_deque_t *d) {
+    int64_t b = __atomic_load_n(&d->bottom, __ATOMIC_RELAXED) - 1;
+    __atomic_store_n(&d->bottom, b, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    int64_t t = __atomic_load_n(&d->top, __ATOMIC_RELAXED);
+
+    if( t > b ) {
+        /* empty */
+        __atomic_store_n(&d->bottom, b + 1, __ATOMIC_RELAXED);
+        return NULL;
+    }
+
+    fnt_task_t *task = __atomic_load_n(&d->tasks[b & (FNT_SCHED_DEQUE_SIZE-1)], __ATOMIC_RELAXED);
+    if( t == b ) {
+        /* last task, race any thieves for it */
+        if( !__atomic_compare_exchange_n(&d->top, &t, t + 1, 0,
+                __ATOMIC_SEQ_CST, __ATOMIC_RELAXED) ) {
+            task = NULL;
+        }
+        __atomic_store_n(&d->bottom, b + 1, __ATOMIC_RELAXED);
+    }
+
+    return task;
+}
+
+
+static fnt_task_t *fnt_deque_steal(fnt_deque_t *d) {
+    int64_t t = __atomic_load_n(&d->top, __ATOMIC_ACQUIRE);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    int64_t b = __atomic_load_n(&d->bottom, __ATOMIC_ACQUIRE);
+
+    if( t >= b )    { return NULL; }
+
+    fnt_task_t *task = __atomic_load_n(&d->tasks[t & (FNT_SCHED_DEQUE_SIZE-1)], __ATOMIC_RELAXED);
+    if( !__atomic_compare_exchange_n(&d->top, &t, t + 1, 0,
+            __ATOMIC_SEQ_CST, __ATOMIC_RELAXED) ) {
+        /* lost the race */
+        return NULL;
+    }
+
+    return task;
+}
+
+
+/* MARK: Internal functions */
+
+/* Wake parked threads, after new work or a finished group is published. */
+static void fnt_sched_notify(fnt_sched_t *s) {
+    /* pairs with the fence in fnt_sched_park, so either the parking thread
+     * sees the work or this sees it sleeping */
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    if( __atomic_load_n(&s->sleepers, __ATOMIC_RELAXED) == 0 ) {
+        return;
+    }
+
+    pthread_mutex_lock(&s->park_lock);
+    ++s->epoch;
+    pthread_cond_broadcast(&s->wake);
+    pthread_mutex_unlock(&s->park_lock);
+}
+
+
+static void fnt_sched_run(fnt_sched_t *s, fnt_task_t *task) {
+    int *group = task->group;
+
+    task->fn(task->arg);
+    free(task);
+
+    if( __atomic_sub_fetch(group, 1, __ATOMIC_RELEASE) == 0 ) {
+        fnt_sched_notify(s);
+    }
+}
+
+
+static fnt_task_t *fnt_sched_inject_pop(fnt_sched_t *s) {
+    if( __atomic_load_n(&s->inject_count, __ATOMIC_ACQUIRE) == 0 ) {
+        return NULL;
+    }
+
+    pthread_mutex_lock(&s->inject_lock);
+    fnt_task_t *task = s->inject_head;
+    if( task != NULL ) {
+        s->inject_head = task->next;
+        __atomic_sub_fetch(&s->inject_count, 1, __ATOMIC_RELEASE);
+    }
+    pthread_mutex_unlock(&s->inject_lock);
+
+    return task;
+}
+
+
+/* Find a task: own deque first, then injected tasks, then steal. */
+static fnt_task_t *fnt_sched_find(fnt_sched_t *s, fnt_worker_t *self) {
+    fnt_task_t *task = NULL;
+
+    if( self != NULL && (task = fnt_deque_pop(&self->deque)) != NULL ) {
+        return task;
+    }
+    if( (task = fnt_sched_inject_pop(s)) != NULL ) {
+        return task;
+    }
+
+    /* xorshift picks where to start looking */
+    int start = 0;
+    if( self != NULL ) {
+        uint32_t x = self->rng;
+        x ^= x << 13;   x ^= x >> 17;   x ^= x << 5;
+        self->rng = x;
+        start = x % s->count;
+    }
+    for(int i=0; i<s->count; ++i) {
+        fnt_worker_t *victim = &s->workers[(start + i) % s->count];
+        if( victim == self )    { continue; }
+        if( (task = fnt_deque_steal(&victim->deque)) != NULL ) {
+            return task;
+        }
+    }
+
+    return NULL;
+}
+
+
+/* Whether any task could be found, without taking one. */
+static int fnt_sched_has_work(fnt_sched_t *s) {
+    if( __atomic_load_n(&s->inject_count, __ATOMIC_ACQUIRE) > 0 ) {
+        return 1;
+    }
+    for(int i=0; i<s->count; ++i) {
+        fnt_deque_t *d = &s->workers[i].deque;
+        if( __atomic_load_n(&d->bottom, __ATOMIC_ACQUIRE)
+            > __atomic_load_n(&d->top, __ATOMIC_ACQUIRE) ) {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+
+/* Block until woken, unless there is work, shutdown was requested, or
+ * group, when not NULL, has finished. */
+static void fnt_sched_park(fnt_sched_t *s, int *group) {
+    pthread_mutex_lock(&s->park_lock);
+    __atomic_add_fetch(&s->sleepers, 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+    unsigned epoch = s->epoch;
+    if( !fnt_sched_has_work(s)
+        && !__atomic_load_n(&s->shutdown, __ATOMIC_ACQUIRE)
+        && (group == NULL || __atomic_load_n(group, __ATOMIC_ACQUIRE) > 0) ) {
+        while( s->epoch == epoch ) {
+            pthread_cond_wait(&s->wake, &s->park_lock);
+        }
+    }
+
+    __atomic_sub_fetch(&s->sleepers, 1, __ATOMIC_RELAXED);
+    pthread_mutex_unlock(&s->park_lock);
+}
+
+
+/* Spin briefly after failing to find a task, then park. */
+static void fnt_sched_idle(fnt_sched_t *s, int *group, int *rounds) {
+    if( ++*rounds < FNT_SCHED_SPIN ) {
+        sched_yield();
+    } else {
+        fnt_sched_park(s, group);
+        *rounds = 0;
+    }
+}
+
+
+static void *fnt_sched_worker(void *arg) {
+    fnt_worker_t *self = (fnt_worker_t*)arg;
+    fnt_sched_t *s = self->sched;
+    fnt_sched_self = self;
+
+    int rounds = 0;
+    while( !__atomic_load_n(&s->shutdown, __ATOMIC_ACQUIRE) ) {
+        fnt_task_t *task = fnt_sched_find(s, self);
+        if( task != NULL ) {
+            fnt_sched_run(s, task);
+            rounds = 0;
+        } else {
+            fnt_sched_idle(s, NULL, &rounds);
+        }
+    }
+
+    return NULL;
+}
+
+
+/* MARK: User callable functions */
+
+int fnt_sched_init(void **sched, int workers) {
+    if( sched == NULL )     { return FNT_FAILURE; }
+
+    if( workers < 1 ) {
+        workers = (int)sysconf(_SC_NPROCESSORS_ONLN);
+        if( workers < 1 )   { workers = 1; }
+    }
+
+    fnt_sched_t *s = calloc(1, sizeof(fnt_sched_t));
+    if( s == NULL )         { return FNT_FAILURE; }
+    s->workers = calloc(workers, sizeof(fnt_worker_t));
+    if( s->workers == NULL ) {
+        free(s);
+        return FNT_FAILURE;
+    }
+    pthread_mutex_init(&s->inject_lock, NULL);
+    pthread_mutex_init(&s->park_lock, NULL);
+    pthread_cond_init(&s->wake, NULL);
+
+    /* every worker must exist before any of them looks for victims */
+    s->count = workers;
+    for(int i=0; i<workers; ++i) {
+        fnt_worker_t *w = &s->workers[i];
+        w->sched = s;
+        w->index = i;
+        w->rng = 2463534242u + 7919u * i;
+    }
+    for(int i=0; i<workers; ++i) {
+        if( pthread_create(&s->workers[i].thread, NULL, fnt_sched_worker, &s->workers[i]) != 0 ) {
+            ERROR("ERROR: Failed to start worker %d.\n", i);
+            break;
+        }
+        s->started = i + 1;
+    }
+
+    *sched = s;
+    if( s->started != workers ) {
+        fnt_sched_free(sched);
+        return FNT_FAILURE;
+    }
+    INFO("Started scheduler with %d workers.\n", s->count);
+
+    return FNT_SUCCESS;
+}
+
+
+int fnt_sched_free(void **sched) {
+    if( sched == NULL )     { return FNT_FAILURE; }
+    fnt_sched_t *s = (fnt_sched_t*)*sched;
+    if( s == NULL )         { return FNT_FAILURE; }
+
+    __atomic_store_n(&s->shutdown, 1, __ATOMIC_RELEASE);
+    pthread_mutex_lock(&s->park_lock);
+    ++s->epoch;
+    pthread_cond_broadcast(&s->wake);
+    pthread_mutex_unlock(&s->park_lock);
+    for(int i=0; i<s->started; ++i) {
+        pthread_join(s->workers[i].thread, NULL);
+    }
+
+    /* drop tasks nobody waited for */
+    while( s->inject_head != NULL ) {
+        fnt_task_t *next = s->inject_head->next;
+        free(s->inject_head);
+        s->inject_head = next;
+    }
+    for(int i=0; i<s->count; ++i) {
+        fnt_task_t *task;
+        while( (task = fnt_deque_pop(&s->workers[i].deque)) != NULL ) {
+            free(task);
+        }
+    }
+
+    pthread_mutex_destroy(&s->inject_lock);
+    pthread_mutex_destroy(&s->park_lock);
+    pthread_cond_destroy(&s->wake);
+    free(s->workers);
+    free(s); *sched = NULL;
+
+    return FNT_SUCCESS;
+}
+
+
+int fnt_sched_spawn(void *sched, int *group, fnt_task_fn_t fn, void *arg) {
+    fnt_sched_t *s = (fnt_sched_t*)sched;
+    if( s == NULL )         { return FNT_FAILURE; }
+    if( group == NULL )     { return FNT_FAILURE; }
+    if( fn == NULL )        { return FNT_FAILURE; }
+
+    fnt_task_t *task = malloc(sizeof(fnt_task_t));
+    if( task == NULL )      { return FNT_FAILURE; }
+    task->fn = fn;
+    task->arg = arg;
+    task->group = group;
+    task->next = NULL;
+    __atomic_add_fetch(group, 1, __ATOMIC_RELAXED);
+
+    fnt_worker_t *self = fnt_sched_self;
+    if( self != NULL && self->sched == s ) {
+        if( fnt_deque_push(&self->deque, task) != FNT_SUCCESS ) {
+            /* deque is full, run it now rather than grow */
+            fnt_sched_run(s, task);
+            return FNT_SUCCESS;
+        }
+        fnt_sched_notify(s);
+        return FNT_SUCCESS;
+    }
+
+    /* spawned from outside the pool */
+    pthread_mutex_lock(&s->inject_lock);
+    task->next = s->inject_head;
+    s->inject_head = task;
+    __atomic_add_fetch(&s->inject_count, 1, __ATOMIC_RELEASE);
+    pthread_mutex_unlock(&s->inject_lock);
+    fnt_sched_notify(s);
+
+    return FNT_SUCCESS;
+}
+
+
+int fnt_sched_wait(void *sched, int *group) {
+    fnt_sched_t *s = (fnt_sched_t*)sched;
+    if( s == NULL )         { return FNT_FAILURE; }
+    if( group == NULL )     { return FNT_FAILURE; }
+
+    /* help out instead of blocking, so nested waits cannot starve */
+    fnt_worker_t *self = fnt_sched_self;
+    if( self != NULL && self->sched != s )  { self = NULL; }
+
+    int rounds = 0;
+    while( __atomic_load_n(group, __ATOMIC_ACQUIRE) > 0 ) {
+        fnt_task_t *task = fnt_sched_find(s, self);
+        if( task != NULL ) {
+            fnt_sched_run(s, task);
+            rounds = 0;
+        } else {
+            fnt_sched_idle(s, group, &rounds);
+        }
+    }
+
+    return FNT_SUCCESS;
+}
+
+
+/* MARK: Evaluation driver */
+
+typedef struct fnt_sched_eval {
+    fnt_objective_t objective;
+    void *user;
+    fnt_vect_t *x;
+    double value;
+} fnt_sched_eval_t;
+
+
+static void fnt_sched_evaluate(void *arg) {
+    fnt_sched_eval_t *eval = (fnt_sched_eval_t*)arg;
+    eval->value = eval->objective(eval->x, eval->user);
+}
+
+
+int fnt_sched_minimize(void *sched, void *context, fnt_objective_t objective, void *user) {
+    if( sched == NULL )     { return FNT_FAILURE; }
+    if( context == NULL )   { return FNT_FAILURE; }
+    if( objective == NULL ) { return FNT_FAILURE; }
+
+    int dimensions = 0;
+    if( fnt_dimensions(context, &dimensions) != FNT_SUCCESS ) {
+        return FNT_FAILURE;
+    }
+
+    fnt_vect_t vecs[FNT_SCHED_BATCH];
+    int tickets[FNT_SCHED_BATCH];
+    fnt_sched_eval_t evals[FNT_SCHED_BATCH];
+    memset(vecs, '\0', sizeof(vecs));
+    int ret = FNT_SUCCESS;
+    for(int i=0; i<FNT_SCHED_BATCH && ret == FNT_SUCCESS; ++i) {
+        if( fnt_vect_calloc(&vecs[i], dimensions) != FNT_VEC_SUCCESS ) {
+            ret = FNT_FAILURE;
+        }
+        evals[i].objective = objective;
+        evals[i].user = user;
+        evals[i].x = &vecs[i];
+    }
+
+    int status = FNT_CONTINUE;
+    while( ret == FNT_SUCCESS && (status = fnt_done(context)) == FNT_CONTINUE ) {
+        int count = 0;
+        if( fnt_next_batch(context, vecs, tickets, FNT_SCHED_BATCH, &count) != FNT_SUCCESS
+            || count == 0 ) {
+            /* handing out inputs can itself finish the method */
+            if( (status = fnt_done(context)) != FNT_DONE )  { ret = FNT_FAILURE; }
+            break;
+        }
+
+        /* evaluate the last input on this thread while the rest are stolen */
+        int group = 0;
+        for(int i=0; i<count-1; ++i) {
+            if( fnt_sched_spawn(sched, &group, fnt_sched_evaluate, &evals[i]) != FNT_SUCCESS ) {
+                fnt_sched_evaluate(&evals[i]);
+            }
+        }
+        fnt_sched_evaluate(&evals[count-1]);
+        fnt_sched_wait(sched, &group);
+
+        for(int i=0; i<count && ret == FNT_SUCCESS; ++i) {
+            ret = fnt_set_value_ticket(context, tickets[i], &vecs[i], evals[i].value);
+        }
+    }
+    if( status == FNT_FAILURE ) { ret = FNT_FAILURE; }
+
+    for(int i=0; i<FNT_SCHED_BATCH; ++i) {
+        fnt_vect_free(&vecs[i]);
+    }
+
+    return ret;
+}
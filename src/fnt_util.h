@@ -79,6 +79,14 @@
 
 /* MARK: Externed Global Variables */
 
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
 extern int fnt_verbose_level;
 
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
 #endif /* FNT_UTIL_H */
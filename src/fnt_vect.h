@@ -14,6 +14,10 @@
 #define FNT_VEC_SUCCESS 0
 #define FNT_VEC_FAILURE 1
 
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
 extern int fnt_verbose_level;
 
 /* MARK: Type and extern declarations */
@@ -31,14 +35,14 @@ typedef struct fnt_vect {
 
 /* MARK: Vector I/O */
 
-static int fnt_vect_print(fnt_vect_t *vec, char *label, char *fmt) {
+static inline int fnt_vect_print(fnt_vect_t *vec, char *label, char *fmt) {
     if( vec == NULL )   { return FNT_VEC_FAILURE; }
     /* label and fmt can each be NULL */
 
     if( label != NULL ) { printf("%s", label); }
 
     printf("[");
-    for(int i=0; i<vec->n; ++i) {
+    for(size_t i=0; i<vec->n; ++i) {
         if( fmt != NULL )       { printf(fmt, vec->v[i]); }
         else                    { printf("%g", vec->v[i]); }
 
@@ -50,7 +54,7 @@ static int fnt_vect_print(fnt_vect_t *vec, char *label, char *fmt) {
 }
 
 
-static int fnt_vect_println(fnt_vect_t *vec, char *label, char *fmt) {
+static inline int fnt_vect_println(fnt_vect_t *vec, char *label, char *fmt) {
     int ret = fnt_vect_print(vec, label, fmt);
     if( ret == FNT_VEC_SUCCESS ) { printf("\n"); }
 
@@ -58,7 +62,7 @@ static int fnt_vect_println(fnt_vect_t *vec, char *label, char *fmt) {
 }
 
 
-static int fnt_vect_snprint(char *out, size_t n, fnt_vect_t *vec, char *label, char *fmt) {
+static inline int fnt_vect_snprint(char *out, size_t n, fnt_vect_t *vec, char *label, char *fmt) {
     if( out == NULL )   { return FNT_VEC_FAILURE; }
     if( vec == NULL )   { return FNT_VEC_FAILURE; }
     /* label and fmt can each be NULL */
@@ -68,7 +72,7 @@ static int fnt_vect_snprint(char *out, size_t n, fnt_vect_t *vec, char *label, c
     if( label != NULL ) { offset += snprintf(out+offset, n-offset, "%s", label); }
 
     offset += snprintf(out+offset, n-offset, "[");
-    for(int i=0; i<vec->n; ++i) {
+    for(size_t i=0; i<vec->n; ++i) {
         if( fmt != NULL )       { offset += snprintf(out+offset, n-offset, fmt, vec->v[i]); }
         else                    { offset += snprintf(out+offset, n-offset, "%g", vec->v[i]); }
 
@@ -82,10 +86,10 @@ static int fnt_vect_snprint(char *out, size_t n, fnt_vect_t *vec, char *label, c
 
 /* MARK: Vector memory operations */
 
-static int fnt_vect_calloc(fnt_vect_t *vec, int length) {
+static inline int fnt_vect_calloc(fnt_vect_t *vec, int length) {
     if( vec == NULL )   { return FNT_VEC_FAILURE; }
 
-    if( (vec->v = calloc(length, sizeof(double))) == NULL ) {
+    if( (vec->v = (double*)calloc(length, sizeof(double))) == NULL ) {
         if( fnt_verbose_level >= FNT_ERROR ) {
             perror("calloc");
         }
@@ -97,7 +101,7 @@ static int fnt_vect_calloc(fnt_vect_t *vec, int length) {
 }
 
 
-static int fnt_vect_free(fnt_vect_t *vec) {
+static inline int fnt_vect_free(fnt_vect_t *vec) {
     if( vec == NULL )   { return FNT_VEC_FAILURE; }
 
     if( vec->v != NULL ) {
@@ -109,7 +113,7 @@ static int fnt_vect_free(fnt_vect_t *vec) {
 }
 
 
-static int fnt_vect_reset(fnt_vect_t *vec) {
+static inline int fnt_vect_reset(fnt_vect_t *vec) {
     if( vec == NULL )       { return FNT_VEC_FAILURE; }
     if( vec->v == NULL )    { return FNT_VEC_FAILURE; }
 
@@ -120,7 +124,7 @@ static int fnt_vect_reset(fnt_vect_t *vec) {
 
 
 
-static int fnt_vect_copy(fnt_vect_t *dst, fnt_vect_t *src) {
+static inline int fnt_vect_copy(fnt_vect_t *dst, fnt_vect_t *src) {
     if( dst == NULL )       { return FNT_VEC_FAILURE; }
     if( src == NULL )       { return FNT_VEC_FAILURE; }
     if( dst->v == NULL )    { return FNT_VEC_FAILURE; }
@@ -134,6 +138,9 @@ static int fnt_vect_copy(fnt_vect_t *dst, fnt_vect_t *src) {
         return FNT_VEC_FAILURE;
     }
 
+    /* nothing to do when a borrowed view is handed back */
+    if( dst->v == src->v )  { return FNT_VEC_SUCCESS; }
+
     memcpy(dst->v, src->v, src->n * sizeof(double));
 
     return FNT_VEC_SUCCESS;
@@ -142,7 +149,7 @@ static int fnt_vect_copy(fnt_vect_t *dst, fnt_vect_t *src) {
 
 /* MARK: Basic vector operations */
 
-static int fnt_vect_add(fnt_vect_t *a, fnt_vect_t *b, fnt_vect_t *sum) {
+static inline int fnt_vect_add(fnt_vect_t *a, fnt_vect_t *b, fnt_vect_t *sum) {
     if( sum == NULL )       { return FNT_VEC_FAILURE; }
     if( a == NULL )         { return FNT_VEC_FAILURE; }
     if( b == NULL )         { return FNT_VEC_FAILURE; }
@@ -152,7 +159,7 @@ static int fnt_vect_add(fnt_vect_t *a, fnt_vect_t *b, fnt_vect_t *sum) {
     if( sum->n != a->n )    { return FNT_VEC_FAILURE; }
     if( b->n != a->n )      { return FNT_VEC_FAILURE; }
 
-    for(int i=0; i<a->n; ++i) {
+    for(size_t i=0; i<a->n; ++i) {
         sum->v[i] = a->v[i] + b->v[i];
     }
 
@@ -160,7 +167,7 @@ static int fnt_vect_add(fnt_vect_t *a, fnt_vect_t *b, fnt_vect_t *sum) {
 }
 
 
-static int fnt_vect_sub(fnt_vect_t *a, fnt_vect_t *b, fnt_vect_t *diff) {
+static inline int fnt_vect_sub(fnt_vect_t *a, fnt_vect_t *b, fnt_vect_t *diff) {
     if( diff == NULL )      { return FNT_VEC_FAILURE; }
     if( a == NULL )         { return FNT_VEC_FAILURE; }
     if( b == NULL )         { return FNT_VEC_FAILURE; }
@@ -170,7 +177,7 @@ static int fnt_vect_sub(fnt_vect_t *a, fnt_vect_t *b, fnt_vect_t *diff) {
     if( diff->n != a->n )   { return FNT_VEC_FAILURE; }
     if( b->n != a->n )      { return FNT_VEC_FAILURE; }
 
-    for(int i=0; i<a->n; ++i) {
+    for(size_t i=0; i<a->n; ++i) {
         diff->v[i] = a->v[i] - b->v[i];
     }
 
@@ -178,14 +185,14 @@ static int fnt_vect_sub(fnt_vect_t *a, fnt_vect_t *b, fnt_vect_t *diff) {
 }
 
 
-static int fnt_vect_scale(fnt_vect_t *vec, double scaling, fnt_vect_t *result) {
+static inline int fnt_vect_scale(fnt_vect_t *vec, double scaling, fnt_vect_t *result) {
     if( vec == NULL )           { return FNT_VEC_FAILURE; }
     if( result == NULL )        { return FNT_VEC_FAILURE; }
     if( vec->v == NULL )        { return FNT_VEC_FAILURE; }
     if( result->v == NULL )     { return FNT_VEC_FAILURE; }
     if( result->n != vec->n )   { return FNT_VEC_FAILURE; }
 
-    for(int i=0; i<vec->n; ++i) {
+    for(size_t i=0; i<vec->n; ++i) {
         result->v[i] = scaling * vec->v[i];
     }
 
@@ -195,13 +202,13 @@ static int fnt_vect_scale(fnt_vect_t *vec, double scaling, fnt_vect_t *result) {
 
 /* MARK: Advanced vector operations */
 
-static int fnt_vect_l2norm(fnt_vect_t *vec, double *result) {
+static inline int fnt_vect_l2norm(fnt_vect_t *vec, double *result) {
     if( vec == NULL )           { return FNT_VEC_FAILURE; }
     if( result == NULL )        { return FNT_VEC_FAILURE; }
     if( vec->v == NULL )        { return FNT_VEC_FAILURE; }
 
     double sum = 0.0;
-    for(int i=0; i<vec->n; ++i) {
+    for(size_t i=0; i<vec->n; ++i) {
         sum += pow(vec->v[i], 2.0);
     }
     *result = sqrt(sum);
@@ -210,7 +217,7 @@ static int fnt_vect_l2norm(fnt_vect_t *vec, double *result) {
 }
 
 
-static int fnt_vect_dist(fnt_vect_t *a, fnt_vect_t *b, double *result) {
+static inline int fnt_vect_dist(fnt_vect_t *a, fnt_vect_t *b, double *result) {
     if( result == NULL )    { return FNT_VEC_FAILURE; }
     if( a == NULL )         { return FNT_VEC_FAILURE; }
     if( b == NULL )         { return FNT_VEC_FAILURE; }
@@ -228,35 +235,8 @@ static int fnt_vect_dist(fnt_vect_t *a, fnt_vect_t *b, double *result) {
 }
 
 
-#ifndef FNT_VECT_QUIET
-#define FNT_VECT_QUIET
-/* This shuts up the warnings about not calling functions */
-void fnt_call_quiet_statics() {
-    fnt_vect_t x, y, z;
-    double v;
-    char buf[24];
-
-    fnt_vect_calloc(&x, 3);
-    fnt_vect_calloc(&y, 3);
-    fnt_vect_calloc(&x, 3);
-
-    fnt_vect_print(&x, NULL, NULL);
-    fnt_vect_println(&x, NULL, NULL);
-    fnt_vect_snprint(buf, sizeof(buf), &x, NULL, NULL);
-
-    fnt_vect_reset(&x);
-    fnt_vect_copy(&x, &x);
-    fnt_vect_add(&x, &y, &z);
-    fnt_vect_sub(&x, &y, &z);
-    fnt_vect_scale(&y, 2.0, &z);
-
-    fnt_vect_l2norm(&x, &v);
-    fnt_vect_dist(&x, &y, &v);
-
-    fnt_vect_free(&x);
-    fnt_vect_free(&y);
-    fnt_vect_free(&z);
+#ifdef __cplusplus
 }
-#endif /* FNT_VECT_QUIET */
+#endif /* __cplusplus */
 
 #endif /* FNT_VECT_H */
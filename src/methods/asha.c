@@ -0,0 +1,742 @@
+/*
+ * asha.c
+ * fnt: Numerical Toolbox
+ *
+ * Copyright (c) 2024 Bryan Franklin. All rights reserved.
+ */
+#include <errno.h>
+#include <limits.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../fnt.h"
+
+
+/* MARK: Method type definitions */
+
+/* mutation and crossover of the differential evolution sampler */
+#define ASHA_DE_F       0.5
+#define ASHA_DE_CR      0.5
+
+/* dimensions with Sobol direction numbers below */
+#define ASHA_SOBOL_DIMS 21
+
+typedef enum asha_sampler {
+    asha_random, asha_sobol, asha_de
+} asha_sampler_t;
+
+typedef struct asha_entry {
+    double value;
+    int config;
+} asha_entry_t;
+
+typedef struct asha_rung {
+    asha_entry_t *entries;  /* sorted by increasing value */
+    int count;
+    int capacity;
+} asha_rung_t;
+
+typedef struct asha {
+    int dim;                /* dimensions of inputs, the last is the fidelity */
+    int n;                  /* dimensions searched */
+    int started;
+
+    /* hyper-parameters */
+    double min_fidelity;
+    double max_fidelity;
+    double eta;
+    double budget;
+    int early_stop;
+    int sampler;
+    fnt_vect_t lower_bounds;
+    fnt_vect_t upper_bounds;
+    int has_lower_bounds;
+    int has_upper_bounds;
+
+    /* rung k is evaluated at max_fidelity * eta^(k - rungs + 1) */
+    int rungs;
+    asha_rung_t *rung;
+
+    /* configurations, config c is at [c * n, (c + 1) * n) */
+    double *configs;
+    int *level;             /* highest rung each was handed out at */
+    int config_count;
+    int config_capacity;
+
+    /* jobs, indexed by ticket */
+    int *job_config;
+    int *job_rung;
+    unsigned char *job_known;
+    int job_count;
+    int job_capacity;
+    int oldest;             /* no job before it is outstanding */
+    int outstanding;
+    double cost;            /* sum of fidelities handed out */
+
+    /* Sobol sequence, gray code order */
+    uint32_t *sobol_v;      /* 32 direction numbers per dimension */
+    uint32_t *sobol_x;
+    uint32_t sobol_index;
+
+    /* results */
+    fnt_vect_t minimum_x;
+    double minimum_f;
+    int minimum_rung;       /* -1 until a value arrives */
+} asha_t;
+
+
+/* MARK: Internal functions */
+
+/* Primitive polynomials and initial direction numbers of dimensions 2 to 21,
+ * from Joe and Kuo's new-joe-kuo-6.21201: degree s, coefficients a, m_1..m_s.
+ */
+static const int asha_sobol_table[ASHA_SOBOL_DIMS - 1][9] = {
+    { 1,  0, 1 },
+    { 2,  1, 1, 3 },
+    { 3,  1, 1, 3, 1 },
+    { 3,  2, 1, 1, 1 },
+    { 4,  1, 1, 1, 3, 3 },
+    { 4,  4, 1, 3, 5, 13 },
+    { 5,  2, 1, 1, 5, 5, 17 },
+    { 5,  4, 1, 1, 5, 5, 5 },
+    { 5,  7, 1, 1, 7, 11, 19 },
+    { 5, 11, 1, 1, 5, 1, 1 },
+    { 5, 13, 1, 1, 1, 3, 11 },
+    { 5, 14, 1, 3, 5, 5, 31 },
+    { 6,  1, 1, 3, 3, 9, 7, 49 },
+    { 6, 13, 1, 1, 1, 15, 21, 21 },
+    { 6, 16, 1, 3, 1, 13, 27, 49 },
+    { 6, 19, 1, 1, 1, 15, 7, 5 },
+    { 6, 22, 1, 3, 1, 15, 13, 25 },
+    { 6, 25, 1, 1, 5, 5, 19, 61 },
+    { 7,  1, 1, 3, 7, 11, 23, 15, 103 },
+    { 7,  4, 1, 3, 7, 13, 13, 15, 69 },
+};
+
+
+static double asha_uniform() {
+    return FNT_RAND() / (double)FNT_RAND_MAX;
+}
+
+
+/* Range searched in dimension j, the bounds where given, otherwise [-1, 1]. */
+static void asha_range(asha_t *ptr, int j, double *lo, double *hi) {
+    *lo = ptr->has_lower_bounds ? FNT_VECT_ELEM(ptr->lower_bounds, j) : -1.0;
+    *hi = ptr->has_upper_bounds ? FNT_VECT_ELEM(ptr->upper_bounds, j) : 1.0;
+    if( *hi <= *lo ) {
+        if( ptr->has_lower_bounds ) { *hi = *lo + 2.0; } else { *lo = *hi - 2.0; }
+    }
+}
+
+
+static double asha_fidelity(asha_t *ptr, int k) {
+    return ptr->max_fidelity * pow(ptr->eta, k - ptr->rungs + 1);
+}
+
+
+static int asha_sobol_init(asha_t *ptr) {
+    ptr->sobol_v = calloc((size_t)ptr->n * 32, sizeof(uint32_t));
+    ptr->sobol_x = calloc(ptr->n, sizeof(uint32_t));
+    if( ptr->sobol_v == NULL || ptr->sobol_x == NULL ) {
+        ERROR("calloc: %s\n", strerror(errno));
+        return FNT_FAILURE;
+    }
+
+    for(int d=0; d<ptr->n; ++d) {
+        uint32_t *v = &ptr->sobol_v[d * 32];
+        if( d == 0 ) {
+            for(int k=0; k<32; ++k) { v[k] = (uint32_t)1 << (31 - k); }
+            continue;
+        }
+
+        const int *row = asha_sobol_table[d - 1];
+        int s = row[0], a = row[1];
+        for(int k=0; k<s; ++k) { v[k] = (uint32_t)row[2 + k] << (31 - k); }
+        for(int k=s; k<32; ++k) {
+            v[k] = v[k - s] ^ (v[k - s] >> s);
+            for(int j=1; j<s; ++j) {
+                if( (a >> (s - 1 - j)) & 1 )    { v[k] ^= v[k - j]; }
+            }
+        }
+    }
+    ptr->sobol_index = 0;
+
+    return FNT_SUCCESS;
+}
+
+
+/* Next point of the Sobol sequence, skipping the origin. */
+static void asha_sobol_next(asha_t *ptr, double *x) {
+    /* flip the direction number of the lowest zero bit of the index */
+    int c = 0;
+    while( (ptr->sobol_index >> c) & 1 )    { ++c; }
+    ++ptr->sobol_index;
+
+    for(int j=0; j<ptr->n; ++j) {
+        double lo, hi;
+        asha_range(ptr, j, &lo, &hi);
+        ptr->sobol_x[j] ^= ptr->sobol_v[j * 32 + c];
+        x[j] = lo + (hi - lo) * (ptr->sobol_x[j] / 4294967296.0);
+    }
+}
+
+
+/* Differential evolution proposal from the best configurations of the
+ * highest rung with enough of them, crossed with a random point (as in
+ * DEHB).  Returns FNT_FAILURE if no rung has three values yet. */
+static int asha_de_next(asha_t *ptr, double *x) {
+    int k = ptr->rungs - 1;
+    while( k >= 0 && ptr->rung[k].count < 3 )   { --k; }
+    if( k < 0 )     { return FNT_FAILURE; }
+
+    asha_rung_t *r = &ptr->rung[k];
+    int pool = (int)(r->count / ptr->eta);
+    if( pool < 3 )  { pool = 3; }
+    int i1 = FNT_RAND() % pool;
+    int i2 = FNT_RAND() % pool;
+    int i3 = FNT_RAND() % pool;
+    while( i2 == i1 )               { i2 = FNT_RAND() % pool; }
+    while( i3 == i1 || i3 == i2 )   { i3 = FNT_RAND() % pool; }
+    double *a = &ptr->configs[r->entries[i1].config * ptr->n];
+    double *b = &ptr->configs[r->entries[i2].config * ptr->n];
+    double *c = &ptr->configs[r->entries[i3].config * ptr->n];
+
+    int keep = FNT_RAND() % ptr->n;
+    for(int j=0; j<ptr->n; ++j) {
+        double lo, hi;
+        asha_range(ptr, j, &lo, &hi);
+        if( j == keep || asha_uniform() < ASHA_DE_CR ) {
+            x[j] = fmin(fmax(a[j] + ASHA_DE_F * (b[j] - c[j]), lo), hi);
+        } else {
+            x[j] = lo + (hi - lo) * asha_uniform();
+        }
+    }
+
+    return FNT_SUCCESS;
+}
+
+
+static void asha_sample(asha_t *ptr, double *x) {
+    if( ptr->sampler == asha_sobol ) {
+        asha_sobol_next(ptr, x);
+        return;
+    }
+    if( ptr->sampler == asha_de && asha_de_next(ptr, x) == FNT_SUCCESS ) {
+        return;
+    }
+
+    for(int j=0; j<ptr->n; ++j) {
+        double lo, hi;
+        asha_range(ptr, j, &lo, &hi);
+        x[j] = lo + (hi - lo) * asha_uniform();
+    }
+}
+
+
+static void asha_free_state(asha_t *ptr) {
+    for(int k=0; ptr->rung != NULL && k<ptr->rungs; ++k) {
+        free(ptr->rung[k].entries);
+    }
+    free(ptr->rung);        ptr->rung = NULL;
+    free(ptr->configs);     ptr->configs = NULL;
+    free(ptr->level);       ptr->level = NULL;
+    free(ptr->job_config);  ptr->job_config = NULL;
+    free(ptr->job_rung);    ptr->job_rung = NULL;
+    free(ptr->job_known);   ptr->job_known = NULL;
+    free(ptr->sobol_v);     ptr->sobol_v = NULL;
+    free(ptr->sobol_x);     ptr->sobol_x = NULL;
+    ptr->config_count = ptr->config_capacity = 0;
+    ptr->job_count = ptr->job_capacity = 0;
+    ptr->oldest = ptr->outstanding = 0;
+    ptr->cost = 0.0;
+    ptr->started = 0;
+}
+
+
+/* Check hyper-parameters and set up the rungs before the first input. */
+static int asha_start(asha_t *ptr) {
+    if( ptr->min_fidelity <= 0.0 || ptr->max_fidelity < ptr->min_fidelity ) {
+        ERROR("ERROR: Fidelities must satisfy 0 < min_fidelity <= max_fidelity.\n");
+        return FNT_FAILURE;
+    }
+    if( ptr->eta <= 1.0 ) {
+        ERROR("ERROR: eta must be greater than one, eta was %g.\n", ptr->eta);
+        return FNT_FAILURE;
+    }
+
+    /* rungs from min_fidelity * eta^early_stop up to max_fidelity */
+    int top = (int)floor(log(ptr->max_fidelity / ptr->min_fidelity) / log(ptr->eta) + 1e-9);
+    if( ptr->early_stop < 0 || ptr->early_stop > top ) {
+        WARN("early_stop must be between 0 and %d.  Setting early_stop to 0.\n", top);
+        ptr->early_stop = 0;
+    }
+    ptr->rungs = top - ptr->early_stop + 1;
+    ptr->rung = calloc(ptr->rungs, sizeof(asha_rung_t));
+    if( ptr->rung == NULL ) {
+        ERROR("calloc: %s\n", strerror(errno));
+        return FNT_FAILURE;
+    }
+
+    if( ptr->sampler == asha_sobol && ptr->n > ASHA_SOBOL_DIMS ) {
+        WARN("Sobol points are limited to %d dimensions, sampling randomly instead.\n", ASHA_SOBOL_DIMS);
+        ptr->sampler = asha_random;
+    }
+    if( ptr->sampler == asha_sobol && asha_sobol_init(ptr) != FNT_SUCCESS ) {
+        return FNT_FAILURE;
+    }
+
+    ptr->minimum_rung = -1;
+    ptr->started = 1;
+    DEBUG("DEBUG: %d rungs, fidelities %g to %g.\n", ptr->rungs,
+            asha_fidelity(ptr, 0), asha_fidelity(ptr, ptr->rungs - 1));
+
+    return FNT_SUCCESS;
+}
+
+
+/* Grow an array holding count elements of size bytes to hold one more. */
+static int asha_reserve(void **array, int count, int *capacity, size_t size) {
+    if( count < *capacity ) { return FNT_SUCCESS; }
+
+    int grown = *capacity > 0 ? 2 * *capacity : 64;
+    void *p = realloc(*array, (size_t)grown * size);
+    if( p == NULL ) {
+        ERROR("realloc: %s\n", strerror(errno));
+        return FNT_FAILURE;
+    }
+    *array = p;
+    *capacity = grown;
+
+    return FNT_SUCCESS;
+}
+
+
+/* \brief Pick the next job: promote a configuration in the top 1/eta of its
+ * rung that has not been promoted yet, highest rung first, or else sample a
+ * new configuration for the bottom rung.
+ */
+static int asha_job(asha_t *ptr, int *config, int *rung) {
+
+    for(int k=ptr->rungs-2; k>=0; --k) {
+        asha_rung_t *r = &ptr->rung[k];
+        int top = (int)(r->count / ptr->eta);
+        for(int i=0; i<top; ++i) {
+            int c = r->entries[i].config;
+            if( ptr->level[c] != k )    { continue; }
+            ptr->level[c] = *rung = k + 1;
+            *config = c;
+            return FNT_SUCCESS;
+        }
+    }
+
+    /* level and configs share config_capacity, updated by the last */
+    int c = ptr->config_count;
+    int capacity = ptr->config_capacity;
+    if( asha_reserve((void**)&ptr->level, c, &capacity, sizeof(int)) != FNT_SUCCESS
+        || asha_reserve((void**)&ptr->configs, c, &ptr->config_capacity,
+                        ptr->n * sizeof(double)) != FNT_SUCCESS ) {
+        return FNT_FAILURE;
+    }
+    asha_sample(ptr, &ptr->configs[c * ptr->n]);
+    ptr->level[c] = *rung = 0;
+    *config = c;
+    ++ptr->config_count;
+
+    return FNT_SUCCESS;
+}
+
+
+/* MARK: Functions called by FNT */
+
+/* \brief Provides the name of the method.
+ * \param name Allocated buffer to hold the name.
+ * \param size Size of the name buffer in bytes.
+ * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
+ */
+static int method_name(char *name, int size) {
+    if( snprintf(name, size, "asha") >= size ) {
+        return FNT_FAILURE;
+    }
+
+    return FNT_SUCCESS;
+}
+
+
+/* \brief Initialize intenal state for method.
+ * \param handle_ptr Pointer to the method handle pointer.
+ * \param dimensions Number of dimensions in the objactive function input,
+ * including the fidelity.
+ * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
+ */
+static int method_init(void **handle_ptr, int dimensions) {
+    if( handle_ptr == NULL )    { return FNT_FAILURE; }
+    if( dimensions < 2 ) {
+        ERROR("ERROR: Inputs need at least one dimension besides the fidelity.\n");
+        return FNT_FAILURE;
+    }
+    asha_t *ptr = calloc(1, sizeof(asha_t));
+    if( ptr == NULL )           { return FNT_FAILURE; }
+    *handle_ptr = (void*)ptr;
+
+    ptr->dim = dimensions;
+    ptr->n = dimensions - 1;
+    ptr->min_fidelity = 1.0;
+    ptr->max_fidelity = 81.0;
+    ptr->eta = 3.0;
+    ptr->budget = 100.0 * ptr->max_fidelity;
+    ptr->sampler = asha_random;
+    ptr->minimum_rung = -1;
+
+    fnt_vect_calloc(&ptr->minimum_x, dimensions);
+
+    return FNT_SUCCESS;
+}
+
+
+/* \brief Free any resources allocated for the method.
+ * \param handle_ptr Pointer to the method handle pointer.
+ * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
+ */
+static int method_free(void **handle_ptr) {
+    if( handle_ptr == NULL )    { return FNT_FAILURE; }
+    if( *handle_ptr == NULL )   { return FNT_FAILURE; }
+    asha_t *ptr = (asha_t*)*handle_ptr;
+
+    asha_free_state(ptr);
+    fnt_vect_free(&ptr->minimum_x);
+    if( ptr->has_lower_bounds ) { fnt_vect_free(&ptr->lower_bounds); }
+    if( ptr->has_upper_bounds ) { fnt_vect_free(&ptr->upper_bounds); }
+
+    free(ptr);  *handle_ptr = ptr = NULL;
+
+    return FNT_SUCCESS;
+}
+
+
+/* \brief Return the method to its initial state, keeping hyper-parameters.
+ * \param handle Pointer to the method handle.
+ * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
+ */
+static int method_reset(void *handle) {
+    asha_t *ptr = (asha_t*)handle;
+    if( ptr == NULL )       { return FNT_FAILURE; }
+
+    asha_free_state(ptr);
+    fnt_vect_reset(&ptr->minimum_x);
+    ptr->minimum_f = 0.0;
+    ptr->minimum_rung = -1;
+
+    return FNT_SUCCESS;
+}
+
+
+/* \brief Display information about the method to the console.
+ * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
+ */
+static int method_info() {
+    printf(
+"Asynchronous successive halving (ASHA) searches with an objective that can\n"
+"be evaluated at reduced fidelity, for a fraction of the cost.  The last\n"
+"element of every input is the fidelity to evaluate it at, the others are\n"
+"the point; bounds are given for all elements, the last is ignored.\n"
+"\n"
+"Configurations start on the bottom rung, at min_fidelity * eta^early_stop.\n"
+"Whenever an input is needed, a configuration in the top 1/eta of a rung\n"
+"that has not been promoted yet is evaluated on the next rung, eta times the\n"
+"fidelity, highest rungs first, otherwise a new configuration is sampled.\n"
+"Promotions never wait for a rung to fill, so any number of inputs may be\n"
+"outstanding, and values may arrive in any order.  The top rung is\n"
+"max_fidelity.  The search stops once the sum of the fidelities handed out\n"
+"reaches budget.\n"
+"\n"
+"New configurations are drawn uniformly at random (sampler 0), from a Sobol\n"
+"sequence (1), or by differential evolution from the best configurations on\n"
+"the highest rung with three values, crossed with a random point (2).\n"
+"\n"
+"Hyper-parameters:\n"
+"name\t\trequired\ttype\t\tDefault\tDescription\n"
+"lower\t\toptional\tfnt_vect_t\tnone\tLower bounds on search region.\n"
+"upper\t\toptional\tfnt_vect_t\tnone\tUpper bounds on search region.\n"
+"min_fidelity\toptional\tdouble\t\t1\tLowest fidelity.\n"
+"max_fidelity\toptional\tdouble\t\t81\tHighest fidelity.\n"
+"eta\t\toptional\tdouble\t\t3\tReduction factor between rungs.\n"
+"early_stop\toptional\tint\t\t0\tRungs skipped above min_fidelity.\n"
+"budget\t\toptional\tdouble\t\t100*max\tSum of fidelities to spend.\n"
+"sampler\t\toptional\tint\t\t0\tNew configurations, see above.\n"
+"\n"
+"Results:\n"
+"name\t\ttype\t\tDescription\n"
+"minimum x\tfnt_vect_t\tBest input on the highest rung with values.\n"
+"minimum f\tdouble\t\tObjective value at minimum x.\n"
+"configurations\tint\t\tNumber of configurations sampled.\n"
+"evaluations\tint\t\tNumber of evaluations.\n"
+"cost\t\tdouble\t\tSum of the fidelities evaluated.\n"
+"\n"
+"References:\n"
+"L. Li, K. Jamieson, A. Rostamizadeh, E. Gonina, J. Ben-tzur, M. Hardt,\n"
+"\tB. Recht, A. Talwalkar, A System for Massively Parallel\n"
+"\tHyperparameter Tuning, Proceedings of MLSys 2020.\n"
+"L. Li, K. Jamieson, G. DeSalvo, A. Rostamizadeh, A. Talwalkar,\n"
+"\tHyperband: A Novel Bandit-Based Approach to Hyperparameter\n"
+"\tOptimization, JMLR 18 (2018), 1-52.\n"
+"N. Awad, N. Mallik, F. Hutter, DEHB: Evolutionary Hyperband for\n"
+"\tScalable, Robust and Efficient Hyperparameter Optimization,\n"
+"\tProceedings of IJCAI-21, 2147-2153.\n"
+"S. Joe, F. Y. Kuo, Constructing Sobol sequences with better\n"
+"\ttwo-dimensional projections, SIAM J. Sci. Comput. 30 (2008),\n"
+"\t2635-2654.\n"
+);
+    return FNT_SUCCESS;
+}
+
+
+/* \brief Set any hyper-parameters needed for the method.
+ * \param handle Pointer to the method handle.
+ * \param id The name of the hyper-parameter.
+ * \param value_ptr A pointer to the value being set.
+ * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
+ */
+static int method_hparam_set(void *handle, char *id, void *value_ptr) {
+    if( id == NULL )        { return FNT_FAILURE; }
+    if( value_ptr == NULL ) { return FNT_FAILURE; }
+    if( handle == NULL )    { return FNT_FAILURE; }
+    asha_t *ptr = (asha_t*)handle;
+
+    FNT_HPARAM_SET("min_fidelity", id, double, value_ptr, ptr->min_fidelity);
+    FNT_HPARAM_SET("max_fidelity", id, double, value_ptr, ptr->max_fidelity);
+    FNT_HPARAM_SET("eta", id, double, value_ptr, ptr->eta);
+    FNT_HPARAM_SET("early_stop", id, int, value_ptr, ptr->early_stop);
+    FNT_HPARAM_SET("budget", id, double, value_ptr, ptr->budget);
+
+    if( strncmp("sampler", id, 8) == 0 ) {
+        int sampler = *(int*)value_ptr;
+        if( sampler < asha_random || sampler > asha_de ) {
+            ERROR("ERROR: Unknown sampler %d.\n", sampler);
+            return FNT_FAILURE;
+        }
+        ptr->sampler = sampler;
+        return FNT_SUCCESS;
+    }
+
+    if( strncmp("lower", id, 6) == 0 ) {
+        if( !ptr->has_lower_bounds ) {
+            fnt_vect_calloc(&ptr->lower_bounds, ptr->dim);
+        }
+        ptr->has_lower_bounds = 1;
+        return fnt_vect_copy(&ptr->lower_bounds, value_ptr);
+    }
+
+    if( strncmp("upper", id, 6) == 0 ) {
+        if( !ptr->has_upper_bounds ) {
+            fnt_vect_calloc(&ptr->upper_bounds, ptr->dim);
+        }
+        ptr->has_upper_bounds = 1;
+        return fnt_vect_copy(&ptr->upper_bounds, value_ptr);
+    }
+
+    ERROR("No hyper-parameter named '%s'.\n", id);
+
+    return FNT_FAILURE;
+}
+
+
+/* \brief Get any hyper-parameters values form the method.
+ * \param handle Pointer to the method handle.
+ * \param id The name of the hyper-parameter.
+ * \param value_ptr A pointer to the value being set.
+ * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
+ */
+static int method_hparam_get(void *handle, char *id, void *value_ptr) {
+    asha_t *ptr = (asha_t*)handle;
+    if( ptr == NULL )       { return FNT_FAILURE; }
+    if( id == NULL )        { return FNT_FAILURE; }
+    if( value_ptr == NULL ) { return FNT_FAILURE; }
+
+    FNT_HPARAM_GET("min_fidelity", id, double, ptr->min_fidelity, value_ptr);
+    FNT_HPARAM_GET("max_fidelity", id, double, ptr->max_fidelity, value_ptr);
+    FNT_HPARAM_GET("eta", id, double, ptr->eta, value_ptr);
+    FNT_HPARAM_GET("early_stop", id, int, ptr->early_stop, value_ptr);
+    FNT_HPARAM_GET("budget", id, double, ptr->budget, value_ptr);
+    FNT_HPARAM_GET("sampler", id, int, ptr->sampler, value_ptr);
+    if( ptr->has_lower_bounds ) {
+        FNT_HPARAM_GET_VECT("lower", id, &ptr->lower_bounds, value_ptr);
+    }
+    if( ptr->has_upper_bounds ) {
+        FNT_HPARAM_GET_VECT("upper", id, &ptr->upper_bounds, value_ptr);
+    }
+
+    ERROR("No hyper-parameter named '%s'.\n", id);
+
+    return FNT_FAILURE;
+}
+
+
+/* \brief Hands out jobs, up to capacity, until the budget is spent.  The
+ * last element of each input is the fidelity to evaluate it at.
+ */
+static int method_next_batch(void *handle, fnt_vect_t *vecs, int *tickets, int capacity, int *count) {
+    asha_t *ptr = (asha_t*)handle;
+    if( ptr == NULL )       { return FNT_FAILURE; }
+    if( vecs == NULL )      { return FNT_FAILURE; }
+    if( tickets == NULL )   { return FNT_FAILURE; }
+    if( count == NULL )     { return FNT_FAILURE; }
+
+    *count = 0;
+    if( !ptr->started && asha_start(ptr) != FNT_SUCCESS ) {
+        return FNT_FAILURE;
+    }
+
+    while( *count < capacity && ptr->cost < ptr->budget && ptr->job_count < INT_MAX ) {
+        /* the job arrays share job_capacity, updated by the last */
+        int job = ptr->job_count;
+        int capacity_config = ptr->job_capacity, capacity_rung = ptr->job_capacity;
+        if( asha_reserve((void**)&ptr->job_config, job, &capacity_config, sizeof(int)) != FNT_SUCCESS
+            || asha_reserve((void**)&ptr->job_rung, job, &capacity_rung, sizeof(int)) != FNT_SUCCESS
+            || asha_reserve((void**)&ptr->job_known, job, &ptr->job_capacity, 1) != FNT_SUCCESS ) {
+            return FNT_FAILURE;
+        }
+
+        int c = 0, k = 0;
+        if( asha_job(ptr, &c, &k) != FNT_SUCCESS ) { return FNT_FAILURE; }
+        ptr->job_config[job] = c;
+        ptr->job_rung[job] = k;
+        ptr->job_known[job] = 0;
+        ++ptr->job_count;
+        ++ptr->outstanding;
+
+        double fidelity = asha_fidelity(ptr, k);
+        ptr->cost += fidelity;
+        memcpy(vecs[*count].v, &ptr->configs[c * ptr->n], ptr->n * sizeof(double));
+        FNT_VECT_ELEM(vecs[*count], ptr->n) = fidelity;
+        tickets[*count] = job;
+        ++*count;
+    }
+
+    return FNT_SUCCESS;
+}
+
+
+static int method_next(void *handle, fnt_vect_t *vec) {
+    int ticket = 0, count = 0;
+
+    if( method_next_batch(handle, vec, &ticket, 1, &count) != FNT_SUCCESS ) {
+        return FNT_FAILURE;
+    }
+    if( count == 0 ) {
+        ERROR("ERROR: No input needed, the budget is spent.\n");
+        return FNT_FAILURE;
+    }
+
+    return FNT_SUCCESS;
+}
+
+
+static int method_value_ticket(void *handle, int ticket, double value) {
+    asha_t *ptr = (asha_t*)handle;
+    if( ptr == NULL )       { return FNT_FAILURE; }
+    if( ticket < 0 || ticket >= ptr->job_count || ptr->job_known[ticket] ) {
+        ERROR("ERROR: Ticket %d is not outstanding.\n", ticket);
+        return FNT_FAILURE;
+    }
+
+    int c = ptr->job_config[ticket];
+    int k = ptr->job_rung[ticket];
+    asha_rung_t *r = &ptr->rung[k];
+    if( asha_reserve((void**)&r->entries, r->count, &r->capacity, sizeof(asha_entry_t)) != FNT_SUCCESS ) {
+        return FNT_FAILURE;
+    }
+    ptr->job_known[ticket] = 1;
+    --ptr->outstanding;
+
+    /* keep the rung sorted, so its top 1/eta are its first entries */
+    int lo = 0, hi = r->count;
+    while( lo < hi ) {
+        int mid = (lo + hi) / 2;
+        if( r->entries[mid].value <= value )    { lo = mid + 1; } else { hi = mid; }
+    }
+    memmove(&r->entries[lo + 1], &r->entries[lo], (r->count - lo) * sizeof(asha_entry_t));
+    r->entries[lo].value = value;
+    r->entries[lo].config = c;
+    ++r->count;
+
+    /* values on higher rungs are more faithful, so they take precedence */
+    if( k > ptr->minimum_rung || (k == ptr->minimum_rung && value < ptr->minimum_f) ) {
+        memcpy(ptr->minimum_x.v, &ptr->configs[c * ptr->n], ptr->n * sizeof(double));
+        FNT_VECT_ELEM(ptr->minimum_x, ptr->n) = asha_fidelity(ptr, k);
+        ptr->minimum_f = value;
+        ptr->minimum_rung = k;
+        DEBUG("DEBUG: New best value %g on rung %d.\n", value, k);
+    }
+
+    return FNT_SUCCESS;
+}
+
+
+/* \brief A value without a ticket belongs to the oldest outstanding job.
+ */
+static int method_value(void *handle, fnt_vect_t *vec, double value) {
+    asha_t *ptr = (asha_t*)handle;
+    if( ptr == NULL )       { return FNT_FAILURE; }
+    (void)vec;
+
+    while( ptr->oldest < ptr->job_count && ptr->job_known[ptr->oldest] ) {
+        ++ptr->oldest;
+    }
+    if( ptr->oldest == ptr->job_count ) {
+        ERROR("ERROR: Value received, but no jobs are outstanding.\n");
+        return FNT_FAILURE;
+    }
+
+    return method_value_ticket(handle, ptr->oldest, value);
+}
+
+
+static int method_done(void *handle) {
+    asha_t *ptr = (asha_t*)handle;
+    if( ptr == NULL )       { return FNT_FAILURE; }
+
+    if( ptr->cost < ptr->budget || ptr->outstanding > 0 ) {
+        return FNT_CONTINUE;
+    }
+
+    return FNT_DONE;
+}
+
+
+static int method_result(void *handle, char *id, void *value_ptr) {
+    asha_t *ptr = (asha_t*)handle;
+    if( ptr == NULL )       { return FNT_FAILURE; }
+
+    FNT_RESULT_GET_VECT("minimum x", id, ptr->minimum_x, value_ptr);
+    FNT_RESULT_GET("minimum f", id, double, ptr->minimum_f, value_ptr);
+    FNT_RESULT_GET("configurations", id, int, ptr->config_count, value_ptr);
+    FNT_RESULT_GET("evaluations", id, int, ptr->job_count, value_ptr);
+    FNT_RESULT_GET("cost", id, double, ptr->cost, value_ptr);
+
+    ERROR("No result named '%s'.\n", id);
+
+    return FNT_FAILURE;
+}
+
+
+/* MARK: Method descriptor */
+
+fnt_method_descriptor_t fnt_method_descriptor = {
+    .abi_version       = FNT_METHOD_ABI_VERSION,
+    .capabilities      = FNT_METHOD_CAP_BATCH,
+    .name              = method_name,
+    .init              = method_init,
+    .free              = method_free,
+    .reset             = method_reset,
+    .info              = method_info,
+    .hparam_set        = method_hparam_set,
+    .hparam_get        = method_hparam_get,
+    .next              = method_next,
+    .next_batch        = method_next_batch,
+    .value             = method_value,
+    .value_ticket      = method_value_ticket,
+    .done              = method_done,
+    .result            = method_result,
+};
@@ -4,6 +4,7 @@
  *
  * Copyright (c) 2024 Bryan Franklin. All rights reserved.
  */
+#include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -29,6 +30,19 @@ typedef struct bisection {
     double x_tol;
     double f_tol;
 
+    /* sections per round when handing out batches */
+    int k;
+
+    /* round of inputs handed out by method_next_batch */
+    int round_active;
+    int round_count;
+    int round_issued;
+    int round_known;
+    int round_capacity;
+    double *round_x;
+    double *round_f;
+    unsigned char *round_told;
+
     /* current bounds */
     double a;
     double b;
@@ -50,7 +64,7 @@ typedef struct bisection {
  * \param size Size of the name buffer in bytes.
  * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
  */
-int method_name(char *name, int size) {
+static int method_name(char *name, int size) {
     if( snprintf(name, size, "bisection") >= size ) {
         return FNT_FAILURE;
     }
@@ -62,7 +76,7 @@ int method_name(char *name, int size) {
 /* \brief Initialize intenal state for method.
  * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
  */
-int method_init(void **handle_ptr, int dimensions) {
+static int method_init(void **handle_ptr, int dimensions) {
     if( handle_ptr == NULL )    { return FNT_FAILURE; }
     bisection_t *ptr = calloc(1, sizeof(bisection_t));
     if( ptr == NULL )           { return FNT_FAILURE; }
@@ -74,17 +88,21 @@ int method_init(void **handle_ptr, int dimensions) {
     ptr->f_tol = 1e-6;
     ptr->lower_bound = -1e6;
     ptr->upper_bound = 1e6;
+    ptr->k = 2;
 
     return FNT_SUCCESS;
 }
 
 
-int method_free(void **handle_ptr) {
+static int method_free(void **handle_ptr) {
     if( handle_ptr == NULL )    { return FNT_FAILURE; }
     if( *handle_ptr == NULL )   { return FNT_FAILURE; }
     bisection_t *ptr = (bisection_t*)*handle_ptr;
 
     /* free any memory allocated by method */
+    free(ptr->round_x);
+    free(ptr->round_f);
+    free(ptr->round_told);
 
     free(ptr);  *handle_ptr = ptr = NULL;
 
@@ -92,10 +110,28 @@ int method_free(void **handle_ptr) {
 }
 
 
+/* \brief Return the method to its initial state, keeping hyper-parameters.
+ * \param handle Pointer to the method handle.
+ * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
+ */
+static int method_reset(void *handle) {
+    bisection_t *ptr = (bisection_t*)handle;
+    if( ptr == NULL )       { return FNT_FAILURE; }
+
+    ptr->state = initial;
+    ptr->a = ptr->b = 0.0;
+    ptr->f_a = ptr->f_b = 0.0;
+    ptr->root_x = 0.0;
+    ptr->round_active = 0;
+
+    return FNT_SUCCESS;
+}
+
+
 /* \brief Display information about the method to the console.
  * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
  */
-int method_info() {
+static int method_info() {
     printf(
 "The bisection method is a root finding technique that works by repeatedly "
 "dividing a search region in half until it converges on the root."
@@ -106,9 +142,11 @@ int method_info() {
 "upper\tREQUIRED\tdouble\t1e6\tUpper bound of the region.\n"
 "f_tol\toptional\tdouble\t1e-6\tTerminates when |f(x)| < f_tol.\n"
 "x_tol\toptional\tdouble\t1e-6\tTerminates when |a-b| < x_tol.\n"
+"k\toptional\tint\t2\tSections per round when inputs are requested in\n"
+"\t\t\t\tbatches, each round evaluates k-1 interior points.\n"
 "\n"
 "References\n"
-"https://en.wikipedia.org/wiki/Bisection_method"
+"https://en.wikipedia.org/wiki/Bisection_method\n"
 );
     return FNT_SUCCESS;
 }
@@ -119,7 +157,7 @@ int method_info() {
  * \param value_ptr A pointer to the value being set.
  * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
  */
-int method_hparam_set(void *handle, char *id, void *value_ptr) {
+static int method_hparam_set(void *handle, char *id, void *value_ptr) {
     if( id == NULL )        { return FNT_FAILURE; }
     if( value_ptr == NULL ) { return FNT_FAILURE; }
     if( handle == NULL )    { return FNT_FAILURE; }
@@ -129,6 +167,7 @@ int method_hparam_set(void *handle, char *id, void *value_ptr) {
     FNT_HPARAM_SET("x_tol", id, double, value_ptr, ptr->x_tol);
     FNT_HPARAM_SET("lower", id, double, value_ptr, ptr->lower_bound);
     FNT_HPARAM_SET("upper", id, double, value_ptr, ptr->upper_bound);
+    FNT_HPARAM_SET("k", id, int, value_ptr, ptr->k);
 
     ERROR("No hyper-parameter named '%s'.\n", id);
 
@@ -136,7 +175,7 @@ int method_hparam_set(void *handle, char *id, void *value_ptr) {
 }
 
 
-int method_hparam_get(void *handle, char *id, void *value_ptr) {
+static int method_hparam_get(void *handle, char *id, void *value_ptr) {
     if( id == NULL )        { return FNT_FAILURE; }
     if( value_ptr == NULL ) { return FNT_FAILURE; }
     bisection_t *ptr = (bisection_t*)handle;
@@ -145,6 +184,7 @@ int method_hparam_get(void *handle, char *id, void *value_ptr) {
     FNT_HPARAM_GET("x_tol", id, double, ptr->x_tol, value_ptr);
     FNT_HPARAM_GET("lower", id, double, ptr->lower_bound, value_ptr);
     FNT_HPARAM_GET("upper", id, double, ptr->upper_bound, value_ptr);
+    FNT_HPARAM_GET("k", id, int, ptr->k, value_ptr);
 
     ERROR("No hyper-parameter named '%s'.\n", id);
 
@@ -152,7 +192,7 @@ int method_hparam_get(void *handle, char *id, void *value_ptr) {
 }
 
 
-int method_next(void *handle, fnt_vect_t *vec) {
+static int method_next(void *handle, fnt_vect_t *vec) {
     if( handle == NULL )    { return FNT_FAILURE; }
     if( vec == NULL )       { return FNT_FAILURE; }
     bisection_t *ptr = (bisection_t*)handle;
@@ -178,34 +218,39 @@ int method_next(void *handle, fnt_vect_t *vec) {
 }
 
 
-int method_value(void *handle, fnt_vect_t *vec, double value) {
+/* Check the values at both bounds, ordering them so that f(a) < f(b). */
+static int bisection_bracket(bisection_t *ptr) {
+    /* ensure that f(a) < f(b) */
+    if( ptr->f_b < ptr->f_a ) {
+        /* swap a & b if order of f(a) & f(b) are awkward. */
+        double tmp;
+        tmp = ptr->b;       ptr->b = ptr->a;        ptr->a = tmp;
+        tmp = ptr->f_b;     ptr->f_b = ptr->f_a;    ptr->f_a = tmp;
+    }
+
+    /* check that endpoints meet bisection precondition, f(a)*f(b) < 0 */
+    if( ptr->f_a > 0.0 ) {
+        ERROR("Lower bound is not less than zero (f(%g)=%g)\n", ptr->a, ptr->f_a); 
+        return FNT_FAILURE;
+    }
+    if( ptr->f_b < 0.0 ) {
+        ERROR("Upper bound is not greater than zero (f(%g)=%g)\n", ptr->b, ptr->f_b); 
+        return FNT_FAILURE;
+    }
+
+    ptr->state = running;
+    return FNT_SUCCESS;
+}
+
+
+static int method_value(void *handle, fnt_vect_t *vec, double value) {
     if( handle == NULL )    { return FNT_FAILURE; }
     bisection_t *ptr = (bisection_t*)handle;
 
     /* update method using value */
     if( ptr->state == initial2 ) {
         ptr->f_b = value;
-
-        /* ensure that f(a) < f(b) */
-        if( ptr->f_b < ptr->f_a ) {
-            /* swap a & b if order of f(a) & f(b) are awkward. */
-            double tmp;
-            tmp = ptr->b;       ptr->b = ptr->a;        ptr->a = tmp;
-            tmp = ptr->f_b;     ptr->f_b = ptr->f_a;    ptr->f_a = tmp;
-        }
-
-        /* check that endpoints meet bisection precondition, f(a)*f(b) < 0 */
-        if( ptr->f_a > 0.0 ) {
-            ERROR("Lower bound is not less than zero (f(%g)=%g)\n", ptr->a, ptr->f_a); 
-            return FNT_FAILURE;
-        }
-        if( ptr->f_b < 0.0 ) {
-            ERROR("Upper bound is not greater than zero (f(%g)=%g)\n", ptr->b, ptr->f_b); 
-            return FNT_FAILURE;
-        }
-
-        ptr->state = running;
-        return FNT_SUCCESS;
+        return bisection_bracket(ptr);
     } else if( ptr->state == initial ) {
         ptr->f_a = value;
         ptr->state = initial2;
@@ -236,7 +281,145 @@ int method_value(void *handle, fnt_vect_t *vec, double value) {
 }
 
 
-int method_done(void *handle) {
+/* MARK: k-section rounds */
+
+/* Start a round: both bounds at first, then the k-1 points dividing [a, b]
+ * into k equal sections. */
+static int bisection_round_start(bisection_t *ptr) {
+    if( ptr->k < 2 ) {
+        ERROR("k must be at least 2, currently set to %d.\n", ptr->k);
+        return FNT_FAILURE;
+    }
+
+    int count = ptr->state == initial ? 2 : ptr->k - 1;
+    if( count > ptr->round_capacity ) {
+        double *x = realloc(ptr->round_x, count * sizeof(double));
+        if( x != NULL ) { ptr->round_x = x; }
+        double *f = realloc(ptr->round_f, count * sizeof(double));
+        if( f != NULL ) { ptr->round_f = f; }
+        unsigned char *told = realloc(ptr->round_told, count * sizeof(unsigned char));
+        if( told != NULL ) { ptr->round_told = told; }
+        if( x == NULL || f == NULL || told == NULL ) {
+            ERROR("ERROR: Failed to allocate a round of %d inputs.\n", count);
+            return FNT_FAILURE;
+        }
+        ptr->round_capacity = count;
+    }
+
+    if( ptr->state == initial ) {
+        ptr->a = ptr->lower_bound;
+        ptr->b = ptr->upper_bound;
+        ptr->round_x[0] = ptr->a;
+        ptr->round_x[1] = ptr->b;
+    } else {
+        for(int i=0; i<count; ++i) {
+            ptr->round_x[i] = ptr->a + (ptr->b - ptr->a) * (i+1) / ptr->k;
+        }
+    }
+    memset(ptr->round_told, '\0', count * sizeof(unsigned char));
+    ptr->round_count = count;
+    ptr->round_issued = ptr->round_known = 0;
+    ptr->round_active = 1;
+
+    return FNT_SUCCESS;
+}
+
+
+/* Keep the section whose ends straddle zero, walking from a to b. */
+static int bisection_round_finish(bisection_t *ptr) {
+    ptr->round_active = 0;
+
+    if( ptr->state == initial ) {
+        ptr->f_a = ptr->round_f[0];
+        ptr->f_b = ptr->round_f[1];
+        return bisection_bracket(ptr);
+    }
+
+    double x_prev = ptr->a;
+    double f_prev = ptr->f_a;
+    for(int i=0; i<ptr->round_count; ++i) {
+        double x = ptr->round_x[i];
+        double f = ptr->round_f[i];
+        if( f == 0.0 ) {
+            ptr->a = ptr->b = ptr->root_x = x;
+            ptr->f_a = ptr->f_b = 0.0;
+            ptr->state = done;
+            return FNT_SUCCESS;
+        }
+        if( f > 0.0 ) {
+            ptr->a = x_prev;    ptr->f_a = f_prev;
+            ptr->b = x;         ptr->f_b = f;
+            return FNT_SUCCESS;
+        }
+        if( isnan(f) ) {
+            ERROR("Value (%g) is not comparable to zero.\n", f);
+            return FNT_FAILURE;
+        }
+        x_prev = x;
+        f_prev = f;
+    }
+
+    /* every interior value is negative */
+    ptr->a = x_prev;
+    ptr->f_a = f_prev;
+
+    return FNT_SUCCESS;
+}
+
+
+/* \brief Hand out the inputs of the current round.
+ * count is zero while values for the round are still outstanding.
+ * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
+ */
+static int method_next_batch(void *handle, fnt_vect_t *vecs, int *tickets, int capacity, int *count) {
+    if( handle == NULL )    { return FNT_FAILURE; }
+    if( vecs == NULL )      { return FNT_FAILURE; }
+    if( tickets == NULL )   { return FNT_FAILURE; }
+    if( count == NULL )     { return FNT_FAILURE; }
+    bisection_t *ptr = (bisection_t*)handle;
+    *count = 0;
+
+    if( ptr->state == initial2 ) {
+        ERROR("ERROR: Batches cannot be mixed with single inputs.\n");
+        return FNT_FAILURE;
+    }
+    if( !ptr->round_active && ptr->state != done ) {
+        if( bisection_round_start(ptr) != FNT_SUCCESS ) { return FNT_FAILURE; }
+    }
+
+    while( ptr->round_active && *count < capacity && ptr->round_issued < ptr->round_count ) {
+        FNT_VECT_ELEM(vecs[*count], 0) = ptr->round_x[ptr->round_issued];
+        tickets[*count] = ptr->round_issued;
+        ptr->round_issued += 1;
+        *count += 1;
+    }
+
+    return FNT_SUCCESS;
+}
+
+
+static int method_value_ticket(void *handle, int ticket, double value) {
+    if( handle == NULL )    { return FNT_FAILURE; }
+    bisection_t *ptr = (bisection_t*)handle;
+
+    if( !ptr->round_active || ticket < 0 || ticket >= ptr->round_issued
+        || ptr->round_told[ticket] ) {
+        ERROR("ERROR: Ticket %d is not outstanding.\n", ticket);
+        return FNT_FAILURE;
+    }
+    ptr->round_f[ticket] = value;
+    ptr->round_told[ticket] = 1;
+    ptr->round_known += 1;
+
+    if( ptr->round_known < ptr->round_count ) {
+        return FNT_SUCCESS;
+    }
+
+    return bisection_round_finish(ptr);
+}
+
+
+static int method_done(void *handle) {
     if( handle == NULL )    { return FNT_FAILURE; }
     bisection_t *ptr = (bisection_t*)handle;
 
@@ -267,7 +450,7 @@ int method_done(void *handle) {
 }
 
 
-int method_result(void *handle, char *id, void *value_ptr) {
+static int method_result(void *handle, char *id, void *value_ptr) {
     if( handle == NULL )    { return FNT_FAILURE; }
     bisection_t *ptr = (bisection_t*)handle;
 
@@ -278,3 +461,24 @@ int method_result(void *handle, char *id, void *value_ptr) {
 
     return FNT_FAILURE;
 }
+
+
+/* MARK: Method descriptor */
+
+fnt_method_descriptor_t fnt_method_descriptor = {
+    .abi_version       = FNT_METHOD_ABI_VERSION,
+    .capabilities      = FNT_METHOD_CAP_BATCH,
+    .name              = method_name,
+    .init              = method_init,
+    .free              = method_free,
+    .reset             = method_reset,
+    .info              = method_info,
+    .hparam_set        = method_hparam_set,
+    .hparam_get        = method_hparam_get,
+    .next              = method_next,
+    .next_batch        = method_next_batch,
+    .value             = method_value,
+    .value_ticket      = method_value_ticket,
+    .done              = method_done,
+    .result            = method_result,
+};
@@ -26,6 +26,8 @@ typedef struct brent_dekker {
     brent_dekker_state_t state;
 
     /* hyper-parameters */
+    double x_0;     /* lower bound of search region */
+    double x_1;     /* upper bound of search region */
     double macheps; /* machine epsilon */
     double t;       /* a positive tolerance */
 
@@ -52,7 +54,7 @@ typedef struct brent_dekker {
  * \param size Size of the name buffer in bytes.
  * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
  */
-int method_name(char *name, int size) {
+static int method_name(char *name, int size) {
     if( snprintf(name,  size,  "brent-dekker") >= size ) {
         return FNT_FAILURE;
     }
@@ -64,7 +66,7 @@ int method_name(char *name, int size) {
 /* \brief Initialize intenal state for method.
  * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
  */
-int method_init(void **handle_ptr, int dimensions) {
+static int method_init(void **handle_ptr, int dimensions) {
     if( handle_ptr == NULL )    { return FNT_FAILURE; }
     brent_dekker_t *ptr = calloc(1, sizeof(brent_dekker_t));
     if( ptr == NULL )           { return FNT_FAILURE; }
@@ -84,7 +86,7 @@ int method_init(void **handle_ptr, int dimensions) {
 }
 
 
-int method_free(void **handle_ptr) {
+static int method_free(void **handle_ptr) {
     if( handle_ptr == NULL )    { return FNT_FAILURE; }
     if( *handle_ptr == NULL )   { return FNT_FAILURE; }
     brent_dekker_t *ptr = (brent_dekker_t*)*handle_ptr;
@@ -97,10 +99,28 @@ int method_free(void **handle_ptr) {
 }
 
 
+/* \brief Return the method to its initial state, keeping hyper-parameters.
+ * \param handle Pointer to the method handle.
+ * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
+ */
+static int method_reset(void *handle) {
+    brent_dekker_t *ptr = (brent_dekker_t*)handle;
+    if( ptr == NULL )       { return FNT_FAILURE; }
+
+    ptr->state = brent_dekker_initial;
+    ptr->a = ptr->b = ptr->c = 0.0;
+    ptr->f_a = ptr->f_b = ptr->f_c = 0.0;
+    ptr->d = ptr->e = 0.0;
+    ptr->root_x = 0.0;
+
+    return FNT_SUCCESS;
+}
+
+
 /* \brief Display information about the method to the console.
  * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
  */
-int method_info() {
+static int method_info() {
     printf(
 "The Brent-Dekker method is a root finding method, similar to bisection,\n"
 "that uses multiple strategies that, in general, reduce the search space\n"
@@ -128,7 +148,7 @@ int method_info() {
  * \param value_ptr A pointer to the value being set.
  * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
  */
-int method_hparam_set(void *handle, char *id, void *value_ptr) {
+static int method_hparam_set(void *handle, char *id, void *value_ptr) {
     if( handle == NULL )    { return FNT_FAILURE; }
     brent_dekker_t *ptr = (brent_dekker_t*)handle;
     if( id == NULL )        { return FNT_FAILURE; }
@@ -136,8 +156,8 @@ int method_hparam_set(void *handle, char *id, void *value_ptr) {
 
     FNT_HPARAM_SET("macheps", id, double, value_ptr, ptr->macheps);
     FNT_HPARAM_SET("t", id, double, value_ptr, ptr->t);
-    FNT_HPARAM_SET("x_0", id, double, value_ptr, ptr->a);
-    FNT_HPARAM_SET("x_1", id, double, value_ptr, ptr->b);
+    FNT_HPARAM_SET("x_0", id, double, value_ptr, ptr->x_0);
+    FNT_HPARAM_SET("x_1", id, double, value_ptr, ptr->x_1);
 
     ERROR("No hyper-parameter named '%s'.\n", id);
 
@@ -145,7 +165,7 @@ int method_hparam_set(void *handle, char *id, void *value_ptr) {
 }
 
 
-int method_hparam_get(void *handle, char *id, void *value_ptr) {
+static int method_hparam_get(void *handle, char *id, void *value_ptr) {
     if( handle == NULL )    { return FNT_FAILURE; }
     brent_dekker_t *ptr = (brent_dekker_t*)handle;
     if( id == NULL )        { return FNT_FAILURE; }
@@ -153,8 +173,8 @@ int method_hparam_get(void *handle, char *id, void *value_ptr) {
 
     FNT_HPARAM_GET("macheps", id, double, ptr->macheps, value_ptr);
     FNT_HPARAM_GET("t", id, double, ptr->t, value_ptr);
-    FNT_HPARAM_GET("x_0", id, double, ptr->a, value_ptr);
-    FNT_HPARAM_GET("x_1", id, double, ptr->b, value_ptr);
+    FNT_HPARAM_GET("x_0", id, double, ptr->x_0, value_ptr);
+    FNT_HPARAM_GET("x_1", id, double, ptr->x_1, value_ptr);
 
     ERROR("No hyper-parameter named '%s'.\n", id);
 
@@ -162,7 +182,7 @@ int method_hparam_get(void *handle, char *id, void *value_ptr) {
 }
 
 
-int method_next(void *handle, fnt_vect_t *vec) {
+static int method_next(void *handle, fnt_vect_t *vec) {
     if( handle == NULL )    { return FNT_FAILURE; }
     brent_dekker_t *ptr = (brent_dekker_t*)handle;
     if( vec == NULL )       { return FNT_FAILURE; }
@@ -170,6 +190,8 @@ int method_next(void *handle, fnt_vect_t *vec) {
 
     /* fill vector pointed to by vec with next input to try */
     if( ptr->state == brent_dekker_initial ) {
+        ptr->a = ptr->x_0;
+        ptr->b = ptr->x_1;
         FNT_VECT_ELEM(*vec, 0) = ptr->a;
         return FNT_SUCCESS;
     }
@@ -181,7 +203,7 @@ int method_next(void *handle, fnt_vect_t *vec) {
 }
 
 
-int method_value(void *handle, fnt_vect_t *vec, double value) {
+static int method_value(void *handle, fnt_vect_t *vec, double value) {
     if( handle == NULL )    { return FNT_FAILURE; }
     brent_dekker_t *ptr = (brent_dekker_t*)handle;
     if( vec == NULL )       { return FNT_FAILURE; }
@@ -315,7 +337,7 @@ int method_value(void *handle, fnt_vect_t *vec, double value) {
 }
 
 
-int method_done(void *handle) {
+static int method_done(void *handle) {
     if( handle == NULL )    { return FNT_FAILURE; }
     brent_dekker_t *ptr = (brent_dekker_t*)handle;
 
@@ -332,7 +354,7 @@ int method_done(void *handle) {
 }
 
 
-int method_result(void *handle, char *id, void *value_ptr) {
+static int method_result(void *handle, char *id, void *value_ptr) {
     if( handle == NULL )    { return FNT_FAILURE; }
     brent_dekker_t *ptr = (brent_dekker_t*)handle;
 
@@ -342,3 +364,22 @@ int method_result(void *handle, char *id, void *value_ptr) {
 
     return FNT_FAILURE;
 }
+
+
+/* MARK: Method descriptor */
+
+fnt_method_descriptor_t fnt_method_descriptor = {
+    .abi_version       = FNT_METHOD_ABI_VERSION,
+    .capabilities      = FNT_METHOD_CAP_NONE,
+    .name              = method_name,
+    .init              = method_init,
+    .free              = method_free,
+    .reset             = method_reset,
+    .info              = method_info,
+    .hparam_set        = method_hparam_set,
+    .hparam_get        = method_hparam_get,
+    .next              = method_next,
+    .value             = method_value,
+    .done              = method_done,
+    .result            = method_result,
+};
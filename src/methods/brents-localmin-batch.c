@@ -0,0 +1,417 @@
+/*
+ * brents-localmin-batch.c
+ * fnt: Numerical Toolbox
+ *
+ * Copyright (c) 2024 Bryan Franklin. All rights reserved.
+ */
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../fnt.h"
+#include "../fnt_coro.h"
+
+
+/* MARK: Method type definitions */
+
+#define BRENT_BATCH_MAX_K   32
+#define BRENT_BATCH_KEEP    (BRENT_BATCH_MAX_K + 4)
+
+typedef struct brent_batch {
+
+    /* hyper-parameters */
+    double x_0;
+    double x_1;
+    double eps;
+    double t;
+    int k;
+
+    /* method state */
+    fnt_coro_t co;
+    double a;
+    double b;
+    double x;               /* best point so far */
+    double fx;
+    int have_x;
+
+    /* evaluated points inside [a, b], in increasing order */
+    int kept;
+    double kept_x[BRENT_BATCH_KEEP];
+    double kept_f[BRENT_BATCH_KEEP];
+
+    /* points requested by the current round */
+    int count;
+    double u[BRENT_BATCH_MAX_K + 1];
+
+    /* result */
+    double min_x;
+    double min_fx;
+
+} brent_batch_t;
+
+
+/* MARK: Internal functions */
+
+/* A point is worth evaluating if it is inside the bracket and not within
+ * tol of any point already evaluated or requested. */
+static int brent_batch_usable(brent_batch_t *ptr, double u, double tol) {
+    if( !(u > ptr->a + tol && u < ptr->b - tol) ) { return 0; }
+
+    for(int i=0; i<ptr->kept; ++i) {
+        if( fabs(u - ptr->kept_x[i]) < tol )    { return 0; }
+    }
+    for(int i=0; i<ptr->count; ++i) {
+        if( fabs(u - ptr->u[i]) < tol )         { return 0; }
+    }
+
+    return 1;
+}
+
+
+/* Choose the points for one round: the k-1 points dividing the bracket into
+ * k sections, plus the vertex of a parabola through the best point and its
+ * neighbours once they are known. */
+static void brent_batch_plan(brent_batch_t *ptr, double tol) {
+    ptr->count = 0;
+
+    for(int i=1; i<ptr->k; ++i) {
+        double u = ptr->a + (ptr->b - ptr->a) * i / ptr->k;
+        if( brent_batch_usable(ptr, u, tol) ) {
+            ptr->u[ptr->count++] = u;
+        }
+    }
+
+    int j = 0;
+    for(int i=1; i<ptr->kept; ++i) {
+        if( ptr->kept_f[i] < ptr->kept_f[j] ) { j = i; }
+    }
+    if( j > 0 && j < ptr->kept-1 ) {
+        double x = ptr->kept_x[j],      fx = ptr->kept_f[j];
+        double w = ptr->kept_x[j-1],    fw = ptr->kept_f[j-1];
+        double v = ptr->kept_x[j+1],    fv = ptr->kept_f[j+1];
+        double r = (x - w) * (fx - fv);
+        double q = (x - v) * (fx - fw);
+        double p = (x - v) * q - (x - w) * r;
+        q = 2.0 * (q - r);
+        if( q != 0.0 ) {
+            double u = x - p / q;
+            if( brent_batch_usable(ptr, u, tol) ) {
+                DEBUG("DEBUG: Parabolic prediction at %g.\n", u);
+                ptr->u[ptr->count++] = u;
+            }
+        }
+    }
+
+    /* bracket too narrow for new sections, step away from x as Brent does */
+    if( ptr->count == 0 ) {
+        double m = 0.5 * (ptr->a + ptr->b);
+        ptr->u[ptr->count++] = ptr->x + (ptr->x < m ? tol : -tol);
+    }
+}
+
+
+/* Merge a round's values, then narrow the bracket to the neighbours of the
+ * best point. */
+static void brent_batch_update(brent_batch_t *ptr, double *values) {
+    for(int i=0; i<ptr->count; ++i) {
+        /* insertion keeps kept_x sorted */
+        int pos = ptr->kept;
+        while( pos > 0 && ptr->kept_x[pos-1] > ptr->u[i] ) {
+            ptr->kept_x[pos] = ptr->kept_x[pos-1];
+            ptr->kept_f[pos] = ptr->kept_f[pos-1];
+            --pos;
+        }
+        ptr->kept_x[pos] = ptr->u[i];
+        ptr->kept_f[pos] = values[i];
+        ++ptr->kept;
+    }
+
+    int j = 0;
+    for(int i=1; i<ptr->kept; ++i) {
+        if( ptr->kept_f[i] < ptr->kept_f[j] ) { j = i; }
+    }
+    ptr->x = ptr->kept_x[j];
+    ptr->fx = ptr->kept_f[j];
+    ptr->have_x = 1;
+
+    if( j > 0 )             { ptr->a = ptr->kept_x[j-1]; }
+    if( j < ptr->kept-1 )   { ptr->b = ptr->kept_x[j+1]; }
+
+    /* only the best point and the new ends stay inside the bracket */
+    int first = j > 0 ? j-1 : 0;
+    int last = j < ptr->kept-1 ? j+1 : j;
+    ptr->kept = last - first + 1;
+    memmove(ptr->kept_x, &ptr->kept_x[first], ptr->kept * sizeof(double));
+    memmove(ptr->kept_f, &ptr->kept_f[first], ptr->kept * sizeof(double));
+
+    DEBUG("DEBUG: Bracket narrowed to [%g, %g], f(%g) = %g.\n", ptr->a, ptr->b, ptr->x, ptr->fx);
+}
+
+
+/* \brief Method logic, run as a coroutine.
+ * Each round is requested as a single batch.
+ */
+static int brent_batch_body(void *self) {
+    brent_batch_t *ptr = (brent_batch_t*)self;
+    fnt_coro_t *co = &ptr->co;
+
+    FNT_CORO_BEGIN(co);
+
+    ptr->a = ptr->x_0 < ptr->x_1 ? ptr->x_0 : ptr->x_1;
+    ptr->b = ptr->x_0 < ptr->x_1 ? ptr->x_1 : ptr->x_0;
+    ptr->x = 0.5 * (ptr->a + ptr->b);
+    ptr->have_x = 0;
+    ptr->kept = 0;
+
+    for(;;) {
+        /* same stopping criterion as brents-localmin */
+        double m = 0.5 * (ptr->a + ptr->b);
+        double tol = ptr->eps * fabs(ptr->x) + ptr->t;
+        if( ptr->have_x && fabs(ptr->x - m) <= 2.0 * tol - 0.5 * (ptr->b - ptr->a) ) {
+            break;
+        }
+
+        brent_batch_plan(ptr, tol);
+        for(int i=0; i<ptr->count; ++i) {
+            FNT_VECT_ELEM(*fnt_coro_push(co), 0) = ptr->u[i];
+        }
+        FNT_CORO_YIELD(co);
+
+        brent_batch_update(ptr, co->values);
+    }
+
+    ptr->min_x = ptr->x;
+    ptr->min_fx = ptr->fx;
+
+    FNT_CORO_END(co);
+}
+
+
+/* MARK: Functions called by FNT */
+
+/* \brief Provides the name of the method.
+ * \param name Allocated buffer to hold the name.
+ * \param size Size of the name buffer in bytes.
+ * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
+ */
+static int method_name(char *name, int size) {
+    if( snprintf(name, size, "brents-localmin-batch") >= size ) {
+        return FNT_FAILURE;
+    }
+
+    return FNT_SUCCESS;
+}
+
+
+/* \brief Initialize intenal state for method.
+ * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
+ */
+static int method_init(void **handle_ptr, int dimensions) {
+    if( handle_ptr == NULL )    { return FNT_FAILURE; }
+    if( dimensions != 1 ) {
+        ERROR("ERROR: brents-localmin-batch only minimizes functions of one variable.\n");
+        return FNT_FAILURE;
+    }
+    brent_batch_t *ptr = calloc(1, sizeof(brent_batch_t));
+    if( ptr == NULL )           { return FNT_FAILURE; }
+    *handle_ptr = (void*)ptr;
+
+    /* initialize method here */
+    if( fnt_coro_init(&ptr->co, brent_batch_body, ptr, BRENT_BATCH_MAX_K+1, 1) != FNT_SUCCESS ) {
+        free(ptr);  *handle_ptr = NULL;
+        return FNT_FAILURE;
+    }
+    ptr->eps = 1e-10;
+    ptr->t = 1e-6;
+    ptr->k = 4;
+
+    return FNT_SUCCESS;
+}
+
+
+static int method_free(void **handle_ptr) {
+    if( handle_ptr == NULL )    { return FNT_FAILURE; }
+    if( *handle_ptr == NULL )   { return FNT_FAILURE; }
+    brent_batch_t *ptr = (brent_batch_t*)*handle_ptr;
+
+    /* free any memory allocated by method */
+    fnt_coro_free(&ptr->co);
+
+    free(ptr);  *handle_ptr = ptr = NULL;
+
+    return FNT_SUCCESS;
+}
+
+
+/* \brief Return the method to its initial state, keeping hyper-parameters.
+ * \param handle Pointer to the method handle.
+ * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
+ */
+static int method_reset(void *handle) {
+    brent_batch_t *ptr = (brent_batch_t*)handle;
+    if( ptr == NULL )       { return FNT_FAILURE; }
+
+    fnt_coro_reset(&ptr->co);
+    ptr->a = ptr->b = ptr->x = ptr->fx = 0.0;
+    ptr->have_x = ptr->kept = ptr->count = 0;
+    ptr->min_x = ptr->min_fx = 0.0;
+
+    return FNT_SUCCESS;
+}
+
+
+/* \brief Display information about the method to the console.
+ * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
+ */
+static int method_info() {
+    printf(
+"A batched variant of Brent's local minimizer.  Each round requests the\n"
+"k-1 points dividing the bracket into k sections, plus the vertex of a\n"
+"parabola through the best point and its neighbours, as one batch.  The\n"
+"bracket then narrows to the neighbours of the best point, by a factor of\n"
+"at least k/2 per round.\n"
+"\n"
+"Hyper-parameters:\n"
+"name\trequired\ttype\tDefault\tDescription\n"
+"x_0\tREQUIRED\tdouble\tnone\tLower bound of search region.\n"
+"x_1\tREQUIRED\tdouble\tnone\tUpper bound of search region.\n"
+"eps\toptional\tdouble\t1e-10\tRelative tolerance.\n"
+"t\toptional\tdouble\t1e-6\tAbsolute tolerance.\n"
+"k\toptional\tint\t4\tSections per round (2 to 32).\n"
+"\n"
+"References:\n"
+"R. P. Brent, Algorithms for Minimization without Derivatives,\n"
+"\tPrentice-Hall, Englewood Cliffs, New Jersey, 1973, 195 pp.\n"
+"\tISBN 0-13-022335-2.\n"
+"https://maths-people.anu.edu.au/~brent/pub/pub011.html\n"
+);
+    return FNT_SUCCESS;
+}
+
+
+/* \brief Set any hyper-parameters needed for the method.
+ * \param id The name of the hyper-parameter.
+ * \param value_ptr A pointer to the value being set.
+ * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
+ */
+static int method_hparam_set(void *handle, char *id, void *value_ptr) {
+    if( id == NULL )        { return FNT_FAILURE; }
+    if( value_ptr == NULL ) { return FNT_FAILURE; }
+    if( handle == NULL )    { return FNT_FAILURE; }
+    brent_batch_t *ptr = (brent_batch_t*)handle;
+
+    FNT_HPARAM_SET("x_0", id, double, value_ptr, ptr->x_0);
+    FNT_HPARAM_SET("x_1", id, double, value_ptr, ptr->x_1);
+    FNT_HPARAM_SET("eps", id, double, value_ptr, ptr->eps);
+    FNT_HPARAM_SET("t", id, double, value_ptr, ptr->t);
+
+    if( strncmp("k", id, 2) == 0 ) {
+        int k = *(int*)value_ptr;
+        if( k < 2 || k > BRENT_BATCH_MAX_K ) {
+            ERROR("ERROR: k must be between 2 and %d, got %d.\n", BRENT_BATCH_MAX_K, k);
+            return FNT_FAILURE;
+        }
+        ptr->k = k;
+        return FNT_SUCCESS;
+    }
+
+    ERROR("No hyper-parameter named '%s'.\n", id);
+
+    return FNT_FAILURE;
+}
+
+
+static int method_hparam_get(void *handle, char *id, void *value_ptr) {
+    if( id == NULL )        { return FNT_FAILURE; }
+    if( value_ptr == NULL ) { return FNT_FAILURE; }
+    if( handle == NULL )    { return FNT_FAILURE; }
+    brent_batch_t *ptr = (brent_batch_t*)handle;
+
+    FNT_HPARAM_GET("x_0", id, double, ptr->x_0, value_ptr);
+    FNT_HPARAM_GET("x_1", id, double, ptr->x_1, value_ptr);
+    FNT_HPARAM_GET("eps", id, double, ptr->eps, value_ptr);
+    FNT_HPARAM_GET("t", id, double, ptr->t, value_ptr);
+    FNT_HPARAM_GET("k", id, int, ptr->k, value_ptr);
+
+    ERROR("No hyper-parameter named '%s'.\n", id);
+
+    return FNT_FAILURE;
+}
+
+
+static int method_next(void *handle, fnt_vect_t *vec) {
+    brent_batch_t *ptr = (brent_batch_t*)handle;
+    if( ptr == NULL )       { return FNT_FAILURE; }
+    if( vec == NULL )       { return FNT_FAILURE; }
+    if( vec->v == NULL )    { return FNT_FAILURE; }
+
+    return fnt_coro_next(&ptr->co, vec);
+}
+
+
+static int method_next_batch(void *handle, fnt_vect_t *vecs, int *tickets, int capacity, int *count) {
+    brent_batch_t *ptr = (brent_batch_t*)handle;
+    if( ptr == NULL )       { return FNT_FAILURE; }
+
+    return fnt_coro_next_batch(&ptr->co, vecs, tickets, capacity, count);
+}
+
+
+static int method_value(void *handle, fnt_vect_t *vec, double value) {
+    brent_batch_t *ptr = (brent_batch_t*)handle;
+    if( ptr == NULL )       { return FNT_FAILURE; }
+    if( vec == NULL )       { return FNT_FAILURE; }
+    if( vec->v == NULL )    { return FNT_FAILURE; }
+
+    return fnt_coro_value(&ptr->co, value);
+}
+
+
+static int method_value_ticket(void *handle, int ticket, double value) {
+    brent_batch_t *ptr = (brent_batch_t*)handle;
+    if( ptr == NULL )       { return FNT_FAILURE; }
+
+    return fnt_coro_value_ticket(&ptr->co, ticket, value);
+}
+
+
+static int method_done(void *handle) {
+    brent_batch_t *ptr = (brent_batch_t*)handle;
+    if( ptr == NULL )       { return FNT_FAILURE; }
+
+    return fnt_coro_done(&ptr->co);
+}
+
+
+static int method_result(void *handle, char *id, void *value_ptr) {
+    if( handle == NULL )    { return FNT_FAILURE; }
+    brent_batch_t *ptr = (brent_batch_t*)handle;
+
+    FNT_RESULT_GET("minimum x", id, double, ptr->min_x, value_ptr);
+    FNT_RESULT_GET("minimum f", id, double, ptr->min_fx, value_ptr);
+
+    ERROR("No result named '%s'.\n", id);
+
+    return FNT_FAILURE;
+}
+
+
+/* MARK: Method descriptor */
+
+fnt_method_descriptor_t fnt_method_descriptor = {
+    .abi_version       = FNT_METHOD_ABI_VERSION,
+    .capabilities      = FNT_METHOD_CAP_BATCH,
+    .name              = method_name,
+    .init              = method_init,
+    .free              = method_free,
+    .reset             = method_reset,
+    .info              = method_info,
+    .hparam_set        = method_hparam_set,
+    .hparam_get        = method_hparam_get,
+    .next              = method_next,
+    .next_batch        = method_next_batch,
+    .value             = method_value,
+    .value_ticket      = method_value_ticket,
+    .done              = method_done,
+    .result            = method_result,
+};
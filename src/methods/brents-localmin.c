@@ -8,35 +8,19 @@
 #include <stdlib.h>
 #include <string.h>
 #include "../fnt.h"
+#include "../fnt_brent.h"
 
 
 /* MARK: Method type definitions */
 
-typedef enum brent_states {
-    brent_initial, brent_starting, brent_running, brent_done
-} brent_state_t;
-
 typedef struct brent {
-    brent_state_t state;
-
-    /* variables that need to persists between function calls */
-    double a;
-    double b;
-    double c;
-
-    double u;
-    double v;
-    double w;
-    double x;
-    double fu;
-    double fv;
-    double fw;
-    double fx;
-
-    double e;
-    double d;
+    /* the search itself lives in fnt_brent.h */
+    fnt_brent_t brent;
+    int started;
 
     /* hyper-parameters */
+    double x_0;
+    double x_1;
     double eps;
     double t;
 
@@ -54,7 +38,7 @@ typedef struct brent {
  * \param size Size of the name buffer in bytes.
  * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
  */
-int method_name(char *name, int size) {
+static int method_name(char *name, int size) {
     if( snprintf(name, size, "brents-localmin") >= size ) {
         return FNT_FAILURE;
     }
@@ -66,7 +50,7 @@ int method_name(char *name, int size) {
 /* \brief Initialize intenal state for method.
  * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
  */
-int method_init(void **handle_ptr, int dimensions) {
+static int method_init(void **handle_ptr, int dimensions) {
     if( handle_ptr == NULL )    { return FNT_FAILURE; }
     brent_t *ptr = calloc(1, sizeof(brent_t));
     if( ptr == NULL )           { return FNT_FAILURE; }
@@ -78,7 +62,7 @@ int method_init(void **handle_ptr, int dimensions) {
 }
 
 
-int method_free(void **handle_ptr) {
+static int method_free(void **handle_ptr) {
     if( handle_ptr == NULL )    { return FNT_FAILURE; }
     if( *handle_ptr == NULL )   { return FNT_FAILURE; }
     brent_t *ptr = (brent_t*)*handle_ptr;
@@ -91,10 +75,26 @@ int method_free(void **handle_ptr) {
 }
 
 
+/* \brief Return the method to its initial state, keeping hyper-parameters.
+ * \param handle Pointer to the method handle.
+ * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
+ */
+static int method_reset(void *handle) {
+    brent_t *ptr = (brent_t*)handle;
+    if( ptr == NULL )       { return FNT_FAILURE; }
+
+    memset(&ptr->brent, '\0', sizeof(ptr->brent));
+    ptr->started = 0;
+    ptr->min_x = ptr->min_fx = 0.0;
+
+    return FNT_SUCCESS;
+}
+
+
 /* \brief Display information about the method to the console.
  * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
  */
-int method_info() {
+static int method_info() {
     printf(
 "Brent's method is a minimization method, that uses a search strategy\n"
 "similar to the Brent-Dekker root finding method.\n"
@@ -121,14 +121,14 @@ int method_info() {
  * \param value_ptr A pointer to the value being set.
  * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
  */
-int method_hparam_set(void *handle, char *id, void *value_ptr) {
+static int method_hparam_set(void *handle, char *id, void *value_ptr) {
     if( id == NULL )        { return FNT_FAILURE; }
     if( value_ptr == NULL ) { return FNT_FAILURE; }
     if( handle == NULL )    { return FNT_FAILURE; }
     brent_t *ptr = (brent_t*)handle;
 
-    FNT_HPARAM_SET("x_0", id, double, value_ptr, ptr->a);
-    FNT_HPARAM_SET("x_1", id, double, value_ptr, ptr->b);
+    FNT_HPARAM_SET("x_0", id, double, value_ptr, ptr->x_0);
+    FNT_HPARAM_SET("x_1", id, double, value_ptr, ptr->x_1);
     FNT_HPARAM_SET("eps", id, double, value_ptr, ptr->eps);
     FNT_HPARAM_SET("t", id, double, value_ptr, ptr->t);
 
@@ -138,14 +138,14 @@ int method_hparam_set(void *handle, char *id, void *value_ptr) {
 }
 
 
-int method_hparam_get(void *handle, char *id, void *value_ptr) {
+static int method_hparam_get(void *handle, char *id, void *value_ptr) {
     if( id == NULL )        { return FNT_FAILURE; }
     if( value_ptr == NULL ) { return FNT_FAILURE; }
     if( handle == NULL )    { return FNT_FAILURE; }
     brent_t *ptr = (brent_t*)handle;
 
-    FNT_HPARAM_GET("x_0", id, double, ptr->a, value_ptr);
-    FNT_HPARAM_GET("x_1", id, double, ptr->b, value_ptr);
+    FNT_HPARAM_GET("x_0", id, double, ptr->x_0, value_ptr);
+    FNT_HPARAM_GET("x_1", id, double, ptr->x_1, value_ptr);
     FNT_HPARAM_GET("eps", id, double, ptr->eps, value_ptr);
     FNT_HPARAM_GET("t", id, double, ptr->t, value_ptr);
 
@@ -155,181 +155,53 @@ int method_hparam_get(void *handle, char *id, void *value_ptr) {
 }
 
 
-int method_next(void *handle, fnt_vect_t *vec) {
+static int method_next(void *handle, fnt_vect_t *vec) {
     if( handle == NULL )    { return FNT_FAILURE; }
     if( vec == NULL )       { return FNT_FAILURE; }
     if( vec->v == NULL )    { return FNT_FAILURE; }
     brent_t *ptr = (brent_t*)handle;
 
     /* fill vector pointed to by vec with next input to try */
-    if( ptr->state == brent_initial ) {
-        double a = ptr->a;
-        double b = ptr->b;
-
-        double c = (3.0 - sqrt(5.0)) / 2.0;
-        double v, w, x, e;
-        v = w = x = a + c * (b - a);   e = 0;
-        double d = 0.0;  /* from errata */
-        FNT_VECT_ELEM(*vec, 0) = x;  /* f(x) is needed */
-
-        ptr->c = c;
-        ptr->v = v;
-        ptr->w = w;
-        ptr->x = x;
-        ptr->e = e;
-        ptr->d = d;
-
-        DEBUG("Initializing by requesting f(x) = f(%g).\n", x);
-
-        return FNT_SUCCESS;
-    } else {
-        FNT_VECT_ELEM(*vec, 0) = ptr->u; /* f(u) is needed */
-        DEBUG("Requesting f(u) = f(%g).\n", ptr->u);
-        return FNT_SUCCESS;
+    if( !ptr->started ) {
+        fnt_brent_start(&ptr->brent, ptr->x_0, ptr->x_1, ptr->eps, ptr->t);
+        ptr->started = 1;
     }
+    FNT_VECT_ELEM(*vec, 0) = fnt_brent_point(&ptr->brent);
 
-    return FNT_FAILURE;
+    return FNT_SUCCESS;
 }
 
 
-int method_value(void *handle, fnt_vect_t *vec, double value) {
+static int method_value(void *handle, fnt_vect_t *vec, double value) {
     if( handle == NULL )    { return FNT_FAILURE; }
     if( vec == NULL )       { return FNT_FAILURE; }
     if( vec->v == NULL )    { return FNT_FAILURE; }
     brent_t *ptr = (brent_t*)handle;
 
-    double a = ptr->a;
-    double b = ptr->b;
-    double c = ptr->c;
-    double u = ptr->v;
-    double v = ptr->v;
-    double w = ptr->w;
-    double x = ptr->x;
-    double fu = ptr->fu;
-    double fv = ptr->fv;
-    double fw = ptr->fw;
-    double fx = ptr->fx;
-    double e = ptr->e;
-    double d = ptr->d;
-
-    if( ptr->state == brent_initial ) {
-        v  = w = x = FNT_VECT_ELEM(*vec, 0);
-        fv = fw = fx = value;
-
-        DEBUG("Got initial value f(x) = f(%g) = %g.\n", x, fx);
-
-        DEBUG("Setting state to starting.\n");
-        ptr->state = brent_starting;
+    if( !ptr->started ) {
+        ERROR("ERROR: Value received before any input was requested.\n");
+        return FNT_FAILURE;
     }
 
     /* update method using value */
-
-    if( ptr->state == brent_running ) {
-        /* skip this on the first iteration,
-         * as it is the end of the original loop. */
-        u = FNT_VECT_ELEM(*vec, 0);
-        fu = value;
-
-        DEBUG("Updating with f(u) = f(%g) = %g.\n", u, fu);
-
-        /* Update a, b, v, w, and x */
-        if( fu <= fx ) {
-                                        /* FORTRAN: 130 */
-            if( u < x ) { b = x; } else { a = x; }
-            /* FORTRAN: 140 */
-            v = w;  fv = fw;    w = x;  fw = fx;    x = u;  fx = fu;
-        } else {
-            /* FORTRAN: 150 */          /* FORTRAN: 160 */
-            if( u < x ) { a = u; } else { b = u; }
-            /* FORTRAN: 170 */
-            if( fu <= fw || w == x ) {
-                v = w;  fv = fw;    w = u;  fw = fu;
-            } else {
-                /* FORTRAN: 180 */
-                v = u;  fv = fu;
-            }
-        }
-    } else {
-        DEBUG("Setting state to running.\n");
-        ptr->state = brent_running;
-    }
-
-    /* ALGOL: loop */
-    /* FORTRAN: 10 */
-    double m = 0.5 * (a + b);
-    double tol = ptr->eps * fabs(x) + ptr->t;
-    double t2 = 2.0 * tol;
-
-    /* Check stopping criterion */
-    if( fabs(x - m) > t2 - 0.5 * (b - a) ) {
-        double p, q, r;
-        p = q = r = 0;
-        if( fabs(e) > tol ) {
-            DEBUG("Fitting a parabola.\n");
-            /* Fit parabola */
-            r = (x - w) * (fx -fv);     q = (x - v) * (fx - fw);
-            p = (x - v) * q - (x - w) * r;      q = 2 * (q - r);
-                                         /* FORTRAN: 20 */
-            if( q > 0 ) { p = -p; } else { q = -q; }
-            /* FORTRAN: 30 */
-            r = e;      e = d;
-        }
-        /* FORTRAN: 40 */
-        if( fabs(p) < fabs(0.5 * q * r) && p > q * (a - x) && p < q * (b-x) ) {
-            DEBUG("Parabolic interpolation.\n");
-            /* A "parabolic interpolation" step */
-            d = p / q;      u = x + d;
-            /* f must not be evaluated too close to a or b */
-                                                        /* FORTRAN: 50 */
-            if( u - a < t2 || b - u < t2 ) { d = (x < m) ? tol : -tol; }
-        } else {
-            DEBUG("Golden section step.\n");
-            /* A "golden section" step */
-            /* FORTRAN: 60 & 70 */          /* FORTRAN: 80 */
-            e = ((x < m) ? b : a) - x;      d = c * e;
-        }
-        /* f must not be evaluated too close to x */
-        /* FORTRAN: 90 100 & 110 */
-        u = x + ((fabs(d) >= tol ? d : (d > 0 ? tol : -tol)));
-
-        DEBUG("Requesting f(u) = f(%g).\n", u);
-        ptr->u = u; /* need f(u) */
-        /* FORTRAN: 120 is external to this function. */
-    } else {
-        /* FORTRAN: 190 */
-        DEBUG("Setting state to done.\n");
-        ptr->state = brent_done;
+    if( fnt_brent_value(&ptr->brent, FNT_VECT_ELEM(*vec, 0), value) == FNT_DONE ) {
         /* local minimum should be in fx */
-        ptr->min_x = ptr->x;
-        ptr->min_fx = ptr->fx;
+        ptr->min_x = ptr->brent.x;
+        ptr->min_fx = ptr->brent.fx;
     }
 
-    ptr->a = a;
-    ptr->b = b;
-    ptr->c = c;
-    ptr->u = u;
-    ptr->v = v;
-    ptr->w = w;
-    ptr->x = x;
-    ptr->fu = fu;
-    ptr->fv = fv;
-    ptr->fw = fw;
-    ptr->fx = fx;
-    ptr->e = e;
-    ptr->d = d;
-
     return FNT_SUCCESS;
 }
 
 
-int method_done(void *handle) {
+static int method_done(void *handle) {
     if( handle == NULL )    { return FNT_FAILURE; }
     brent_t *ptr = (brent_t*)handle;
 
     /* test for completion
      *  Return FNT_DONE when comlete, or FNT_CONTINUE when not done.
      */
-    if( ptr->state == brent_done ) {
+    if( ptr->started && ptr->brent.state == fnt_brent_done ) {
         return FNT_DONE;
     } else {
         return FNT_CONTINUE;
@@ -339,7 +211,7 @@ int method_done(void *handle) {
 }
 
 
-int method_result(void *handle, char *id, void *value_ptr) {
+static int method_result(void *handle, char *id, void *value_ptr) {
     if( handle == NULL )    { return FNT_FAILURE; }
     brent_t *ptr = (brent_t*)handle;
 
@@ -350,3 +222,22 @@ int method_result(void *handle, char *id, void *value_ptr) {
 
     return FNT_FAILURE;
 }
+
+
+/* MARK: Method descriptor */
+
+fnt_method_descriptor_t fnt_method_descriptor = {
+    .abi_version       = FNT_METHOD_ABI_VERSION,
+    .capabilities      = FNT_METHOD_CAP_NONE,
+    .name              = method_name,
+    .init              = method_init,
+    .free              = method_free,
+    .reset             = method_reset,
+    .info              = method_info,
+    .hparam_set        = method_hparam_set,
+    .hparam_get        = method_hparam_get,
+    .next              = method_next,
+    .value             = method_value,
+    .done              = method_done,
+    .result            = method_result,
+};
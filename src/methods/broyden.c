@@ -0,0 +1,550 @@
+/*
+ * broyden.c
+ * fnt: Numerical Toolbox
+ *
+ * Copyright (c) 2024 Bryan Franklin. All rights reserved.
+ */
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../fnt.h"
+
+
+/* MARK: Method type definitions */
+
+typedef enum broyden_update {
+    broyden_good, broyden_bad, broyden_newton
+} broyden_update_t;
+
+typedef enum broyden_state {
+    broyden_initial, broyden_jacobian, broyden_search, broyden_done
+} broyden_state_t;
+
+#define BROYDEN_ARMIJO      1e-4    /* sufficient decrease of |r| */
+#define BROYDEN_MIN_STEP    1e-4    /* smallest line search step taken */
+
+typedef struct broyden {
+    int n;
+
+    /* hyper-parameters */
+    fnt_vect_t x0;
+    int update;
+    double f_tol;
+    double x_tol;
+    double fd_step;
+    int max_iter;
+
+    /* method state */
+    broyden_state_t state;
+    int column;             /* Jacobian column being estimated */
+    int iterations;
+    fnt_vect_t x;           /* current iterate and its residual */
+    fnt_vect_t r;
+    double r_norm;
+    fnt_vect_t p;           /* search direction, -H r */
+    double lambda;          /* line search step along p */
+    fnt_vect_t x_t;         /* trial point */
+    double h;               /* finite difference step for column */
+
+    /* inverse Jacobian approximation H and scratch, both row-major n*n */
+    double *H;
+    double *J;
+    fnt_vect_t s;
+    fnt_vect_t y;
+    fnt_vect_t Hy;
+    fnt_vect_t sH;
+
+    /* results */
+    fnt_vect_t root;
+    double root_norm;
+
+} broyden_t;
+
+
+/* MARK: Internal functions */
+
+/* Invert the n*n row-major matrix J into H by Gauss-Jordan elimination
+ * with partial pivoting, destroying J. */
+static int broyden_invert(int n, double *J, double *H) {
+    for(int i=0; i<n; ++i) {
+        for(int j=0; j<n; ++j) {
+            H[i*n+j] = i == j ? 1.0 : 0.0;
+        }
+    }
+
+    for(int col=0; col<n; ++col) {
+        int pivot = col;
+        for(int i=col+1; i<n; ++i) {
+            if( fabs(J[i*n+col]) > fabs(J[pivot*n+col]) ) { pivot = i; }
+        }
+        if( J[pivot*n+col] == 0.0 ) {
+            ERROR("ERROR: Jacobian is singular (column %d).\n", col);
+            return FNT_FAILURE;
+        }
+        if( pivot != col ) {
+            for(int j=0; j<n; ++j) {
+                double tmp;
+                tmp = J[col*n+j];   J[col*n+j] = J[pivot*n+j];  J[pivot*n+j] = tmp;
+                tmp = H[col*n+j];   H[col*n+j] = H[pivot*n+j];  H[pivot*n+j] = tmp;
+            }
+        }
+
+        double scale = 1.0 / J[col*n+col];
+        for(int j=0; j<n; ++j) {
+            J[col*n+j] *= scale;
+            H[col*n+j] *= scale;
+        }
+        for(int i=0; i<n; ++i) {
+            if( i == col )  { continue; }
+            double factor = J[i*n+col];
+            if( factor == 0.0 ) { continue; }
+            for(int j=0; j<n; ++j) {
+                J[i*n+j] -= factor * J[col*n+j];
+                H[i*n+j] -= factor * H[col*n+j];
+            }
+        }
+    }
+
+    return FNT_SUCCESS;
+}
+
+
+/* Begin an iteration from x, or stop if the residual is small enough. */
+static int broyden_iterate(broyden_t *ptr) {
+    int n = ptr->n;
+
+    if( ptr->r_norm < ptr->f_tol ) {
+        INFO("Residual norm (%g) below f_tol (%g).\n", ptr->r_norm, ptr->f_tol);
+        ptr->state = broyden_done;
+        return FNT_SUCCESS;
+    }
+    if( ptr->iterations >= ptr->max_iter ) {
+        INFO("Iteration count (%d) reached limit.\n", ptr->iterations);
+        ptr->state = broyden_done;
+        return FNT_SUCCESS;
+    }
+
+    /* p = -H r */
+    for(int i=0; i<n; ++i) {
+        double sum = 0.0;
+        for(int j=0; j<n; ++j) {
+            sum += ptr->H[i*n+j] * FNT_VECT_ELEM(ptr->r, j);
+        }
+        FNT_VECT_ELEM(ptr->p, i) = -sum;
+    }
+    ptr->lambda = 1.0;
+    ptr->state = broyden_search;
+
+    return FNT_SUCCESS;
+}
+
+
+/* Rank-1 update of H from step s and residual change y, O(n^2). */
+static void broyden_rank1(broyden_t *ptr) {
+    int n = ptr->n;
+    double *H = ptr->H;
+
+    /* Hy = H y */
+    for(int i=0; i<n; ++i) {
+        double sum = 0.0;
+        for(int j=0; j<n; ++j) { sum += H[i*n+j] * FNT_VECT_ELEM(ptr->y, j); }
+        FNT_VECT_ELEM(ptr->Hy, i) = sum;
+    }
+
+    double denom = 0.0;
+    if( ptr->update == broyden_good ) {
+        /* H += (s - H y) s^T H / (s^T H y) */
+        for(int j=0; j<n; ++j) {
+            double sum = 0.0;
+            for(int i=0; i<n; ++i) { sum += FNT_VECT_ELEM(ptr->s, i) * H[i*n+j]; }
+            FNT_VECT_ELEM(ptr->sH, j) = sum;
+        }
+        for(int i=0; i<n; ++i) { denom += FNT_VECT_ELEM(ptr->s, i) * FNT_VECT_ELEM(ptr->Hy, i); }
+    } else {
+        /* H += (s - H y) y^T / (y^T y) */
+        fnt_vect_copy(&ptr->sH, &ptr->y);
+        for(int i=0; i<n; ++i) { denom += FNT_VECT_ELEM(ptr->y, i) * FNT_VECT_ELEM(ptr->y, i); }
+    }
+    if( fabs(denom) < 1e-300 ) {
+        DEBUG("DEBUG: Skipping update with vanishing denominator.\n");
+        return;
+    }
+
+    for(int i=0; i<n; ++i) {
+        double u = (FNT_VECT_ELEM(ptr->s, i) - FNT_VECT_ELEM(ptr->Hy, i)) / denom;
+        if( u == 0.0 )  { continue; }
+        for(int j=0; j<n; ++j) {
+            H[i*n+j] += u * FNT_VECT_ELEM(ptr->sH, j);
+        }
+    }
+}
+
+
+/* MARK: Functions called by FNT */
+
+/* \brief Provides the name of the method.
+ * \param name Allocated buffer to hold the name.
+ * \param size Size of the name buffer in bytes.
+ * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
+ */
+static int method_name(char *name, int size) {
+    if( snprintf(name, size, "broyden") >= size ) {
+        return FNT_FAILURE;
+    }
+
+    return FNT_SUCCESS;
+}
+
+
+/* \brief Initialize intenal state for method.
+ * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
+ */
+static int method_init(void **handle_ptr, int dimensions) {
+    if( handle_ptr == NULL )    { return FNT_FAILURE; }
+    if( dimensions < 1 )        { return FNT_FAILURE; }
+    broyden_t *ptr = calloc(1, sizeof(broyden_t));
+    if( ptr == NULL )           { return FNT_FAILURE; }
+    *handle_ptr = (void*)ptr;
+
+    /* initialize method here */
+    ptr->n = dimensions;
+    ptr->update = broyden_good;
+    ptr->f_tol = 1e-8;
+    ptr->x_tol = 1e-12;
+    ptr->fd_step = 1e-7;
+    ptr->max_iter = 100;
+    ptr->state = broyden_initial;
+
+    ptr->H = calloc((size_t)dimensions * dimensions, sizeof(double));
+    ptr->J = calloc((size_t)dimensions * dimensions, sizeof(double));
+    if( ptr->H == NULL || ptr->J == NULL ) {
+        ERROR("ERROR: Failed to allocate %dx%d Jacobian.\n", dimensions, dimensions);
+        free(ptr->H);   free(ptr->J);
+        free(ptr);  *handle_ptr = NULL;
+        return FNT_FAILURE;
+    }
+
+    fnt_vect_calloc(&ptr->x0, dimensions);
+    fnt_vect_calloc(&ptr->x, dimensions);
+    fnt_vect_calloc(&ptr->r, dimensions);
+    fnt_vect_calloc(&ptr->p, dimensions);
+    fnt_vect_calloc(&ptr->x_t, dimensions);
+    fnt_vect_calloc(&ptr->s, dimensions);
+    fnt_vect_calloc(&ptr->y, dimensions);
+    fnt_vect_calloc(&ptr->Hy, dimensions);
+    fnt_vect_calloc(&ptr->sH, dimensions);
+    fnt_vect_calloc(&ptr->root, dimensions);
+
+    return FNT_SUCCESS;
+}
+
+
+static int method_free(void **handle_ptr) {
+    if( handle_ptr == NULL )    { return FNT_FAILURE; }
+    if( *handle_ptr == NULL )   { return FNT_FAILURE; }
+    broyden_t *ptr = (broyden_t*)*handle_ptr;
+
+    /* free any memory allocated by method */
+    free(ptr->H);
+    free(ptr->J);
+    fnt_vect_free(&ptr->x0);
+    fnt_vect_free(&ptr->x);
+    fnt_vect_free(&ptr->r);
+    fnt_vect_free(&ptr->p);
+    fnt_vect_free(&ptr->x_t);
+    fnt_vect_free(&ptr->s);
+    fnt_vect_free(&ptr->y);
+    fnt_vect_free(&ptr->Hy);
+    fnt_vect_free(&ptr->sH);
+    fnt_vect_free(&ptr->root);
+
+    free(ptr);  *handle_ptr = ptr = NULL;
+
+    return FNT_SUCCESS;
+}
+
+
+/* \brief Return the method to its initial state, keeping hyper-parameters.
+ * \param handle Pointer to the method handle.
+ * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
+ */
+static int method_reset(void *handle) {
+    broyden_t *ptr = (broyden_t*)handle;
+    if( ptr == NULL )       { return FNT_FAILURE; }
+
+    ptr->state = broyden_initial;
+    ptr->column = ptr->iterations = 0;
+    ptr->r_norm = ptr->lambda = ptr->h = 0.0;
+    fnt_vect_reset(&ptr->root);
+    ptr->root_norm = 0.0;
+
+    return FNT_SUCCESS;
+}
+
+
+/* \brief Display information about the method to the console.
+ * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
+ */
+static int method_info() {
+    printf(
+"Broyden's method solves systems of nonlinear equations r(x) = 0, given\n"
+"the residual vector r at each point through fnt_set_value_residual.  The\n"
+"inverse Jacobian is estimated once, from a user supplied Jacobian or by\n"
+"finite differences, then kept current with rank-1 updates.  Each step is\n"
+"damped by a backtracking line search on |r|.\n"
+"\n"
+"Hyper-parameters:\n"
+"name\t\trequired\ttype\t\tDefault\tDescription\n"
+"x0\t\tREQUIRED\tfnt_vect_t\tzeros\tStarting point.\n"
+"update\t\toptional\tint\t\t0\t0: Broyden's good update, 1: bad update,\n"
+"\t\t\t\t\t\t\t2: Newton, requires a Jacobian with\n"
+"\t\t\t\t\t\t\tevery residual.\n"
+"f_tol\t\toptional\tdouble\t\t1e-8\tTerminates when |r(x)| < f_tol.\n"
+"x_tol\t\toptional\tdouble\t\t1e-12\tTerminates when a step is shorter.\n"
+"fd_step\t\toptional\tdouble\t\t1e-7\tRelative finite difference step.\n"
+"max_iter\toptional\tint\t\t100\tMaximum number of iterations.\n"
+"\n"
+"Results:\n"
+"name\t\ttype\t\tDescription\n"
+"root\t\tfnt_vect_t\tApproximate solution.\n"
+"residual norm\tdouble\t\t|r(root)|.\n"
+"iterations\tint\t\tNumber of accepted steps.\n"
+"\n"
+"References:\n"
+"C. G. Broyden, A Class of Methods for Solving Nonlinear Simultaneous\n"
+"\tEquations, Mathematics of Computation 19 (1965), 577-593.\n"
+"\thttps://doi.org/10.1090/S0025-5718-1965-0198670-6\n"
+);
+    return FNT_SUCCESS;
+}
+
+
+/* \brief Set any hyper-parameters needed for the method.
+ * \param id The name of the hyper-parameter.
+ * \param value_ptr A pointer to the value being set.
+ * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
+ */
+static int method_hparam_set(void *handle, char *id, void *value_ptr) {
+    if( id == NULL )        { return FNT_FAILURE; }
+    if( value_ptr == NULL ) { return FNT_FAILURE; }
+    if( handle == NULL )    { return FNT_FAILURE; }
+    broyden_t *ptr = (broyden_t*)handle;
+
+    FNT_HPARAM_SET_VECT("x0", id, value_ptr, &ptr->x0);
+    FNT_HPARAM_SET("update", id, int, value_ptr, ptr->update);
+    FNT_HPARAM_SET("f_tol", id, double, value_ptr, ptr->f_tol);
+    FNT_HPARAM_SET("x_tol", id, double, value_ptr, ptr->x_tol);
+    FNT_HPARAM_SET("fd_step", id, double, value_ptr, ptr->fd_step);
+    FNT_HPARAM_SET("max_iter", id, int, value_ptr, ptr->max_iter);
+
+    ERROR("No hyper-parameter named '%s'.\n", id);
+
+    return FNT_FAILURE;
+}
+
+
+static int method_hparam_get(void *handle, char *id, void *value_ptr) {
+    if( id == NULL )        { return FNT_FAILURE; }
+    if( value_ptr == NULL ) { return FNT_FAILURE; }
+    if( handle == NULL )    { return FNT_FAILURE; }
+    broyden_t *ptr = (broyden_t*)handle;
+
+    FNT_HPARAM_GET_VECT("x0", id, &ptr->x0, value_ptr);
+    FNT_HPARAM_GET("update", id, int, ptr->update, value_ptr);
+    FNT_HPARAM_GET("f_tol", id, double, ptr->f_tol, value_ptr);
+    FNT_HPARAM_GET("x_tol", id, double, ptr->x_tol, value_ptr);
+    FNT_HPARAM_GET("fd_step", id, double, ptr->fd_step, value_ptr);
+    FNT_HPARAM_GET("max_iter", id, int, ptr->max_iter, value_ptr);
+
+    ERROR("No hyper-parameter named '%s'.\n", id);
+
+    return FNT_FAILURE;
+}
+
+
+static int method_next(void *handle, fnt_vect_t *vec) {
+    if( handle == NULL )    { return FNT_FAILURE; }
+    if( vec == NULL )       { return FNT_FAILURE; }
+    if( vec->v == NULL )    { return FNT_FAILURE; }
+    broyden_t *ptr = (broyden_t*)handle;
+
+    switch( ptr->state ) {
+        case broyden_initial:
+            return fnt_vect_copy(vec, &ptr->x0);
+        case broyden_jacobian:
+            /* step along one coordinate */
+            fnt_vect_copy(vec, &ptr->x);
+            ptr->h = ptr->fd_step * fmax(1.0, fabs(FNT_VECT_ELEM(ptr->x, ptr->column)));
+            FNT_VECT_ELEM(*vec, ptr->column) += ptr->h;
+            return FNT_SUCCESS;
+        case broyden_search:
+            for(int i=0; i<ptr->n; ++i) {
+                FNT_VECT_ELEM(ptr->x_t, i) = FNT_VECT_ELEM(ptr->x, i)
+                                           + ptr->lambda * FNT_VECT_ELEM(ptr->p, i);
+            }
+            return fnt_vect_copy(vec, &ptr->x_t);
+        default:
+            break;
+    }
+
+    ERROR("ERROR: No input needed, method is done.\n");
+
+    return FNT_FAILURE;
+}
+
+
+static int method_value_residual(void *handle, fnt_vect_t *vec, fnt_vect_t *residual, fnt_vect_t *jacobian) {
+    if( handle == NULL )    { return FNT_FAILURE; }
+    if( vec == NULL )       { return FNT_FAILURE; }
+    if( residual == NULL )  { return FNT_FAILURE; }
+    broyden_t *ptr = (broyden_t*)handle;
+    int n = ptr->n;
+
+    if( (int)residual->n != n ) {
+        ERROR("ERROR: Residual has %zu elements, expected %d.\n", residual->n, n);
+        return FNT_FAILURE;
+    }
+    if( ptr->update == broyden_newton && jacobian == NULL
+        && ptr->state != broyden_jacobian ) {
+        ERROR("ERROR: Newton updates require a Jacobian with every residual.\n");
+        return FNT_FAILURE;
+    }
+
+    double norm = 0.0;
+    fnt_vect_l2norm(residual, &norm);
+
+    if( ptr->state == broyden_initial ) {
+        fnt_vect_copy(&ptr->x, vec);
+        fnt_vect_copy(&ptr->r, residual);
+        ptr->r_norm = norm;
+
+        if( jacobian == NULL ) {
+            /* estimate the Jacobian one column at a time */
+            ptr->column = 0;
+            ptr->state = broyden_jacobian;
+            return FNT_SUCCESS;
+        }
+        memcpy(ptr->J, jacobian->v, (size_t)n * n * sizeof(double));
+        if( broyden_invert(n, ptr->J, ptr->H) != FNT_SUCCESS ) { return FNT_FAILURE; }
+
+        return broyden_iterate(ptr);
+    }
+
+    if( ptr->state == broyden_jacobian ) {
+        for(int i=0; i<n; ++i) {
+            ptr->J[i*n+ptr->column] = (FNT_VECT_ELEM(*residual, i) - FNT_VECT_ELEM(ptr->r, i)) / ptr->h;
+        }
+        if( ++ptr->column < n ) { return FNT_SUCCESS; }
+
+        if( broyden_invert(n, ptr->J, ptr->H) != FNT_SUCCESS ) { return FNT_FAILURE; }
+
+        return broyden_iterate(ptr);
+    }
+
+    if( ptr->state != broyden_search ) {
+        ERROR("ERROR: Residual received, but none was requested.\n");
+        return FNT_FAILURE;
+    }
+
+    /* backtrack until |r| decreases enough, or the step is too short */
+    if( norm > (1.0 - BROYDEN_ARMIJO * ptr->lambda) * ptr->r_norm
+        && ptr->lambda > BROYDEN_MIN_STEP ) {
+        ptr->lambda *= 0.5;
+        DEBUG("DEBUG: Backtracking to step %g.\n", ptr->lambda);
+        return FNT_SUCCESS;
+    }
+
+    /* accept the trial point */
+    double step = 0.0;
+    for(int i=0; i<n; ++i) {
+        FNT_VECT_ELEM(ptr->s, i) = FNT_VECT_ELEM(*vec, i) - FNT_VECT_ELEM(ptr->x, i);
+        FNT_VECT_ELEM(ptr->y, i) = FNT_VECT_ELEM(*residual, i) - FNT_VECT_ELEM(ptr->r, i);
+        step += FNT_VECT_ELEM(ptr->s, i) * FNT_VECT_ELEM(ptr->s, i);
+    }
+    fnt_vect_copy(&ptr->x, vec);
+    fnt_vect_copy(&ptr->r, residual);
+    ptr->r_norm = norm;
+    ptr->iterations += 1;
+
+    if( ptr->update == broyden_newton ) {
+        memcpy(ptr->J, jacobian->v, (size_t)n * n * sizeof(double));
+        if( broyden_invert(n, ptr->J, ptr->H) != FNT_SUCCESS ) { return FNT_FAILURE; }
+    } else {
+        broyden_rank1(ptr);
+    }
+
+    if( sqrt(step) < ptr->x_tol ) {
+        INFO("Step length (%g) below x_tol (%g).\n", sqrt(step), ptr->x_tol);
+        ptr->state = broyden_done;
+        return FNT_SUCCESS;
+    }
+
+    return broyden_iterate(ptr);
+}
+
+
+/* \brief Scalar values are only meaningful for a single equation, where the
+ * value is the residual itself.
+ */
+static int method_value(void *handle, fnt_vect_t *vec, double value) {
+    if( handle == NULL )    { return FNT_FAILURE; }
+    broyden_t *ptr = (broyden_t*)handle;
+
+    if( ptr->n != 1 ) {
+        ERROR("ERROR: Broyden's method needs residual vectors, see fnt_set_value_residual.\n");
+        return FNT_FAILURE;
+    }
+    fnt_vect_t residual = { &value, 1 };
+
+    return method_value_residual(handle, vec, &residual, NULL);
+}
+
+
+static int method_done(void *handle) {
+    if( handle == NULL )    { return FNT_FAILURE; }
+    broyden_t *ptr = (broyden_t*)handle;
+
+    if( ptr->state != broyden_done ) {
+        return FNT_CONTINUE;
+    }
+
+    fnt_vect_copy(&ptr->root, &ptr->x);
+    ptr->root_norm = ptr->r_norm;
+
+    return FNT_DONE;
+}
+
+
+static int method_result(void *handle, char *id, void *value_ptr) {
+    if( handle == NULL )    { return FNT_FAILURE; }
+    broyden_t *ptr = (broyden_t*)handle;
+
+    FNT_RESULT_GET_VECT("root", id, ptr->root, value_ptr);
+    FNT_RESULT_GET("residual norm", id, double, ptr->root_norm, value_ptr);
+    FNT_RESULT_GET("iterations", id, int, ptr->iterations, value_ptr);
+
+    ERROR("No result named '%s'.\n", id);
+
+    return FNT_FAILURE;
+}
+
+
+/* MARK: Method descriptor */
+
+fnt_method_descriptor_t fnt_method_descriptor = {
+    .abi_version       = FNT_METHOD_ABI_VERSION,
+    .capabilities      = FNT_METHOD_CAP_RESIDUAL,
+    .name              = method_name,
+    .init              = method_init,
+    .free              = method_free,
+    .reset             = method_reset,
+    .info              = method_info,
+    .hparam_set        = method_hparam_set,
+    .hparam_get        = method_hparam_get,
+    .next              = method_next,
+    .value             = method_value,
+    .value_residual    = method_value_residual,
+    .done              = method_done,
+    .result            = method_result,
+};
@@ -5,6 +5,8 @@
  * Copyright (c) 2024 Bryan Franklin. All rights reserved.
  */
 #include <errno.h>
+#include <math.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -12,6 +14,17 @@
 
 /* MARK: Method type definitions */
 
+/* attempts at a fresh trial before a duplicate is settled from the cache */
+#define DE_RETRIES  10
+
+/* tickets tell samples of the trial from samples of the member it challenges */
+#define DE_TICKET_TRIAL     0
+#define DE_TICKET_PARENT    1
+
+typedef enum de_type {
+    de_continuous = 0, de_integer = 1, de_categorical = 2
+} de_type_t;
+
 typedef enum de_state {
     de_initial, de_running, de_done
 } de_state_t;
@@ -23,7 +36,7 @@ typedef struct de {
     int allocated_NP;
 
     /* hyper parameters */
-    int iterations;
+    int max_iterations;
     int NP;
     double F;
     double CR;
@@ -34,6 +47,16 @@ typedef struct de {
     int has_start_point;
     int has_lower_bounds;
     int has_upper_bounds;
+    fnt_vect_t types;   /* de_type_t of each dimension */
+    int has_types;
+    int noisy;
+    double confidence;
+    int min_samples;
+    int max_samples;
+    int max_evals;      /* zero for no limit */
+
+    /* remaining generations */
+    int iterations;
 
     /* current generation */
     fnt_vect_t *x;
@@ -41,12 +64,42 @@ typedef struct de {
     double *fx;
     double *fx_prev;
     int best;
+    int seeded;     /* leading members of x given by warm start, unevaluated */
+
+    /* with noise, fx is the mean of samples evaluations, m2 the sum of their
+     * squared deviations from it */
+    int *samples;
+    int *samples_prev;
+    double *m2;
+    double *m2_prev;
 
     /* trial vector */
     fnt_vect_t v;
     int current;    /* index of vector that v might replace */
+    int trial_samples;
+    double trial_mean;
+    double trial_m2;
+
+    /* repeats scheduled but not handed out, and inputs awaiting values */
+    int queued_trial;
+    int queued_parent;
+    int outstanding;
+
+    /* scratch space for computing trial vectors */
+    fnt_vect_t diff;
+    fnt_vect_t scaled;
+
+    /* evaluated configurations, open addressing, used with types */
+    double *seen_x;
+    double *seen_fx;
+    unsigned char *seen_used;
+    int seen_capacity;
+    int seen_count;
+    int duplicates;
 
     /* results */
+    int evaluations;
+    int resamples;
     double min_fx;
     fnt_vect_t min_x;
 } de_t;
@@ -102,6 +155,13 @@ static int de_allocate_generations(de_t *ptr) {
         ERROR("calloc: %s\n", strerror(errno));
         ret = FNT_FAILURE;
     }
+    if( (ptr->samples = calloc(ptr->NP, sizeof(int))) == NULL
+     || (ptr->samples_prev = calloc(ptr->NP, sizeof(int))) == NULL
+     || (ptr->m2 = calloc(ptr->NP, sizeof(double))) == NULL
+     || (ptr->m2_prev = calloc(ptr->NP, sizeof(double))) == NULL ) {
+        ERROR("calloc: %s\n", strerror(errno));
+        ret = FNT_FAILURE;
+    }
 
     if( ret == FNT_FAILURE ) {
         /* one or more allocations failed,
@@ -115,10 +175,16 @@ static int de_allocate_generations(de_t *ptr) {
         if( ptr->x_prev )   { free(ptr->x_prev); ptr->x_prev = NULL; }
         if( ptr->fx )       { free(ptr->fx); ptr->fx = NULL; }
         if( ptr->fx_prev )  { free(ptr->fx_prev); ptr->fx_prev = NULL; }
+        free(ptr->samples);         ptr->samples = NULL;
+        free(ptr->samples_prev);    ptr->samples_prev = NULL;
+        free(ptr->m2);              ptr->m2 = NULL;
+        free(ptr->m2_prev);         ptr->m2_prev = NULL;
 
         return FNT_FAILURE;
     }
 
+    ptr->allocated_NP = ptr->NP;
+
     if( fnt_verbose_level >= FNT_DEBUG ) {
         de_print_generation(ptr);
     }
@@ -129,7 +195,7 @@ static int de_allocate_generations(de_t *ptr) {
 
 static int de_free_generations(de_t *ptr) {
 
-    for(int i=0; i<ptr->NP; ++i) {
+    for(int i=0; i<ptr->allocated_NP; ++i) {
         fnt_vect_free(&ptr->x[i]);
         fnt_vect_free(&ptr->x_prev[i]);
     }
@@ -137,17 +203,241 @@ static int de_free_generations(de_t *ptr) {
     free(ptr->x_prev); ptr->x_prev=NULL;
     free(ptr->fx); ptr->fx=NULL;
     free(ptr->fx_prev); ptr->fx_prev=NULL;
+    free(ptr->samples); ptr->samples=NULL;
+    free(ptr->samples_prev); ptr->samples_prev=NULL;
+    free(ptr->m2); ptr->m2=NULL;
+    free(ptr->m2_prev); ptr->m2_prev=NULL;
+    ptr->allocated_NP = 0;
+
+    return FNT_SUCCESS;
+}
+
+
+static de_type_t de_type(de_t *ptr, int j) {
+    return ptr->has_types ? (de_type_t)FNT_VECT_ELEM(ptr->types, j) : de_continuous;
+}
+
+
+/* Range of integer values dimension j may take, when bounded. */
+static void de_int_range(de_t *ptr, int j, double *lo, double *hi) {
+    *lo = ptr->has_lower_bounds ? ceil(FNT_VECT_ELEM(ptr->lower_bounds, j)) : -INFINITY;
+    *hi = ptr->has_upper_bounds ? floor(FNT_VECT_ELEM(ptr->upper_bounds, j)) : INFINITY;
+}
+
+
+/* Round integer and categorical elements of v to values they may take. */
+static void de_snap(de_t *ptr, fnt_vect_t *v) {
+    for(int j=0; ptr->has_types && j<ptr->dim; ++j) {
+        if( de_type(ptr, j) == de_continuous )  { continue; }
+        double lo, hi;
+        de_int_range(ptr, j, &lo, &hi);
+        FNT_VECT_ELEM(*v, j) = fmin(fmax(round(FNT_VECT_ELEM(*v, j)), lo), hi);
+    }
+}
+
+
+/* A uniformly random category of dimension j, which must be bounded. */
+static double de_random_category(de_t *ptr, int j) {
+    double lo, hi;
+    de_int_range(ptr, j, &lo, &hi);
+
+    return lo + FNT_RAND() % (int)(hi - lo + 1.0);
+}
+
+
+/* Categories have no order, so differences of them mean nothing.  Instead a
+ * categorical element comes from the base vector, and is replaced by a
+ * random category with probability F where the difference vectors disagree. */
+static void de_mutate_categorical(de_t *ptr, fnt_vect_t *base, int r2, int r3) {
+    for(int j=0; ptr->has_types && j<ptr->dim; ++j) {
+        if( de_type(ptr, j) != de_categorical )  { continue; }
+        FNT_VECT_ELEM(ptr->v, j) = FNT_VECT_ELEM(*base, j);
+        if( FNT_VECT_ELEM(ptr->x_prev[r2], j) != FNT_VECT_ELEM(ptr->x_prev[r3], j)
+            && FNT_RAND() / (double)FNT_RAND_MAX < ptr->F ) {
+            FNT_VECT_ELEM(ptr->v, j) = de_random_category(ptr, j);
+        }
+    }
+}
+
+
+static uint64_t de_hash(de_t *ptr, fnt_vect_t *x) {
+    uint64_t h = 14695981039346656037ull;  /* FNV-1a */
+    for(int j=0; j<ptr->dim; ++j) {
+        double xj = FNT_VECT_ELEM(*x, j) + 0.0;    /* -0.0 hashes as 0.0 */
+        unsigned char bytes[sizeof(double)];
+        memcpy(bytes, &xj, sizeof(double));
+        for(size_t k=0; k<sizeof(double); ++k) {
+            h = (h ^ bytes[k]) * 1099511628211ull;
+        }
+    }
+
+    return h;
+}
+
+
+/* Slot holding x, or the empty slot where it belongs. */
+static int de_seen_slot(de_t *ptr, fnt_vect_t *x) {
+    int mask = ptr->seen_capacity - 1;
+    int slot = (int)(de_hash(ptr, x) & (uint64_t)mask);
+
+    while( ptr->seen_used[slot] ) {
+        double *key = &ptr->seen_x[(size_t)slot * ptr->dim];
+        int j = 0;
+        while( j < ptr->dim && key[j] == FNT_VECT_ELEM(*x, j) ) { ++j; }
+        if( j == ptr->dim ) { break; }
+        slot = (slot + 1) & mask;
+    }
+
+    return slot;
+}
+
+
+/* Value of an evaluated configuration, or NULL if x is new. */
+static double *de_seen_find(de_t *ptr, fnt_vect_t *x) {
+    if( ptr->seen_capacity == 0 )   { return NULL; }
+
+    int slot = de_seen_slot(ptr, x);
+
+    return ptr->seen_used[slot] ? &ptr->seen_fx[slot] : NULL;
+}
+
+
+static int de_seen_add(de_t *ptr, fnt_vect_t *x, double fx) {
+
+    /* keep the table at most half full */
+    if( 2 * (ptr->seen_count + 1) > ptr->seen_capacity ) {
+        int old_capacity = ptr->seen_capacity;
+        double *old_x = ptr->seen_x, *old_fx = ptr->seen_fx;
+        unsigned char *old_used = ptr->seen_used;
+
+        ptr->seen_capacity = old_capacity > 0 ? 2 * old_capacity : 256;
+        ptr->seen_x = calloc((size_t)ptr->seen_capacity * ptr->dim, sizeof(double));
+        ptr->seen_fx = calloc(ptr->seen_capacity, sizeof(double));
+        ptr->seen_used = calloc(ptr->seen_capacity, sizeof(unsigned char));
+        if( ptr->seen_x == NULL || ptr->seen_fx == NULL || ptr->seen_used == NULL ) {
+            ERROR("calloc: %s\n", strerror(errno));
+            free(ptr->seen_x);  free(ptr->seen_fx);  free(ptr->seen_used);
+            ptr->seen_x = old_x;    ptr->seen_fx = old_fx;  ptr->seen_used = old_used;
+            ptr->seen_capacity = old_capacity;
+            return FNT_FAILURE;
+        }
+
+        ptr->seen_count = 0;
+        for(int i=0; i<old_capacity; ++i) {
+            if( !old_used[i] )  { continue; }
+            fnt_vect_t key = { .n = ptr->dim, .v = &old_x[(size_t)i * ptr->dim] };
+            de_seen_add(ptr, &key, old_fx[i]);
+        }
+        free(old_x);    free(old_fx);   free(old_used);
+    }
+
+    int slot = de_seen_slot(ptr, x);
+    if( !ptr->seen_used[slot] ) {
+        memcpy(&ptr->seen_x[(size_t)slot * ptr->dim], x->v, ptr->dim * sizeof(double));
+        ptr->seen_fx[slot] = fx;
+        ptr->seen_used[slot] = 1;
+        ++ptr->seen_count;
+    }
 
     return FNT_SUCCESS;
 }
 
 
+/* Add value to a running mean and sum of squared deviations (Welford). */
+static void de_accumulate(int *count, double *mean, double *m2, double value) {
+    ++*count;
+    double delta = value - *mean;
+    *mean += delta / *count;
+    *m2 += delta * (value - *mean);
+}
+
+
+/* Quantile of the standard normal distribution, by Abramowitz and Stegun
+ * 26.2.23, accurate to 4.5e-4. */
+static double de_normal_quantile(double p) {
+    double q = p < 0.5 ? p : 1.0 - p;
+    double t = sqrt(-2.0 * log(q));
+    double z = t - (2.515517 + t * (0.802853 + t * 0.010328))
+                 / (1.0 + t * (1.432788 + t * (0.189269 + t * 0.001308)));
+
+    return p < 0.5 ? -z : z;
+}
+
+
+/* Quantile of Student's t distribution with df degrees of freedom, from the
+ * normal one by its Cornish-Fisher expansion. */
+static double de_t_quantile(double p, double df) {
+    double z = de_normal_quantile(p);
+    double z2 = z * z;
+
+    return z + z * (z2 + 1.0) / (4.0 * df)
+             + z * ((5.0 * z2 + 16.0) * z2 + 3.0) / (96.0 * df * df)
+             + z * (((3.0 * z2 + 19.0) * z2 + 17.0) * z2 - 15.0) / (384.0 * df * df * df);
+}
+
+
+/* \brief Decide whether the trial replaces member curr on noisy values.
+ * The means are compared by Student's t-test, with the variance pooled over
+ * the trial and the population, as two or three samples say little about the
+ * noise, while nearby points share much the same noise.  While the difference
+ * is not significant, whichever of the two has fewer samples has them doubled,
+ * up to max_samples, after which the means decide.
+ * \return 1 to replace the member, 0 to keep it, -1 if samples were queued.
+ */
+static int de_select(de_t *ptr) {
+
+    int curr = ptr->current;
+    int nt = ptr->trial_samples;
+    int np = ptr->samples_prev[curr];
+    double diff = ptr->fx_prev[curr] - ptr->trial_mean;
+
+    if( nt < ptr->min_samples ) { ptr->queued_trial = ptr->min_samples - nt; }
+    if( np < ptr->min_samples ) { ptr->queued_parent = ptr->min_samples - np; }
+    if( ptr->queued_trial + ptr->queued_parent > 0 )    { return -1; }
+
+    double m2 = ptr->trial_m2;
+    int df = nt - 1;
+    for(int i=0; i<ptr->NP; ++i) {
+        if( ptr->samples_prev[i] < 2 )  { continue; }
+        m2 += ptr->m2_prev[i];
+        df += ptr->samples_prev[i] - 1;
+    }
+    if( df < 1 ) {
+        /* no variance to go on yet, repeats of members are kept for later */
+        ptr->queued_parent = 1;
+        return -1;
+    }
+
+    double se = sqrt(m2 / df * (1.0 / nt + 1.0 / np));
+    if( se == 0.0 )     { return diff > 0.0; }
+    double critical = de_t_quantile(1.0 - 0.5 * (1.0 - ptr->confidence), df);
+    if( fabs(diff) >= critical * se )   { return diff > 0.0; }
+
+    int more_t = ptr->max_samples - nt;
+    int more_p = ptr->max_samples - np;
+    if( more_t <= 0 && more_p <= 0 )    { return diff > 0.0; }
+    if( more_p <= 0 || (more_t > 0 && nt <= np) ) {
+        ptr->queued_trial = nt < more_t ? nt : more_t;
+    } else {
+        ptr->queued_parent = np < more_p ? np : more_p;
+    }
+    DEBUG("DEBUG: Member %d undecided (%g vs %g, t=%g), queued %d trial and %d member repeats.\n",
+            curr, ptr->trial_mean, ptr->fx_prev[curr], fabs(diff) / se,
+            ptr->queued_trial, ptr->queued_parent);
+
+    return -1;
+}
+
+
 static int de_fill_first_gen(de_t *ptr) {
 
     int curr = ptr->current;
 
-    /* if an initial value is give, fill based on it. */
-    if( ptr->has_start_point ) {
+    /* points given to warm start without values are evaluated first */
+    if( curr < ptr->seeded ) {
+        DEBUG("Filling initial generation with warm start point %d.\n", curr);
+        fnt_vect_copy(&ptr->v, &ptr->x[curr]);
+    } else if( ptr->has_start_point ) {
         if( fnt_verbose_level >= FNT_DEBUG ) {
             DEBUG("Filling initial generation using ");
             fnt_vect_print(&ptr->start_point, "start point: ", NULL);
@@ -192,8 +482,13 @@ static int de_fill_first_gen(de_t *ptr) {
                 }
             }
             FNT_VECT_ELEM(ptr->v, j) = lower + rnd * (upper-lower);
+            if( de_type(ptr, j) == de_categorical
+                && ptr->has_lower_bounds && ptr->has_upper_bounds ) {
+                FNT_VECT_ELEM(ptr->v, j) = de_random_category(ptr, j);
+            }
         }
     }
+    de_snap(ptr, &ptr->v);
 
     return FNT_SUCCESS;
 }
@@ -207,7 +502,7 @@ static int de_fill_first_gen(de_t *ptr) {
  * \param size Size of the name buffer in bytes.
  * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
  */
-int method_name(char *name, int size) {
+static int method_name(char *name, int size) {
     if( snprintf(name, size, "differential evolution") >= size ) {
         return FNT_FAILURE;
     }
@@ -219,7 +514,7 @@ int method_name(char *name, int size) {
 /* \brief Initialize intenal state for method.
  * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
  */
-int method_init(void **handle_ptr, int dimensions) {
+static int method_init(void **handle_ptr, int dimensions) {
     de_t *ptr = calloc(1, sizeof(de_t));
 
     /* record dimensionality */
@@ -227,16 +522,20 @@ int method_init(void **handle_ptr, int dimensions) {
     ptr->state = de_initial;
 
     /* set up method */
-    ptr->iterations = 1000;
+    ptr->max_iterations = ptr->iterations = 1000;
     ptr->NP = dimensions * 10;
-    ptr->allocated_NP = ptr->NP;
     ptr->F = 0.5;
     ptr->CR = 0.5;
     ptr->lambda = 0.1;
+    ptr->confidence = 0.95;
+    ptr->min_samples = 1;
+    ptr->max_samples = 8;
 
     /* allocate generations */
     de_allocate_generations(ptr);
     fnt_vect_calloc(&ptr->v, dimensions);
+    fnt_vect_calloc(&ptr->diff, dimensions);
+    fnt_vect_calloc(&ptr->scaled, dimensions);
     ptr->current = 0;
     ptr->best = 0;
 
@@ -250,19 +549,25 @@ int method_init(void **handle_ptr, int dimensions) {
 }
 
 
-int method_free(void **handle_ptr) {
+static int method_free(void **handle_ptr) {
     if( handle_ptr == NULL )    { return FNT_FAILURE; }
     if( *handle_ptr == NULL )   { return FNT_FAILURE; }
     de_t *ptr = (de_t*)*handle_ptr;
 
     /* free generation tracking */
     fnt_vect_free(&ptr->v);
+    fnt_vect_free(&ptr->diff);
+    fnt_vect_free(&ptr->scaled);
     de_free_generations(ptr);
 
     /* free vectors, if allocated */
     if( ptr->has_start_point )  { fnt_vect_free(&ptr->start_point);  }
     if( ptr->has_lower_bounds ) { fnt_vect_free(&ptr->lower_bounds); }
     if( ptr->has_upper_bounds ) { fnt_vect_free(&ptr->upper_bounds); }
+    if( ptr->has_types )        { fnt_vect_free(&ptr->types); }
+    free(ptr->seen_x);
+    free(ptr->seen_fx);
+    free(ptr->seen_used);
 
     /* free results */
     fnt_vect_free(&ptr->min_x);
@@ -273,10 +578,55 @@ int method_free(void **handle_ptr) {
 }
 
 
+/* \brief Return the method to its initial state, keeping hyper-parameters.
+ * \param handle Pointer to the method handle.
+ * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
+ */
+static int method_reset(void *handle) {
+    de_t *ptr = (de_t*)handle;
+    if( ptr == NULL )       { return FNT_FAILURE; }
+
+    ptr->state = de_initial;
+    ptr->iterations = ptr->max_iterations;
+    ptr->current = 0;
+    ptr->best = 0;
+    ptr->seeded = 0;
+
+    /* clear generations in place, they are resized on the next run if NP
+     * has changed */
+    for(int i=0; i<ptr->allocated_NP; ++i) {
+        fnt_vect_reset(&ptr->x[i]);
+        fnt_vect_reset(&ptr->x_prev[i]);
+    }
+    memset(ptr->fx, '\0', ptr->allocated_NP * sizeof(double));
+    memset(ptr->fx_prev, '\0', ptr->allocated_NP * sizeof(double));
+    memset(ptr->samples, '\0', ptr->allocated_NP * sizeof(int));
+    memset(ptr->samples_prev, '\0', ptr->allocated_NP * sizeof(int));
+    memset(ptr->m2, '\0', ptr->allocated_NP * sizeof(double));
+    memset(ptr->m2_prev, '\0', ptr->allocated_NP * sizeof(double));
+    fnt_vect_reset(&ptr->v);
+    ptr->trial_samples = ptr->queued_trial = ptr->queued_parent = ptr->outstanding = 0;
+    ptr->trial_mean = ptr->trial_m2 = 0.0;
+
+    /* forget evaluated configurations */
+    if( ptr->seen_capacity > 0 ) {
+        memset(ptr->seen_used, '\0', ptr->seen_capacity);
+    }
+    ptr->seen_count = ptr->duplicates = 0;
+
+    /* clear results */
+    fnt_vect_reset(&ptr->min_x);
+    ptr->min_fx = 0.0;
+    ptr->evaluations = ptr->resamples = 0;
+
+    return FNT_SUCCESS;
+}
+
+
 /* \brief Display information about the method to the console.
  * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
  */
-int method_info() {
+static int method_info() {
     printf(
 "Differential evolution is a minimization method that uses a population of\n"
 "randomized guesses that are systematically updated with better guesses until\n"
@@ -284,16 +634,39 @@ int method_info() {
 "\n"
 "Note: crossover is not currently implemented.\n"
 "\n"
+"Each dimension may be continuous (type 0), integer (1) or categorical (2).\n"
+"Integer elements are rounded after mutation.  Categorical elements, coded\n"
+"as the integers from lower to upper, are taken from the base vector and\n"
+"replaced by a random category with probability F where the difference\n"
+"vectors disagree.  With types set, trials matching a configuration that\n"
+"was already evaluated are drawn again, or settled with the known value,\n"
+"rather than handed out.  Neither counts as an evaluation, they are counted\n"
+"in the duplicates result instead.\n"
+"\n"
+"With noisy set, values are treated as noisy measurements.  Members keep the\n"
+"mean of every evaluation of them, and a trial replaces a member only if a\n"
+"t-test, with the variance pooled over the population, finds it better at\n"
+"the given confidence.  Until it does, the trial or the member, whichever has\n"
+"fewer evaluations, has them doubled, up to max_samples, and the repeats are\n"
+"handed out together by next_batch.  Duplicate trials are not skipped when\n"
+"noisy.\n"
+"\n"
 "Hyper-parameters:\n"
 "name\trequired\ttype\t\tDefault\tDescription\n"
 "lower\toptional\tfnt_vect_t\tnone\tLower bounds on search region.\n"
 "upper\toptional\tfnt_vect_t\tnone\tUpper bounds on search region.\n"
 "start\toptional\tfnt_vect_t\tnone\tCenter of initial search region.\n"
+"types\toptional\tfnt_vect_t\tzeros\tType of each dimension, see above.\n"
 "NP\tREQUIRED\tint\t\t10*dims\tNumber of random points.\n"
 "F\toptional\tint\t\t0\tScaling factor applied to difference of vectors.\n"
 "CR\toptional\tdouble\t\t0.5\tCrossover rate. (DE1 only)\n"
 "lambda\toptional\tint\t\t0\tScaling factor applied to best vector difference.\n"
 "iters\toptional\tint\t\t1000\tNumber of iterations to run.\n"
+"noisy\toptional\tint\t\t0\tSelect on noisy values, see above.\n"
+"confidence\toptional\tdouble\t0.95\tConfidence of noisy selections.\n"
+"min_samples\toptional\tint\t1\tEvaluations of every trial when noisy.\n"
+"max_samples\toptional\tint\t8\tEvaluations of any point when noisy.\n"
+"max_evals\toptional\tint\t0\tStop after this many evaluations, 0 for no limit.\n"
 "\n"
 "References:\n"
 "Storn, R., Price, K. Differential Evolution – A Simple and Efficient\n"
@@ -307,7 +680,7 @@ int method_info() {
 static int validate_hparams(de_t *ptr) {
 
     if( (ptr->has_lower_bounds && ptr->has_upper_bounds) ) {
-        for(int j=0; j<ptr->lower_bounds.n; ++j) {
+        for(int j=0; j<ptr->dim; ++j) {
             double lower = FNT_VECT_ELEM(ptr->lower_bounds, j);
             double upper = FNT_VECT_ELEM(ptr->upper_bounds, j);
             if( upper < lower ) {
@@ -318,6 +691,14 @@ static int validate_hparams(de_t *ptr) {
         }
     }
 
+    for(int j=0; ptr->has_types && j<ptr->dim; ++j) {
+        if( de_type(ptr, j) == de_categorical
+            && !(ptr->has_lower_bounds && ptr->has_upper_bounds) ) {
+            WARN("WARNING: Categorical dimension %d needs lower and upper bounds, treating it as integer.\n", j);
+            FNT_VECT_ELEM(ptr->types, j) = de_integer;
+        }
+    }
+
     if( ptr->NP < 3 ) {
         ERROR("ERROR: NP must be at least 3, NP was %d, changing it to 3.\n", ptr->NP);
         ptr->NP = 3;
@@ -336,6 +717,22 @@ static int validate_hparams(de_t *ptr) {
         ptr->CR = 1.0;
     }
 
+    if( ptr->noisy ) {
+        if( ptr->confidence <= 0.0 || ptr->confidence >= 1.0 ) {
+            WARN("confidence must be between zero and one.  Setting confidence to 0.95.\n");
+            ptr->confidence = 0.95;
+        }
+        if( ptr->min_samples < 1 ) {
+            WARN("min_samples must be at least one.  Setting min_samples to 1.\n");
+            ptr->min_samples = 1;
+        }
+        if( ptr->max_samples < ptr->min_samples || ptr->max_samples < 2 ) {
+            int max_samples = ptr->min_samples > 2 ? ptr->min_samples : 2;
+            WARN("max_samples must be at least 2 and min_samples.  Setting max_samples to %d.\n", max_samples);
+            ptr->max_samples = max_samples;
+        }
+    }
+
     /* Note: Storn and Price to not specify a valid range for \lambda. */
 
     /* resize generation, if NP changed */
@@ -356,17 +753,25 @@ static int validate_hparams(de_t *ptr) {
  * \param value_ptr A pointer to the value being set.
  * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
  */
-int method_hparam_set(void *handle, char *id, void *value_ptr) {
+static int method_hparam_set(void *handle, char *id, void *value_ptr) {
     de_t *ptr = (de_t*)handle;
     if( ptr == NULL )       { return FNT_FAILURE; }
     if( id == NULL )        { return FNT_FAILURE; }
     if( value_ptr == NULL ) { return FNT_FAILURE; }
 
-    FNT_HPARAM_SET("iters", id, int, value_ptr, ptr->iterations);
+    if( strncmp("iters", id, 6) == 0 ) {
+        ptr->max_iterations = ptr->iterations = *(int*)value_ptr;
+        return FNT_SUCCESS;
+    }
     FNT_HPARAM_SET("F", id, double, value_ptr, ptr->F);
     FNT_HPARAM_SET("CR", id, double, value_ptr, ptr->CR);
     FNT_HPARAM_SET("lambda", id, double, value_ptr, ptr->lambda);
     FNT_HPARAM_SET("NP", id, int, value_ptr, ptr->NP);
+    FNT_HPARAM_SET("noisy", id, int, value_ptr, ptr->noisy);
+    FNT_HPARAM_SET("confidence", id, double, value_ptr, ptr->confidence);
+    FNT_HPARAM_SET("min_samples", id, int, value_ptr, ptr->min_samples);
+    FNT_HPARAM_SET("max_samples", id, int, value_ptr, ptr->max_samples);
+    FNT_HPARAM_SET("max_evals", id, int, value_ptr, ptr->max_evals);
 
     if( strncmp("start", id, 5) == 0 ) {
         if( !ptr->has_start_point ) {
@@ -398,22 +803,46 @@ int method_hparam_set(void *handle, char *id, void *value_ptr) {
         return FNT_SUCCESS;
     }
 
+    if( strncmp("types", id, 6) == 0 ) {
+        fnt_vect_t *types = (fnt_vect_t*)value_ptr;
+        for(int j=0; j<ptr->dim && j<(int)types->n; ++j) {
+            double type = FNT_VECT_ELEM(*types, j);
+            if( type != de_continuous && type != de_integer && type != de_categorical ) {
+                ERROR("ERROR: Unknown type %g for dimension %d.\n", type, j);
+                return FNT_FAILURE;
+            }
+        }
+        if( !ptr->has_types ) {
+            fnt_vect_calloc(&ptr->types, ptr->dim);
+        }
+        fnt_vect_copy(&ptr->types, value_ptr);
+        ptr->has_types = 1;
+
+        return FNT_SUCCESS;
+    }
+
     ERROR("No hyper-parameter named '%s'.\n", id);
 
     return FNT_FAILURE;
 }
 
 
-int method_hparam_get(void *handle, char *id, void *value_ptr) {
+static int method_hparam_get(void *handle, char *id, void *value_ptr) {
     de_t *ptr = (de_t*)handle;
     if( ptr == NULL )       { return FNT_FAILURE; }
     if( id == NULL )        { return FNT_FAILURE; }
     if( value_ptr == NULL ) { return FNT_FAILURE; }
 
+    FNT_HPARAM_GET("iters", id, int, ptr->max_iterations, value_ptr);
     FNT_HPARAM_GET("F", id, double, ptr->F, value_ptr);
     FNT_HPARAM_GET("CR", id, double, ptr->CR, value_ptr);
     FNT_HPARAM_GET("lambda", id, double, ptr->lambda, value_ptr);
     FNT_HPARAM_GET("NP", id, int, ptr->NP, value_ptr);
+    FNT_HPARAM_GET("noisy", id, int, ptr->noisy, value_ptr);
+    FNT_HPARAM_GET("confidence", id, double, ptr->confidence, value_ptr);
+    FNT_HPARAM_GET("min_samples", id, int, ptr->min_samples, value_ptr);
+    FNT_HPARAM_GET("max_samples", id, int, ptr->max_samples, value_ptr);
+    FNT_HPARAM_GET("max_evals", id, int, ptr->max_evals, value_ptr);
 
     if( strncmp("start", id, 5) == 0 ) {
         if( ptr->has_start_point ) {
@@ -439,6 +868,14 @@ int method_hparam_get(void *handle, char *id, void *value_ptr) {
             return FNT_FAILURE;
         }
     }
+    if( strncmp("types", id, 6) == 0 ) {
+        if( ptr->has_types ) {
+            return fnt_vect_copy(value_ptr, &ptr->types);
+        } else {
+            ERROR("Types requested, but not set.\n");
+            return FNT_FAILURE;
+        }
+    }
 
     ERROR("No hyper-parameter named '%s'.\n", id);
 
@@ -446,9 +883,10 @@ int method_hparam_get(void *handle, char *id, void *value_ptr) {
 }
 
 
-int method_next(void *handle, fnt_vect_t *vec) {
-    de_t *ptr = (de_t*)handle;
-    if( ptr == NULL )   { return FNT_FAILURE; }
+/* \brief Fill ptr->v with a candidate for the next vector to be evaluated.
+ * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
+ */
+static int de_propose(de_t *ptr) {
 
     int curr = ptr->current;
 
@@ -456,8 +894,7 @@ int method_next(void *handle, fnt_vect_t *vec) {
     if( ptr->state == de_initial ) {
         validate_hparams(ptr);
 
-        de_fill_first_gen(ptr);
-        return fnt_vect_copy(vec, &ptr->v);
+        return de_fill_first_gen(ptr);
     }
 
     if( ptr->state != de_running ) {
@@ -475,27 +912,31 @@ int method_next(void *handle, fnt_vect_t *vec) {
     DEBUG("DEBUG: r1, r2, r3 = %d, %d, %d\n", r1, r2, r3);
 
     /* compute trial vector v */
-    fnt_vect_t diff;    /* Note: these could reside in de_t */
-    fnt_vect_t scaled;
-    fnt_vect_calloc(&diff, ptr->dim);
-    fnt_vect_calloc(&scaled, ptr->dim);
+    fnt_vect_t *diff = &ptr->diff;
+    fnt_vect_t *scaled = &ptr->scaled;
     fnt_vect_t *x_prev = ptr->x_prev;
     if( ptr->lambda != 0.0 ) {
         /* scheme DE2 */
-        fnt_vect_sub(&x_prev[ptr->best], &x_prev[curr], &diff);
-        fnt_vect_scale(&diff, ptr->lambda, &scaled);
-        fnt_vect_add(&x_prev[curr], &scaled, &ptr->v);
+        fnt_vect_sub(&x_prev[ptr->best], &x_prev[curr], diff);
+        fnt_vect_scale(diff, ptr->lambda, scaled);
+        fnt_vect_add(&x_prev[curr], scaled, &ptr->v);
+
+        fnt_vect_sub(&x_prev[r2], &x_prev[r3], diff);
+        fnt_vect_scale(diff, ptr->F, scaled);
+        fnt_vect_add(&ptr->v, scaled, &ptr->v);
 
-        fnt_vect_sub(&x_prev[r2], &x_prev[r3], &diff);
-        fnt_vect_scale(&diff, ptr->F, &scaled);
-        fnt_vect_add(&ptr->v, &scaled, &ptr->v);
+        fnt_vect_t *base = FNT_RAND() / (double)FNT_RAND_MAX < ptr->lambda
+                           ? &x_prev[ptr->best] : &x_prev[curr];
+        de_mutate_categorical(ptr, base, r2, r3);
     } else if( ptr->F != 0.0 ) {
         /* scheme DE1 */
-        fnt_vect_sub(&x_prev[r2], &x_prev[r3], &diff);
-        fnt_vect_scale(&diff, ptr->F, &scaled);
-        fnt_vect_add(&x_prev[r1], &scaled, &ptr->v);
+        fnt_vect_sub(&x_prev[r2], &x_prev[r3], diff);
+        fnt_vect_scale(diff, ptr->F, scaled);
+        fnt_vect_add(&x_prev[r1], scaled, &ptr->v);
+        de_mutate_categorical(ptr, &x_prev[r1], r2, r3);
 
-        /* apply crossover */
+        /* apply crossover, which takes whole elements from x_prev[curr], so
+         * integer and categorical elements stay valid */
         int n = FNT_RAND() % ptr->dim;
         int L = 0;
         do {
@@ -517,47 +958,150 @@ int method_next(void *handle, fnt_vect_t *vec) {
 
     /* apply lower and upper bounds */
     if( ptr->has_lower_bounds ) {
-        for(int j=0; j<ptr->v.n; ++j) {
+        for(int j=0; j<ptr->dim; ++j) {
             if( FNT_VECT_ELEM(ptr->v, j) < FNT_VECT_ELEM(ptr->lower_bounds, j) ) {
                 FNT_VECT_ELEM(ptr->v, j) = FNT_VECT_ELEM(ptr->lower_bounds, j);
             }
         }
     }
     if( ptr->has_upper_bounds ) {
-        for(int j=0; j<ptr->v.n; ++j) {
+        for(int j=0; j<ptr->dim; ++j) {
             if( FNT_VECT_ELEM(ptr->v, j) > FNT_VECT_ELEM(ptr->upper_bounds, j) ) {
                 FNT_VECT_ELEM(ptr->v, j) = FNT_VECT_ELEM(ptr->upper_bounds, j);
             }
         }
     }
+    de_snap(ptr, &ptr->v);
+
+    return FNT_SUCCESS;
+}
+
+
+static int de_settle(de_t *ptr, fnt_vect_t *vec, double value);
+
+
+/* \brief Fill ptr->v with the next vector to be evaluated.
+ * With variable types, many trials round to a configuration that was
+ * already evaluated.  Such a trial is drawn again, and if that keeps
+ * happening it is settled with the known value instead of handing it out.
+ * \return FNT_SUCCESS on success, FNT_DONE if settling duplicates finished
+ * the run, FNT_FAILURE otherwise.
+ */
+static int de_trial(de_t *ptr) {
+
+    for(int attempt=0; ; ++attempt) {
+        if( de_propose(ptr) != FNT_SUCCESS )    { return FNT_FAILURE; }
+        if( !ptr->has_types || ptr->noisy )     { return FNT_SUCCESS; }
+
+        double *known = de_seen_find(ptr, &ptr->v);
+        if( known == NULL )     { return FNT_SUCCESS; }
+        ++ptr->duplicates;
+        if( attempt < DE_RETRIES )  { continue; }
+
+        DEBUG("DEBUG: Settling duplicate trial for member %d with known value %g.\n", ptr->current, *known);
+        if( de_settle(ptr, &ptr->v, *known) != FNT_SUCCESS ) { return FNT_FAILURE; }
+        if( ptr->state == de_running && ptr->iterations <= 0 ) { return FNT_DONE; }
+        attempt = -1;
+    }
+}
+
+
+/* \brief Pick the next input to hand out: a scheduled repeat of the trial or
+ * of the member it challenges, or else a new trial.
+ * \param wait Whether to hand out nothing while values are outstanding.
+ * \param src Set to the vector to be evaluated.
+ * \param ticket Set to DE_TICKET_TRIAL or DE_TICKET_PARENT.
+ * \return FNT_SUCCESS on success, FNT_CONTINUE if waiting for values,
+ * FNT_DONE if settling duplicates finished the run, FNT_FAILURE otherwise.
+ */
+static int de_handout(de_t *ptr, int wait, fnt_vect_t **src, int *ticket) {
+
+    if( ptr->queued_trial > 0 ) {
+        --ptr->queued_trial;
+        *src = &ptr->v;
+        *ticket = DE_TICKET_TRIAL;
+    } else if( ptr->queued_parent > 0 ) {
+        --ptr->queued_parent;
+        *src = &ptr->x_prev[ptr->current];
+        *ticket = DE_TICKET_PARENT;
+    } else if( wait && ptr->outstanding > 0 ) {
+        return FNT_CONTINUE;
+    } else {
+        int ret = de_trial(ptr);
+        if( ret != FNT_SUCCESS )    { return ret; }
+        ptr->trial_samples = 0;
+        ptr->trial_mean = ptr->trial_m2 = 0.0;
+        ptr->outstanding = 0;
+        *src = &ptr->v;
+        *ticket = DE_TICKET_TRIAL;
+    }
+    ++ptr->outstanding;
 
-    return fnt_vect_copy(vec, &ptr->v);
+    return FNT_SUCCESS;
 }
 
 
-int method_value(void *handle, fnt_vect_t *vec, double value) {
+static int method_next(void *handle, fnt_vect_t *vec) {
     de_t *ptr = (de_t*)handle;
     if( ptr == NULL )   { return FNT_FAILURE; }
 
-    /* replace parameter vector with v, if warranted */
-    int curr = ptr->current;
-    if( value < ptr->fx_prev[curr] || ptr->state == de_initial ) {
-        fnt_vect_copy(&ptr->x[curr], vec);
-        ptr->fx[curr] = value;
-        if( curr == ptr->NP
-            && ptr->state == de_initial ) { ptr->state = de_running; }
-    } else {
-        fnt_vect_copy(&ptr->x[curr], &ptr->x_prev[curr]);
-        ptr->fx[curr] = ptr->fx_prev[curr];
+    fnt_vect_t *src = NULL;
+    int ticket = 0;
+    int ret = de_handout(ptr, 0, &src, &ticket);
+    if( ret != FNT_SUCCESS )    { return ret; }
+
+    return fnt_vect_copy(vec, src);
+}
+
+
+/* \brief Hands out a new trial, or every scheduled repeat up to capacity.
+ * count is zero while values are outstanding.
+ */
+static int method_next_batch(void *handle, fnt_vect_t *vecs, int *tickets, int capacity, int *count) {
+    de_t *ptr = (de_t*)handle;
+    if( ptr == NULL )       { return FNT_FAILURE; }
+    if( vecs == NULL )      { return FNT_FAILURE; }
+    if( tickets == NULL )   { return FNT_FAILURE; }
+    if( count == NULL )     { return FNT_FAILURE; }
+
+    *count = 0;
+    while( *count < capacity ) {
+        fnt_vect_t *src = NULL;
+        int ret = de_handout(ptr, 1, &src, &tickets[*count]);
+        if( ret == FNT_CONTINUE || ret == FNT_DONE )    { break; }
+        if( ret != FNT_SUCCESS )    { return FNT_FAILURE; }
+        fnt_vect_copy(&vecs[*count], src);
+        ++*count;
     }
 
-    /* fx[curr] and x[curr] are now set correctly */
+    return FNT_SUCCESS;
+}
+
+
+static int method_next_view(void *handle, fnt_vect_t **vec) {
+    de_t *ptr = (de_t*)handle;
+    if( ptr == NULL )   { return FNT_FAILURE; }
+    if( vec == NULL )   { return FNT_FAILURE; }
+
+    /* lend the trial vector, it is adopted in method_value */
+    int ticket = 0;
+    return de_handout(ptr, 0, vec, &ticket);
+}
+
+
+/* \brief Move on from member curr, once x[curr] and fx[curr] are set.
+ * \param trial The trial vector, for reporting.
+ * \param value The trial's value.
+ */
+static int de_advance(de_t *ptr, fnt_vect_t *trial, double value) {
+
+    int curr = ptr->current;
 
     /* compare against current best value */
     if( value < ptr->fx[ptr->best] ) {
         if( fnt_verbose_level >= FNT_INFO ) {
             INFO("New best value %g ", value);
-            fnt_vect_print(vec, "for input ", NULL);
+            fnt_vect_print(trial, "for input ", NULL);
             INFO(" at position %d.\n", curr);
         }
 
@@ -582,6 +1126,8 @@ int method_value(void *handle, fnt_vect_t *vec, double value) {
         DEBUG("DEBUG: Swapping generations.\n");
         tmp = ptr->x;   ptr->x = ptr->x_prev;       ptr->x_prev = tmp;
         tmp = ptr->fx;  ptr->fx = ptr->fx_prev;     ptr->fx_prev = tmp;
+        tmp = ptr->samples; ptr->samples = ptr->samples_prev;   ptr->samples_prev = tmp;
+        tmp = ptr->m2;  ptr->m2 = ptr->m2_prev;     ptr->m2_prev = tmp;
 
         ptr->current = 0;
 
@@ -597,7 +1143,255 @@ int method_value(void *handle, fnt_vect_t *vec, double value) {
 }
 
 
-int method_done(void *handle) {
+/* \brief Add a noisy value of the trial or of the member it challenges, and
+ * settle the member once every scheduled sample has been reported.
+ */
+static int de_sample(de_t *ptr, int parent, double value) {
+
+    int curr = ptr->current;
+    ++ptr->evaluations;
+    if( ptr->outstanding > 0 )  { --ptr->outstanding; }
+
+    if( parent ) {
+        ++ptr->resamples;
+        de_accumulate(&ptr->samples_prev[curr], &ptr->fx_prev[curr], &ptr->m2_prev[curr], value);
+    } else {
+        if( ptr->trial_samples > 0 )    { ++ptr->resamples; }
+        de_accumulate(&ptr->trial_samples, &ptr->trial_mean, &ptr->trial_m2, value);
+    }
+    if( ptr->outstanding > 0 || ptr->queued_trial + ptr->queued_parent > 0 ) {
+        return FNT_SUCCESS;
+    }
+
+    int replace = 1;
+    if( ptr->state == de_initial ) {
+        if( ptr->trial_samples < ptr->min_samples ) {
+            ptr->queued_trial = ptr->min_samples - ptr->trial_samples;
+            return FNT_SUCCESS;
+        }
+    } else if( (replace = de_select(ptr)) < 0 ) {
+        return FNT_SUCCESS;
+    }
+
+    if( replace ) {
+        fnt_vect_copy(&ptr->x[curr], &ptr->v);
+        ptr->fx[curr] = ptr->trial_mean;
+        ptr->samples[curr] = ptr->trial_samples;
+        ptr->m2[curr] = ptr->trial_m2;
+    } else {
+        fnt_vect_copy(&ptr->x[curr], &ptr->x_prev[curr]);
+        ptr->fx[curr] = ptr->fx_prev[curr];
+        ptr->samples[curr] = ptr->samples_prev[curr];
+        ptr->m2[curr] = ptr->m2_prev[curr];
+    }
+    ptr->trial_samples = 0;
+    ptr->trial_mean = ptr->trial_m2 = 0.0;
+
+    return de_advance(ptr, &ptr->x[curr], ptr->fx[curr]);
+}
+
+
+static int method_value(void *handle, fnt_vect_t *vec, double value) {
+    de_t *ptr = (de_t*)handle;
+    if( ptr == NULL )   { return FNT_FAILURE; }
+
+    if( ptr->noisy ) {
+        /* anything but the trial is a repeat of the member it challenges */
+        int parent = ptr->state == de_running && vec != &ptr->v
+                     && memcmp(vec->v, ptr->v.v, ptr->dim * sizeof(double)) != 0;
+        return de_sample(ptr, parent, value);
+    }
+
+    /* remember the configuration, so trials repeating it are skipped */
+    if( ptr->has_types && de_seen_add(ptr, vec, value) != FNT_SUCCESS ) {
+        return FNT_FAILURE;
+    }
+    ++ptr->evaluations;
+    if( ptr->outstanding > 0 )  { --ptr->outstanding; }
+
+    return de_settle(ptr, vec, value);
+}
+
+
+/* \brief Select between the trial vec and the member it challenges, given
+ * the trial's value, which may come from the cache without an evaluation.
+ */
+static int de_settle(de_t *ptr, fnt_vect_t *vec, double value) {
+
+    /* replace parameter vector with v, if warranted */
+    int curr = ptr->current;
+    fnt_vect_t *trial = vec;
+    if( value < ptr->fx_prev[curr] || ptr->state == de_initial ) {
+        if( vec == &ptr->v ) {
+            /* trial vector was lent out, so adopt it by swapping buffers */
+            double *tmp = ptr->x[curr].v;
+            ptr->x[curr].v = ptr->v.v;
+            ptr->v.v = tmp;
+            trial = &ptr->x[curr];
+        } else {
+            fnt_vect_copy(&ptr->x[curr], vec);
+        }
+        ptr->fx[curr] = value;
+        if( curr == ptr->NP
+            && ptr->state == de_initial ) { ptr->state = de_running; }
+    } else {
+        fnt_vect_copy(&ptr->x[curr], &ptr->x_prev[curr]);
+        ptr->fx[curr] = ptr->fx_prev[curr];
+    }
+
+    /* fx[curr] and x[curr] are now set correctly */
+
+    return de_advance(ptr, trial, value);
+}
+
+
+/* \brief Report the value of an input handed out by method_next_batch.
+ * \param ticket DE_TICKET_TRIAL or DE_TICKET_PARENT.
+ */
+static int method_value_ticket(void *handle, int ticket, double value) {
+    de_t *ptr = (de_t*)handle;
+    if( ptr == NULL )   { return FNT_FAILURE; }
+
+    if( ticket != DE_TICKET_TRIAL && ticket != DE_TICKET_PARENT ) {
+        ERROR("ERROR: Unknown ticket %d.\n", ticket);
+        return FNT_FAILURE;
+    }
+    if( ptr->noisy )    { return de_sample(ptr, ticket == DE_TICKET_PARENT, value); }
+
+    /* without noise only the trial is handed out, and it is still in v */
+    return method_value(ptr, &ptr->v, value);
+}
+
+
+/* \brief Report a member of the population and its fitness.
+ * \param handle Pointer to the method handle.
+ * \param which Index of the population member.
+ * \param point Vector to be filled with the member, may be NULL.
+ * \param value Set to the fitness of the member, may be NULL.
+ * \return FNT_SUCCESS on success, FNT_FAILURE if which is out of range.
+ */
+static int method_sample(void *handle, int which, fnt_vect_t *point, double *value) {
+    de_t *ptr = (de_t*)handle;
+    if( ptr == NULL )   { return FNT_FAILURE; }
+    if( which < 0 )     { return FNT_FAILURE; }
+
+    /* the last complete generation is in x_prev, a partial first one in x */
+    fnt_vect_t *x = ptr->x_prev;
+    double *fx = ptr->fx_prev;
+    int count = ptr->NP;
+    if( ptr->state == de_initial ) {
+        x = ptr->x;
+        fx = ptr->fx;
+        count = ptr->current;
+    }
+    if( which >= count || which >= ptr->allocated_NP ) { return FNT_FAILURE; }
+
+    if( point ) { fnt_vect_copy(point, &x[which]); }
+    if( value ) { *value = fx[which]; }
+
+    return FNT_SUCCESS;
+}
+
+
+/* \brief Seed the population with previously evaluated points.
+ * \param handle Pointer to the method handle.
+ * \param points Points ordered by increasing value.
+ * \param values Fitness of points, or NULL if not evaluated.
+ * \param count Number of points.
+ * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
+ */
+static int method_warm_start(void *handle, fnt_vect_t *points, double *values, int count) {
+    de_t *ptr = (de_t*)handle;
+    if( ptr == NULL )       { return FNT_FAILURE; }
+    if( points == NULL )    { return FNT_FAILURE; }
+    if( count < 1 )         { return FNT_FAILURE; }
+    if( ptr->state != de_initial || ptr->current > 0 ) {
+        ERROR("ERROR: Differential evolution can only be warm started before the first evaluation.\n");
+        return FNT_FAILURE;
+    }
+
+    /* make sure the generations match NP before filling them */
+    validate_hparams(ptr);
+
+    /* without values, points replace random members of the first generation */
+    if( values == NULL ) {
+        ptr->seeded = count < ptr->NP ? count : ptr->NP;
+        for(int i=0; i<ptr->seeded; ++i) {
+            fnt_vect_copy(&ptr->x[i], &points[i]);
+        }
+        DEBUG("DEBUG: Seeded %d of %d population members.\n", ptr->seeded, ptr->NP);
+
+        return FNT_SUCCESS;
+    }
+
+    int n = count < ptr->NP ? count : ptr->NP;
+    for(int i=0; i<n; ++i) {
+        fnt_vect_copy(&ptr->x[i], &points[i]);
+        ptr->fx[i] = values[i];
+        ptr->samples[i] = 1;
+        ptr->m2[i] = 0.0;
+    }
+    for(int i=0; ptr->has_types && i<count; ++i) {
+        if( de_seen_add(ptr, &points[i], values[i]) != FNT_SUCCESS ) {
+            return FNT_FAILURE;
+        }
+    }
+    ptr->best = 0;
+
+    if( n < ptr->NP ) {
+        /* remaining members are generated as usual */
+        ptr->current = n;
+        DEBUG("DEBUG: Warm started %d of %d population members.\n", n, ptr->NP);
+
+        return FNT_SUCCESS;
+    }
+
+    /* full generation supplied, start evolving it right away */
+    for(int i=0; i<ptr->NP; ++i) {
+        fnt_vect_copy(&ptr->x_prev[i], &ptr->x[i]);
+        ptr->fx_prev[i] = ptr->fx[i];
+        ptr->samples_prev[i] = ptr->samples[i];
+        ptr->m2_prev[i] = ptr->m2[i];
+    }
+    ptr->current = 0;
+    ptr->state = de_running;
+    DEBUG("DEBUG: Warm started full population of %d.\n", ptr->NP);
+
+    return FNT_SUCCESS;
+}
+
+
+static int method_done(void *handle);
+
+
+/* \brief Run to completion, evaluating objective at each trial vector.
+ * \param handle Pointer to the method handle.
+ * \param objective Objective function.
+ * \param user Passed through to objective.
+ * \return FNT_DONE on completion, FNT_FAILURE otherwise.
+ */
+static int method_minimize(void *handle, fnt_objective_t objective, void *user) {
+    de_t *ptr = (de_t*)handle;
+    if( ptr == NULL )   { return FNT_FAILURE; }
+
+    /* evaluate inputs in place, as method_next_view lends them */
+    int ret;
+    while( (ret = method_done(ptr)) == FNT_CONTINUE ) {
+        fnt_vect_t *src = NULL;
+        int ticket = 0;
+        int next = de_handout(ptr, 0, &src, &ticket);
+        if( next == FNT_DONE )          { continue; }
+        if( next != FNT_SUCCESS )       { return FNT_FAILURE; }
+
+        double fx = objective(src, user);
+        if( method_value_ticket(ptr, ticket, fx) != FNT_SUCCESS ) { return FNT_FAILURE; }
+    }
+
+    return ret;
+}
+
+
+static int method_done(void *handle) {
     de_t *ptr = (de_t*)handle;
     if( ptr == NULL )   { return FNT_FAILURE; }
 
@@ -605,11 +1399,34 @@ int method_done(void *handle) {
         return FNT_CONTINUE;
     }
 
+    if( ptr->max_evals > 0 && ptr->evaluations >= ptr->max_evals ) {
+        INFO("Evaluation count (%d) reached limit.\n", ptr->evaluations);
+        ptr->iterations = 0;
+    }
+
     if( ptr->iterations <= 0 ) {
 
+        /* the last complete generation is in x_prev, unless the evaluation
+         * budget ran out part way through one, in which case members not
+         * challenged yet survive into it */
+        fnt_vect_t *x = ptr->x_prev;
+        double *fx = ptr->fx_prev;
+        if( ptr->current > 0 ) {
+            for(int i=ptr->current; i<ptr->NP; ++i) {
+                fnt_vect_copy(&ptr->x[i], &ptr->x_prev[i]);
+                ptr->fx[i] = ptr->fx_prev[i];
+            }
+            x = ptr->x;
+            fx = ptr->fx;
+        }
+        int best = 0;
+        for(int i=1; i<ptr->NP; ++i) {
+            if( fx[i] < fx[best] )  { best = i; }
+        }
+
         /* update result fields */
-        ptr->min_fx = ptr->fx[ptr->best];
-        fnt_vect_copy(&ptr->min_x, &ptr->x[ptr->best]);
+        ptr->min_fx = fx[best];
+        fnt_vect_copy(&ptr->min_x, &x[best]);
 
         /* mark method as complete */
         ptr->state = de_done;
@@ -621,14 +1438,42 @@ int method_done(void *handle) {
 }
 
 
-int method_result(void *handle, char *id, void *value_ptr) {
+static int method_result(void *handle, char *id, void *value_ptr) {
     de_t *ptr = (de_t*)handle;
     if( ptr == NULL )       { return FNT_FAILURE; }
 
     FNT_RESULT_GET_VECT("minimum x", id, ptr->min_x, value_ptr);
     FNT_RESULT_GET("minimum f", id, double, ptr->min_fx, value_ptr);
+    FNT_RESULT_GET("duplicates", id, int, ptr->duplicates, value_ptr);
+    FNT_RESULT_GET("evaluations", id, int, ptr->evaluations, value_ptr);
+    FNT_RESULT_GET("resamples", id, int, ptr->resamples, value_ptr);
 
     ERROR("No result named '%s'.\n", id);
 
     return FNT_FAILURE;
 }
+
+
+/* MARK: Method descriptor */
+
+fnt_method_descriptor_t fnt_method_descriptor = {
+    .abi_version       = FNT_METHOD_ABI_VERSION,
+    .capabilities      = FNT_METHOD_CAP_BATCH,
+    .name              = method_name,
+    .init              = method_init,
+    .free              = method_free,
+    .reset             = method_reset,
+    .info              = method_info,
+    .hparam_set        = method_hparam_set,
+    .hparam_get        = method_hparam_get,
+    .next              = method_next,
+    .next_batch        = method_next_batch,
+    .next_view         = method_next_view,
+    .value             = method_value,
+    .value_ticket      = method_value_ticket,
+    .sample            = method_sample,
+    .warm_start        = method_warm_start,
+    .minimize          = method_minimize,
+    .done              = method_done,
+    .result            = method_result,
+};
@@ -4,18 +4,16 @@
  *
  * Copyright (c) 2024 Bryan Franklin. All rights reserved.
  */
+#include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include "../fnt.h"
+#include "../fnt_coro.h"
 
 
 /* MARK: Method type definitions */
 
-typedef enum gradient_est_states {
-    gradient_est_initial, gradient_est_running, gradient_est_done
-} gradient_est_state_t;
-
 typedef struct gradient_est {
 
     /* hyper-parameters */
@@ -24,17 +22,246 @@ typedef struct gradient_est {
     fnt_vect_t steps;
     int has_steps_vec;
 
+    /* sparsity pattern of the Jacobian as (row, column) pairs, if any */
+    int nnz;
+    int *pat_row;
+    int *pat_col;
+
+    /* Curtis-Powell-Reid coloring, columns sharing a color are perturbed
+     * together, without a pattern every column has its own color */
+    int colors;
+    int *color;
+
     /* method state */
-    gradient_est_state_t state;
+    fnt_coro_t co;
     double fx0;
     int curr;
+    int m;                  /* residual count, 0 until residuals arrive */
+    int residuals;          /* residuals received for the current batch */
+    double *res;            /* residual of each queued point, m each */
 
     /* results */
     fnt_vect_t gradient;
+    double *jac;            /* Jacobian entries, in pattern order or dense */
 
 } gradient_est_t;
 
 
+/* MARK: Internal functions */
+
+static double gradient_est_step(gradient_est_t *ptr, int i) {
+    if( ptr->has_steps_vec ) {
+        return FNT_VECT_ELEM(ptr->steps, i);
+    }
+
+    return ptr->step;
+}
+
+
+/* Color the columns of the sparsity pattern so that no two columns with a
+ * nonzero in the same row share a color (Curtis, Powell & Reid).  Columns
+ * are colored greedily, most nonzeros first, with the lowest free color. */
+static int gradient_est_color(gradient_est_t *ptr) {
+    int n = ptr->gradient.n;
+    int rows = 0;
+    for(int k=0; k<ptr->nnz; ++k) {
+        if( ptr->pat_row[k] >= rows )   { rows = ptr->pat_row[k] + 1; }
+    }
+
+    /* nonzeros grouped by row and by column */
+    int *row_start = calloc(rows + 1, sizeof(int));
+    int *col_start = calloc(n + 1, sizeof(int));
+    int *row_cols = calloc(ptr->nnz + 1, sizeof(int));
+    int *col_rows = calloc(ptr->nnz + 1, sizeof(int));
+    int *order = calloc(n, sizeof(int));
+    int *forbidden = calloc(n, sizeof(int));
+    int ret = FNT_FAILURE;
+    if( row_start == NULL || col_start == NULL || row_cols == NULL
+        || col_rows == NULL || order == NULL || forbidden == NULL ) {
+        ERROR("ERROR: Failed to allocate coloring workspace.\n");
+        goto cleanup;
+    }
+
+    for(int k=0; k<ptr->nnz; ++k) {
+        ++row_start[ptr->pat_row[k]+1];
+        ++col_start[ptr->pat_col[k]+1];
+    }
+    for(int i=0; i<rows; ++i)   { row_start[i+1] += row_start[i]; }
+    for(int j=0; j<n; ++j)      { col_start[j+1] += col_start[j]; }
+    for(int k=0; k<ptr->nnz; ++k) {
+        row_cols[row_start[ptr->pat_row[k]]++] = ptr->pat_col[k];
+        col_rows[col_start[ptr->pat_col[k]]++] = ptr->pat_row[k];
+    }
+    for(int i=rows; i>0; --i)   { row_start[i] = row_start[i-1]; }
+    for(int j=n; j>0; --j)      { col_start[j] = col_start[j-1]; }
+    row_start[0] = col_start[0] = 0;
+
+    /* largest first ordering, by insertion since ties keep column order */
+    for(int j=0; j<n; ++j) {
+        int deg = col_start[j+1] - col_start[j];
+        int k = j;
+        while( k > 0 && col_start[order[k-1]+1] - col_start[order[k-1]] < deg ) {
+            order[k] = order[k-1];
+            --k;
+        }
+        order[k] = j;
+    }
+
+    for(int j=0; j<n; ++j)  { ptr->color[j] = -1; forbidden[j] = -1; }
+    ptr->colors = 0;
+    for(int o=0; o<n; ++o) {
+        int j = order[o];
+        for(int a=col_start[j]; a<col_start[j+1]; ++a) {
+            int i = col_rows[a];
+            for(int b=row_start[i]; b<row_start[i+1]; ++b) {
+                int c = ptr->color[row_cols[b]];
+                if( c >= 0 )    { forbidden[c] = j; }
+            }
+        }
+        int c = 0;
+        while( forbidden[c] == j )  { ++c; }
+        ptr->color[j] = c;
+        if( c + 1 > ptr->colors )   { ptr->colors = c + 1; }
+    }
+    INFO("Sparsity pattern with %d nonzeros needs %d of %d evaluations.\n",
+            ptr->nnz, ptr->colors, n);
+    ret = FNT_SUCCESS;
+
+cleanup:
+    free(row_start);    free(col_start);
+    free(row_cols);     free(col_rows);
+    free(order);        free(forbidden);
+
+    return ret;
+}
+
+
+/* Parse a sparsity pattern given as (row, column) pairs and color it. */
+static int gradient_est_pattern(gradient_est_t *ptr, fnt_vect_t *pattern) {
+    int n = ptr->gradient.n;
+    if( pattern->n == 0 ) {
+        ERROR("ERROR: Sparsity pattern has no entries.\n");
+        return FNT_FAILURE;
+    }
+    if( pattern->n % 2 != 0 ) {
+        ERROR("ERROR: Sparsity pattern needs (row, column) pairs, got %zu values.\n", pattern->n);
+        return FNT_FAILURE;
+    }
+    int nnz = pattern->n / 2;
+    int *pat_row = calloc(nnz + 1, sizeof(int));
+    int *pat_col = calloc(nnz + 1, sizeof(int));
+    if( pat_row == NULL || pat_col == NULL ) {
+        free(pat_row);  free(pat_col);
+        return FNT_FAILURE;
+    }
+    for(int k=0; k<nnz; ++k) {
+        double row = FNT_VECT_ELEM(*pattern, 2*k);
+        double col = FNT_VECT_ELEM(*pattern, 2*k+1);
+        if( row < 0 || col < 0 || col >= n || row != floor(row) || col != floor(col) ) {
+            ERROR("ERROR: Sparsity pattern entry %d, (%g, %g), is not valid.\n", k, row, col);
+            free(pat_row);  free(pat_col);
+            return FNT_FAILURE;
+        }
+        pat_row[k] = (int)row;
+        pat_col[k] = (int)col;
+    }
+
+    free(ptr->pat_row); free(ptr->pat_col);
+    free(ptr->jac);     ptr->jac = NULL;
+    ptr->pat_row = pat_row;
+    ptr->pat_col = pat_col;
+    ptr->nnz = nnz;
+
+    return gradient_est_color(ptr);
+}
+
+
+/* Jacobian entries and the gradient of half the squared residual norm,
+ * J^T r, from the residuals of each color's perturbed point. */
+static int gradient_est_jacobian(gradient_est_t *ptr) {
+    int n = ptr->gradient.n;
+    int m = ptr->m;
+    double *r0 = ptr->res;
+
+    if( ptr->jac == NULL ) {
+        ptr->jac = calloc(ptr->nnz > 0 ? (size_t)ptr->nnz : (size_t)m * n, sizeof(double));
+        if( ptr->jac == NULL )  { return FNT_FAILURE; }
+    }
+
+    fnt_vect_reset(&ptr->gradient);
+    if( ptr->nnz > 0 ) {
+        for(int k=0; k<ptr->nnz; ++k) {
+            int i = ptr->pat_row[k], j = ptr->pat_col[k];
+            if( i >= m ) {
+                ERROR("ERROR: Sparsity pattern row %d, but only %d residuals.\n", i, m);
+                return FNT_FAILURE;
+            }
+            double *r = &ptr->res[(1 + ptr->color[j]) * m];
+            ptr->jac[k] = (r[i] - r0[i]) / gradient_est_step(ptr, j);
+            FNT_VECT_ELEM(ptr->gradient, j) += ptr->jac[k] * r0[i];
+        }
+        return FNT_SUCCESS;
+    }
+
+    for(int j=0; j<n; ++j) {
+        double *r = &ptr->res[(1 + j) * m];
+        double h = gradient_est_step(ptr, j);
+        for(int i=0; i<m; ++i) {
+            ptr->jac[i*n+j] = (r[i] - r0[i]) / h;
+            FNT_VECT_ELEM(ptr->gradient, j) += ptr->jac[i*n+j] * r0[i];
+        }
+    }
+
+    return FNT_SUCCESS;
+}
+
+
+/* \brief Method logic, run as a coroutine.
+ * Every point is independent of the others, so they are all requested as a
+ * single batch.  With a sparsity pattern, each point steps along all the
+ * columns of one color.
+ */
+static int gradient_est_body(void *self) {
+    gradient_est_t *ptr = (gradient_est_t*)self;
+    fnt_coro_t *co = &ptr->co;
+
+    FNT_CORO_BEGIN(co);
+
+    /* f(x0), followed by one step along the columns of each color */
+    ptr->residuals = 0;
+    fnt_vect_copy(fnt_coro_push(co), &ptr->x0);
+    for(ptr->curr=0; ptr->curr<ptr->colors; ++ptr->curr) {
+        fnt_vect_copy(fnt_coro_push(co), &ptr->x0);
+    }
+    for(ptr->curr=0; ptr->curr<(int)ptr->gradient.n; ++ptr->curr) {
+        fnt_vect_t *x = &co->points[1 + ptr->color[ptr->curr]];
+        DEBUG("DEBUG: Updating x0 with step %i (%g).\n", ptr->curr, gradient_est_step(ptr, ptr->curr));
+        FNT_VECT_ELEM(*x, ptr->curr) += gradient_est_step(ptr, ptr->curr);
+    }
+    FNT_CORO_YIELD(co);
+
+    ptr->fx0 = co->values[0];
+    if( ptr->residuals > 0 ) {
+        if( ptr->residuals != ptr->colors + 1 ) {
+            ERROR("ERROR: Residuals are needed for every point, got %d of %d.\n",
+                    ptr->residuals, ptr->colors + 1);
+            return FNT_FAILURE;
+        }
+        if( gradient_est_jacobian(ptr) != FNT_SUCCESS ) { return FNT_FAILURE; }
+    } else if( ptr->nnz > 0 ) {
+        ERROR("ERROR: A sparsity pattern needs residual vectors, not values.\n");
+        return FNT_FAILURE;
+    } else {
+        /* estimate partial derivative with respect to each dimension */
+        for(int i=0; i<(int)ptr->gradient.n; ++i) {
+            FNT_VECT_ELEM(ptr->gradient, i) = (co->values[i+1]-ptr->fx0) / gradient_est_step(ptr, i);
+        }
+    }
+
+    FNT_CORO_END(co);
+}
+
+
 /* MARK: Functions called by FNT */
 
 /* \brief Provides the name of the method.
@@ -42,7 +269,7 @@ typedef struct gradient_est {
  * \param size Size of the name buffer in bytes.
  * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
  */
-int method_name(char *name, int size) {
+static int method_name(char *name, int size) {
     if( snprintf(name, size, "gradient estimate") >= size ) {
         return FNT_FAILURE;
     }
@@ -56,14 +283,27 @@ int method_name(char *name, int size) {
  * \param dimensions Number of dimensions in the objactive function input.
  * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
  */
-int method_init(void **handle_ptr, int dimensions) {
+static int method_init(void **handle_ptr, int dimensions) {
     if( handle_ptr == NULL )    { return FNT_FAILURE; }
     gradient_est_t *ptr = calloc(1, sizeof(gradient_est_t));
     if( ptr == NULL )           { return FNT_FAILURE; }
     *handle_ptr = (void*)ptr;
 
     /* initialize method here */
-    ptr->state = gradient_est_initial;
+    if( fnt_coro_init(&ptr->co, gradient_est_body, ptr, dimensions+1, dimensions) != FNT_SUCCESS ) {
+        free(ptr);  *handle_ptr = NULL;
+        return FNT_FAILURE;
+    }
+
+    /* every column has its own color until a sparsity pattern is set */
+    ptr->color = calloc(dimensions, sizeof(int));
+    if( ptr->color == NULL ) {
+        fnt_coro_free(&ptr->co);
+        free(ptr);  *handle_ptr = NULL;
+        return FNT_FAILURE;
+    }
+    for(int j=0; j<dimensions; ++j) { ptr->color[j] = j; }
+    ptr->colors = dimensions;
 
     /* allocate x0, steps and result vectors */
     fnt_vect_calloc(&ptr->x0, dimensions);
@@ -84,15 +324,21 @@ int method_init(void **handle_ptr, int dimensions) {
  * \param handle_ptr Pointer to the method handle pointer.
  * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
  */
-int method_free(void **handle_ptr) {
+static int method_free(void **handle_ptr) {
     if( handle_ptr == NULL )    { return FNT_FAILURE; }
     if( *handle_ptr == NULL )   { return FNT_FAILURE; }
     gradient_est_t *ptr = (gradient_est_t*)*handle_ptr;
 
     /* free any memory allocated by method */
+    fnt_coro_free(&ptr->co);
     fnt_vect_free(&ptr->x0);
     fnt_vect_free(&ptr->steps);
     fnt_vect_free(&ptr->gradient);
+    free(ptr->pat_row);
+    free(ptr->pat_col);
+    free(ptr->color);
+    free(ptr->res);
+    free(ptr->jac);
 
     free(ptr);  *handle_ptr = ptr = NULL;
 
@@ -100,27 +346,57 @@ int method_free(void **handle_ptr) {
 }
 
 
+/* \brief Return the method to its initial state, keeping hyper-parameters.
+ * \param handle Pointer to the method handle.
+ * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
+ */
+static int method_reset(void *handle) {
+    gradient_est_t *ptr = (gradient_est_t*)handle;
+    if( ptr == NULL )       { return FNT_FAILURE; }
+
+    fnt_coro_reset(&ptr->co);
+    ptr->fx0 = 0.0;
+    ptr->curr = 0;
+    ptr->residuals = 0;
+    fnt_vect_reset(&ptr->gradient);
+
+    return FNT_SUCCESS;
+}
+
+
 /* \brief Display information about the method to the console.
  * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
  */
-int method_info() {
+static int method_info() {
     printf(
 "The gradient estimation method uses small steps in each dimension to\n"
 "estimate the gradient of a fucntion at a specified point.\n"
 "\n"
+"Given residual vectors through fnt_set_value_residual, it estimates the\n"
+"Jacobian instead, and the gradient of half the squared residual norm.\n"
+"With a sparsity pattern, columns without a nonzero in a common row are\n"
+"stepped together, so only one evaluation per color is needed.\n"
+"\n"
 "Hyper-parameters:\n"
 "name\t\trequired\ttype\t\tDefault\tDescription\n"
 "x0\t\tREQUIRED\tfnt_vect_t\tnone\tPoint where the gradient is estimated.\n"
 "step\t\toptional\tdouble\t\t1e-3\tStep size to use.\n"
 "step_vec\toptional\tfnt_vect_t\tnone\tStep sizes to use in each dimension.\n"
+"sparsity\toptional\tfnt_vect_t\tdense\tNonzeros of the Jacobian, as\n"
+"\t\t\t\t\t\t\t(row, column) pairs, each once.\n"
 "\n"
 "Results:\n"
 "name\t\ttype\tDescription\n"
 "gradient\tdouble\tEstimated gradient at x0.\n"
+"jacobian\tfnt_vect_t\tRow-major Jacobian at x0, from residuals.\n"
+"jacobian values\tfnt_vect_t\tJacobian entries in sparsity pattern order.\n"
+"colors\t\tint\tNumber of stepped points.\n"
 "\n"
 "References:\n"
 "Anton, H. (1992). Calculus with analytic geometry -- 4th ed.\n"
 "\tISBN 0-471-50901-9\n"
+"Curtis, A. R., Powell, M. J. D. and Reid, J. K. (1974). On the estimation\n"
+"\tof sparse Jacobian matrices. IMA J. Appl. Math. 13, 117-119.\n"
 );
     return FNT_SUCCESS;
 }
@@ -132,7 +408,7 @@ int method_info() {
  * \param value_ptr A pointer to the value being set.
  * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
  */
-int method_hparam_set(void *handle, char *id, void *value_ptr) {
+static int method_hparam_set(void *handle, char *id, void *value_ptr) {
     if( id == NULL )        { return FNT_FAILURE; }
     if( value_ptr == NULL ) { return FNT_FAILURE; }
     if( handle == NULL )    { return FNT_FAILURE; }
@@ -147,6 +423,11 @@ int method_hparam_set(void *handle, char *id, void *value_ptr) {
         /* Note: FNT_HPARAM_SET_VECT will return FNT_SUCCESS */
     }
 
+    /* pattern length varies, so it cannot be copied into a fixed vector */
+    if( strncmp("sparsity", id, 9) == 0 ) {
+        return gradient_est_pattern(ptr, (fnt_vect_t*)value_ptr);
+    }
+
     ERROR("No hyper-parameter named '%s'.\n", id);
 
     return FNT_FAILURE;
@@ -159,7 +440,7 @@ int method_hparam_set(void *handle, char *id, void *value_ptr) {
  * \param value_ptr A pointer to the value being set.
  * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
  */
-int method_hparam_get(void *handle, char *id, void *value_ptr) {
+static int method_hparam_get(void *handle, char *id, void *value_ptr) {
     gradient_est_t *ptr = (gradient_est_t*)handle;
     if( ptr == NULL )       { return FNT_FAILURE; }
     if( id == NULL )        { return FNT_FAILURE; }
@@ -174,84 +455,139 @@ int method_hparam_get(void *handle, char *id, void *value_ptr) {
 }
 
 
-int method_next(void *handle, fnt_vect_t *vec) {
+static int method_next(void *handle, fnt_vect_t *vec) {
     gradient_est_t *ptr = (gradient_est_t*)handle;
     if( ptr == NULL )       { return FNT_FAILURE; }
     if( vec == NULL )       { return FNT_FAILURE; }
     if( vec->v == NULL )    { return FNT_FAILURE; }
 
-    /* fill vector pointed to by vec with next input to try */
-    if( ptr->state == gradient_est_initial ) {
-        return fnt_vect_copy(vec, &ptr->x0);
-    }
+    return fnt_coro_next(&ptr->co, vec);
+}
 
-    fnt_vect_copy(vec, &ptr->x0);
-    if( ptr->has_steps_vec ) {
-        DEBUG("DEBUG: Updating x0 with element %i of step vector (%g).\n", ptr->curr, FNT_VECT_ELEM(ptr->steps, ptr->curr));
-        FNT_VECT_ELEM(*vec, ptr->curr) += FNT_VECT_ELEM(ptr->steps, ptr->curr);
-    } else {
-        DEBUG("DEBUG: Updating x0 with step (%g).\n", ptr->step);
-        FNT_VECT_ELEM(*vec, ptr->curr) += ptr->step;
-    }
 
-    return FNT_SUCCESS;
+static int method_next_batch(void *handle, fnt_vect_t *vecs, int *tickets, int capacity, int *count) {
+    gradient_est_t *ptr = (gradient_est_t*)handle;
+    if( ptr == NULL )       { return FNT_FAILURE; }
+
+    return fnt_coro_next_batch(&ptr->co, vecs, tickets, capacity, count);
 }
 
 
-int method_value(void *handle, fnt_vect_t *vec, double value) {
+static int method_value(void *handle, fnt_vect_t *vec, double value) {
     gradient_est_t *ptr = (gradient_est_t*)handle;
     if( ptr == NULL )       { return FNT_FAILURE; }
     if( vec == NULL )       { return FNT_FAILURE; }
     if( vec->v == NULL )    { return FNT_FAILURE; }
 
-    /* update method using value */
-    if( ptr->state == gradient_est_initial ) {
-        ptr->fx0 = value;
-        ptr->curr = 0;
-        ptr->state = gradient_est_running;
-        return FNT_SUCCESS;
-    }
+    return fnt_coro_value(&ptr->co, value);
+}
 
-    /* estimate partial derivative with respect to current dimension */
-    double step = ptr->step;
-    if( ptr->has_steps_vec ) {
-        step = FNT_VECT_ELEM(ptr->steps, ptr->curr);
-    }
-    FNT_VECT_ELEM(ptr->gradient, ptr->curr) = (value-ptr->fx0) / step;
 
+static int method_value_residual(void *handle, fnt_vect_t *vec, fnt_vect_t *residual, fnt_vect_t *jacobian) {
+    gradient_est_t *ptr = (gradient_est_t*)handle;
+    if( ptr == NULL )       { return FNT_FAILURE; }
+    if( vec == NULL )       { return FNT_FAILURE; }
+    if( residual == NULL )  { return FNT_FAILURE; }
+    (void)jacobian;
+
+    if( ptr->m != (int)residual->n ) {
+        if( ptr->res != NULL && ptr->residuals > 0 ) {
+            ERROR("ERROR: Residual has %zu elements, expected %d.\n", residual->n, ptr->m);
+            return FNT_FAILURE;
+        }
+        free(ptr->res); free(ptr->jac);
+        ptr->jac = NULL;
+        ptr->m = residual->n;
+        ptr->res = calloc((size_t)ptr->co.capacity * ptr->m, sizeof(double));
+        if( ptr->res == NULL )  { ptr->m = 0;  return FNT_FAILURE; }
+    }
 
-    /* update state */
-    ++ptr->curr;
-    if( ptr->curr >= ptr->gradient.n ) {
-        ptr->state = gradient_est_done;
+    int ticket = fnt_coro_find(&ptr->co, vec);
+    if( ticket < 0 ) {
+        ERROR("ERROR: Residual for an input that is not outstanding.\n");
+        return FNT_FAILURE;
     }
+    memcpy(&ptr->res[ticket * ptr->m], residual->v, ptr->m * sizeof(double));
+    ++ptr->residuals;
 
-    return FNT_SUCCESS;
+    double norm = 0.0;
+    fnt_vect_l2norm(residual, &norm);
+
+    return fnt_coro_value_ticket(&ptr->co, ticket, 0.5 * norm * norm);
 }
 
 
-int method_done(void *handle) {
+static int method_value_ticket(void *handle, int ticket, double value) {
     gradient_est_t *ptr = (gradient_est_t*)handle;
     if( ptr == NULL )       { return FNT_FAILURE; }
 
-    /* test for completion
-     *  Return FNT_DONE when comlete, or FNT_CONTINUE when not done.
-     */
-    if( ptr->state == gradient_est_done )
-        return FNT_DONE;
+    return fnt_coro_value_ticket(&ptr->co, ticket, value);
+}
+
 
-    return FNT_CONTINUE;
+static int method_done(void *handle) {
+    gradient_est_t *ptr = (gradient_est_t*)handle;
+    if( ptr == NULL )       { return FNT_FAILURE; }
+
+    return fnt_coro_done(&ptr->co);
 }
 
 
-int method_result(void *handle, char *id, void *value_ptr) {
+static int method_result(void *handle, char *id, void *value_ptr) {
     gradient_est_t *ptr = (gradient_est_t*)handle;
     if( ptr == NULL )       { return FNT_FAILURE; }
 
     /* Report any results the method produces. */
     FNT_RESULT_GET_VECT("gradient", id, ptr->gradient, value_ptr);
+    FNT_RESULT_GET("colors", id, int, ptr->colors, value_ptr);
+
+    if( strncmp("jacobian", id, 9) == 0 || strncmp("jacobian values", id, 16) == 0 ) {
+        fnt_vect_t *dst = (fnt_vect_t*)value_ptr;
+        int n = ptr->gradient.n;
+        int values = id[8] != '\0';
+        size_t size = values && ptr->nnz > 0 ? (size_t)ptr->nnz : (size_t)ptr->m * n;
+        if( ptr->jac == NULL ) {
+            ERROR("ERROR: No Jacobian, residuals were not provided.\n");
+            return FNT_FAILURE;
+        }
+        if( dst->n != size ) {
+            ERROR("ERROR: Result '%s' has %zu elements, got a vector of %zu.\n", id, size, dst->n);
+            return FNT_FAILURE;
+        }
+        if( values || ptr->nnz == 0 ) {
+            memcpy(dst->v, ptr->jac, size * sizeof(double));
+            return FNT_SUCCESS;
+        }
+        fnt_vect_reset(dst);
+        for(int k=0; k<ptr->nnz; ++k) {
+            FNT_VECT_ELEM(*dst, ptr->pat_row[k]*n + ptr->pat_col[k]) = ptr->jac[k];
+        }
+        return FNT_SUCCESS;
+    }
 
     ERROR("No result named '%s'.\n", id);
 
     return FNT_FAILURE;
 }
+
+
+/* MARK: Method descriptor */
+
+fnt_method_descriptor_t fnt_method_descriptor = {
+    .abi_version       = FNT_METHOD_ABI_VERSION,
+    .capabilities      = FNT_METHOD_CAP_BATCH | FNT_METHOD_CAP_RESIDUAL,
+    .name              = method_name,
+    .init              = method_init,
+    .free              = method_free,
+    .reset             = method_reset,
+    .info              = method_info,
+    .hparam_set        = method_hparam_set,
+    .hparam_get        = method_hparam_get,
+    .next              = method_next,
+    .next_batch        = method_next_batch,
+    .value             = method_value,
+    .value_ticket      = method_value_ticket,
+    .value_residual    = method_value_residual,
+    .done              = method_done,
+    .result            = method_result,
+};
@@ -0,0 +1,436 @@
+/*
+ * hessian-estimate.c
+ * fnt: Numerical Toolbox
+ *
+ * Copyright (c) 2024 Bryan Franklin. All rights reserved.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../fnt.h"
+#include "../fnt_coro.h"
+
+
+/* MARK: Method type definitions */
+
+typedef struct hessian_est {
+    int n;
+
+    /* hyper-parameters */
+    fnt_vect_t x0;
+    double step;
+    fnt_vect_t steps;
+    int has_steps_vec;
+    int use_gradient;
+
+    /* method state */
+    fnt_coro_t co;
+    int curr;
+    int pair;
+    int gradients;          /* gradients received for the current batch */
+    double *grad;           /* gradient of each queued point, n each */
+
+    /* results */
+    fnt_vect_t hessian;     /* lower triangle, packed row by row */
+    fnt_vect_t gradient;
+
+} hessian_est_t;
+
+
+/* MARK: Internal functions */
+
+static double hessian_est_step(hessian_est_t *ptr, int i) {
+    if( ptr->has_steps_vec ) {
+        return FNT_VECT_ELEM(ptr->steps, i);
+    }
+
+    return ptr->step;
+}
+
+
+/* Packed index of H(i,j), either triangle. */
+static int hessian_est_index(int i, int j) {
+    if( i < j ) { int tmp = i;  i = j;  j = tmp; }
+
+    return i * (i + 1) / 2 + j;
+}
+
+
+/* Points in the stencil, x0 and x0 +/- h_i e_i are shared by the diagonal
+ * and every off-diagonal entry, only x0 +/- (h_i e_i + h_j e_j) is needed
+ * per pair.  With gradients, only x0 +/- h_i e_i are needed. */
+static int hessian_est_points(hessian_est_t *ptr) {
+    int n = ptr->n;
+
+    return ptr->use_gradient ? 2 * n : 1 + 2 * n + n * (n - 1);
+}
+
+
+/* \brief Method logic, run as a coroutine.
+ * The whole stencil is independent, so it is requested as a single batch.
+ * Points are queued as x0 + h_i e_i, x0 - h_i e_i, then, without gradients,
+ * x0 itself and x0 +/- (h_i e_i + h_j e_j) for each pair i < j.
+ */
+static int hessian_est_body(void *self) {
+    hessian_est_t *ptr = (hessian_est_t*)self;
+    fnt_coro_t *co = &ptr->co;
+    int n = ptr->n;
+
+    FNT_CORO_BEGIN(co);
+
+    ptr->gradients = 0;
+    for(ptr->curr=0; ptr->curr<2*n; ++ptr->curr) {
+        fnt_vect_t *x = fnt_coro_push(co);
+        int i = ptr->curr % n;
+        fnt_vect_copy(x, &ptr->x0);
+        FNT_VECT_ELEM(*x, i) += ptr->curr < n ? hessian_est_step(ptr, i) : -hessian_est_step(ptr, i);
+    }
+    if( !ptr->use_gradient ) {
+        fnt_vect_copy(fnt_coro_push(co), &ptr->x0);
+        for(ptr->curr=0; ptr->curr<n; ++ptr->curr) {
+            for(ptr->pair=ptr->curr+1; ptr->pair<n; ++ptr->pair) {
+                for(int sign=1; sign>=-1; sign-=2) {
+                    fnt_vect_t *x = fnt_coro_push(co);
+                    fnt_vect_copy(x, &ptr->x0);
+                    FNT_VECT_ELEM(*x, ptr->curr) += sign * hessian_est_step(ptr, ptr->curr);
+                    FNT_VECT_ELEM(*x, ptr->pair) += sign * hessian_est_step(ptr, ptr->pair);
+                }
+            }
+        }
+    }
+    DEBUG("DEBUG: Queued %d stencil points.\n", co->count);
+    FNT_CORO_YIELD(co);
+
+    if( ptr->use_gradient ) {
+        if( ptr->gradients != 2 * n ) {
+            ERROR("ERROR: Gradients are needed for every point, got %d of %d.\n",
+                    ptr->gradients, 2 * n);
+            return FNT_FAILURE;
+        }
+
+        /* central differences of the gradient, averaged across the diagonal */
+        fnt_vect_reset(&ptr->hessian);
+        fnt_vect_reset(&ptr->gradient);
+        for(int i=0; i<n; ++i) {
+            double *gp = &ptr->grad[i * n];
+            double *gm = &ptr->grad[(n + i) * n];
+            double h = hessian_est_step(ptr, i);
+            for(int j=0; j<n; ++j) {
+                double weight = i == j ? 0.5 : 0.25;
+                FNT_VECT_ELEM(ptr->hessian, hessian_est_index(i, j)) += weight * (gp[j] - gm[j]) / h;
+                FNT_VECT_ELEM(ptr->gradient, j) += 0.5 * (gp[j] + gm[j]) / n;
+            }
+        }
+    } else {
+        double *v = co->values;
+        double f0 = v[2*n];
+        int p = 2*n + 1;
+        for(int i=0; i<n; ++i) {
+            double hi = hessian_est_step(ptr, i);
+            double fpi = v[i], fmi = v[n + i];
+            FNT_VECT_ELEM(ptr->gradient, i) = (fpi - fmi) / (2.0 * hi);
+            FNT_VECT_ELEM(ptr->hessian, hessian_est_index(i, i)) = (fpi - 2.0 * f0 + fmi) / (hi * hi);
+            for(int j=i+1; j<n; ++j, p+=2) {
+                double hj = hessian_est_step(ptr, j);
+                double fpj = v[j], fmj = v[n + j];
+                FNT_VECT_ELEM(ptr->hessian, hessian_est_index(i, j)) =
+                    (v[p] - fpi - fpj + 2.0 * f0 - fmi - fmj + v[p+1]) / (2.0 * hi * hj);
+            }
+        }
+    }
+
+    FNT_CORO_END(co);
+}
+
+
+/* Size the stencil once hyper-parameters are final. */
+static int hessian_est_ready(hessian_est_t *ptr) {
+    int points = hessian_est_points(ptr);
+    if( ptr->co.capacity == points )    { return FNT_SUCCESS; }
+
+    if( ptr->co.capacity > 0 )  { fnt_coro_free(&ptr->co); }
+    free(ptr->grad);    ptr->grad = NULL;
+    if( fnt_coro_init(&ptr->co, hessian_est_body, ptr, points, ptr->n) != FNT_SUCCESS ) {
+        return FNT_FAILURE;
+    }
+    if( ptr->use_gradient ) {
+        ptr->grad = calloc((size_t)points * ptr->n, sizeof(double));
+        if( ptr->grad == NULL ) { return FNT_FAILURE; }
+    }
+
+    return FNT_SUCCESS;
+}
+
+
+/* MARK: Functions called by FNT */
+
+/* \brief Provides the name of the method.
+ * \param name Allocated buffer to hold the name.
+ * \param size Size of the name buffer in bytes.
+ * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
+ */
+static int method_name(char *name, int size) {
+    if( snprintf(name, size, "hessian estimate") >= size ) {
+        return FNT_FAILURE;
+    }
+
+    return FNT_SUCCESS;
+}
+
+
+/* \brief Initialize intenal state for method.
+ * \param handle_ptr Pointer to the method handle pointer.
+ * \param dimensions Number of dimensions in the objactive function input.
+ * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
+ */
+static int method_init(void **handle_ptr, int dimensions) {
+    if( handle_ptr == NULL )    { return FNT_FAILURE; }
+    if( dimensions < 1 )        { return FNT_FAILURE; }
+    hessian_est_t *ptr = calloc(1, sizeof(hessian_est_t));
+    if( ptr == NULL )           { return FNT_FAILURE; }
+    *handle_ptr = (void*)ptr;
+
+    /* the stencil is allocated by hessian_est_ready, its size depends on
+     * use_gradient */
+    ptr->n = dimensions;
+    fnt_vect_calloc(&ptr->x0, dimensions);
+    fnt_vect_calloc(&ptr->steps, dimensions);
+    fnt_vect_calloc(&ptr->hessian, dimensions * (dimensions + 1) / 2);
+    fnt_vect_calloc(&ptr->gradient, dimensions);
+
+    /* set default step size, about the fourth root of machine epsilon */
+    ptr->step = 1e-4;
+    for(int i=0; i<dimensions; ++i) {
+        FNT_VECT_ELEM(ptr->steps, i) = ptr->step;
+    }
+
+    return FNT_SUCCESS;
+}
+
+
+/* \brief Free any resources allocated for the method.
+ * \param handle_ptr Pointer to the method handle pointer.
+ * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
+ */
+static int method_free(void **handle_ptr) {
+    if( handle_ptr == NULL )    { return FNT_FAILURE; }
+    if( *handle_ptr == NULL )   { return FNT_FAILURE; }
+    hessian_est_t *ptr = (hessian_est_t*)*handle_ptr;
+
+    /* free any memory allocated by method */
+    if( ptr->co.capacity > 0 )  { fnt_coro_free(&ptr->co); }
+    free(ptr->grad);
+    fnt_vect_free(&ptr->x0);
+    fnt_vect_free(&ptr->steps);
+    fnt_vect_free(&ptr->hessian);
+    fnt_vect_free(&ptr->gradient);
+
+    free(ptr);  *handle_ptr = ptr = NULL;
+
+    return FNT_SUCCESS;
+}
+
+
+/* \brief Return the method to its initial state, keeping hyper-parameters.
+ * \param handle Pointer to the method handle.
+ * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
+ */
+static int method_reset(void *handle) {
+    hessian_est_t *ptr = (hessian_est_t*)handle;
+    if( ptr == NULL )       { return FNT_FAILURE; }
+
+    if( ptr->co.capacity > 0 )  { fnt_coro_reset(&ptr->co); }
+    ptr->curr = ptr->pair = ptr->gradients = 0;
+    fnt_vect_reset(&ptr->hessian);
+    fnt_vect_reset(&ptr->gradient);
+
+    return FNT_SUCCESS;
+}
+
+
+/* \brief Display information about the method to the console.
+ * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
+ */
+static int method_info() {
+    printf(
+"The Hessian estimation method uses a second difference stencil around a\n"
+"specified point to estimate the matrix of second partial derivatives.\n"
+"All points of the stencil are requested as a single batch, with the\n"
+"points shared between entries requested once: 1 + 2n + n(n-1) points\n"
+"from values, or 2n points when gradients are given through\n"
+"fnt_set_value_gradient.\n"
+"\n"
+"Hyper-parameters:\n"
+"name\t\trequired\ttype\t\tDefault\tDescription\n"
+"x0\t\tREQUIRED\tfnt_vect_t\tnone\tPoint where the Hessian is estimated.\n"
+"step\t\toptional\tdouble\t\t1e-4\tStep size to use.\n"
+"step_vec\toptional\tfnt_vect_t\tnone\tStep sizes to use in each dimension.\n"
+"use_gradient\toptional\tint\t\t0\tDifference gradients instead of values.\n"
+"\n"
+"Results:\n"
+"name\t\ttype\t\tDescription\n"
+"hessian\t\tfnt_vect_t\tLower triangle of the Hessian, packed row by\n"
+"\t\t\t\trow, H(i,j) at i(i+1)/2 + j for j <= i.\n"
+"gradient\tfnt_vect_t\tGradient at x0, as a by-product.\n"
+"\n"
+"References:\n"
+"Nocedal, J. and Wright, S. J. (2006). Numerical Optimization, 2nd ed.,\n"
+"\tsection 8.1. ISBN 978-0-387-30303-1\n"
+);
+    return FNT_SUCCESS;
+}
+
+
+/* \brief Set any hyper-parameters needed for the method.
+ * \param handle Pointer to the method handle.
+ * \param id The name of the hyper-parameter.
+ * \param value_ptr A pointer to the value being set.
+ * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
+ */
+static int method_hparam_set(void *handle, char *id, void *value_ptr) {
+    if( id == NULL )        { return FNT_FAILURE; }
+    if( value_ptr == NULL ) { return FNT_FAILURE; }
+    if( handle == NULL )    { return FNT_FAILURE; }
+    hessian_est_t *ptr = (hessian_est_t*)handle;
+
+    FNT_HPARAM_SET("step", id, double, value_ptr, ptr->step);
+    FNT_HPARAM_SET("use_gradient", id, int, value_ptr, ptr->use_gradient);
+    FNT_HPARAM_SET_VECT("x0", id, value_ptr, &ptr->x0);
+
+    if( strncmp("step_vec", id, 9) == 0 ) {
+        ptr->has_steps_vec = 1;
+        FNT_HPARAM_SET_VECT("step_vec", id, value_ptr, &ptr->steps);
+    }
+
+    ERROR("No hyper-parameter named '%s'.\n", id);
+
+    return FNT_FAILURE;
+}
+
+
+/* \brief Get any hyper-parameters values form the method.
+ * \param handle Pointer to the method handle.
+ * \param id The name of the hyper-parameter.
+ * \param value_ptr A pointer to the value being set.
+ * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
+ */
+static int method_hparam_get(void *handle, char *id, void *value_ptr) {
+    hessian_est_t *ptr = (hessian_est_t*)handle;
+    if( ptr == NULL )       { return FNT_FAILURE; }
+    if( id == NULL )        { return FNT_FAILURE; }
+    if( value_ptr == NULL ) { return FNT_FAILURE; }
+
+    FNT_HPARAM_GET("step", id, double, ptr->step, value_ptr);
+    FNT_HPARAM_GET("use_gradient", id, int, ptr->use_gradient, value_ptr);
+    FNT_HPARAM_GET_VECT("x0", id, &ptr->x0, value_ptr);
+
+    ERROR("No hyper-parameter named '%s'.\n", id);
+
+    return FNT_FAILURE;
+}
+
+
+static int method_next(void *handle, fnt_vect_t *vec) {
+    hessian_est_t *ptr = (hessian_est_t*)handle;
+    if( ptr == NULL )       { return FNT_FAILURE; }
+    if( vec == NULL )       { return FNT_FAILURE; }
+    if( vec->v == NULL )    { return FNT_FAILURE; }
+    if( hessian_est_ready(ptr) != FNT_SUCCESS ) { return FNT_FAILURE; }
+
+    return fnt_coro_next(&ptr->co, vec);
+}
+
+
+static int method_next_batch(void *handle, fnt_vect_t *vecs, int *tickets, int capacity, int *count) {
+    hessian_est_t *ptr = (hessian_est_t*)handle;
+    if( ptr == NULL )       { return FNT_FAILURE; }
+    if( hessian_est_ready(ptr) != FNT_SUCCESS ) { return FNT_FAILURE; }
+
+    return fnt_coro_next_batch(&ptr->co, vecs, tickets, capacity, count);
+}
+
+
+static int method_value(void *handle, fnt_vect_t *vec, double value) {
+    hessian_est_t *ptr = (hessian_est_t*)handle;
+    if( ptr == NULL )       { return FNT_FAILURE; }
+    if( vec == NULL )       { return FNT_FAILURE; }
+    if( vec->v == NULL )    { return FNT_FAILURE; }
+    if( ptr->co.capacity == 0 ) { return FNT_FAILURE; }
+
+    return fnt_coro_value(&ptr->co, value);
+}
+
+
+static int method_value_ticket(void *handle, int ticket, double value) {
+    hessian_est_t *ptr = (hessian_est_t*)handle;
+    if( ptr == NULL )       { return FNT_FAILURE; }
+    if( ptr->co.capacity == 0 ) { return FNT_FAILURE; }
+
+    return fnt_coro_value_ticket(&ptr->co, ticket, value);
+}
+
+
+static int method_value_gradient(void *handle, fnt_vect_t *vec, double value, fnt_vect_t *gradient) {
+    hessian_est_t *ptr = (hessian_est_t*)handle;
+    if( ptr == NULL )       { return FNT_FAILURE; }
+    if( vec == NULL )       { return FNT_FAILURE; }
+    if( gradient == NULL )  { return FNT_FAILURE; }
+    if( ptr->co.capacity == 0 ) { return FNT_FAILURE; }
+
+    int ticket = fnt_coro_find(&ptr->co, vec);
+    if( ticket < 0 ) {
+        ERROR("ERROR: Gradient for an input that is not outstanding.\n");
+        return FNT_FAILURE;
+    }
+    if( ptr->grad != NULL ) {
+        memcpy(&ptr->grad[ticket * ptr->n], gradient->v, ptr->n * sizeof(double));
+        ++ptr->gradients;
+    }
+
+    return fnt_coro_value_ticket(&ptr->co, ticket, value);
+}
+
+
+static int method_done(void *handle) {
+    hessian_est_t *ptr = (hessian_est_t*)handle;
+    if( ptr == NULL )       { return FNT_FAILURE; }
+    if( ptr->co.capacity == 0 ) { return FNT_CONTINUE; }
+
+    return fnt_coro_done(&ptr->co);
+}
+
+
+static int method_result(void *handle, char *id, void *value_ptr) {
+    hessian_est_t *ptr = (hessian_est_t*)handle;
+    if( ptr == NULL )       { return FNT_FAILURE; }
+
+    /* Report any results the method produces. */
+    FNT_RESULT_GET_VECT("hessian", id, ptr->hessian, value_ptr);
+    FNT_RESULT_GET_VECT("gradient", id, ptr->gradient, value_ptr);
+
+    ERROR("No result named '%s'.\n", id);
+
+    return FNT_FAILURE;
+}
+
+
+/* MARK: Method descriptor */
+
+fnt_method_descriptor_t fnt_method_descriptor = {
+    .abi_version       = FNT_METHOD_ABI_VERSION,
+    .capabilities      = FNT_METHOD_CAP_BATCH | FNT_METHOD_CAP_GRADIENT,
+    .name              = method_name,
+    .init              = method_init,
+    .free              = method_free,
+    .reset             = method_reset,
+    .info              = method_info,
+    .hparam_set        = method_hparam_set,
+    .hparam_get        = method_hparam_get,
+    .next              = method_next,
+    .next_batch        = method_next_batch,
+    .value             = method_value,
+    .value_ticket      = method_value_ticket,
+    .value_gradient    = method_value_gradient,
+    .done              = method_done,
+    .result            = method_result,
+};
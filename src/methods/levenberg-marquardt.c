@@ -0,0 +1,813 @@
+/*
+ * levenberg-marquardt.c
+ * fnt: Numerical Toolbox
+ *
+ * Copyright (c) 2024 Bryan Franklin. All rights reserved.
+ */
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../fnt.h"
+
+
+/* MARK: Method type definitions */
+
+typedef enum lm_state {
+    lm_initial, lm_jacobian, lm_trial, lm_done
+} lm_state_t;
+
+#define LM_BLOCK        32      /* columns per Householder panel */
+#define LM_MAX_DAMPING  1e30    /* give up once damping grows past this */
+
+typedef struct lm {
+    int n;
+    int m;                  /* residual count, known after first evaluation */
+
+    /* hyper-parameters */
+    fnt_vect_t x0;
+    double tau;
+    double g_tol;
+    double x_tol;
+    double fd_step;
+    int max_iter;
+
+    /* method state */
+    lm_state_t state;
+    int iterations;
+    fnt_vect_t x;           /* current iterate and its residual */
+    double *r;
+    double cost;            /* 0.5 |r|^2 */
+    double *J;              /* column-major m*n Jacobian at x */
+    double *fd_h;           /* finite difference step per column */
+    char *issued;           /* per column, handed out by next_batch */
+    char *known;            /* per column, residual received */
+    fnt_vect_t x_t;         /* trial point x + p */
+    double *J_t;            /* column-major Jacobian supplied at x_t */
+    fnt_vect_t p;
+    double mu;              /* damping */
+    double nu;              /* damping growth factor */
+
+    /* QR workspace, column-major (m+n) x (n+1) with right hand side last */
+    double *A;
+    double *tau_qr;
+    double *T;              /* LM_BLOCK x LM_BLOCK triangular factor */
+    double *w;
+
+    /* results */
+    fnt_vect_t minimum_x;
+    double minimum_f;
+    fnt_vect_t covariance;
+    int reported;
+
+} lm_t;
+
+
+/* MARK: Internal functions */
+
+/* Allocate storage that depends on the residual count. */
+static int lm_alloc(lm_t *ptr, int m) {
+    int n = ptr->n;
+    if( ptr->m == m )   { return FNT_SUCCESS; }
+
+    free(ptr->r);   free(ptr->J);   free(ptr->J_t);
+    free(ptr->A);
+    ptr->m = m;
+    ptr->r = calloc(m, sizeof(double));
+    ptr->J = calloc((size_t)m * n, sizeof(double));
+    ptr->J_t = calloc((size_t)m * n, sizeof(double));
+    ptr->A = calloc((size_t)(m + n) * (n + 1), sizeof(double));
+    if( ptr->r == NULL || ptr->J == NULL || ptr->J_t == NULL || ptr->A == NULL ) {
+        ERROR("ERROR: Failed to allocate storage for %d residuals.\n", m);
+        ptr->m = 0;
+        return FNT_FAILURE;
+    }
+
+    return FNT_SUCCESS;
+}
+
+
+/* Copy a row-major m*n Jacobian into column-major storage. */
+static void lm_transpose(int m, int n, double *src, double *dst) {
+    for(int i=0; i<m; ++i) {
+        for(int j=0; j<n; ++j) {
+            dst[j*m+i] = src[i*n+j];
+        }
+    }
+}
+
+
+/* Blocked Householder QR of the column-major rows x cols matrix A (leading
+ * dimension lda).  Each panel of LM_BLOCK columns is factored one column
+ * at a time, then its reflectors are aggregated as I - V T V^T and applied
+ * to each trailing column in a single pass, so the panel stays in cache
+ * instead of every reflector sweeping the whole trailing matrix.  The
+ * reflectors are left below the diagonal, R on and above it. */
+static int lm_qr(lm_t *ptr, double *A, int lda, int rows, int cols, int factor) {
+    double *tau = ptr->tau_qr;
+    double *T = ptr->T;
+    double *w = ptr->w;
+
+    for(int k0=0; k0<factor; k0+=LM_BLOCK) {
+        int kb = factor - k0 < LM_BLOCK ? factor - k0 : LM_BLOCK;
+
+        /* factor the panel */
+        for(int j=k0; j<k0+kb; ++j) {
+            double *col = &A[j*lda];
+            double alpha = col[j];
+            double xnorm = 0.0;
+            for(int i=j+1; i<rows; ++i) { xnorm += col[i] * col[i]; }
+            xnorm = sqrt(xnorm);
+            if( xnorm == 0.0 ) {
+                tau[j] = 0.0;
+                continue;
+            }
+            double beta = alpha >= 0.0 ? -hypot(alpha, xnorm) : hypot(alpha, xnorm);
+            tau[j] = (beta - alpha) / beta;
+            double scale = 1.0 / (alpha - beta);
+            for(int i=j+1; i<rows; ++i) { col[i] *= scale; }
+            col[j] = beta;
+
+            for(int c=j+1; c<k0+kb; ++c) {
+                double *dst = &A[c*lda];
+                double dot = dst[j];
+                for(int i=j+1; i<rows; ++i) { dot += col[i] * dst[i]; }
+                dot *= tau[j];
+                dst[j] -= dot;
+                for(int i=j+1; i<rows; ++i) { dst[i] -= dot * col[i]; }
+            }
+        }
+        if( k0 + kb >= cols ) { continue; }
+
+        /* T, upper triangular, such that H_k0 ... H_k0+kb-1 = I - V T V^T */
+        for(int i=0; i<kb; ++i) {
+            int ri = k0 + i;
+            for(int l=0; l<i; ++l) {
+                double *vl = &A[(k0+l)*lda];
+                double dot = vl[ri];
+                for(int r=ri+1; r<rows; ++r) { dot += vl[r] * A[ri*lda+r]; }
+                w[l] = -tau[ri] * dot;
+            }
+            for(int l=0; l<i; ++l) {
+                double sum = 0.0;
+                for(int q=l; q<i; ++q) { sum += T[l*LM_BLOCK+q] * w[q]; }
+                T[l*LM_BLOCK+i] = sum;
+            }
+            T[i*LM_BLOCK+i] = tau[ri];
+        }
+
+        /* C -= V T^T V^T C, one trailing column at a time */
+        for(int c=k0+kb; c<cols; ++c) {
+            double *dst = &A[c*lda];
+            for(int l=0; l<kb; ++l) {
+                double *vl = &A[(k0+l)*lda];
+                double dot = dst[k0+l];
+                for(int r=k0+l+1; r<rows; ++r) { dot += vl[r] * dst[r]; }
+                w[l] = dot;
+            }
+            for(int l=kb-1; l>=0; --l) {
+                double sum = 0.0;
+                for(int q=0; q<=l; ++q) { sum += T[q*LM_BLOCK+l] * w[q]; }
+                w[l] = sum;
+            }
+            for(int l=0; l<kb; ++l) {
+                double *vl = &A[(k0+l)*lda];
+                dst[k0+l] -= w[l];
+                for(int r=k0+l+1; r<rows; ++r) { dst[r] -= w[l] * vl[r]; }
+            }
+        }
+    }
+
+    for(int j=0; j<factor; ++j) {
+        if( A[j*lda+j] == 0.0 ) {
+            return FNT_FAILURE;
+        }
+    }
+
+    return FNT_SUCCESS;
+}
+
+
+/* Solve min |[J; sqrt(mu) I] p + [r; 0]| for the step p. */
+static int lm_step(lm_t *ptr) {
+    int m = ptr->m, n = ptr->n;
+    int lda = m + n;
+    double *A = ptr->A;
+    double damp = sqrt(ptr->mu);
+
+    memset(A, 0, (size_t)lda * (n + 1) * sizeof(double));
+    for(int j=0; j<n; ++j) {
+        memcpy(&A[j*lda], &ptr->J[j*m], m * sizeof(double));
+        A[j*lda+m+j] = damp;
+    }
+    for(int i=0; i<m; ++i) { A[n*lda+i] = -ptr->r[i]; }
+
+    if( lm_qr(ptr, A, lda, lda, n + 1, n) != FNT_SUCCESS ) {
+        ERROR("ERROR: Damped Jacobian is rank deficient.\n");
+        return FNT_FAILURE;
+    }
+
+    /* back substitution, R p = Q^T b */
+    for(int j=n-1; j>=0; --j) {
+        double sum = A[n*lda+j];
+        for(int k=j+1; k<n; ++k) { sum -= A[k*lda+j] * FNT_VECT_ELEM(ptr->p, k); }
+        FNT_VECT_ELEM(ptr->p, j) = sum / A[j*lda+j];
+    }
+
+    for(int j=0; j<n; ++j) {
+        FNT_VECT_ELEM(ptr->x_t, j) = FNT_VECT_ELEM(ptr->x, j) + FNT_VECT_ELEM(ptr->p, j);
+    }
+
+    return FNT_SUCCESS;
+}
+
+
+/* Covariance of the fit, s^2 (J^T J)^-1 = s^2 R^-1 R^-T, with s^2 the
+ * residual variance |r|^2 / (m - n) when there are more residuals than
+ * parameters. */
+static void lm_covariance(lm_t *ptr) {
+    int m = ptr->m, n = ptr->n;
+    int lda = m + n;
+    double *A = ptr->A;
+
+    memset(A, 0, (size_t)lda * (n + 1) * sizeof(double));
+    for(int j=0; j<n; ++j) {
+        memcpy(&A[j*lda], &ptr->J[j*m], m * sizeof(double));
+    }
+    if( m < n || lm_qr(ptr, A, lda, m, n, n) != FNT_SUCCESS ) {
+        WARN("WARN: Jacobian is rank deficient, covariance is undefined.\n");
+        for(int k=0; k<n*n; ++k) { FNT_VECT_ELEM(ptr->covariance, k) = NAN; }
+        return;
+    }
+
+    /* invert R into the unused damping rows, Rinv(i,j) at A[j*lda+m+i] */
+    double *Rinv = &A[m];
+    for(int j=0; j<n; ++j) {
+        for(int i=0; i<n; ++i) { Rinv[j*lda+i] = 0.0; }
+    }
+    for(int j=0; j<n; ++j) {
+        Rinv[j*lda+j] = 1.0 / A[j*lda+j];
+        for(int i=j-1; i>=0; --i) {
+            double sum = 0.0;
+            for(int k=i+1; k<=j; ++k) { sum += A[k*lda+i] * Rinv[j*lda+k]; }
+            Rinv[j*lda+i] = -sum / A[i*lda+i];
+        }
+    }
+
+    double s2 = m > n ? 2.0 * ptr->cost / (m - n) : 1.0;
+    for(int i=0; i<n; ++i) {
+        for(int j=i; j<n; ++j) {
+            double sum = 0.0;
+            for(int k=j; k<n; ++k) { sum += Rinv[k*lda+i] * Rinv[k*lda+j]; }
+            FNT_VECT_ELEM(ptr->covariance, i*n+j) = s2 * sum;
+            FNT_VECT_ELEM(ptr->covariance, j*n+i) = s2 * sum;
+        }
+    }
+}
+
+
+/* Start an iteration once the Jacobian at x is complete. */
+static int lm_iterate(lm_t *ptr) {
+    int m = ptr->m, n = ptr->n;
+
+    double g_max = 0.0;
+    double jtj_max = 0.0;
+    for(int j=0; j<n; ++j) {
+        double g = 0.0, d = 0.0;
+        for(int i=0; i<m; ++i) {
+            g += ptr->J[j*m+i] * ptr->r[i];
+            d += ptr->J[j*m+i] * ptr->J[j*m+i];
+        }
+        g_max = fmax(g_max, fabs(g));
+        jtj_max = fmax(jtj_max, d);
+    }
+    if( ptr->iterations == 0 && ptr->mu == 0.0 ) {
+        ptr->mu = ptr->tau * (jtj_max > 0.0 ? jtj_max : 1.0);
+        ptr->nu = 2.0;
+    }
+
+    if( g_max < ptr->g_tol ) {
+        INFO("Gradient (%g) below g_tol (%g).\n", g_max, ptr->g_tol);
+        ptr->state = lm_done;
+        return FNT_SUCCESS;
+    }
+    if( ptr->iterations >= ptr->max_iter ) {
+        INFO("Iteration count (%d) reached limit.\n", ptr->iterations);
+        ptr->state = lm_done;
+        return FNT_SUCCESS;
+    }
+
+    return lm_step(ptr);
+}
+
+
+/* Decide whether the trial step is short enough to stop. */
+static int lm_converged(lm_t *ptr) {
+    double step = 0.0, size = 0.0;
+    fnt_vect_l2norm(&ptr->p, &step);
+    fnt_vect_l2norm(&ptr->x, &size);
+
+    return step <= ptr->x_tol * (size + ptr->x_tol);
+}
+
+
+/* Record the residual, and perhaps Jacobian, at an accepted point. */
+static int lm_accept(lm_t *ptr, fnt_vect_t *vec, fnt_vect_t *residual, double *jacobian_cm) {
+    fnt_vect_copy(&ptr->x, vec);
+    memcpy(ptr->r, residual->v, ptr->m * sizeof(double));
+
+    if( jacobian_cm == NULL ) {
+        memset(ptr->issued, 0, ptr->n);
+        memset(ptr->known, 0, ptr->n);
+        for(int j=0; j<ptr->n; ++j) {
+            ptr->fd_h[j] = ptr->fd_step * fmax(1.0, fabs(FNT_VECT_ELEM(ptr->x, j)));
+        }
+        ptr->state = lm_jacobian;
+        return FNT_SUCCESS;
+    }
+    if( jacobian_cm != ptr->J ) {
+        memcpy(ptr->J, jacobian_cm, (size_t)ptr->m * ptr->n * sizeof(double));
+    }
+    ptr->state = lm_trial;
+
+    return lm_iterate(ptr);
+}
+
+
+/* Find which finite difference column vec was issued for. */
+static int lm_column(lm_t *ptr, fnt_vect_t *vec) {
+    int n = ptr->n;
+    int column = -1;
+
+    for(int j=0; j<n; ++j) {
+        double expect = FNT_VECT_ELEM(ptr->x, j);
+        double actual = FNT_VECT_ELEM(*vec, j);
+        if( actual == expect )  { continue; }
+        if( column >= 0 || actual != expect + ptr->fd_h[j] ) {
+            return -1;
+        }
+        column = j;
+    }
+
+    return column;
+}
+
+
+/* Fill in finite difference column j of the Jacobian from its residual,
+ * moving on to the trial step once every column is known. */
+static int lm_column_value(lm_t *ptr, int j, fnt_vect_t *residual) {
+    int n = ptr->n;
+    int m = ptr->m;
+
+    if( ptr->known[j] ) { return FNT_SUCCESS; }
+    for(int i=0; i<m; ++i) {
+        ptr->J[j*m+i] = (FNT_VECT_ELEM(*residual, i) - ptr->r[i]) / ptr->fd_h[j];
+    }
+    ptr->known[j] = 1;
+    for(int k=0; k<n; ++k) {
+        if( !ptr->known[k] )    { return FNT_SUCCESS; }
+    }
+    ptr->state = lm_trial;
+    if( lm_iterate(ptr) != FNT_SUCCESS )    { return FNT_FAILURE; }
+    if( ptr->state == lm_trial && lm_converged(ptr) ) {
+        ptr->state = lm_done;
+    }
+
+    return FNT_SUCCESS;
+}
+
+
+/* MARK: Functions called by FNT */
+
+/* \brief Provides the name of the method.
+ * \param name Allocated buffer to hold the name.
+ * \param size Size of the name buffer in bytes.
+ * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
+ */
+static int method_name(char *name, int size) {
+    if( snprintf(name, size, "levenberg-marquardt") >= size ) {
+        return FNT_FAILURE;
+    }
+
+    return FNT_SUCCESS;
+}
+
+
+/* \brief Initialize intenal state for method.
+ * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
+ */
+static int method_init(void **handle_ptr, int dimensions) {
+    if( handle_ptr == NULL )    { return FNT_FAILURE; }
+    if( dimensions < 1 )        { return FNT_FAILURE; }
+    lm_t *ptr = calloc(1, sizeof(lm_t));
+    if( ptr == NULL )           { return FNT_FAILURE; }
+    *handle_ptr = (void*)ptr;
+
+    /* initialize method here */
+    ptr->n = dimensions;
+    ptr->tau = 1e-3;
+    ptr->g_tol = 1e-10;
+    ptr->x_tol = 1e-10;
+    ptr->fd_step = 1e-7;
+    ptr->max_iter = 100;
+    ptr->state = lm_initial;
+
+    ptr->fd_h = calloc(dimensions, sizeof(double));
+    ptr->issued = calloc(dimensions, 1);
+    ptr->known = calloc(dimensions, 1);
+    ptr->tau_qr = calloc(dimensions, sizeof(double));
+    ptr->T = calloc(LM_BLOCK * LM_BLOCK, sizeof(double));
+    ptr->w = calloc(LM_BLOCK, sizeof(double));
+    fnt_vect_calloc(&ptr->x0, dimensions);
+    fnt_vect_calloc(&ptr->x, dimensions);
+    fnt_vect_calloc(&ptr->x_t, dimensions);
+    fnt_vect_calloc(&ptr->p, dimensions);
+    fnt_vect_calloc(&ptr->minimum_x, dimensions);
+    fnt_vect_calloc(&ptr->covariance, dimensions * dimensions);
+
+    return FNT_SUCCESS;
+}
+
+
+static int method_free(void **handle_ptr) {
+    if( handle_ptr == NULL )    { return FNT_FAILURE; }
+    if( *handle_ptr == NULL )   { return FNT_FAILURE; }
+    lm_t *ptr = (lm_t*)*handle_ptr;
+
+    /* free any memory allocated by method */
+    free(ptr->r);   free(ptr->J);   free(ptr->J_t);
+    free(ptr->A);
+    free(ptr->fd_h);
+    free(ptr->issued);
+    free(ptr->known);
+    free(ptr->tau_qr);
+    free(ptr->T);
+    free(ptr->w);
+    fnt_vect_free(&ptr->x0);
+    fnt_vect_free(&ptr->x);
+    fnt_vect_free(&ptr->x_t);
+    fnt_vect_free(&ptr->p);
+    fnt_vect_free(&ptr->minimum_x);
+    fnt_vect_free(&ptr->covariance);
+
+    free(ptr);  *handle_ptr = ptr = NULL;
+
+    return FNT_SUCCESS;
+}
+
+
+/* \brief Return the method to its initial state, keeping hyper-parameters.
+ * \param handle Pointer to the method handle.
+ * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
+ */
+static int method_reset(void *handle) {
+    lm_t *ptr = (lm_t*)handle;
+    if( ptr == NULL )       { return FNT_FAILURE; }
+
+    ptr->state = lm_initial;
+    ptr->iterations = 0;
+    ptr->mu = ptr->nu = ptr->cost = 0.0;
+    ptr->reported = 0;
+    fnt_vect_reset(&ptr->minimum_x);
+    fnt_vect_reset(&ptr->covariance);
+    ptr->minimum_f = 0.0;
+
+    return FNT_SUCCESS;
+}
+
+
+/* \brief Display information about the method to the console.
+ * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
+ */
+static int method_info() {
+    printf(
+"Levenberg-Marquardt minimizes half the sum of squared residuals,\n"
+"0.5 |r(x)|^2, given the residual vector at each point through\n"
+"fnt_set_value_residual.  When no Jacobian is supplied with a residual,\n"
+"its columns are estimated by forward differences, all of which are\n"
+"available together through fnt_next_batch; residuals for batched inputs\n"
+"are matched to their columns by input vector.  Damped steps are solved\n"
+"by blocked Householder QR.\n"
+"\n"
+"Hyper-parameters:\n"
+"name\t\trequired\ttype\t\tDefault\tDescription\n"
+"x0\t\tREQUIRED\tfnt_vect_t\tzeros\tStarting point.\n"
+"tau\t\toptional\tdouble\t\t1e-3\tInitial damping, relative to the largest\n"
+"\t\t\t\t\t\t\tdiagonal element of J^T J.\n"
+"g_tol\t\toptional\tdouble\t\t1e-10\tTerminates when |J^T r| < g_tol.\n"
+"x_tol\t\toptional\tdouble\t\t1e-10\tTerminates when a step is shorter\n"
+"\t\t\t\t\t\t\tthan x_tol (|x| + x_tol).\n"
+"fd_step\t\toptional\tdouble\t\t1e-7\tRelative finite difference step.\n"
+"max_iter\toptional\tint\t\t100\tMaximum number of Jacobian updates.\n"
+"\n"
+"Results:\n"
+"name\t\ttype\t\tDescription\n"
+"minimum x\tfnt_vect_t\tBest fit parameters.\n"
+"minimum f\tdouble\t\t0.5 |r(minimum x)|^2.\n"
+"covariance\tfnt_vect_t\tRow-major n*n covariance of the fit,\n"
+"\t\t\t\ts^2 (J^T J)^-1, with s^2 = |r|^2 / (m - n)\n"
+"\t\t\t\twhen there are m > n residuals.\n"
+"iterations\tint\t\tNumber of Jacobians used.\n"
+"\n"
+"References:\n"
+"K. Madsen, H. B. Nielsen, O. Tingleff, Methods for Non-Linear Least\n"
+"\tSquares Problems, 2nd ed., Technical University of Denmark (2004).\n"
+"Golub, G. H. and Van Loan, C. F., Matrix Computations, 4th ed.,\n"
+"\tsection 5.2.3 (block Householder QR).\n"
+);
+    return FNT_SUCCESS;
+}
+
+
+/* \brief Set any hyper-parameters needed for the method.
+ * \param id The name of the hyper-parameter.
+ * \param value_ptr A pointer to the value being set.
+ * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
+ */
+static int method_hparam_set(void *handle, char *id, void *value_ptr) {
+    if( id == NULL )        { return FNT_FAILURE; }
+    if( value_ptr == NULL ) { return FNT_FAILURE; }
+    if( handle == NULL )    { return FNT_FAILURE; }
+    lm_t *ptr = (lm_t*)handle;
+
+    FNT_HPARAM_SET_VECT("x0", id, value_ptr, &ptr->x0);
+    FNT_HPARAM_SET("tau", id, double, value_ptr, ptr->tau);
+    FNT_HPARAM_SET("g_tol", id, double, value_ptr, ptr->g_tol);
+    FNT_HPARAM_SET("x_tol", id, double, value_ptr, ptr->x_tol);
+    FNT_HPARAM_SET("fd_step", id, double, value_ptr, ptr->fd_step);
+    FNT_HPARAM_SET("max_iter", id, int, value_ptr, ptr->max_iter);
+
+    ERROR("No hyper-parameter named '%s'.\n", id);
+
+    return FNT_FAILURE;
+}
+
+
+static int method_hparam_get(void *handle, char *id, void *value_ptr) {
+    if( id == NULL )        { return FNT_FAILURE; }
+    if( value_ptr == NULL ) { return FNT_FAILURE; }
+    if( handle == NULL )    { return FNT_FAILURE; }
+    lm_t *ptr = (lm_t*)handle;
+
+    FNT_HPARAM_GET_VECT("x0", id, &ptr->x0, value_ptr);
+    FNT_HPARAM_GET("tau", id, double, ptr->tau, value_ptr);
+    FNT_HPARAM_GET("g_tol", id, double, ptr->g_tol, value_ptr);
+    FNT_HPARAM_GET("x_tol", id, double, ptr->x_tol, value_ptr);
+    FNT_HPARAM_GET("fd_step", id, double, ptr->fd_step, value_ptr);
+    FNT_HPARAM_GET("max_iter", id, int, ptr->max_iter, value_ptr);
+
+    ERROR("No hyper-parameter named '%s'.\n", id);
+
+    return FNT_FAILURE;
+}
+
+
+static int method_next(void *handle, fnt_vect_t *vec) {
+    if( handle == NULL )    { return FNT_FAILURE; }
+    if( vec == NULL )       { return FNT_FAILURE; }
+    if( vec->v == NULL )    { return FNT_FAILURE; }
+    lm_t *ptr = (lm_t*)handle;
+
+    switch( ptr->state ) {
+        case lm_initial:
+            return fnt_vect_copy(vec, &ptr->x0);
+        case lm_jacobian:
+            for(int j=0; j<ptr->n; ++j) {
+                if( ptr->known[j] ) { continue; }
+                fnt_vect_copy(vec, &ptr->x);
+                FNT_VECT_ELEM(*vec, j) += ptr->fd_h[j];
+                ptr->issued[j] = 1;
+                return FNT_SUCCESS;
+            }
+            break;
+        case lm_trial:
+            return fnt_vect_copy(vec, &ptr->x_t);
+        default:
+            break;
+    }
+
+    ERROR("ERROR: No input needed, method is done.\n");
+
+    return FNT_FAILURE;
+}
+
+
+/* \brief Hands out every finite difference column not yet issued; other
+ * states have a single input.
+ */
+static int method_next_batch(void *handle, fnt_vect_t *vecs, int *tickets, int capacity, int *count) {
+    if( handle == NULL )    { return FNT_FAILURE; }
+    lm_t *ptr = (lm_t*)handle;
+
+    *count = 0;
+    if( ptr->state != lm_jacobian ) {
+        int ret = method_next(handle, &vecs[0]);
+        if( ret != FNT_SUCCESS )    { return ret; }
+        tickets[0] = 0;
+        *count = 1;
+        return FNT_SUCCESS;
+    }
+
+    for(int j=0; j<ptr->n && *count < capacity; ++j) {
+        if( ptr->issued[j] )    { continue; }
+        fnt_vect_copy(&vecs[*count], &ptr->x);
+        FNT_VECT_ELEM(vecs[*count], j) += ptr->fd_h[j];
+        tickets[*count] = j;
+        ptr->issued[j] = 1;
+        ++*count;
+    }
+
+    return FNT_SUCCESS;
+}
+
+
+static int method_value_residual(void *handle, fnt_vect_t *vec, fnt_vect_t *residual, fnt_vect_t *jacobian) {
+    if( handle == NULL )    { return FNT_FAILURE; }
+    if( vec == NULL )       { return FNT_FAILURE; }
+    if( residual == NULL )  { return FNT_FAILURE; }
+    lm_t *ptr = (lm_t*)handle;
+    int n = ptr->n;
+
+    if( ptr->state == lm_initial ) {
+        if( residual->n < 1 )   { return FNT_FAILURE; }
+        if( lm_alloc(ptr, residual->n) != FNT_SUCCESS ) { return FNT_FAILURE; }
+    } else if( (int)residual->n != ptr->m ) {
+        ERROR("ERROR: Residual has %zu elements, expected %d.\n", residual->n, ptr->m);
+        return FNT_FAILURE;
+    }
+    int m = ptr->m;
+
+    double norm = 0.0;
+    fnt_vect_l2norm(residual, &norm);
+    double cost = 0.5 * norm * norm;
+
+    if( ptr->state == lm_initial ) {
+        ptr->cost = cost;
+        if( jacobian == NULL ) {
+            return lm_accept(ptr, vec, residual, NULL);
+        }
+        lm_transpose(m, n, jacobian->v, ptr->J);
+        return lm_accept(ptr, vec, residual, ptr->J);
+    }
+
+    if( ptr->state == lm_jacobian ) {
+        int j = lm_column(ptr, vec);
+        if( j < 0 ) {
+            ERROR("ERROR: Input does not match any requested Jacobian column.\n");
+            return FNT_FAILURE;
+        }
+        return lm_column_value(ptr, j, residual);
+    }
+
+    if( ptr->state != lm_trial ) {
+        ERROR("ERROR: Residual received, but none was requested.\n");
+        return FNT_FAILURE;
+    }
+
+    /* gain ratio, actual over predicted reduction, with J p from the step */
+    double predicted = 0.0;
+    for(int i=0; i<m; ++i) {
+        double jp = 0.0;
+        for(int j=0; j<n; ++j) { jp += ptr->J[j*m+i] * FNT_VECT_ELEM(ptr->p, j); }
+        predicted -= jp * (ptr->r[i] + 0.5 * jp);
+    }
+    double rho = predicted > 0.0 ? (ptr->cost - cost) / predicted : -1.0;
+
+    if( rho > 0.0 ) {
+        ptr->iterations += 1;
+        ptr->cost = cost;
+        double t = 2.0 * rho - 1.0;
+        ptr->mu *= fmax(1.0 / 3.0, 1.0 - t * t * t);
+        ptr->nu = 2.0;
+        int stop = lm_converged(ptr);
+        if( jacobian != NULL ) {
+            lm_transpose(m, n, jacobian->v, ptr->J_t);
+        }
+        if( lm_accept(ptr, vec, residual, jacobian != NULL ? ptr->J_t : NULL) != FNT_SUCCESS ) {
+            return FNT_FAILURE;
+        }
+        if( stop ) {
+            INFO("Step length below x_tol (%g).\n", ptr->x_tol);
+            ptr->state = lm_done;
+        } else if( ptr->state == lm_trial && lm_converged(ptr) ) {
+            ptr->state = lm_done;
+        }
+        return FNT_SUCCESS;
+    }
+
+    /* reject, damp harder and retry from x */
+    ptr->mu *= ptr->nu;
+    ptr->nu *= 2.0;
+    if( ptr->mu > LM_MAX_DAMPING ) {
+        INFO("Damping (%g) too large to make progress.\n", ptr->mu);
+        ptr->state = lm_done;
+        return FNT_SUCCESS;
+    }
+    if( lm_step(ptr) != FNT_SUCCESS )   { return FNT_FAILURE; }
+    if( lm_converged(ptr) ) {
+        ptr->state = lm_done;
+    }
+
+    return FNT_SUCCESS;
+}
+
+
+/* \brief A scalar value is treated as a single residual.
+ */
+static int method_value(void *handle, fnt_vect_t *vec, double value) {
+    if( handle == NULL )    { return FNT_FAILURE; }
+    fnt_vect_t residual = { &value, 1 };
+
+    return method_value_residual(handle, vec, &residual, NULL);
+}
+
+
+/* \brief A scalar value is the single residual of the input handed out
+ * with ticket, the finite difference column during a Jacobian round.
+ * Systems with more residuals report them with fnt_set_value_residual.
+ */
+static int method_value_ticket(void *handle, int ticket, double value) {
+    if( handle == NULL )    { return FNT_FAILURE; }
+    lm_t *ptr = (lm_t*)handle;
+    fnt_vect_t residual = { &value, 1 };
+
+    if( ptr->state != lm_initial && ptr->m != 1 ) {
+        ERROR("ERROR: A value is one residual, %d expected; use fnt_set_value_residual.\n", ptr->m);
+        return FNT_FAILURE;
+    }
+
+    switch( ptr->state ) {
+        case lm_initial:
+            return method_value_residual(handle, &ptr->x0, &residual, NULL);
+        case lm_jacobian:
+            if( ticket < 0 || ticket >= ptr->n || !ptr->issued[ticket] ) {
+                ERROR("ERROR: Ticket %d does not match any requested Jacobian column.\n", ticket);
+                return FNT_FAILURE;
+            }
+            return lm_column_value(ptr, ticket, &residual);
+        case lm_trial:
+            return method_value_residual(handle, &ptr->x_t, &residual, NULL);
+        default:
+            break;
+    }
+
+    ERROR("ERROR: Value received, but none was requested.\n");
+
+    return FNT_FAILURE;
+}
+
+
+static int method_done(void *handle) {
+    if( handle == NULL )    { return FNT_FAILURE; }
+    lm_t *ptr = (lm_t*)handle;
+
+    if( ptr->state != lm_done ) {
+        return FNT_CONTINUE;
+    }
+
+    if( !ptr->reported ) {
+        fnt_vect_copy(&ptr->minimum_x, &ptr->x);
+        ptr->minimum_f = ptr->cost;
+        lm_covariance(ptr);
+        ptr->reported = 1;
+    }
+
+    return FNT_DONE;
+}
+
+
+static int method_result(void *handle, char *id, void *value_ptr) {
+    if( handle == NULL )    { return FNT_FAILURE; }
+    lm_t *ptr = (lm_t*)handle;
+
+    FNT_RESULT_GET_VECT("minimum x", id, ptr->minimum_x, value_ptr);
+    FNT_RESULT_GET("minimum f", id, double, ptr->minimum_f, value_ptr);
+    FNT_RESULT_GET_VECT("covariance", id, ptr->covariance, value_ptr);
+    FNT_RESULT_GET("iterations", id, int, ptr->iterations, value_ptr);
+
+    ERROR("No result named '%s'.\n", id);
+
+    return FNT_FAILURE;
+}
+
+
+/* MARK: Method descriptor */
+
+fnt_method_descriptor_t fnt_method_descriptor = {
+    .abi_version       = FNT_METHOD_ABI_VERSION,
+    .capabilities      = FNT_METHOD_CAP_BATCH | FNT_METHOD_CAP_RESIDUAL,
+    .name              = method_name,
+    .init              = method_init,
+    .free              = method_free,
+    .reset             = method_reset,
+    .info              = method_info,
+    .hparam_set        = method_hparam_set,
+    .hparam_get        = method_hparam_get,
+    .next              = method_next,
+    .next_batch        = method_next_batch,
+    .value             = method_value,
+    .value_ticket      = method_value_ticket,
+    .value_residual    = method_value_residual,
+    .done              = method_done,
+    .result            = method_result,
+};
@@ -6,6 +6,7 @@
  */
 
 #include <float.h>
+#include <limits.h>
 #include <stdio.h>
 #include "../fnt.h"
 #include "../fnt_util.h"
@@ -27,11 +28,23 @@ void nm_sample_copy(nm_sample_t *dst, nm_sample_t *src) {
 }
 
 
+/* Exchange two samples of the same length by swapping their buffers. */
+void nm_sample_swap(nm_sample_t *a, nm_sample_t *b) {
+    fnt_vect_t parameters = a->parameters;
+    double value = a->value;
+    a->parameters = b->parameters;
+    a->value = b->value;
+    b->parameters = parameters;
+    b->value = value;
+}
+
+
 /* MARK: Simplex types */
 
 typedef struct nm_simplex {
     nm_sample_t *points;
     int count;
+    int capacity;
 } nm_simplex_t;
 
 
@@ -40,14 +53,28 @@ typedef struct nm_simplex {
 void nm_simplex_init(nm_simplex_t *simplex, int dimensions) {
     memset(simplex, '\0', sizeof(*simplex));
     simplex->points = calloc(dimensions+1, sizeof(nm_sample_t));
+    simplex->capacity = dimensions+1;
 }
 
 
 void nm_simplex_free(nm_simplex_t *simplex) {
-    for(int i=0; i<simplex->count; ++i) {
+    /* points past count may still hold vectors from before a reset */
+    for(int i=0; i<simplex->capacity; ++i) {
         fnt_vect_free(&simplex->points[i].parameters);
     }
     free(simplex->points); simplex->points=NULL;
+    simplex->count = simplex->capacity = 0;
+}
+
+
+void nm_simplex_reset(nm_simplex_t *simplex) {
+    /* keep allocated point vectors for reuse by nm_simplex_add */
+    for(int i=0; i<simplex->capacity; ++i) {
+        if( simplex->points[i].parameters.v != NULL ) {
+            fnt_vect_reset(&simplex->points[i].parameters);
+        }
+        simplex->points[i].value = 0.0;
+    }
     simplex->count = 0;
 }
 
@@ -62,7 +89,9 @@ void nm_simplex_print(nm_simplex_t *simplex) {
 
 
 void nm_simplex_add(nm_simplex_t *simplex, nm_sample_t *sample) {
-    fnt_vect_calloc(&simplex->points[simplex->count].parameters, sample->parameters.n);
+    if( simplex->points[simplex->count].parameters.v == NULL ) {
+        fnt_vect_calloc(&simplex->points[simplex->count].parameters, sample->parameters.n);
+    }
     nm_sample_copy(&simplex->points[simplex->count], sample);
     simplex->count += 1;
 }
@@ -104,6 +133,12 @@ typedef enum nm_state {
 } nm_state_t;
 
 
+/* speculative candidates, in the order reflect, expand, contract_out and
+ * contract_in would request them, followed by a slot for any other point */
+#define NM_SPEC_COUNT   5
+#define NM_SPEC_SERIAL  4
+
+
 /* see: http://www.scholarpedia.org/article/Nelder-Mead_algorithm */
 typedef struct nelder_mead {
     /* maintain search state */
@@ -114,16 +149,23 @@ typedef struct nelder_mead {
     nm_state_t state;
 
     /* sample points */
+    nm_sample_t sample;
     nm_sample_t x_r;
-    nm_sample_t x_e;
-    nm_sample_t x_c;
     fnt_vect_t s_shrink;
 
+    /* speculative evaluation */
+    int active;             /* candidates belong to the current simplex */
+    int generation;         /* tells tickets of earlier rounds apart */
+    nm_sample_t spec[NM_SPEC_COUNT];
+    unsigned char issued[NM_SPEC_COUNT];
+    unsigned char known[NM_SPEC_COUNT];
+
     /* hyper-parameters */
     double alpha;
     double beta;
     double gamma;
     double delta;
+    int speculative;
 
     /* termination criteria */
     double dist_threshold;
@@ -143,7 +185,7 @@ typedef struct nelder_mead {
  * \param size Size of the name buffer in bytes.
  * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
  */
-int method_name(char *name, int size) {
+static int method_name(char *name, int size) {
     if( snprintf(name, size, "nelder-mead") >= size ) {
         return FNT_FAILURE;
     }
@@ -152,7 +194,7 @@ int method_name(char *name, int size) {
 }
 
 
-int method_init(void **nm_ptr, int dimensions) {
+static int method_init(void **nm_ptr, int dimensions) {
     nelder_mead_t *nm = calloc(1, sizeof(nelder_mead_t));
     *nm_ptr = nm;
     memset(nm, '\0', sizeof(*nm));
@@ -171,10 +213,12 @@ int method_init(void **nm_ptr, int dimensions) {
     nm->delta = 0.5;    /* 0 < \delta < 1 */
 
     fnt_vect_calloc(&nm->seed, dimensions);
+    fnt_vect_calloc(&nm->sample.parameters, dimensions);
     fnt_vect_calloc(&nm->x_r.parameters, dimensions);
-    fnt_vect_calloc(&nm->x_e.parameters, dimensions);
-    fnt_vect_calloc(&nm->x_c.parameters, dimensions);
     fnt_vect_calloc(&nm->s_shrink, dimensions);
+    for(int i=0; i<NM_SPEC_COUNT; ++i) {
+        fnt_vect_calloc(&nm->spec[i].parameters, dimensions);
+    }
 
     /* allocate space for result */
     fnt_vect_calloc(&nm->min_x, dimensions);
@@ -186,14 +230,16 @@ int method_init(void **nm_ptr, int dimensions) {
 }
 
 
-int method_free(void **nm_ptr) {
+static int method_free(void **nm_ptr) {
     nelder_mead_t *nm = *nm_ptr;
 
     fnt_vect_free(&nm->seed);
+    fnt_vect_free(&nm->sample.parameters);
     fnt_vect_free(&nm->x_r.parameters);
-    fnt_vect_free(&nm->x_e.parameters);
-    fnt_vect_free(&nm->x_c.parameters);
     fnt_vect_free(&nm->s_shrink);
+    for(int i=0; i<NM_SPEC_COUNT; ++i) {
+        fnt_vect_free(&nm->spec[i].parameters);
+    }
 
     nm_simplex_free(&nm->simplex);
 
@@ -204,10 +250,42 @@ int method_free(void **nm_ptr) {
 
 
  
+/* \brief Return the method to its initial state, keeping hyper-parameters.
+ * \param handle Pointer to the method handle.
+ * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
+ */
+static int method_reset(void *nm_ptr) {
+    nelder_mead_t *nm = nm_ptr;
+    if( nm == NULL )    { return FNT_FAILURE; }
+
+    nm->iterations = 0;
+    nm->state = initial;
+    nm_simplex_reset(&nm->simplex);
+
+    /* clear sample points */
+    fnt_vect_reset(&nm->sample.parameters);
+    fnt_vect_reset(&nm->x_r.parameters);
+    fnt_vect_reset(&nm->s_shrink);
+    nm->sample.value = nm->x_r.value = 0.0;
+
+    /* forget candidates, values still outstanding will be discarded */
+    nm->active = 0;
+    nm->generation = (nm->generation + 1) % (INT_MAX / NM_SPEC_COUNT);
+    memset(nm->issued, '\0', sizeof(nm->issued));
+    memset(nm->known, '\0', sizeof(nm->known));
+
+    /* clear results */
+    fnt_vect_reset(&nm->min_x);
+    nm->min_fx = 0.0;
+
+    return FNT_SUCCESS;
+}
+
+
 /* \brief Display information about the method to the console.
  * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
  */
-int method_info() {
+static int method_info() {
     printf(
 "Nelder-Mead is minimization method which uses a simplex of points and an\n"
 "an update staategy to pick new points.\n"
@@ -218,6 +296,8 @@ int method_info() {
 "beta\toptional\tdouble\t0.5\tContraction scaling factor (0<beta<1).\n"
 "gamma\toptional\tdouble\t2.0\tExpand scaling factor (gamma>1).\n"
 "delta\toptional\tdouble\t0.5\tShrink scaling factor (0<delta<1).\n"
+"speculative\toptional\tint\t0\tHand out reflection, expansion and both\n"
+"\t\t\t\tcontraction points as one batch (0 or 1).\n"
 "\n"
 "References:\n"
 "J. A. Nelder, R. Mead, A Simplex Method for Function Minimization,\n"
@@ -251,7 +331,7 @@ static int validate_hparams(nelder_mead_t *nm) {
 }
 
 
-int method_hparam_set(void *nm_ptr, char *id, void *value_ptr) {
+static int method_hparam_set(void *nm_ptr, char *id, void *value_ptr) {
     nelder_mead_t *nm = (nelder_mead_t*)nm_ptr;
     if( nm == NULL )        { return FNT_FAILURE; }
     if( id == NULL )        { return FNT_FAILURE; }
@@ -261,6 +341,7 @@ int method_hparam_set(void *nm_ptr, char *id, void *value_ptr) {
     FNT_HPARAM_SET("beta", id, double, value_ptr, nm->beta);
     FNT_HPARAM_SET("gamma", id, double, value_ptr, nm->gamma);
     FNT_HPARAM_SET("delta", id, double, value_ptr, nm->delta);
+    FNT_HPARAM_SET("speculative", id, int, value_ptr, nm->speculative);
 
     ERROR("No hyper-parameter '%s'.\n", id);
 
@@ -268,7 +349,7 @@ int method_hparam_set(void *nm_ptr, char *id, void *value_ptr) {
 }
 
 
-int method_hparam_get(void *nm_ptr, char *id, void *value_ptr) {
+static int method_hparam_get(void *nm_ptr, char *id, void *value_ptr) {
     nelder_mead_t *nm = (nelder_mead_t*)nm_ptr;
     if( nm == NULL )        { return FNT_FAILURE; }
     if( id == NULL )        { return FNT_FAILURE; }
@@ -278,6 +359,7 @@ int method_hparam_get(void *nm_ptr, char *id, void *value_ptr) {
     FNT_HPARAM_GET("beta", id, double, nm->beta, value_ptr);
     FNT_HPARAM_GET("gamma", id, double, nm->gamma, value_ptr);
     FNT_HPARAM_GET("delta", id, double, nm->delta, value_ptr);
+    FNT_HPARAM_GET("speculative", id, int, nm->speculative, value_ptr);
 
     ERROR("No hyper-parameter '%s'.\n", id);
 
@@ -285,10 +367,42 @@ int method_hparam_get(void *nm_ptr, char *id, void *value_ptr) {
 }
 
 
-int method_seed(void *nm_ptr, fnt_vect_t *seed) {
+/* \brief Seed the simplex with previously evaluated points.
+ * \param nm_ptr Pointer to the method handle.
+ * \param points Points ordered by increasing value.
+ * \param values Objective values of points, or NULL if not evaluated.
+ * \param count Number of points.
+ * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
+ */
+static int method_warm_start(void *nm_ptr, fnt_vect_t *points, double *values, int count) {
     nelder_mead_t *nm = nm_ptr;
-    if( nm->state != initial ) { return FNT_FAILURE; }
-    fnt_vect_copy(&nm->seed, seed);
+    if( nm == NULL )            { return FNT_FAILURE; }
+    if( points == NULL )        { return FNT_FAILURE; }
+    if( count < 1 )             { return FNT_FAILURE; }
+    if( nm->state != initial || nm->simplex.count > 0 ) {
+        ERROR("ERROR: Nelder-Mead can only be warm started before the first evaluation.\n");
+        return FNT_FAILURE;
+    }
+
+    /* best point is used to generate any missing simplex points */
+    fnt_vect_copy(&nm->seed, &points[0]);
+
+    /* without values, only the seed can be used */
+    if( values == NULL )        { return FNT_SUCCESS; }
+
+    validate_hparams(nm);
+
+    /* keep the best points, their values are already known */
+    for(int i=0; i<count && nm->simplex.count < nm->dimensions+1; ++i) {
+        fnt_vect_copy(&nm->sample.parameters, &points[i]);
+        nm->sample.value = values[i];
+        nm_simplex_add(&nm->simplex, &nm->sample);
+    }
+    DEBUG("DEBUG: Warm started simplex with %d of %d points.\n", nm->simplex.count, nm->dimensions+1);
+
+    if( nm->simplex.count >= nm->dimensions+1 ) {
+        nm->state = reflect;
+    }
 
     return FNT_SUCCESS;
 }
@@ -311,7 +425,7 @@ void nm_best_point(void *nm_ptr, fnt_vect_t *result) {
 }
 
 
-int method_value(void *nm_ptr, fnt_vect_t *parameters, double value) {
+static int method_value(void *nm_ptr, fnt_vect_t *parameters, double value) {
     nelder_mead_t *nm = nm_ptr;
     if( nm == NULL )            { return FNT_FAILURE; }
     if( parameters == NULL )    { return FNT_FAILURE; }
@@ -324,30 +438,27 @@ int method_value(void *nm_ptr, fnt_vect_t *parameters, double value) {
 
     nm->iterations += 1;
 
-    nm_sample_t new_sample;
-    fnt_vect_calloc(&new_sample.parameters, parameters->n);
-    fnt_vect_copy(&new_sample.parameters, parameters);
-    new_sample.value = value;
+    /* record new sample, a view lent by method_next_view is not copied */
+    nm_sample_t *new_sample = &nm->sample;
+    fnt_vect_copy(&new_sample->parameters, parameters);
+    new_sample->value = value;
 
     /* shrink just replaces points, but needs the associated values */
     if( nm->state == shrink2 ) {
-        nm_sample_copy(&nm->simplex.points[nm->simplex.count-2], &new_sample);
+        nm_sample_swap(&nm->simplex.points[nm->simplex.count-2], new_sample);
         nm->state = reflect;
-        fnt_vect_free(&new_sample.parameters);
         return FNT_SUCCESS;
     } else if( nm->state == shrink ) {
-        nm_sample_copy(&nm->simplex.points[nm->simplex.count-1], &new_sample);
+        nm_sample_swap(&nm->simplex.points[nm->simplex.count-1], new_sample);
         nm->state = shrink2;
-        fnt_vect_free(&new_sample.parameters);
         return FNT_SUCCESS;
     }
 
     /* check for initialization state */
     if( nm->simplex.count <= nm->dimensions ) {
-        nm_simplex_add(&nm->simplex, &new_sample);
+        nm_simplex_add(&nm->simplex, new_sample);
         if( nm->simplex.count >= nm->dimensions+1 )
             nm->state = reflect;
-        fnt_vect_free(&new_sample.parameters);
         return FNT_SUCCESS;
     }
 
@@ -356,101 +467,78 @@ int method_value(void *nm_ptr, fnt_vect_t *parameters, double value) {
         nm_simplex_sort(&nm->simplex);
 
     /* get h, s, l */
-    nm_sample_t h; /* simplex[simplex.count-1] */
-    nm_sample_t s; /* simplex[simplex.count-2] */
-    nm_sample_t l; /* simplex[0] */
-    nm_sample_t r; /* new_sample */
-    fnt_vect_calloc(&h.parameters, nm->dimensions);
-    fnt_vect_calloc(&s.parameters, nm->dimensions);
-    fnt_vect_calloc(&l.parameters, nm->dimensions);
-    fnt_vect_calloc(&r.parameters, nm->dimensions);
-    nm_sample_copy(&h, &nm->simplex.points[nm->simplex.count-1]);
-    nm_sample_copy(&s, &nm->simplex.points[nm->simplex.count-2]);
-    nm_sample_copy(&l, &nm->simplex.points[0]);
-    nm_sample_copy(&r, &new_sample);
-    fnt_vect_free(&new_sample.parameters);
+    nm_sample_t *h = &nm->simplex.points[nm->simplex.count-1];
+    double h_value = h->value;
+    double s_value = nm->simplex.points[nm->simplex.count-2].value;
+    double l_value = nm->simplex.points[0].value;
+    double r_value = new_sample->value;
 
     if( fnt_verbose_level >= FNT_DEBUG ) {
-        fnt_vect_print(&h.parameters, "f(h) = f(", "%.3f");
-        DEBUG(") = %g\n", h.value);
+        fnt_vect_print(&h->parameters, "f(h) = f(", "%.3f");
+        DEBUG(") = %g\n", h_value);
 
-        fnt_vect_print(&s.parameters, "f(s) = f(", "%.3f");
-        DEBUG(") = %g\n", s.value);
+        fnt_vect_print(&nm->simplex.points[nm->simplex.count-2].parameters, "f(s) = f(", "%.3f");
+        DEBUG(") = %g\n", s_value);
 
-        fnt_vect_print(&l.parameters, "f(l) = f(", "%.3f");
-        DEBUG(") = %g\n", l.value);
+        fnt_vect_print(&nm->simplex.points[0].parameters, "f(l) = f(", "%.3f");
+        DEBUG(") = %g\n", l_value);
 
-        fnt_vect_print(&r.parameters, "f(r) = f(", "%.3f");
-        DEBUG(") = %g\n", r.value);
+        fnt_vect_print(&new_sample->parameters, "f(r) = f(", "%.3f");
+        DEBUG(") = %g\n", r_value);
     }
 
-    /* actual parameters can be discarded,
-     * as only the output values are needed here */
-    fnt_vect_free(&h.parameters);
-    fnt_vect_free(&s.parameters);
-    fnt_vect_free(&l.parameters);
-
-    /* deal with recently computed point based on state */
+    /* deal with recently computed point based on state, accepted points are
+     * swapped into the simplex rather than copied */
     if( nm->state == reflect ) {
-        nm_sample_copy(&nm->x_r, &r);
-
-        if( l.value <= nm->x_r.value && nm->x_r.value < s.value ) {
+        if( l_value <= r_value && r_value < s_value ) {
             /* accept x_r and terminate iteration */
-            nm_sample_copy(&nm->simplex.points[nm->simplex.count-1], &r);
-            fnt_vect_free(&r.parameters);
+            nm_sample_swap(h, new_sample);
             return FNT_SUCCESS;
         }
+
+        /* keep x_r for expansion or contraction */
+        nm_sample_swap(&nm->x_r, new_sample);
     }
 
     if( nm->state == expand ) {
-        nm_sample_copy(&nm->x_e, &r);
-
-        if( nm->x_e.value < nm->x_r.value ) {
+        if( r_value < nm->x_r.value ) {
             /* accept x_e and terminate iteration */
-            nm_sample_copy(&nm->simplex.points[nm->simplex.count-1], &nm->x_e);
+            nm_sample_swap(h, new_sample);
         } else {
             /* accept x_r and terminate iteration */
-            nm_sample_copy(&nm->simplex.points[nm->simplex.count-1], &nm->x_r);
+            nm_sample_swap(h, &nm->x_r);
         }
 
         nm->state = reflect;
-        fnt_vect_free(&r.parameters);
         return FNT_SUCCESS;
     }
 
     if( nm->state == contract_out ) {
-        nm_sample_copy(&nm->x_c, &r);
-
-        if( nm->x_c.value < nm->x_r.value ) {
+        if( r_value < nm->x_r.value ) {
             /* accept x_c and terminate iteration */
-            nm_sample_copy(&nm->simplex.points[nm->simplex.count-1], &nm->x_c);
+            nm_sample_swap(h, new_sample);
             nm->state = reflect;
-            fnt_vect_free(&r.parameters);
             return FNT_SUCCESS;
         }
     }
 
     if( nm->state == contract_in ) {
-        nm_sample_copy(&nm->x_c, &r);
-
-        if( nm->x_c.value < h.value ) {
+        if( r_value < h_value ) {
             /* accept x_c and terminate iteration */
-            nm_sample_copy(&nm->simplex.points[nm->simplex.count-1], &nm->x_c);
+            nm_sample_swap(h, new_sample);
             nm->state = reflect;
-            fnt_vect_free(&r.parameters);
             return FNT_SUCCESS;
         }
     }
-    fnt_vect_free(&r.parameters);
 
     /* determine next state if new point not accepted */
-    if( r.value < l.value ) {
+    if( r_value < l_value ) {
         /* cause x_e to be computed next */
         nm->state = expand;
         return FNT_SUCCESS;
-    } else if( r.value >= s.value ) {
+    } else if( r_value >= s_value ) {
         /* cause x_c to be computed next */
-        if( s.value <= r.value && r.value < h.value )
+        if( s_value <= r_value && r_value < h_value )
             nm->state = contract_out;
         else
             nm->state = contract_in;
@@ -462,7 +550,7 @@ int method_value(void *nm_ptr, fnt_vect_t *parameters, double value) {
 }
 
 
-int method_next(void *nm_ptr, fnt_vect_t *vector) {
+static int method_next(void *nm_ptr, fnt_vect_t *vector) {
     nelder_mead_t *nm = nm_ptr;
 
     if( nm->state == initial && nm->simplex.count < nm->dimensions+1 ) {
@@ -581,21 +669,212 @@ int method_next(void *nm_ptr, fnt_vect_t *vector) {
 }
 
 
-int nm_simplex_point(void *nm_ptr, int which, fnt_vect_t *point, double *value) {
+static int method_next_view(void *nm_ptr, fnt_vect_t **vector) {
+    nelder_mead_t *nm = nm_ptr;
+    if( nm == NULL )        { return FNT_FAILURE; }
+    if( vector == NULL )    { return FNT_FAILURE; }
+
+    /* lend the sample buffer that method_value records into */
+    *vector = &nm->sample.parameters;
+
+    return method_next(nm, *vector);
+}
+
+
+/* \brief Report a point of the current simplex and its value.
+ * \param nm_ptr Pointer to the method handle.
+ * \param which Index of the simplex point.
+ * \param point Vector to be filled with the point, may be NULL.
+ * \param value Set to the value at the point, may be NULL.
+ * \return FNT_SUCCESS on success, FNT_FAILURE if which is out of range.
+ */
+static int method_sample(void *nm_ptr, int which, fnt_vect_t *point, double *value) {
     nelder_mead_t *nm = nm_ptr;
-    if( which >= nm->simplex.count )
-        return 0;
+    if( nm == NULL )                            { return FNT_FAILURE; }
+    if( which < 0 || which >= nm->simplex.count ) { return FNT_FAILURE; }
 
     if( point )
         fnt_vect_copy(point, &nm->simplex.points[which].parameters);
     if( value )
         *value = nm->simplex.points[which].value;
 
-    return 1;
+    return FNT_SUCCESS;
 }
 
 
-int method_done(void *nm_ptr) {
+static int method_done(void *nm_ptr);
+
+
+/* \brief Run to completion, evaluating objective at each new point.
+ * \param nm_ptr Pointer to the method handle.
+ * \param objective Objective function.
+ * \param user Passed through to objective.
+ * \return FNT_DONE on completion, FNT_FAILURE otherwise.
+ */
+static int method_minimize(void *nm_ptr, fnt_objective_t objective, void *user) {
+    nelder_mead_t *nm = nm_ptr;
+    if( nm == NULL )            { return FNT_FAILURE; }
+
+    /* evaluate in the sample buffer, exactly as method_next_view does */
+    fnt_vect_t *x = &nm->sample.parameters;
+    int ret;
+    while( (ret = method_done(nm)) == FNT_CONTINUE ) {
+        if( method_next(nm, x) != FNT_SUCCESS )                     { return FNT_FAILURE; }
+        if( method_value(nm, x, objective(x, user)) != FNT_SUCCESS ) { return FNT_FAILURE; }
+    }
+
+    return ret;
+}
+
+
+/* MARK: Speculative evaluation */
+
+static int nm_spec_index(nm_state_t state) {
+    switch( state ) {
+        case reflect:       return 0;
+        case expand:        return 1;
+        case contract_out:  return 2;
+        case contract_in:   return 3;
+        default:            return -1;
+    }
+}
+
+
+static int nm_spec_ticket(nelder_mead_t *nm, int index) {
+    return nm->generation * NM_SPEC_COUNT + index;
+}
+
+
+/* Compute every point the next iteration could ask for.  The simplex does
+ * not change until one of them is accepted, so they are all known now. */
+static int nm_spec_start(nelder_mead_t *nm) {
+    static const nm_state_t states[] = { reflect, expand, contract_out, contract_in };
+
+    nm->generation = (nm->generation + 1) % (INT_MAX / NM_SPEC_COUNT);
+    for(int i=0; i<NM_SPEC_SERIAL; ++i) {
+        /* expansion and outside contraction are taken from x_r */
+        if( i == 1 ) {
+            fnt_vect_copy(&nm->x_r.parameters, &nm->spec[0].parameters);
+        }
+        nm->state = states[i];
+        if( method_next(nm, &nm->spec[i].parameters) != FNT_SUCCESS ) {
+            nm->state = reflect;
+            return FNT_FAILURE;
+        }
+        nm->issued[i] = nm->known[i] = 0;
+    }
+    nm->state = reflect;
+    nm->active = 1;
+
+    return FNT_SUCCESS;
+}
+
+
+/* Pass candidate values to method_value in the order a serial run would
+ * have requested them, until the simplex changes. */
+static int nm_spec_feed(nelder_mead_t *nm) {
+    while( nm->active && method_done(nm) == FNT_CONTINUE ) {
+        int index = nm_spec_index(nm->state);
+        if( index < 0 ) {
+            /* shrink points are handed out one at a time */
+            nm->active = 0;
+            break;
+        }
+        if( !nm->known[index] )     { break; }
+
+        if( method_value(nm, &nm->spec[index].parameters, nm->spec[index].value) != FNT_SUCCESS ) {
+            return FNT_FAILURE;
+        }
+
+        /* every accepted point leaves the state at reflect */
+        if( nm->state == reflect )  { nm->active = 0; }
+    }
+
+    return FNT_SUCCESS;
+}
+
+
+/* \brief Hand out every point that may be needed before the next value.
+ * With speculative set, an iteration hands out its reflection, expansion
+ * and contraction points at once, otherwise one point is handed out at a
+ * time.  count is zero while a needed value is still outstanding.
+ * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
+ */
+static int method_next_batch(void *nm_ptr, fnt_vect_t *vecs, int *tickets, int capacity, int *count) {
+    nelder_mead_t *nm = nm_ptr;
+    if( nm == NULL )        { return FNT_FAILURE; }
+    if( vecs == NULL )      { return FNT_FAILURE; }
+    if( tickets == NULL )   { return FNT_FAILURE; }
+    if( count == NULL )     { return FNT_FAILURE; }
+    *count = 0;
+
+    if( nm->speculative && !nm->active && !nm->issued[NM_SPEC_SERIAL]
+        && nm->state == reflect && nm->simplex.count == nm->dimensions+1 ) {
+        if( nm_spec_start(nm) != FNT_SUCCESS ) { return FNT_FAILURE; }
+    }
+
+    if( nm->active ) {
+        for(int i=0; i<NM_SPEC_SERIAL && *count < capacity; ++i) {
+            if( nm->issued[i] ) { continue; }
+            fnt_vect_copy(&vecs[*count], &nm->spec[i].parameters);
+            tickets[*count] = nm_spec_ticket(nm, i);
+            nm->issued[i] = 1;
+            *count += 1;
+        }
+        return FNT_SUCCESS;
+    }
+
+    /* anything else goes one point at a time, just as method_next */
+    if( nm->issued[NM_SPEC_SERIAL] || capacity < 1 )  { return FNT_SUCCESS; }
+    if( method_next(nm, &nm->spec[NM_SPEC_SERIAL].parameters) != FNT_SUCCESS ) {
+        return FNT_FAILURE;
+    }
+    fnt_vect_copy(&vecs[0], &nm->spec[NM_SPEC_SERIAL].parameters);
+    tickets[0] = nm_spec_ticket(nm, NM_SPEC_SERIAL);
+    nm->issued[NM_SPEC_SERIAL] = 1;
+    *count = 1;
+
+    return FNT_SUCCESS;
+}
+
+
+/* \brief Record the value of a point handed out by method_next_batch.
+ * Values of candidates that turned out not to be needed are discarded.
+ * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
+ */
+static int method_value_ticket(void *nm_ptr, int ticket, double value) {
+    nelder_mead_t *nm = nm_ptr;
+    if( nm == NULL )        { return FNT_FAILURE; }
+    if( ticket < 0 )        { return FNT_FAILURE; }
+
+    int index = ticket % NM_SPEC_COUNT;
+    int current = ticket / NM_SPEC_COUNT == nm->generation;
+
+    if( index == NM_SPEC_SERIAL ) {
+        if( !current || !nm->issued[index] ) {
+            ERROR("ERROR: Ticket %d is not outstanding.\n", ticket);
+            return FNT_FAILURE;
+        }
+        nm->issued[index] = 0;
+        return method_value(nm, &nm->spec[index].parameters, value);
+    }
+
+    if( !current || !nm->active ) {
+        DEBUG("DEBUG: Discarding value of unneeded candidate (ticket %d).\n", ticket);
+        return FNT_SUCCESS;
+    }
+    if( !nm->issued[index] || nm->known[index] ) {
+        ERROR("ERROR: Ticket %d is not outstanding.\n", ticket);
+        return FNT_FAILURE;
+    }
+    nm->spec[index].value = value;
+    nm->known[index] = 1;
+
+    return nm_spec_feed(nm);
+}
+
+
+static int method_done(void *nm_ptr) {
     if( nm_ptr == NULL )        { return FNT_FAILURE; }
     nelder_mead_t *nm = nm_ptr;
     if( nm->state == initial )  { return FNT_CONTINUE; }
@@ -634,7 +913,7 @@ int method_done(void *nm_ptr) {
 }
 
 
-int method_result(void *handle, char *id, void *value_ptr) {
+static int method_result(void *handle, char *id, void *value_ptr) {
     if( handle == NULL )    { return FNT_FAILURE; }
     nelder_mead_t *ptr = (nelder_mead_t*)handle;
 
@@ -645,3 +924,28 @@ int method_result(void *handle, char *id, void *value_ptr) {
 
     return FNT_FAILURE;
 }
+
+
+/* MARK: Method descriptor */
+
+fnt_method_descriptor_t fnt_method_descriptor = {
+    .abi_version       = FNT_METHOD_ABI_VERSION,
+    .capabilities      = FNT_METHOD_CAP_BATCH,
+    .name              = method_name,
+    .init              = method_init,
+    .free              = method_free,
+    .reset             = method_reset,
+    .info              = method_info,
+    .hparam_set        = method_hparam_set,
+    .hparam_get        = method_hparam_get,
+    .next              = method_next,
+    .next_view         = method_next_view,
+    .next_batch        = method_next_batch,
+    .value             = method_value,
+    .value_ticket      = method_value_ticket,
+    .sample            = method_sample,
+    .warm_start        = method_warm_start,
+    .minimize          = method_minimize,
+    .done              = method_done,
+    .result            = method_result,
+};
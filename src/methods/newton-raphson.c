@@ -28,6 +28,7 @@ typedef struct newton_raphson {
     double next_x;
 
     /* hyper-parameters */
+    double x_0;
     double f_tol;
 
     /* result */
@@ -43,7 +44,7 @@ typedef struct newton_raphson {
  * \param size Size of the name buffer in bytes.
  * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
  */
-int method_name(char *name, int size) {
+static int method_name(char *name, int size) {
     if( snprintf(name, size, "newton-raphson") >= size ) {
         return FNT_FAILURE;
     }
@@ -55,7 +56,7 @@ int method_name(char *name, int size) {
 /* \brief Initialize intenal state for method.
  * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
  */
-int method_init(void **handle_ptr, int dimensions) {
+static int method_init(void **handle_ptr, int dimensions) {
     if( handle_ptr == NULL )    { return FNT_FAILURE; }
     newton_raphson_t *ptr = calloc(1, sizeof(newton_raphson_t));
     if( ptr == NULL )           { return FNT_FAILURE; }
@@ -76,7 +77,7 @@ int method_init(void **handle_ptr, int dimensions) {
 }
 
 
-int method_free(void **handle_ptr) {
+static int method_free(void **handle_ptr) {
     if( handle_ptr == NULL )    { return FNT_FAILURE; }
     if( *handle_ptr == NULL )   { return FNT_FAILURE; }
     newton_raphson_t *ptr = (newton_raphson_t*)*handle_ptr;
@@ -89,10 +90,27 @@ int method_free(void **handle_ptr) {
 }
 
 
+/* \brief Return the method to its initial state, keeping hyper-parameters.
+ * \param handle Pointer to the method handle.
+ * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
+ */
+static int method_reset(void *handle) {
+    newton_raphson_t *ptr = (newton_raphson_t*)handle;
+    if( ptr == NULL )       { return FNT_FAILURE; }
+
+    ptr->state = nr_initial;
+    ptr->last_x = ptr->last_fx = 0.0;
+    ptr->next_x = ptr->x_0;
+    ptr->root_x = 0.0;
+
+    return FNT_SUCCESS;
+}
+
+
 /* \brief Display information about the method to the console.
  * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
  */
-int method_info() {
+static int method_info() {
     printf(
 "The Newton-Raphson method is a root finding method that uses the derivative\n"
 "to contruct a tangent line and extents that tangent line to the x-axis to\n"
@@ -120,13 +138,13 @@ int method_info() {
  * \param value_ptr A pointer to the value being set.
  * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
  */
-int method_hparam_set(void *handle, char *id, void *value_ptr) {
+static int method_hparam_set(void *handle, char *id, void *value_ptr) {
     newton_raphson_t *ptr = (newton_raphson_t*)handle;
     if( ptr == NULL )       { return FNT_FAILURE; }
     if( id == NULL )        { return FNT_FAILURE; }
     if( value_ptr == NULL ) { return FNT_FAILURE; }
 
-    FNT_HPARAM_SET("x_0", id, double, value_ptr, ptr->next_x);
+    FNT_HPARAM_SET("x_0", id, double, value_ptr, ptr->x_0);
     FNT_HPARAM_SET("f_tol", id, double, value_ptr, ptr->f_tol);
 
     ERROR("No hyper-parameter named '%s'.\n", id);
@@ -135,13 +153,13 @@ int method_hparam_set(void *handle, char *id, void *value_ptr) {
 }
 
 
-int method_hparam_get(void *handle, char *id, void *value_ptr) {
+static int method_hparam_get(void *handle, char *id, void *value_ptr) {
     newton_raphson_t *ptr = (newton_raphson_t*)handle;
     if( ptr == NULL )       { return FNT_FAILURE; }
     if( id == NULL )        { return FNT_FAILURE; }
     if( value_ptr == NULL ) { return FNT_FAILURE; }
 
-    FNT_HPARAM_GET("x_0", id, double, ptr->next_x, value_ptr);
+    FNT_HPARAM_GET("x_0", id, double, ptr->x_0, value_ptr);
     FNT_HPARAM_GET("f_tol", id, double, ptr->f_tol, value_ptr);
 
     ERROR("No hyper-parameter named '%s'.\n", id);
@@ -150,19 +168,23 @@ int method_hparam_get(void *handle, char *id, void *value_ptr) {
 }
 
 
-int method_next(void *handle, fnt_vect_t *vec) {
+static int method_next(void *handle, fnt_vect_t *vec) {
     newton_raphson_t *ptr = (newton_raphson_t*)handle;
     if( ptr == NULL )       { return FNT_FAILURE; }
     if( vec == NULL )       { return FNT_FAILURE; }
 
     /* fill vector pointed to by vec with next input to try */
+    if( ptr->state == nr_initial ) {
+        FNT_VECT_ELEM(*vec, 0) = ptr->x_0;
+        return FNT_SUCCESS;
+    }
     FNT_VECT_ELEM(*vec, 0) = ptr->next_x;
 
     return FNT_SUCCESS;
 }
 
 
-int method_value(void *handle, fnt_vect_t *vec, double value) {
+static int method_value(void *handle, fnt_vect_t *vec, double value) {
 
     /* update method using value */
     ERROR("ERROR: Newton-Raphsom method requires a dervative.\n");
@@ -171,7 +193,7 @@ int method_value(void *handle, fnt_vect_t *vec, double value) {
 }
 
 
-int method_value_gradient(void *handle, fnt_vect_t *vec, double value, fnt_vect_t *gradient) {
+static int method_value_gradient(void *handle, fnt_vect_t *vec, double value, fnt_vect_t *gradient) {
     newton_raphson_t *ptr = (newton_raphson_t*)handle;
     if( ptr == NULL )       { return FNT_FAILURE; }
     if( vec == NULL )       { return FNT_FAILURE; }
@@ -194,7 +216,7 @@ int method_value_gradient(void *handle, fnt_vect_t *vec, double value, fnt_vect_
 }
 
 
-int method_done(void *handle) {
+static int method_done(void *handle) {
     newton_raphson_t *ptr = (newton_raphson_t*)handle;
     if( ptr == NULL )       { return FNT_FAILURE; }
 
@@ -215,7 +237,7 @@ int method_done(void *handle) {
 }
 
 
-int method_result(void *handle, char *id, void *value_ptr) {
+static int method_result(void *handle, char *id, void *value_ptr) {
     if( handle == NULL )    { return FNT_FAILURE; }
     newton_raphson_t *ptr = (newton_raphson_t*)handle;
 
@@ -225,3 +247,23 @@ int method_result(void *handle, char *id, void *value_ptr) {
 
     return FNT_FAILURE;
 }
+
+
+/* MARK: Method descriptor */
+
+fnt_method_descriptor_t fnt_method_descriptor = {
+    .abi_version       = FNT_METHOD_ABI_VERSION,
+    .capabilities      = FNT_METHOD_CAP_GRADIENT,
+    .name              = method_name,
+    .init              = method_init,
+    .free              = method_free,
+    .reset             = method_reset,
+    .info              = method_info,
+    .hparam_set        = method_hparam_set,
+    .hparam_get        = method_hparam_get,
+    .next              = method_next,
+    .value             = method_value,
+    .value_gradient    = method_value_gradient,
+    .done              = method_done,
+    .result            = method_result,
+};
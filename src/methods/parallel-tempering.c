@@ -0,0 +1,642 @@
+/*
+ * parallel-tempering.c
+ * fnt: Numerical Toolbox
+ *
+ * Copyright (c) 2024 Bryan Franklin. All rights reserved.
+ */
+#include <errno.h>
+#include <limits.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../fnt.h"
+
+
+/* MARK: Method type definitions */
+
+typedef enum pt_state {
+    pt_initial, pt_starting, pt_running, pt_done
+} pt_state_t;
+
+/* Everything a replica carries besides its position.  The random number
+ * generator belongs to the temperature slot, so a run with the same seed
+ * makes the same moves whatever order values arrive in. */
+typedef struct pt_replica {
+    uint32_t rng;           /* xorshift32 state */
+    int accepted;
+    double temperature;
+    double step;
+    double fx;              /* value at the current position */
+    double fy;              /* value at the proposal */
+} pt_replica_t;
+
+typedef struct parallel_tempering {
+    int n;
+    pt_state_t state;
+    int allocated;
+
+    /* hyper-parameters */
+    int replicas;
+    int max_rounds;
+    double t_min;
+    double t_max;
+    double cooling;
+    double step;
+    int seed;
+    fnt_vect_t x0;
+    fnt_vect_t lower_bounds;
+    fnt_vect_t upper_bounds;
+    int has_x0;
+    int has_lower_bounds;
+    int has_upper_bounds;
+
+    /* replicas, replica k is at [k * n, (k + 1) * n) */
+    pt_replica_t *rep;
+    double *x;              /* current positions */
+    double *y;              /* proposals */
+    unsigned char *issued;
+    unsigned char *known;
+    int received;
+    int generation;
+    int round;
+    int evals;
+    int swaps;
+
+    /* best point seen */
+    fnt_vect_t minimum_x;
+    double minimum_f;
+    fnt_vect_t acceptance;
+
+} parallel_tempering_t;
+
+
+/* MARK: Internal functions */
+
+static double pt_uniform(pt_replica_t *r) {
+    uint32_t x = r->rng;
+    x ^= x << 13;   x ^= x >> 17;   x ^= x << 5;
+    r->rng = x;
+
+    /* in (0, 1), so it can be passed to log */
+    return (x + 0.5) / 4294967296.0;
+}
+
+
+static double pt_normal(pt_replica_t *r) {
+    double u1 = pt_uniform(r), u2 = pt_uniform(r);
+
+    return sqrt(-2.0 * log(u1)) * cos(6.283185307179586 * u2);
+}
+
+
+static void pt_free_replicas(parallel_tempering_t *ptr) {
+    free(ptr->rep);     ptr->rep = NULL;
+    free(ptr->x);       ptr->x = NULL;
+    free(ptr->y);       ptr->y = NULL;
+    free(ptr->issued);  ptr->issued = NULL;
+    free(ptr->known);   ptr->known = NULL;
+    fnt_vect_free(&ptr->acceptance);
+    ptr->allocated = 0;
+}
+
+
+static int pt_allocate_replicas(parallel_tempering_t *ptr) {
+    int K = ptr->replicas;
+
+    pt_free_replicas(ptr);
+    ptr->rep = calloc(K, sizeof(pt_replica_t));
+    ptr->x = calloc((size_t)K * ptr->n, sizeof(double));
+    ptr->y = calloc((size_t)K * ptr->n, sizeof(double));
+    ptr->issued = calloc(K, sizeof(unsigned char));
+    ptr->known = calloc(K, sizeof(unsigned char));
+    if( ptr->rep == NULL || ptr->x == NULL || ptr->y == NULL
+        || ptr->issued == NULL || ptr->known == NULL
+        || fnt_vect_calloc(&ptr->acceptance, K) != FNT_VEC_SUCCESS ) {
+        ERROR("calloc: %s\n", strerror(errno));
+        pt_free_replicas(ptr);
+        return FNT_FAILURE;
+    }
+    ptr->allocated = K;
+
+    return FNT_SUCCESS;
+}
+
+
+/* Keep y inside the bounds by reflecting off them. */
+static void pt_bound(parallel_tempering_t *ptr, double *y) {
+    for(int j=0; j<ptr->n; ++j) {
+        double lo = ptr->has_lower_bounds ? FNT_VECT_ELEM(ptr->lower_bounds, j) : -INFINITY;
+        double hi = ptr->has_upper_bounds ? FNT_VECT_ELEM(ptr->upper_bounds, j) : INFINITY;
+        if( y[j] < lo ) { y[j] = fmin(2.0 * lo - y[j], hi); }
+        if( y[j] > hi ) { y[j] = fmax(2.0 * hi - y[j], lo); }
+    }
+}
+
+
+/* Hand every replica its temperature and generator, and pick the starting
+ * points, x0 where given, otherwise uniformly over the bounds as in de. */
+static int pt_start(parallel_tempering_t *ptr) {
+    int n = ptr->n, K;
+
+    if( ptr->replicas < 1 ) {
+        WARN("WARN: replicas must be at least 1, changing it to 1.\n");
+        ptr->replicas = 1;
+    }
+    if( ptr->t_min <= 0.0 || ptr->t_max < ptr->t_min ) {
+        ERROR("ERROR: Temperatures must satisfy 0 < t_min <= t_max.\n");
+        return FNT_FAILURE;
+    }
+    if( ptr->replicas != ptr->allocated && pt_allocate_replicas(ptr) != FNT_SUCCESS ) {
+        return FNT_FAILURE;
+    }
+    K = ptr->replicas;
+
+    for(int k=0; k<K; ++k) {
+        pt_replica_t *r = &ptr->rep[k];
+        memset(r, '\0', sizeof(*r));
+
+        /* geometric ladder from t_min to t_max */
+        r->temperature = K > 1 ? ptr->t_min * pow(ptr->t_max / ptr->t_min, k / (double)(K - 1))
+                               : ptr->t_max;
+        r->step = ptr->step;
+
+        /* seeds are spread by a multiplicative hash, xorshift needs non-zero */
+        r->rng = ((uint32_t)ptr->seed + 1u) * 2654435761u + (uint32_t)k * 40503u;
+        if( r->rng == 0 )   { r->rng = 1; }
+
+        double *x = &ptr->x[k * n];
+        for(int j=0; j<n; ++j) {
+            if( ptr->has_x0 ) {
+                x[j] = FNT_VECT_ELEM(ptr->x0, j);
+                continue;
+            }
+            double lower = -1.0, upper = 1.0;
+            if( ptr->has_lower_bounds ) {
+                lower = FNT_VECT_ELEM(ptr->lower_bounds, j);
+                if( !ptr->has_upper_bounds )    { upper = lower + 1.0; }
+            }
+            if( ptr->has_upper_bounds ) {
+                upper = FNT_VECT_ELEM(ptr->upper_bounds, j);
+                if( !ptr->has_lower_bounds )    { lower = upper - 1.0; }
+            }
+            x[j] = lower + pt_uniform(r) * (upper - lower);
+        }
+        memcpy(&ptr->y[k * n], x, n * sizeof(double));
+    }
+
+    ptr->state = pt_starting;
+    ptr->generation = ptr->received = ptr->round = ptr->evals = ptr->swaps = 0;
+    ptr->minimum_f = INFINITY;
+    memset(ptr->issued, '\0', K);
+    memset(ptr->known, '\0', K);
+
+    return FNT_SUCCESS;
+}
+
+
+/* Each replica proposes a Gaussian move scaled by its step size. */
+static void pt_propose(parallel_tempering_t *ptr) {
+    int n = ptr->n;
+
+    for(int k=0; k<ptr->replicas; ++k) {
+        pt_replica_t *r = &ptr->rep[k];
+        double *x = &ptr->x[k * n], *y = &ptr->y[k * n];
+        for(int j=0; j<n; ++j) {
+            y[j] = x[j] + r->step * pt_normal(r);
+        }
+        pt_bound(ptr, y);
+    }
+
+    ptr->generation = (ptr->generation + 1) % (INT_MAX / ptr->replicas);
+    ptr->received = 0;
+    memset(ptr->issued, '\0', ptr->replicas);
+    memset(ptr->known, '\0', ptr->replicas);
+}
+
+
+/* Swap replicas of neighboring temperatures, alternating between even and
+ * odd pairs from round to round.  Positions move, temperatures and
+ * generators stay with their slots. */
+static void pt_exchange(parallel_tempering_t *ptr) {
+    int n = ptr->n;
+
+    for(int k=ptr->round % 2; k+1<ptr->replicas; k+=2) {
+        pt_replica_t *a = &ptr->rep[k], *b = &ptr->rep[k + 1];
+        double delta = (a->fx - b->fx) * (1.0 / a->temperature - 1.0 / b->temperature);
+        if( delta < 0.0 && pt_uniform(a) >= exp(delta) ) { continue; }
+
+        double *xa = &ptr->x[k * n], *xb = &ptr->x[(k + 1) * n];
+        for(int j=0; j<n; ++j) {
+            double tmp = xa[j];     xa[j] = xb[j];      xb[j] = tmp;
+        }
+        double tmp = a->fx;     a->fx = b->fx;      b->fx = tmp;
+        ++ptr->swaps;
+    }
+}
+
+
+/* All proposals of the round are in, accept or reject each, then exchange. */
+static void pt_round(parallel_tempering_t *ptr) {
+    int n = ptr->n;
+
+    for(int k=0; k<ptr->replicas; ++k) {
+        pt_replica_t *r = &ptr->rep[k];
+        double *y = &ptr->y[k * n];
+
+        if( r->fy < ptr->minimum_f ) {
+            ptr->minimum_f = r->fy;
+            memcpy(ptr->minimum_x.v, y, n * sizeof(double));
+            INFO("New best value %g from replica %d.\n", r->fy, k);
+        }
+
+        if( ptr->state == pt_starting ) {
+            r->fx = r->fy;
+            continue;
+        }
+
+        /* Metropolis, with a step size nudged towards accepting about a
+         * third of the proposals */
+        double delta = r->fy - r->fx;
+        if( delta <= 0.0 || pt_uniform(r) < exp(-delta / r->temperature) ) {
+            memcpy(&ptr->x[k * n], y, n * sizeof(double));
+            r->fx = r->fy;
+            ++r->accepted;
+            r->step *= 1.02;
+        } else {
+            r->step *= 0.99;
+        }
+        r->temperature *= ptr->cooling;
+    }
+
+    if( ptr->state == pt_starting ) {
+        ptr->state = pt_running;
+    } else {
+        pt_exchange(ptr);
+        ++ptr->round;
+    }
+
+    if( ptr->round >= ptr->max_rounds ) {
+        for(int k=0; k<ptr->replicas; ++k) {
+            FNT_VECT_ELEM(ptr->acceptance, k) = ptr->rep[k].accepted / (double)ptr->round;
+        }
+        ptr->state = pt_done;
+        return;
+    }
+
+    pt_propose(ptr);
+}
+
+
+/* MARK: Functions called by FNT */
+
+/* \brief Provides the name of the method.
+ * \param name Allocated buffer to hold the name.
+ * \param size Size of the name buffer in bytes.
+ * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
+ */
+static int method_name(char *name, int size) {
+    if( snprintf(name, size, "parallel-tempering") >= size ) {
+        return FNT_FAILURE;
+    }
+
+    return FNT_SUCCESS;
+}
+
+
+/* \brief Initialize intenal state for method.
+ * \param handle_ptr Pointer to the method handle pointer.
+ * \param dimensions Number of dimensions in the objactive function input.
+ * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
+ */
+static int method_init(void **handle_ptr, int dimensions) {
+    if( handle_ptr == NULL )    { return FNT_FAILURE; }
+    if( dimensions < 1 )        { return FNT_FAILURE; }
+    parallel_tempering_t *ptr = calloc(1, sizeof(parallel_tempering_t));
+    if( ptr == NULL )           { return FNT_FAILURE; }
+    *handle_ptr = (void*)ptr;
+
+    ptr->n = dimensions;
+    ptr->state = pt_initial;
+    ptr->replicas = 8;
+    ptr->max_rounds = 1000;
+    ptr->t_min = 0.01;
+    ptr->t_max = 10.0;
+    ptr->cooling = 1.0;
+    ptr->step = 0.1;
+    ptr->seed = 1;
+
+    fnt_vect_calloc(&ptr->x0, dimensions);
+    fnt_vect_calloc(&ptr->minimum_x, dimensions);
+
+    return FNT_SUCCESS;
+}
+
+
+/* \brief Free any resources allocated for the method.
+ * \param handle_ptr Pointer to the method handle pointer.
+ * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
+ */
+static int method_free(void **handle_ptr) {
+    if( handle_ptr == NULL )    { return FNT_FAILURE; }
+    if( *handle_ptr == NULL )   { return FNT_FAILURE; }
+    parallel_tempering_t *ptr = (parallel_tempering_t*)*handle_ptr;
+
+    pt_free_replicas(ptr);
+    fnt_vect_free(&ptr->x0);
+    fnt_vect_free(&ptr->minimum_x);
+    if( ptr->has_lower_bounds ) { fnt_vect_free(&ptr->lower_bounds); }
+    if( ptr->has_upper_bounds ) { fnt_vect_free(&ptr->upper_bounds); }
+
+    free(ptr);  *handle_ptr = ptr = NULL;
+
+    return FNT_SUCCESS;
+}
+
+
+/* \brief Return the method to its initial state, keeping hyper-parameters.
+ * \param handle Pointer to the method handle.
+ * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
+ */
+static int method_reset(void *handle) {
+    parallel_tempering_t *ptr = (parallel_tempering_t*)handle;
+    if( ptr == NULL )       { return FNT_FAILURE; }
+
+    /* replicas are reseeded, and resized if needed, on the next run */
+    ptr->state = pt_initial;
+    ptr->round = ptr->evals = ptr->swaps = 0;
+    fnt_vect_reset(&ptr->minimum_x);
+    ptr->minimum_f = 0.0;
+
+    return FNT_SUCCESS;
+}
+
+
+/* \brief Display information about the method to the console.
+ * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
+ */
+static int method_info() {
+    printf(
+"Parallel tempering runs several Metropolis random walks (replicas) at\n"
+"temperatures spaced geometrically from t_min to t_max.  Each round every\n"
+"replica proposes a Gaussian move, and all proposals are available as one\n"
+"batch.  Between rounds, replicas at neighboring temperatures exchange\n"
+"positions with the usual Metropolis probability, so good points found by\n"
+"hot replicas move down to cold ones.  Every replica has its own random\n"
+"number generator, so runs are reproducible from seed alone.  With one\n"
+"replica and cooling below 1 this is simulated annealing.\n"
+"\n"
+"Hyper-parameters:\n"
+"name\t\trequired\ttype\t\tDefault\tDescription\n"
+"x0\t\toptional\tfnt_vect_t\tnone\tStart point of every replica.\n"
+"lower\t\toptional\tfnt_vect_t\tnone\tLower bounds on search region.\n"
+"upper\t\toptional\tfnt_vect_t\tnone\tUpper bounds on search region.\n"
+"replicas\toptional\tint\t\t8\tNumber of replicas.\n"
+"max_rounds\toptional\tint\t\t1000\tNumber of rounds to run.\n"
+"t_min\t\toptional\tdouble\t\t0.01\tColdest temperature.\n"
+"t_max\t\toptional\tdouble\t\t10\tHottest temperature.\n"
+"cooling\t\toptional\tdouble\t\t1.0\tFactor applied to every temperature\n"
+"\t\t\t\t\t\t\teach round.\n"
+"step\t\toptional\tdouble\t\t0.1\tInitial standard deviation of moves.\n"
+"seed\t\toptional\tint\t\t1\tSeed of the replica generators.\n"
+"\n"
+"Results:\n"
+"name\t\ttype\t\tDescription\n"
+"minimum x\tfnt_vect_t\tBest point evaluated.\n"
+"minimum f\tdouble\t\tObjective value at minimum x.\n"
+"acceptance\tfnt_vect_t\tFraction of moves accepted per temperature.\n"
+"swaps\t\tint\t\tNumber of exchanges.\n"
+"rounds\t\tint\t\tNumber of rounds.\n"
+"evaluations\tint\t\tNumber of evaluations.\n"
+"\n"
+"References:\n"
+"R. H. Swendsen, J.-S. Wang, Replica Monte Carlo simulation of spin\n"
+"\tglasses, Phys. Rev. Lett. 57 (1986), 2607-2609.\n"
+"D. J. Earl, M. W. Deem, Parallel tempering: Theory, applications, and\n"
+"\tnew perspectives, Phys. Chem. Chem. Phys. 7 (2005), 3910-3916.\n"
+);
+    return FNT_SUCCESS;
+}
+
+
+/* \brief Set any hyper-parameters needed for the method.
+ * \param handle Pointer to the method handle.
+ * \param id The name of the hyper-parameter.
+ * \param value_ptr A pointer to the value being set.
+ * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
+ */
+static int method_hparam_set(void *handle, char *id, void *value_ptr) {
+    if( id == NULL )        { return FNT_FAILURE; }
+    if( value_ptr == NULL ) { return FNT_FAILURE; }
+    if( handle == NULL )    { return FNT_FAILURE; }
+    parallel_tempering_t *ptr = (parallel_tempering_t*)handle;
+
+    FNT_HPARAM_SET("replicas", id, int, value_ptr, ptr->replicas);
+    FNT_HPARAM_SET("max_rounds", id, int, value_ptr, ptr->max_rounds);
+    FNT_HPARAM_SET("t_min", id, double, value_ptr, ptr->t_min);
+    FNT_HPARAM_SET("t_max", id, double, value_ptr, ptr->t_max);
+    FNT_HPARAM_SET("cooling", id, double, value_ptr, ptr->cooling);
+    FNT_HPARAM_SET("step", id, double, value_ptr, ptr->step);
+    FNT_HPARAM_SET("seed", id, int, value_ptr, ptr->seed);
+
+    if( strncmp("x0", id, 3) == 0 ) {
+        ptr->has_x0 = 1;
+        return fnt_vect_copy(&ptr->x0, value_ptr);
+    }
+
+    if( strncmp("lower", id, 6) == 0 ) {
+        if( !ptr->has_lower_bounds ) {
+            fnt_vect_calloc(&ptr->lower_bounds, ptr->n);
+        }
+        ptr->has_lower_bounds = 1;
+        return fnt_vect_copy(&ptr->lower_bounds, value_ptr);
+    }
+
+    if( strncmp("upper", id, 6) == 0 ) {
+        if( !ptr->has_upper_bounds ) {
+            fnt_vect_calloc(&ptr->upper_bounds, ptr->n);
+        }
+        ptr->has_upper_bounds = 1;
+        return fnt_vect_copy(&ptr->upper_bounds, value_ptr);
+    }
+
+    ERROR("No hyper-parameter named '%s'.\n", id);
+
+    return FNT_FAILURE;
+}
+
+
+/* \brief Get any hyper-parameters values form the method.
+ * \param handle Pointer to the method handle.
+ * \param id The name of the hyper-parameter.
+ * \param value_ptr A pointer to the value being set.
+ * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
+ */
+static int method_hparam_get(void *handle, char *id, void *value_ptr) {
+    parallel_tempering_t *ptr = (parallel_tempering_t*)handle;
+    if( ptr == NULL )       { return FNT_FAILURE; }
+    if( id == NULL )        { return FNT_FAILURE; }
+    if( value_ptr == NULL ) { return FNT_FAILURE; }
+
+    FNT_HPARAM_GET("replicas", id, int, ptr->replicas, value_ptr);
+    FNT_HPARAM_GET("max_rounds", id, int, ptr->max_rounds, value_ptr);
+    FNT_HPARAM_GET("t_min", id, double, ptr->t_min, value_ptr);
+    FNT_HPARAM_GET("t_max", id, double, ptr->t_max, value_ptr);
+    FNT_HPARAM_GET("cooling", id, double, ptr->cooling, value_ptr);
+    FNT_HPARAM_GET("step", id, double, ptr->step, value_ptr);
+    FNT_HPARAM_GET("seed", id, int, ptr->seed, value_ptr);
+    if( ptr->has_x0 ) {
+        FNT_HPARAM_GET_VECT("x0", id, &ptr->x0, value_ptr);
+    }
+    if( ptr->has_lower_bounds ) {
+        FNT_HPARAM_GET_VECT("lower", id, &ptr->lower_bounds, value_ptr);
+    }
+    if( ptr->has_upper_bounds ) {
+        FNT_HPARAM_GET_VECT("upper", id, &ptr->upper_bounds, value_ptr);
+    }
+
+    ERROR("No hyper-parameter named '%s'.\n", id);
+
+    return FNT_FAILURE;
+}
+
+
+/* \brief Hands out every proposal not yet handed out this round, up to
+ * capacity.  count is zero while all proposals are awaiting values.
+ */
+static int method_next_batch(void *handle, fnt_vect_t *vecs, int *tickets, int capacity, int *count) {
+    parallel_tempering_t *ptr = (parallel_tempering_t*)handle;
+    if( ptr == NULL )       { return FNT_FAILURE; }
+    if( vecs == NULL )      { return FNT_FAILURE; }
+    if( tickets == NULL )   { return FNT_FAILURE; }
+    if( count == NULL )     { return FNT_FAILURE; }
+
+    *count = 0;
+    if( ptr->state == pt_done ) {
+        ERROR("ERROR: No input needed, method is done.\n");
+        return FNT_FAILURE;
+    }
+    if( ptr->state == pt_initial && pt_start(ptr) != FNT_SUCCESS ) {
+        return FNT_FAILURE;
+    }
+
+    int n = ptr->n;
+    for(int k=0; k<ptr->replicas && *count < capacity; ++k) {
+        if( ptr->issued[k] )    { continue; }
+        memcpy(vecs[*count].v, &ptr->y[k * n], n * sizeof(double));
+        tickets[*count] = ptr->generation * ptr->replicas + k;
+        ptr->issued[k] = 1;
+        ++ptr->evals;
+        ++*count;
+    }
+
+    return FNT_SUCCESS;
+}
+
+
+static int method_next(void *handle, fnt_vect_t *vec) {
+    int ticket = 0, count = 0;
+
+    if( method_next_batch(handle, vec, &ticket, 1, &count) != FNT_SUCCESS ) {
+        return FNT_FAILURE;
+    }
+    if( count == 0 ) {
+        ERROR("ERROR: No proposals left to hand out, values are still outstanding.\n");
+        return FNT_FAILURE;
+    }
+
+    return FNT_SUCCESS;
+}
+
+
+static int method_value_ticket(void *handle, int ticket, double value) {
+    parallel_tempering_t *ptr = (parallel_tempering_t*)handle;
+    if( ptr == NULL )       { return FNT_FAILURE; }
+    if( ticket < 0 )        { return FNT_FAILURE; }
+
+    int k = ticket % (ptr->replicas > 0 ? ptr->replicas : 1);
+    if( (ptr->state != pt_starting && ptr->state != pt_running)
+        || ticket / ptr->replicas != ptr->generation
+        || !ptr->issued[k] || ptr->known[k] ) {
+        ERROR("ERROR: Ticket %d is not outstanding.\n", ticket);
+        return FNT_FAILURE;
+    }
+    ptr->rep[k].fy = value;
+    ptr->known[k] = 1;
+
+    if( ++ptr->received == ptr->replicas ) {
+        pt_round(ptr);
+    }
+
+    return FNT_SUCCESS;
+}
+
+
+/* \brief A value without a ticket belongs to the oldest outstanding proposal.
+ */
+static int method_value(void *handle, fnt_vect_t *vec, double value) {
+    parallel_tempering_t *ptr = (parallel_tempering_t*)handle;
+    if( ptr == NULL )       { return FNT_FAILURE; }
+    (void)vec;
+
+    if( ptr->state == pt_starting || ptr->state == pt_running ) {
+        for(int k=0; k<ptr->replicas; ++k) {
+            if( ptr->issued[k] && !ptr->known[k] ) {
+                return method_value_ticket(handle, ptr->generation * ptr->replicas + k, value);
+            }
+        }
+    }
+
+    ERROR("ERROR: Value received, but no proposals are outstanding.\n");
+
+    return FNT_FAILURE;
+}
+
+
+static int method_done(void *handle) {
+    parallel_tempering_t *ptr = (parallel_tempering_t*)handle;
+    if( ptr == NULL )       { return FNT_FAILURE; }
+
+    return ptr->state == pt_done ? FNT_DONE : FNT_CONTINUE;
+}
+
+
+static int method_result(void *handle, char *id, void *value_ptr) {
+    parallel_tempering_t *ptr = (parallel_tempering_t*)handle;
+    if( ptr == NULL )       { return FNT_FAILURE; }
+
+    FNT_RESULT_GET_VECT("minimum x", id, ptr->minimum_x, value_ptr);
+    FNT_RESULT_GET("minimum f", id, double, ptr->minimum_f, value_ptr);
+    if( ptr->allocated > 0 ) {
+        FNT_RESULT_GET_VECT("acceptance", id, ptr->acceptance, value_ptr);
+    }
+    FNT_RESULT_GET("swaps", id, int, ptr->swaps, value_ptr);
+    FNT_RESULT_GET("rounds", id, int, ptr->round, value_ptr);
+    FNT_RESULT_GET("evaluations", id, int, ptr->evals, value_ptr);
+
+    ERROR("No result named '%s'.\n", id);
+
+    return FNT_FAILURE;
+}
+
+
+/* MARK: Method descriptor */
+
+fnt_method_descriptor_t fnt_method_descriptor = {
+    .abi_version       = FNT_METHOD_ABI_VERSION,
+    .capabilities      = FNT_METHOD_CAP_BATCH,
+    .name              = method_name,
+    .init              = method_init,
+    .free              = method_free,
+    .reset             = method_reset,
+    .info              = method_info,
+    .hparam_set        = method_hparam_set,
+    .hparam_get        = method_hparam_get,
+    .next              = method_next,
+    .next_batch        = method_next_batch,
+    .value             = method_value,
+    .value_ticket      = method_value_ticket,
+    .done              = method_done,
+    .result            = method_result,
+};
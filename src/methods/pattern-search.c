@@ -0,0 +1,600 @@
+/*
+ * pattern-search.c
+ * fnt: Numerical Toolbox
+ *
+ * Copyright (c) 2024 Bryan Franklin. All rights reserved.
+ */
+#include <float.h>
+#include <limits.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../fnt.h"
+
+
+/* MARK: Method type definitions */
+
+typedef enum ps_state {
+    ps_initial, ps_poll, ps_done
+} ps_state_t;
+
+typedef struct pattern_search {
+    int n;
+    int stride;             /* ticket slots per poll, 2n poll points and x0 */
+
+    /* hyper-parameters */
+    fnt_vect_t x0;
+    fnt_vect_t lower_bounds;
+    fnt_vect_t upper_bounds;
+    int has_lower_bounds;
+    int has_upper_bounds;
+    double initial_step;
+    double min_step;
+    double expand;
+    double contract;
+    int max_evals;
+    int opportunistic;
+    int mads;
+
+    /* method state */
+    ps_state_t state;
+    fnt_vect_t center;
+    double f_center;
+    double step;
+    int generation;         /* tells tickets of earlier polls apart */
+    int last_dir;           /* direction of the last success, polled first */
+    int evals;
+    int iterations;
+
+    /* current poll */
+    fnt_vect_t *poll;
+    int *dir;               /* direction index of each poll point */
+    int count;
+    char *issued;
+    char *known;
+    double *values;
+    double *basis;          /* Householder vector for rotated directions */
+
+    /* results */
+    fnt_vect_t minimum_x;
+    double minimum_f;
+
+} pattern_search_t;
+
+
+/* MARK: Internal functions */
+
+static int ps_ticket(pattern_search_t *ptr, int index) {
+    return ptr->generation * ptr->stride + index;
+}
+
+
+/* Point along direction k, 0 <= k < 2n, of the current poll.  Coordinate
+ * directions are +/- e_i, with mads set they are +/- the columns of the
+ * orthogonal matrix I - 2 v v^T / v^T v for a fresh random v each poll.
+ * They are not rounded to a mesh, so this is not a true MADS instance. */
+static void ps_direction(pattern_search_t *ptr, int k, fnt_vect_t *x) {
+    int n = ptr->n;
+    int i = k % n;
+    double sign = k < n ? 1.0 : -1.0;
+
+    fnt_vect_copy(x, &ptr->center);
+    if( !ptr->mads ) {
+        FNT_VECT_ELEM(*x, i) += sign * ptr->step;
+    } else {
+        double vv = 0.0;
+        for(int j=0; j<n; ++j) { vv += ptr->basis[j] * ptr->basis[j]; }
+        for(int j=0; j<n; ++j) {
+            double h = (i == j ? 1.0 : 0.0) - 2.0 * ptr->basis[j] * ptr->basis[i] / vv;
+            FNT_VECT_ELEM(*x, j) += sign * ptr->step * h;
+        }
+    }
+
+    for(int j=0; j<n; ++j) {
+        if( ptr->has_lower_bounds ) {
+            FNT_VECT_ELEM(*x, j) = fmax(FNT_VECT_ELEM(*x, j), FNT_VECT_ELEM(ptr->lower_bounds, j));
+        }
+        if( ptr->has_upper_bounds ) {
+            FNT_VECT_ELEM(*x, j) = fmin(FNT_VECT_ELEM(*x, j), FNT_VECT_ELEM(ptr->upper_bounds, j));
+        }
+    }
+}
+
+
+/* Start a poll about the center, beginning with the last successful
+ * direction.  Points that bounds fold back onto the center are dropped. */
+static void ps_poll_start(pattern_search_t *ptr) {
+    int n = ptr->n;
+
+    ptr->generation = (ptr->generation + 1) % (INT_MAX / ptr->stride);
+    ptr->state = ps_poll;
+    ptr->count = 0;
+    memset(ptr->issued, 0, ptr->stride);
+    memset(ptr->known, 0, ptr->stride);
+
+    if( ptr->mads ) {
+        double vv = 0.0;
+        while( vv == 0.0 ) {
+            for(int j=0; j<n; ++j) {
+                ptr->basis[j] = 2.0 * FNT_RAND() / (double)FNT_RAND_MAX - 1.0;
+                vv += ptr->basis[j] * ptr->basis[j];
+            }
+        }
+    }
+
+    for(int k=0; k<2*n; ++k) {
+        int dir = (ptr->last_dir + k) % (2*n);
+        fnt_vect_t *x = &ptr->poll[ptr->count];
+        ps_direction(ptr, dir, x);
+        if( memcmp(x->v, ptr->center.v, n * sizeof(double)) == 0 ) { continue; }
+        ptr->dir[ptr->count++] = dir;
+    }
+    ++ptr->iterations;
+}
+
+
+/* Accept poll point index as the new center. */
+static void ps_accept(pattern_search_t *ptr, int index) {
+    fnt_vect_copy(&ptr->center, &ptr->poll[index]);
+    ptr->f_center = ptr->values[index];
+    ptr->last_dir = ptr->dir[index];
+    ptr->step *= ptr->expand;
+    DEBUG("DEBUG: Poll succeeded along direction %d, step now %g.\n", ptr->last_dir, ptr->step);
+}
+
+
+/* Finish the current poll, with no success or the best success. */
+static void ps_poll_finish(pattern_search_t *ptr) {
+    int best = -1;
+    for(int i=0; i<ptr->count; ++i) {
+        if( ptr->values[i] < ptr->f_center
+            && (best < 0 || ptr->values[i] < ptr->values[best]) ) {
+            best = i;
+        }
+    }
+
+    if( best >= 0 ) {
+        ps_accept(ptr, best);
+    } else {
+        ptr->step *= ptr->contract;
+        DEBUG("DEBUG: Poll failed, step now %g.\n", ptr->step);
+    }
+}
+
+
+/* Decide whether to stop, otherwise start the next poll.  A poll that
+ * bounds fold entirely onto the center fails without evaluations. */
+static void ps_next_poll(pattern_search_t *ptr) {
+    for(;;) {
+        if( ptr->step < ptr->min_step ) {
+            INFO("Step size (%g) below limit (%g).\n", ptr->step, ptr->min_step);
+            ptr->state = ps_done;
+            return;
+        }
+        if( ptr->evals >= ptr->max_evals ) {
+            INFO("Evaluation count (%d) reached limit.\n", ptr->evals);
+            ptr->state = ps_done;
+            return;
+        }
+
+        ps_poll_start(ptr);
+        if( ptr->count > 0 )    { return; }
+        ps_poll_finish(ptr);
+    }
+}
+
+
+/* MARK: Functions called by FNT */
+
+/* \brief Provides the name of the method.
+ * \param name Allocated buffer to hold the name.
+ * \param size Size of the name buffer in bytes.
+ * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
+ */
+static int method_name(char *name, int size) {
+    if( snprintf(name, size, "pattern-search") >= size ) {
+        return FNT_FAILURE;
+    }
+
+    return FNT_SUCCESS;
+}
+
+
+/* \brief Initialize intenal state for method.
+ * \param handle_ptr Pointer to the method handle pointer.
+ * \param dimensions Number of dimensions in the objactive function input.
+ * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
+ */
+static int method_init(void **handle_ptr, int dimensions) {
+    if( handle_ptr == NULL )    { return FNT_FAILURE; }
+    if( dimensions < 1 )        { return FNT_FAILURE; }
+    pattern_search_t *ptr = calloc(1, sizeof(pattern_search_t));
+    if( ptr == NULL )           { return FNT_FAILURE; }
+    *handle_ptr = (void*)ptr;
+
+    int n = dimensions;
+    ptr->n = n;
+    ptr->stride = 2 * n + 1;
+    ptr->initial_step = 1.0;
+    ptr->min_step = 1e-6;
+    ptr->expand = 2.0;
+    ptr->contract = 0.5;
+    ptr->max_evals = 1000 * n;
+    ptr->opportunistic = 1;
+    ptr->state = ps_initial;
+
+    ptr->poll = calloc(2 * n, sizeof(fnt_vect_t));
+    ptr->dir = calloc(2 * n, sizeof(int));
+    ptr->issued = calloc(ptr->stride, 1);
+    ptr->known = calloc(ptr->stride, 1);
+    ptr->values = calloc(ptr->stride, sizeof(double));
+    ptr->basis = calloc(n, sizeof(double));
+    if( ptr->poll == NULL || ptr->dir == NULL || ptr->issued == NULL
+        || ptr->known == NULL || ptr->values == NULL || ptr->basis == NULL ) {
+        ERROR("ERROR: Failed to allocate poll of %d points.\n", 2 * n);
+        free(ptr->poll);    free(ptr->dir);
+        free(ptr->issued);  free(ptr->known);
+        free(ptr->values);  free(ptr->basis);
+        free(ptr);  *handle_ptr = NULL;
+        return FNT_FAILURE;
+    }
+    for(int k=0; k<2*n; ++k) { fnt_vect_calloc(&ptr->poll[k], n); }
+
+    fnt_vect_calloc(&ptr->x0, n);
+    fnt_vect_calloc(&ptr->center, n);
+    fnt_vect_calloc(&ptr->minimum_x, n);
+
+    return FNT_SUCCESS;
+}
+
+
+/* \brief Free any resources allocated for the method.
+ * \param handle_ptr Pointer to the method handle pointer.
+ * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
+ */
+static int method_free(void **handle_ptr) {
+    if( handle_ptr == NULL )    { return FNT_FAILURE; }
+    if( *handle_ptr == NULL )   { return FNT_FAILURE; }
+    pattern_search_t *ptr = (pattern_search_t*)*handle_ptr;
+
+    for(int k=0; k<2*ptr->n; ++k) { fnt_vect_free(&ptr->poll[k]); }
+    free(ptr->poll);
+    free(ptr->dir);
+    free(ptr->issued);
+    free(ptr->known);
+    free(ptr->values);
+    free(ptr->basis);
+    fnt_vect_free(&ptr->x0);
+    fnt_vect_free(&ptr->center);
+    fnt_vect_free(&ptr->minimum_x);
+    if( ptr->has_lower_bounds ) { fnt_vect_free(&ptr->lower_bounds); }
+    if( ptr->has_upper_bounds ) { fnt_vect_free(&ptr->upper_bounds); }
+
+    free(ptr);  *handle_ptr = ptr = NULL;
+
+    return FNT_SUCCESS;
+}
+
+
+/* \brief Return the method to its initial state, keeping hyper-parameters.
+ * \param handle Pointer to the method handle.
+ * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
+ */
+static int method_reset(void *handle) {
+    pattern_search_t *ptr = (pattern_search_t*)handle;
+    if( ptr == NULL )       { return FNT_FAILURE; }
+
+    ptr->state = ps_initial;
+    ptr->generation = (ptr->generation + 1) % (INT_MAX / ptr->stride);
+    ptr->last_dir = ptr->evals = ptr->iterations = ptr->count = 0;
+    memset(ptr->issued, 0, ptr->stride);
+    memset(ptr->known, 0, ptr->stride);
+    fnt_vect_reset(&ptr->minimum_x);
+    ptr->minimum_f = 0.0;
+
+    return FNT_SUCCESS;
+}
+
+
+/* \brief Display information about the method to the console.
+ * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
+ */
+static int method_info() {
+    printf(
+"Generalized pattern search polls the 2n points one step from the current\n"
+"center along a positive spanning set of directions.  The whole poll is\n"
+"available as one batch.  When opportunistic, the first improvement to\n"
+"arrive becomes the new center and the rest of the poll is discarded,\n"
+"otherwise the best point of a complete poll is taken.  The step grows\n"
+"after a success and shrinks after a failed poll.  Only comparisons of\n"
+"values are used, so non-smooth objectives are fine.\n"
+"\n"
+"With mads set, each poll uses the columns of a Householder matrix\n"
+"I - 2 v v^T / v^T v, and their negatives, for a fresh random v.  This\n"
+"borrows the orthogonal directions of OrthoMADS, but v is real valued and\n"
+"there is no mesh, so it is pattern search along a randomly rotated basis,\n"
+"not MADS, and the MADS convergence results do not apply.\n"
+"\n"
+"Hyper-parameters:\n"
+"name\t\trequired\ttype\t\tDefault\tDescription\n"
+"x0\t\toptional\tfnt_vect_t\tzeros\tStarting point.\n"
+"lower\t\toptional\tfnt_vect_t\tnone\tLower bounds on search region.\n"
+"upper\t\toptional\tfnt_vect_t\tnone\tUpper bounds on search region.\n"
+"step\t\toptional\tdouble\t\t1.0\tInitial step size.\n"
+"min_step\toptional\tdouble\t\t1e-6\tTerminates below this step size.\n"
+"expand\t\toptional\tdouble\t\t2.0\tStep growth after a success.\n"
+"contract\toptional\tdouble\t\t0.5\tStep reduction after a failed poll.\n"
+"max_evals\toptional\tint\t\t1000*n\tMaximum number of evaluations.\n"
+"opportunistic\toptional\tint\t\t1\tAccept the first improvement.\n"
+"mads\t\toptional\tint\t\t0\tPoll along a random orthogonal basis\n"
+"\t\t\t\t\t\t\tinstead of the axes, see above.\n"
+"\n"
+"Results:\n"
+"name\t\ttype\t\tDescription\n"
+"minimum x\tfnt_vect_t\tBest point found.\n"
+"minimum f\tdouble\t\tObjective value at minimum x.\n"
+"evaluations\tint\t\tNumber of points handed out.\n"
+"\n"
+"References:\n"
+"V. Torczon, On the Convergence of Pattern Search Algorithms, SIAM J.\n"
+"\tOptim. 7 (1997), 1-25.\n"
+"M. A. Abramson, C. Audet, J. E. Dennis, S. Le Digabel, OrthoMADS: A\n"
+"\tDeterministic MADS Instance with Orthogonal Directions, SIAM J. Optim.\n"
+"\t20 (2009), 948-966.\n"
+);
+    return FNT_SUCCESS;
+}
+
+
+/* \brief Set any hyper-parameters needed for the method.
+ * \param handle Pointer to the method handle.
+ * \param id The name of the hyper-parameter.
+ * \param value_ptr A pointer to the value being set.
+ * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
+ */
+static int method_hparam_set(void *handle, char *id, void *value_ptr) {
+    if( id == NULL )        { return FNT_FAILURE; }
+    if( value_ptr == NULL ) { return FNT_FAILURE; }
+    if( handle == NULL )    { return FNT_FAILURE; }
+    pattern_search_t *ptr = (pattern_search_t*)handle;
+
+    FNT_HPARAM_SET_VECT("x0", id, value_ptr, &ptr->x0);
+    FNT_HPARAM_SET("step", id, double, value_ptr, ptr->initial_step);
+    FNT_HPARAM_SET("min_step", id, double, value_ptr, ptr->min_step);
+    FNT_HPARAM_SET("expand", id, double, value_ptr, ptr->expand);
+    FNT_HPARAM_SET("contract", id, double, value_ptr, ptr->contract);
+    FNT_HPARAM_SET("max_evals", id, int, value_ptr, ptr->max_evals);
+    FNT_HPARAM_SET("opportunistic", id, int, value_ptr, ptr->opportunistic);
+    FNT_HPARAM_SET("mads", id, int, value_ptr, ptr->mads);
+
+    if( strncmp("lower", id, 6) == 0 ) {
+        if( !ptr->has_lower_bounds ) {
+            fnt_vect_calloc(&ptr->lower_bounds, ptr->n);
+        }
+        ptr->has_lower_bounds = 1;
+        return fnt_vect_copy(&ptr->lower_bounds, value_ptr);
+    }
+
+    if( strncmp("upper", id, 6) == 0 ) {
+        if( !ptr->has_upper_bounds ) {
+            fnt_vect_calloc(&ptr->upper_bounds, ptr->n);
+        }
+        ptr->has_upper_bounds = 1;
+        return fnt_vect_copy(&ptr->upper_bounds, value_ptr);
+    }
+
+    ERROR("No hyper-parameter named '%s'.\n", id);
+
+    return FNT_FAILURE;
+}
+
+
+/* \brief Get any hyper-parameters values form the method.
+ * \param handle Pointer to the method handle.
+ * \param id The name of the hyper-parameter.
+ * \param value_ptr A pointer to the value being set.
+ * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
+ */
+static int method_hparam_get(void *handle, char *id, void *value_ptr) {
+    pattern_search_t *ptr = (pattern_search_t*)handle;
+    if( ptr == NULL )       { return FNT_FAILURE; }
+    if( id == NULL )        { return FNT_FAILURE; }
+    if( value_ptr == NULL ) { return FNT_FAILURE; }
+
+    FNT_HPARAM_GET_VECT("x0", id, &ptr->x0, value_ptr);
+    FNT_HPARAM_GET("step", id, double, ptr->initial_step, value_ptr);
+    FNT_HPARAM_GET("min_step", id, double, ptr->min_step, value_ptr);
+    FNT_HPARAM_GET("expand", id, double, ptr->expand, value_ptr);
+    FNT_HPARAM_GET("contract", id, double, ptr->contract, value_ptr);
+    FNT_HPARAM_GET("max_evals", id, int, ptr->max_evals, value_ptr);
+    FNT_HPARAM_GET("opportunistic", id, int, ptr->opportunistic, value_ptr);
+    FNT_HPARAM_GET("mads", id, int, ptr->mads, value_ptr);
+    if( ptr->has_lower_bounds ) {
+        FNT_HPARAM_GET_VECT("lower", id, &ptr->lower_bounds, value_ptr);
+    }
+    if( ptr->has_upper_bounds ) {
+        FNT_HPARAM_GET_VECT("upper", id, &ptr->upper_bounds, value_ptr);
+    }
+
+    ERROR("No hyper-parameter named '%s'.\n", id);
+
+    return FNT_FAILURE;
+}
+
+
+/* \brief Hands out every poll point not yet handed out, up to capacity.
+ * count is zero while the whole poll is awaiting values.
+ */
+static int method_next_batch(void *handle, fnt_vect_t *vecs, int *tickets, int capacity, int *count) {
+    pattern_search_t *ptr = (pattern_search_t*)handle;
+    if( ptr == NULL )       { return FNT_FAILURE; }
+    if( vecs == NULL )      { return FNT_FAILURE; }
+    if( tickets == NULL )   { return FNT_FAILURE; }
+    if( count == NULL )     { return FNT_FAILURE; }
+
+    *count = 0;
+    if( ptr->state == ps_done ) {
+        ERROR("ERROR: No input needed, method is done.\n");
+        return FNT_FAILURE;
+    }
+
+    if( ptr->state == ps_initial ) {
+        /* x0 is evaluated first, moved inside any bounds */
+        int center = ptr->stride - 1;
+        if( ptr->issued[center] )   { return FNT_SUCCESS; }
+        fnt_vect_copy(&ptr->center, &ptr->x0);
+        ptr->step = ptr->initial_step;
+        for(int j=0; j<ptr->n; ++j) {
+            double x = FNT_VECT_ELEM(ptr->center, j);
+            if( ptr->has_lower_bounds ) { x = fmax(x, FNT_VECT_ELEM(ptr->lower_bounds, j)); }
+            if( ptr->has_upper_bounds ) { x = fmin(x, FNT_VECT_ELEM(ptr->upper_bounds, j)); }
+            FNT_VECT_ELEM(ptr->center, j) = x;
+        }
+        fnt_vect_copy(&vecs[0], &ptr->center);
+        tickets[0] = ps_ticket(ptr, center);
+        ptr->issued[center] = 1;
+        ++ptr->evals;
+        *count = 1;
+        return FNT_SUCCESS;
+    }
+
+    for(int i=0; i<ptr->count && *count < capacity; ++i) {
+        if( ptr->issued[i] )    { continue; }
+        if( ptr->evals >= ptr->max_evals ) { break; }
+        fnt_vect_copy(&vecs[*count], &ptr->poll[i]);
+        tickets[*count] = ps_ticket(ptr, i);
+        ptr->issued[i] = 1;
+        ++ptr->evals;
+        ++*count;
+    }
+
+    return FNT_SUCCESS;
+}
+
+
+static int method_next(void *handle, fnt_vect_t *vec) {
+    int ticket = 0, count = 0;
+
+    if( method_next_batch(handle, vec, &ticket, 1, &count) != FNT_SUCCESS ) {
+        return FNT_FAILURE;
+    }
+    if( count == 0 ) {
+        ERROR("ERROR: No points left to hand out, values are still outstanding.\n");
+        return FNT_FAILURE;
+    }
+
+    return FNT_SUCCESS;
+}
+
+
+static int method_value_ticket(void *handle, int ticket, double value) {
+    pattern_search_t *ptr = (pattern_search_t*)handle;
+    if( ptr == NULL )       { return FNT_FAILURE; }
+    if( ticket < 0 )        { return FNT_FAILURE; }
+
+    int index = ticket % ptr->stride;
+    if( ticket / ptr->stride != ptr->generation || ptr->state == ps_done ) {
+        DEBUG("DEBUG: Discarding value from an earlier poll (ticket %d).\n", ticket);
+        return FNT_SUCCESS;
+    }
+    if( !ptr->issued[index] || ptr->known[index] ) {
+        ERROR("ERROR: Ticket %d is not outstanding.\n", ticket);
+        return FNT_FAILURE;
+    }
+    ptr->values[index] = value;
+    ptr->known[index] = 1;
+
+    if( ptr->state == ps_initial ) {
+        ptr->f_center = value;
+        ps_next_poll(ptr);
+        return FNT_SUCCESS;
+    }
+
+    if( ptr->opportunistic && value < ptr->f_center ) {
+        ps_accept(ptr, index);
+        ps_next_poll(ptr);
+        return FNT_SUCCESS;
+    }
+
+    for(int i=0; i<ptr->count; ++i) {
+        if( !ptr->known[i] ) {
+            /* a poll cut short by the evaluation limit ends here */
+            if( ptr->evals >= ptr->max_evals && !ptr->issued[i] )  { break; }
+            return FNT_SUCCESS;
+        }
+    }
+    ps_poll_finish(ptr);
+    ps_next_poll(ptr);
+
+    return FNT_SUCCESS;
+}
+
+
+/* \brief A value without a ticket belongs to the oldest outstanding point.
+ */
+static int method_value(void *handle, fnt_vect_t *vec, double value) {
+    pattern_search_t *ptr = (pattern_search_t*)handle;
+    if( ptr == NULL )       { return FNT_FAILURE; }
+    (void)vec;
+
+    for(int i=0; i<ptr->stride; ++i) {
+        if( ptr->issued[i] && !ptr->known[i] ) {
+            return method_value_ticket(handle, ps_ticket(ptr, i), value);
+        }
+    }
+
+    ERROR("ERROR: Value received, but no points are outstanding.\n");
+
+    return FNT_FAILURE;
+}
+
+
+static int method_done(void *handle) {
+    pattern_search_t *ptr = (pattern_search_t*)handle;
+    if( ptr == NULL )       { return FNT_FAILURE; }
+
+    if( ptr->state != ps_done ) {
+        return FNT_CONTINUE;
+    }
+
+    fnt_vect_copy(&ptr->minimum_x, &ptr->center);
+    ptr->minimum_f = ptr->f_center;
+
+    return FNT_DONE;
+}
+
+
+static int method_result(void *handle, char *id, void *value_ptr) {
+    pattern_search_t *ptr = (pattern_search_t*)handle;
+    if( ptr == NULL )       { return FNT_FAILURE; }
+
+    FNT_RESULT_GET_VECT("minimum x", id, ptr->minimum_x, value_ptr);
+    FNT_RESULT_GET("minimum f", id, double, ptr->minimum_f, value_ptr);
+    FNT_RESULT_GET("evaluations", id, int, ptr->evals, value_ptr);
+
+    ERROR("No result named '%s'.\n", id);
+
+    return FNT_FAILURE;
+}
+
+
+/* MARK: Method descriptor */
+
+fnt_method_descriptor_t fnt_method_descriptor = {
+    .abi_version       = FNT_METHOD_ABI_VERSION,
+    .capabilities      = FNT_METHOD_CAP_BATCH,
+    .name              = method_name,
+    .init              = method_init,
+    .free              = method_free,
+    .reset             = method_reset,
+    .info              = method_info,
+    .hparam_set        = method_hparam_set,
+    .hparam_get        = method_hparam_get,
+    .next              = method_next,
+    .next_batch        = method_next_batch,
+    .value             = method_value,
+    .value_ticket      = method_value_ticket,
+    .done              = method_done,
+    .result            = method_result,
+};
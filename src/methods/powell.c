@@ -0,0 +1,425 @@
+/*
+ * powell.c
+ * fnt: Numerical Toolbox
+ *
+ * Copyright (c) 2024 Bryan Franklin. All rights reserved.
+ */
+#include <float.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../fnt.h"
+#include "../fnt_brent.h"
+#include "../fnt_coro.h"
+
+
+/* MARK: Method type definitions */
+
+typedef struct powell {
+    int n;
+
+    /* hyper-parameters */
+    fnt_vect_t x0;
+    double step;
+    double f_tol;
+    double eps;
+    double t;
+    int max_iter;
+
+    /* method state */
+    fnt_coro_t co;
+    fnt_line_t line;
+    fnt_vect_t x;
+    double fx;
+    fnt_vect_t start;       /* x at the start of the iteration */
+    double f_start;
+    fnt_vect_t dirs;        /* direction set, n by n, one direction per row */
+    double *steps;          /* initial bracketing step along each direction */
+    double *dir;            /* direction of the current line search */
+    double *extra;          /* x - start, the candidate new direction */
+    double s;
+    double biggest;         /* largest decrease along a single direction */
+    int big;                /* direction with that decrease */
+    int converged;
+    int curr;
+    int iter;
+    int evals;
+
+    /* results */
+    fnt_vect_t minimum_x;
+    double minimum_f;
+
+} powell_t;
+
+
+/* MARK: Internal functions */
+
+/* Move x to the minimum found by the line search along ptr->dir, and
+ * remember the distance moved as the next bracketing step. */
+static void powell_move(powell_t *ptr, double *step) {
+    fnt_line_t *ls = &ptr->line;
+
+    for(int j=0; j<ptr->n; ++j) {
+        FNT_VECT_ELEM(ptr->x, j) += ls->best_s * ptr->dir[j];
+    }
+    ptr->fx = ls->best_f;
+    *step = ls->best_s != 0.0 ? fabs(ls->best_s) : 0.5 * *step;
+    *step = fmax(*step, 10.0 * ptr->t);
+}
+
+
+/* \brief Method logic, run as a coroutine.
+ * Each iteration minimizes along every direction of the set in turn.  When
+ * the extrapolated point 2x - start shows x - start is worth keeping, it
+ * replaces the direction of largest decrease, as in Powell (1964) with the
+ * safeguard of Numerical Recipes against a linearly dependent set.
+ */
+static int powell_body(void *self) {
+    powell_t *ptr = (powell_t*)self;
+    fnt_coro_t *co = &ptr->co;
+    int n = ptr->n;
+
+    FNT_CORO_BEGIN(co);
+
+    fnt_vect_copy(&ptr->x, &ptr->x0);
+    fnt_vect_copy(fnt_coro_push(co), &ptr->x);
+    ++ptr->evals;
+    FNT_CORO_YIELD(co);
+    ptr->fx = co->values[0];
+
+    for(ptr->iter=0; ptr->iter<ptr->max_iter; ++ptr->iter) {
+        fnt_vect_copy(&ptr->start, &ptr->x);
+        ptr->f_start = ptr->fx;
+        ptr->biggest = 0.0;
+        ptr->big = 0;
+
+        /* one pass of line searches, ptr->curr == n is the new direction */
+        for(ptr->curr=0; ptr->curr<=n; ++ptr->curr) {
+            if( ptr->curr < n ) {
+                ptr->dir = &ptr->dirs.v[ptr->curr * n];
+            } else {
+                ptr->converged = 2.0 * (ptr->f_start - ptr->fx)
+                    <= ptr->f_tol * (fabs(ptr->f_start) + fabs(ptr->fx)) + DBL_MIN;
+                if( ptr->converged )    { break; }
+
+                /* try the extrapolated point 2x - start */
+                fnt_vect_t *x = fnt_coro_push(co);
+                for(int j=0; j<n; ++j) {
+                    ptr->extra[j] = FNT_VECT_ELEM(ptr->x, j) - FNT_VECT_ELEM(ptr->start, j);
+                    FNT_VECT_ELEM(*x, j) = FNT_VECT_ELEM(ptr->x, j) + ptr->extra[j];
+                }
+                ++ptr->evals;
+                FNT_CORO_YIELD(co);
+
+                double fp = ptr->f_start, fx = ptr->fx, fe = co->values[0];
+                double del = ptr->biggest;
+                if( fe >= fp
+                    || 2.0 * (fp - 2.0 * fx + fe) * (fp - fx - del) * (fp - fx - del)
+                       >= del * (fp - fe) * (fp - fe) ) {
+                    break;
+                }
+
+                /* the new direction goes last, replacing the one of the
+                 * largest decrease, with its length as the bracketing step */
+                double len = 0.0;
+                for(int j=0; j<n; ++j) { len += ptr->extra[j] * ptr->extra[j]; }
+                len = sqrt(len);
+                if( len == 0.0 )    { break; }
+                double *last = &ptr->dirs.v[(n - 1) * n];
+                memcpy(&ptr->dirs.v[ptr->big * n], last, n * sizeof(double));
+                for(int j=0; j<n; ++j) { last[j] = ptr->extra[j] / len; }
+                ptr->steps[ptr->big] = ptr->steps[n - 1];
+                ptr->steps[n - 1] = len;
+                ptr->dir = last;
+                DEBUG("DEBUG: Replacing direction %d.\n", ptr->big);
+            }
+
+            fnt_line_start(&ptr->line, ptr->fx, ptr->steps[ptr->curr < n ? ptr->curr : n - 1],
+                           ptr->eps, ptr->t);
+            while( fnt_line_next(&ptr->line, &ptr->s) == FNT_CONTINUE ) {
+                fnt_vect_t *x = fnt_coro_push(co);
+                for(int j=0; j<n; ++j) {
+                    FNT_VECT_ELEM(*x, j) = FNT_VECT_ELEM(ptr->x, j) + ptr->s * ptr->dir[j];
+                }
+                ++ptr->evals;
+                FNT_CORO_YIELD(co);
+                fnt_line_value(&ptr->line, co->values[0]);
+            }
+
+            double before = ptr->fx;
+            powell_move(ptr, &ptr->steps[ptr->curr < n ? ptr->curr : n - 1]);
+            if( ptr->curr < n && before - ptr->fx > ptr->biggest ) {
+                ptr->biggest = before - ptr->fx;
+                ptr->big = ptr->curr;
+            }
+        }
+
+        DEBUG("DEBUG: Iteration %d, f = %g.\n", ptr->iter, ptr->fx);
+        if( ptr->converged )    { break; }
+    }
+    if( ptr->iter >= ptr->max_iter ) {
+        WARN("WARN: Stopped after %d iterations.\n", ptr->iter);
+    }
+
+    fnt_vect_copy(&ptr->minimum_x, &ptr->x);
+    ptr->minimum_f = ptr->fx;
+
+    FNT_CORO_END(co);
+}
+
+
+/* MARK: Functions called by FNT */
+
+/* \brief Provides the name of the method.
+ * \param name Allocated buffer to hold the name.
+ * \param size Size of the name buffer in bytes.
+ * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
+ */
+static int method_name(char *name, int size) {
+    if( snprintf(name, size, "powell") >= size ) {
+        return FNT_FAILURE;
+    }
+
+    return FNT_SUCCESS;
+}
+
+
+/* \brief Return the method to its initial state, keeping hyper-parameters.
+ * \param handle Pointer to the method handle.
+ * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
+ */
+static int method_reset(void *handle) {
+    powell_t *ptr = (powell_t*)handle;
+    if( ptr == NULL )       { return FNT_FAILURE; }
+    int n = ptr->n;
+
+    fnt_coro_reset(&ptr->co);
+    fnt_vect_reset(&ptr->dirs);
+    for(int i=0; i<n; ++i) {
+        FNT_VECT_ELEM(ptr->dirs, i * n + i) = 1.0;
+        ptr->steps[i] = ptr->step;
+    }
+    ptr->iter = ptr->evals = ptr->converged = 0;
+    fnt_vect_reset(&ptr->minimum_x);
+    ptr->minimum_f = 0.0;
+
+    return FNT_SUCCESS;
+}
+
+
+/* \brief Initialize intenal state for method.
+ * \param handle_ptr Pointer to the method handle pointer.
+ * \param dimensions Number of dimensions in the objactive function input.
+ * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
+ */
+static int method_init(void **handle_ptr, int dimensions) {
+    if( handle_ptr == NULL )    { return FNT_FAILURE; }
+    if( dimensions < 1 )        { return FNT_FAILURE; }
+    powell_t *ptr = calloc(1, sizeof(powell_t));
+    if( ptr == NULL )           { return FNT_FAILURE; }
+    *handle_ptr = (void*)ptr;
+
+    int n = dimensions;
+    ptr->n = n;
+    ptr->step = 1.0;
+    ptr->f_tol = 1e-10;
+    ptr->eps = sqrt(DBL_EPSILON);
+    ptr->t = 1e-10;
+    ptr->max_iter = 200;
+
+    if( fnt_coro_init(&ptr->co, powell_body, ptr, 1, n) != FNT_SUCCESS ) {
+        return FNT_FAILURE;
+    }
+    fnt_vect_calloc(&ptr->x0, n);
+    fnt_vect_calloc(&ptr->x, n);
+    fnt_vect_calloc(&ptr->start, n);
+    fnt_vect_calloc(&ptr->dirs, n * n);
+    fnt_vect_calloc(&ptr->minimum_x, n);
+    ptr->steps = calloc(n, sizeof(double));
+    ptr->extra = calloc(n, sizeof(double));
+    if( ptr->steps == NULL || ptr->extra == NULL ) {
+        ERROR("ERROR: Failed to allocate direction set.\n");
+        return FNT_FAILURE;
+    }
+
+    return method_reset(ptr);
+}
+
+
+/* \brief Free any resources allocated for the method.
+ * \param handle_ptr Pointer to the method handle pointer.
+ * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
+ */
+static int method_free(void **handle_ptr) {
+    if( handle_ptr == NULL )    { return FNT_FAILURE; }
+    if( *handle_ptr == NULL )   { return FNT_FAILURE; }
+    powell_t *ptr = (powell_t*)*handle_ptr;
+
+    fnt_coro_free(&ptr->co);
+    fnt_vect_free(&ptr->x0);
+    fnt_vect_free(&ptr->x);
+    fnt_vect_free(&ptr->start);
+    fnt_vect_free(&ptr->dirs);
+    fnt_vect_free(&ptr->minimum_x);
+    free(ptr->steps);
+    free(ptr->extra);
+
+    free(ptr);  *handle_ptr = ptr = NULL;
+
+    return FNT_SUCCESS;
+}
+
+
+/* \brief Display information about the method to the console.
+ * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
+ */
+static int method_info() {
+    printf(
+"Powell's conjugate direction method minimizes along each of a set of\n"
+"directions in turn, starting from the coordinate axes.  After each pass,\n"
+"the overall displacement replaces the direction of largest decrease when\n"
+"that keeps the set from becoming linearly dependent.  For a quadratic the\n"
+"directions become mutually conjugate.  Line minimizations bracket the\n"
+"minimum, then use Brent's local minimizer, as in brents-localmin.\n"
+"\n"
+"Hyper-parameters:\n"
+"name\t\trequired\ttype\t\tDefault\tDescription\n"
+"x0\t\toptional\tfnt_vect_t\tzeros\tStarting point.\n"
+"step\t\toptional\tdouble\t\t1.0\tInitial bracketing step.\n"
+"f_tol\t\toptional\tdouble\t\t1e-10\tRelative decrease per iteration\n"
+"\t\t\t\t\t\t\tbelow which to stop.\n"
+"eps\t\toptional\tdouble\t\t1.5e-8\tRelative tolerance of line searches.\n"
+"t\t\toptional\tdouble\t\t1e-10\tAbsolute tolerance of line searches.\n"
+"max_iter\toptional\tint\t\t200\tMaximum number of iterations.\n"
+"\n"
+"Results:\n"
+"name\t\ttype\t\tDescription\n"
+"minimum x\tfnt_vect_t\tBest point found.\n"
+"minimum f\tdouble\t\tObjective value at minimum x.\n"
+"directions\tfnt_vect_t\tFinal direction set, n by n, one per row.\n"
+"iterations\tint\t\tNumber of iterations.\n"
+"evaluations\tint\t\tNumber of evaluations.\n"
+"\n"
+"References:\n"
+"M. J. D. Powell, An efficient method for finding the minimum of a\n"
+"\tfunction of several variables without calculating derivatives,\n"
+"\tComputer Journal 7 (1964), 155-162.\n"
+"W. H. Press et al., Numerical Recipes in C, 2nd ed., section 10.5.\n"
+);
+    return FNT_SUCCESS;
+}
+
+
+/* \brief Set any hyper-parameters needed for the method.
+ * \param handle Pointer to the method handle.
+ * \param id The name of the hyper-parameter.
+ * \param value_ptr A pointer to the value being set.
+ * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
+ */
+static int method_hparam_set(void *handle, char *id, void *value_ptr) {
+    if( id == NULL )        { return FNT_FAILURE; }
+    if( value_ptr == NULL ) { return FNT_FAILURE; }
+    if( handle == NULL )    { return FNT_FAILURE; }
+    powell_t *ptr = (powell_t*)handle;
+
+    FNT_HPARAM_SET_VECT("x0", id, value_ptr, &ptr->x0);
+    if( strncmp("step", id, 5) == 0 ) {
+        ptr->step = *(double*)value_ptr;
+        for(int i=0; i<ptr->n; ++i) { ptr->steps[i] = ptr->step; }
+        return FNT_SUCCESS;
+    }
+    FNT_HPARAM_SET("f_tol", id, double, value_ptr, ptr->f_tol);
+    FNT_HPARAM_SET("eps", id, double, value_ptr, ptr->eps);
+    FNT_HPARAM_SET("t", id, double, value_ptr, ptr->t);
+    FNT_HPARAM_SET("max_iter", id, int, value_ptr, ptr->max_iter);
+
+    ERROR("No hyper-parameter named '%s'.\n", id);
+
+    return FNT_FAILURE;
+}
+
+
+/* \brief Get any hyper-parameters values form the method.
+ * \param handle Pointer to the method handle.
+ * \param id The name of the hyper-parameter.
+ * \param value_ptr A pointer to the value being set.
+ * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
+ */
+static int method_hparam_get(void *handle, char *id, void *value_ptr) {
+    powell_t *ptr = (powell_t*)handle;
+    if( ptr == NULL )       { return FNT_FAILURE; }
+    if( id == NULL )        { return FNT_FAILURE; }
+    if( value_ptr == NULL ) { return FNT_FAILURE; }
+
+    FNT_HPARAM_GET_VECT("x0", id, &ptr->x0, value_ptr);
+    FNT_HPARAM_GET("step", id, double, ptr->step, value_ptr);
+    FNT_HPARAM_GET("f_tol", id, double, ptr->f_tol, value_ptr);
+    FNT_HPARAM_GET("eps", id, double, ptr->eps, value_ptr);
+    FNT_HPARAM_GET("t", id, double, ptr->t, value_ptr);
+    FNT_HPARAM_GET("max_iter", id, int, ptr->max_iter, value_ptr);
+
+    ERROR("No hyper-parameter named '%s'.\n", id);
+
+    return FNT_FAILURE;
+}
+
+
+static int method_next(void *handle, fnt_vect_t *vec) {
+    powell_t *ptr = (powell_t*)handle;
+    if( ptr == NULL )       { return FNT_FAILURE; }
+
+    return fnt_coro_next(&ptr->co, vec);
+}
+
+
+static int method_value(void *handle, fnt_vect_t *vec, double value) {
+    powell_t *ptr = (powell_t*)handle;
+    if( ptr == NULL )       { return FNT_FAILURE; }
+    (void)vec;
+
+    return fnt_coro_value(&ptr->co, value);
+}
+
+
+static int method_done(void *handle) {
+    powell_t *ptr = (powell_t*)handle;
+    if( ptr == NULL )       { return FNT_FAILURE; }
+
+    return fnt_coro_done(&ptr->co);
+}
+
+
+static int method_result(void *handle, char *id, void *value_ptr) {
+    powell_t *ptr = (powell_t*)handle;
+    if( ptr == NULL )       { return FNT_FAILURE; }
+
+    FNT_RESULT_GET_VECT("minimum x", id, ptr->minimum_x, value_ptr);
+    FNT_RESULT_GET("minimum f", id, double, ptr->minimum_f, value_ptr);
+    FNT_RESULT_GET_VECT("directions", id, ptr->dirs, value_ptr);
+    FNT_RESULT_GET("iterations", id, int, ptr->iter, value_ptr);
+    FNT_RESULT_GET("evaluations", id, int, ptr->evals, value_ptr);
+
+    ERROR("No result named '%s'.\n", id);
+
+    return FNT_FAILURE;
+}
+
+
+/* MARK: Method descriptor */
+
+fnt_method_descriptor_t fnt_method_descriptor = {
+    .abi_version       = FNT_METHOD_ABI_VERSION,
+    .capabilities      = FNT_METHOD_CAP_NONE,
+    .name              = method_name,
+    .init              = method_init,
+    .free              = method_free,
+    .reset             = method_reset,
+    .info              = method_info,
+    .hparam_set        = method_hparam_set,
+    .hparam_get        = method_hparam_get,
+    .next              = method_next,
+    .value             = method_value,
+    .done              = method_done,
+    .result            = method_result,
+};
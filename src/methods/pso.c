@@ -0,0 +1,684 @@
+/*
+ * pso.c
+ * fnt: Numerical Toolbox
+ *
+ * Copyright (c) 2024 Bryan Franklin. All rights reserved.
+ */
+#include <errno.h>
+#include <limits.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../fnt.h"
+
+
+/* MARK: Method type definitions */
+
+typedef enum pso_state {
+    pso_initial, pso_running, pso_done
+} pso_state_t;
+
+typedef enum pso_topology {
+    pso_global, pso_ring, pso_von_neumann
+} pso_topology_t;
+
+typedef struct pso {
+    int n;
+    pso_state_t state;
+    int allocated;          /* swarm size the arrays below hold */
+
+    /* hyper-parameters */
+    int swarm;
+    int max_iter;
+    int constriction;
+    int topology;
+    double c1;
+    double c2;
+    double w_start;
+    double w_end;
+    fnt_vect_t x0;
+    fnt_vect_t lower_bounds;
+    fnt_vect_t upper_bounds;
+    int has_x0;
+    int has_lower_bounds;
+    int has_upper_bounds;
+
+    /* swarm, structure of arrays, particle i is at [i * n, (i + 1) * n) */
+    double *x;              /* positions */
+    double *v;              /* velocities */
+    double *pbest;          /* personal best positions */
+    double *r1;             /* uniform random numbers for the next update */
+    double *r2;
+    double *fx;             /* value at x, one per particle */
+    double *fpbest;         /* value at pbest */
+    int *lbest;             /* particle holding the best pbest in the neighborhood */
+    double *vmax;           /* velocity limit per dimension */
+    unsigned char *issued;
+    unsigned char *known;
+    int received;
+    int generation;         /* tells tickets of earlier iterations apart */
+    int iter;
+    int evals;
+    int best;
+
+    /* results */
+    fnt_vect_t minimum_x;
+    double minimum_f;
+
+} pso_t;
+
+
+/* MARK: Internal functions */
+
+static double pso_uniform() {
+    return FNT_RAND() / (double)FNT_RAND_MAX;
+}
+
+
+static void pso_free_swarm(pso_t *ptr) {
+    free(ptr->x);       ptr->x = NULL;
+    free(ptr->v);       ptr->v = NULL;
+    free(ptr->pbest);   ptr->pbest = NULL;
+    free(ptr->r1);      ptr->r1 = NULL;
+    free(ptr->r2);      ptr->r2 = NULL;
+    free(ptr->fx);      ptr->fx = NULL;
+    free(ptr->fpbest);  ptr->fpbest = NULL;
+    free(ptr->lbest);   ptr->lbest = NULL;
+    free(ptr->issued);  ptr->issued = NULL;
+    free(ptr->known);   ptr->known = NULL;
+    ptr->allocated = 0;
+}
+
+
+static int pso_allocate_swarm(pso_t *ptr) {
+    size_t count = (size_t)ptr->swarm * ptr->n;
+
+    pso_free_swarm(ptr);
+    ptr->x = calloc(count, sizeof(double));
+    ptr->v = calloc(count, sizeof(double));
+    ptr->pbest = calloc(count, sizeof(double));
+    ptr->r1 = calloc(count, sizeof(double));
+    ptr->r2 = calloc(count, sizeof(double));
+    ptr->fx = calloc(ptr->swarm, sizeof(double));
+    ptr->fpbest = calloc(ptr->swarm, sizeof(double));
+    ptr->lbest = calloc(ptr->swarm, sizeof(int));
+    ptr->issued = calloc(ptr->swarm, sizeof(unsigned char));
+    ptr->known = calloc(ptr->swarm, sizeof(unsigned char));
+    if( ptr->x == NULL || ptr->v == NULL || ptr->pbest == NULL
+        || ptr->r1 == NULL || ptr->r2 == NULL || ptr->fx == NULL
+        || ptr->fpbest == NULL || ptr->lbest == NULL
+        || ptr->issued == NULL || ptr->known == NULL ) {
+        ERROR("calloc: %s\n", strerror(errno));
+        pso_free_swarm(ptr);
+        return FNT_FAILURE;
+    }
+    ptr->allocated = ptr->swarm;
+
+    return FNT_SUCCESS;
+}
+
+
+/* Range the swarm starts in, the bounds where given, otherwise x0 +/- 1. */
+static void pso_range(pso_t *ptr, int j, double *lo, double *hi) {
+    double center = ptr->has_x0 ? FNT_VECT_ELEM(ptr->x0, j) : 0.0;
+
+    *lo = ptr->has_lower_bounds ? FNT_VECT_ELEM(ptr->lower_bounds, j) : center - 1.0;
+    *hi = ptr->has_upper_bounds ? FNT_VECT_ELEM(ptr->upper_bounds, j) : center + 1.0;
+    if( *hi <= *lo ) {
+        if( ptr->has_lower_bounds ) { *hi = *lo + 2.0; } else { *lo = *hi - 2.0; }
+    }
+}
+
+
+/* Keep particle i inside the bounds, stopping it at the wall. */
+static void pso_clamp(pso_t *ptr, int i) {
+    double *x = &ptr->x[i * ptr->n];
+    double *v = &ptr->v[i * ptr->n];
+
+    for(int j=0; j<ptr->n; ++j) {
+        if( ptr->has_lower_bounds && x[j] < FNT_VECT_ELEM(ptr->lower_bounds, j) ) {
+            x[j] = FNT_VECT_ELEM(ptr->lower_bounds, j);
+            v[j] = 0.0;
+        }
+        if( ptr->has_upper_bounds && x[j] > FNT_VECT_ELEM(ptr->upper_bounds, j) ) {
+            x[j] = FNT_VECT_ELEM(ptr->upper_bounds, j);
+            v[j] = 0.0;
+        }
+    }
+}
+
+
+/* Scatter the swarm uniformly over its starting range, with x0 itself as
+ * the first particle when given. */
+static int pso_start(pso_t *ptr) {
+    int n = ptr->n;
+
+    if( ptr->swarm < 2 ) {
+        WARN("WARN: swarm must be at least 2, swarm was %d, changing it to 2.\n", ptr->swarm);
+        ptr->swarm = 2;
+    }
+    if( ptr->constriction && ptr->c1 + ptr->c2 <= 4.0 ) {
+        WARN("WARN: Constriction needs c1 + c2 > 4, using inertia weights instead.\n");
+        ptr->constriction = 0;
+    }
+    if( ptr->swarm != ptr->allocated && pso_allocate_swarm(ptr) != FNT_SUCCESS ) {
+        return FNT_FAILURE;
+    }
+
+    for(int j=0; j<n; ++j) {
+        double lo, hi;
+        pso_range(ptr, j, &lo, &hi);
+        ptr->vmax[j] = ptr->has_lower_bounds && ptr->has_upper_bounds
+                       ? 0.5 * (hi - lo) : INFINITY;
+        for(int i=0; i<ptr->swarm; ++i) {
+            double *x = &ptr->x[i * n];
+            x[j] = lo + pso_uniform() * (hi - lo);
+            ptr->v[i * n + j] = 0.5 * (lo + pso_uniform() * (hi - lo) - x[j]);
+        }
+    }
+    if( ptr->has_x0 ) {
+        memcpy(ptr->x, ptr->x0.v, n * sizeof(double));
+    }
+    for(int i=0; i<ptr->swarm; ++i) { pso_clamp(ptr, i); }
+
+    ptr->state = pso_running;
+    ptr->generation = ptr->received = ptr->iter = ptr->evals = ptr->best = 0;
+    memset(ptr->issued, '\0', ptr->swarm);
+    memset(ptr->known, '\0', ptr->swarm);
+
+    return FNT_SUCCESS;
+}
+
+
+/* Find the best personal best among the neighbors of each particle. */
+static void pso_neighborhoods(pso_t *ptr) {
+    int S = ptr->swarm;
+
+    /* von Neumann neighborhoods wrap around a grid with as square a shape
+     * as the swarm size allows */
+    int cols = (int)sqrt((double)S);
+    while( S % cols != 0 ) { --cols; }
+
+    for(int i=0; i<S; ++i) {
+        int nb[5] = { i, i, i, i, i };
+        switch( ptr->topology ) {
+            case pso_global:
+                ptr->lbest[i] = ptr->best;
+                continue;
+            case pso_ring:
+                nb[1] = (i + S - 1) % S;
+                nb[2] = (i + 1) % S;
+                break;
+            case pso_von_neumann:
+                nb[1] = (i + S - cols) % S;
+                nb[2] = (i + cols) % S;
+                nb[3] = i - i % cols + (i % cols + cols - 1) % cols;
+                nb[4] = i - i % cols + (i % cols + 1) % cols;
+                break;
+        }
+        int l = i;
+        for(int k=1; k<5; ++k) {
+            if( ptr->fpbest[nb[k]] < ptr->fpbest[l] ) { l = nb[k]; }
+        }
+        ptr->lbest[i] = l;
+    }
+}
+
+
+/* Velocity and position update of the whole swarm.  Everything is laid out
+ * contiguously and the random numbers are drawn beforehand, so the inner
+ * loop has no branches or calls and vectorizes. */
+static void pso_kernel(int count, int n, double chi, double w, double c1, double c2,
+                       double *restrict x, double *restrict v,
+                       const double *restrict pbest, const int *restrict lbest,
+                       const double *restrict r1, const double *restrict r2,
+                       const double *restrict vmax) {
+    for(int i=0; i<count; ++i) {
+        double *restrict xi = &x[i * n];
+        double *restrict vi = &v[i * n];
+        const double *p = &pbest[i * n];
+        const double *g = &pbest[lbest[i] * n];
+        const double *a = &r1[i * n];
+        const double *b = &r2[i * n];
+        for(int j=0; j<n; ++j) {
+            double vj = chi * (w * vi[j] + c1 * a[j] * (p[j] - xi[j])
+                                         + c2 * b[j] * (g[j] - xi[j]));
+            vj = fmin(fmax(vj, -vmax[j]), vmax[j]);
+            vi[j] = vj;
+            xi[j] += vj;
+        }
+    }
+}
+
+
+/* All values of the iteration are in, update bests and move the swarm. */
+static int pso_update(pso_t *ptr) {
+    int n = ptr->n, S = ptr->swarm;
+
+    for(int i=0; i<S; ++i) {
+        if( ptr->iter == 0 || ptr->fx[i] < ptr->fpbest[i] ) {
+            memcpy(&ptr->pbest[i * n], &ptr->x[i * n], n * sizeof(double));
+            ptr->fpbest[i] = ptr->fx[i];
+        }
+        if( ptr->fpbest[i] < ptr->fpbest[ptr->best] ) {
+            ptr->best = i;
+            INFO("New best value %g from particle %d.\n", ptr->fpbest[i], i);
+        }
+    }
+    ++ptr->iter;
+
+    if( ptr->iter >= ptr->max_iter ) {
+        ptr->state = pso_done;
+        return FNT_SUCCESS;
+    }
+
+    pso_neighborhoods(ptr);
+    for(int k=0; k<S*n; ++k) {
+        ptr->r1[k] = pso_uniform();
+        ptr->r2[k] = pso_uniform();
+    }
+
+    double chi = 1.0, w;
+    if( ptr->constriction ) {
+        double phi = ptr->c1 + ptr->c2;
+        chi = 2.0 / fabs(2.0 - phi - sqrt(phi * phi - 4.0 * phi));
+        w = 1.0;
+    } else {
+        w = ptr->w_start + (ptr->w_end - ptr->w_start) * ptr->iter / ptr->max_iter;
+    }
+    pso_kernel(S, n, chi, w, ptr->c1, ptr->c2, ptr->x, ptr->v, ptr->pbest,
+               ptr->lbest, ptr->r1, ptr->r2, ptr->vmax);
+    if( ptr->has_lower_bounds || ptr->has_upper_bounds ) {
+        for(int i=0; i<S; ++i) { pso_clamp(ptr, i); }
+    }
+
+    ptr->generation = (ptr->generation + 1) % (INT_MAX / S);
+    ptr->received = 0;
+    memset(ptr->issued, '\0', S);
+    memset(ptr->known, '\0', S);
+
+    return FNT_SUCCESS;
+}
+
+
+/* MARK: Functions called by FNT */
+
+/* \brief Provides the name of the method.
+ * \param name Allocated buffer to hold the name.
+ * \param size Size of the name buffer in bytes.
+ * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
+ */
+static int method_name(char *name, int size) {
+    if( snprintf(name, size, "pso") >= size ) {
+        return FNT_FAILURE;
+    }
+
+    return FNT_SUCCESS;
+}
+
+
+static int method_free(void **handle_ptr);
+
+
+/* \brief Initialize intenal state for method.
+ * \param handle_ptr Pointer to the method handle pointer.
+ * \param dimensions Number of dimensions in the objactive function input.
+ * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
+ */
+static int method_init(void **handle_ptr, int dimensions) {
+    if( handle_ptr == NULL )    { return FNT_FAILURE; }
+    if( dimensions < 1 )        { return FNT_FAILURE; }
+    pso_t *ptr = calloc(1, sizeof(pso_t));
+    if( ptr == NULL )           { return FNT_FAILURE; }
+    *handle_ptr = (void*)ptr;
+
+    ptr->n = dimensions;
+    ptr->state = pso_initial;
+    ptr->swarm = 10 + (int)(2.0 * sqrt((double)dimensions));
+    ptr->max_iter = 1000;
+    ptr->constriction = 1;
+    ptr->topology = pso_ring;
+    ptr->c1 = ptr->c2 = 2.05;
+    ptr->w_start = 0.9;
+    ptr->w_end = 0.4;
+
+    ptr->vmax = calloc(dimensions, sizeof(double));
+    if( ptr->vmax == NULL
+        || fnt_vect_calloc(&ptr->x0, dimensions) != FNT_SUCCESS
+        || fnt_vect_calloc(&ptr->minimum_x, dimensions) != FNT_SUCCESS ) {
+        ERROR("ERROR: Failed to allocate state for %d dimensions.\n", dimensions);
+        method_free(handle_ptr);
+        return FNT_FAILURE;
+    }
+
+    return FNT_SUCCESS;
+}
+
+
+/* \brief Free any resources allocated for the method.
+ * \param handle_ptr Pointer to the method handle pointer.
+ * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
+ */
+static int method_free(void **handle_ptr) {
+    if( handle_ptr == NULL )    { return FNT_FAILURE; }
+    if( *handle_ptr == NULL )   { return FNT_FAILURE; }
+    pso_t *ptr = (pso_t*)*handle_ptr;
+
+    pso_free_swarm(ptr);
+    free(ptr->vmax);
+    fnt_vect_free(&ptr->x0);
+    fnt_vect_free(&ptr->minimum_x);
+    if( ptr->has_lower_bounds ) { fnt_vect_free(&ptr->lower_bounds); }
+    if( ptr->has_upper_bounds ) { fnt_vect_free(&ptr->upper_bounds); }
+
+    free(ptr);  *handle_ptr = ptr = NULL;
+
+    return FNT_SUCCESS;
+}
+
+
+/* \brief Return the method to its initial state, keeping hyper-parameters.
+ * \param handle Pointer to the method handle.
+ * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
+ */
+static int method_reset(void *handle) {
+    pso_t *ptr = (pso_t*)handle;
+    if( ptr == NULL )       { return FNT_FAILURE; }
+
+    /* the swarm is scattered again, and resized if needed, on the next run */
+    ptr->state = pso_initial;
+    ptr->iter = ptr->evals = 0;
+    fnt_vect_reset(&ptr->minimum_x);
+    ptr->minimum_f = 0.0;
+
+    return FNT_SUCCESS;
+}
+
+
+/* \brief Display information about the method to the console.
+ * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
+ */
+static int method_info() {
+    printf(
+"Particle swarm optimization moves a swarm of particles, each drawn towards\n"
+"the best point it has visited and the best point found in its neighborhood.\n"
+"The whole swarm is available as one batch per iteration.\n"
+"\n"
+"With constriction (Clerc and Kennedy), velocities are scaled by\n"
+"chi = 2 / |2 - phi - sqrt(phi^2 - 4 phi)|, phi = c1 + c2 > 4.  Otherwise\n"
+"the previous velocity is weighted by an inertia weight that decreases\n"
+"linearly from w_start to w_end (Shi and Eberhart).\n"
+"\n"
+"Neighborhoods are the whole swarm (topology 0), the particles on either\n"
+"side in a ring (1), or the four particles adjacent on a wrapped grid, von\n"
+"Neumann (2).\n"
+"\n"
+"Hyper-parameters:\n"
+"name\t\trequired\ttype\t\tDefault\tDescription\n"
+"x0\t\toptional\tfnt_vect_t\tnone\tStart point, the first particle.\n"
+"lower\t\toptional\tfnt_vect_t\tnone\tLower bounds on search region.\n"
+"upper\t\toptional\tfnt_vect_t\tnone\tUpper bounds on search region.\n"
+"swarm\t\toptional\tint\t\t10+2sqrt(n)\tNumber of particles.\n"
+"max_iter\toptional\tint\t\t1000\tNumber of iterations to run.\n"
+"constriction\toptional\tint\t\t1\tUse constriction, not inertia weights.\n"
+"topology\toptional\tint\t\t1\tNeighborhood topology, see above.\n"
+"c1\t\toptional\tdouble\t\t2.05\tAttraction to the personal best.\n"
+"c2\t\toptional\tdouble\t\t2.05\tAttraction to the neighborhood best.\n"
+"w_start\t\toptional\tdouble\t\t0.9\tInitial inertia weight.\n"
+"w_end\t\toptional\tdouble\t\t0.4\tFinal inertia weight.\n"
+"\n"
+"Results:\n"
+"name\t\ttype\t\tDescription\n"
+"minimum x\tfnt_vect_t\tBest point found.\n"
+"minimum f\tdouble\t\tObjective value at minimum x.\n"
+"iterations\tint\t\tNumber of iterations.\n"
+"evaluations\tint\t\tNumber of evaluations.\n"
+"\n"
+"References:\n"
+"J. Kennedy, R. Eberhart, Particle swarm optimization, Proceedings of\n"
+"\tICNN'95, vol. 4, 1942-1948.\n"
+"M. Clerc, J. Kennedy, The particle swarm - explosion, stability, and\n"
+"\tconvergence in a multidimensional complex space, IEEE Trans. Evol.\n"
+"\tComput. 6 (2002), 58-73.\n"
+"J. Kennedy, R. Mendes, Population structure and particle swarm\n"
+"\tperformance, Proceedings of CEC'02, 1671-1676.\n"
+);
+    return FNT_SUCCESS;
+}
+
+
+/* \brief Set any hyper-parameters needed for the method.
+ * \param handle Pointer to the method handle.
+ * \param id The name of the hyper-parameter.
+ * \param value_ptr A pointer to the value being set.
+ * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
+ */
+static int method_hparam_set(void *handle, char *id, void *value_ptr) {
+    if( id == NULL )        { return FNT_FAILURE; }
+    if( value_ptr == NULL ) { return FNT_FAILURE; }
+    if( handle == NULL )    { return FNT_FAILURE; }
+    pso_t *ptr = (pso_t*)handle;
+
+    FNT_HPARAM_SET("swarm", id, int, value_ptr, ptr->swarm);
+    FNT_HPARAM_SET("max_iter", id, int, value_ptr, ptr->max_iter);
+    FNT_HPARAM_SET("constriction", id, int, value_ptr, ptr->constriction);
+    FNT_HPARAM_SET("c1", id, double, value_ptr, ptr->c1);
+    FNT_HPARAM_SET("c2", id, double, value_ptr, ptr->c2);
+    FNT_HPARAM_SET("w_start", id, double, value_ptr, ptr->w_start);
+    FNT_HPARAM_SET("w_end", id, double, value_ptr, ptr->w_end);
+
+    if( strncmp("topology", id, 9) == 0 ) {
+        int topology = *(int*)value_ptr;
+        if( topology < pso_global || topology > pso_von_neumann ) {
+            ERROR("ERROR: Unknown topology %d.\n", topology);
+            return FNT_FAILURE;
+        }
+        ptr->topology = topology;
+        return FNT_SUCCESS;
+    }
+
+    if( strncmp("x0", id, 3) == 0 ) {
+        ptr->has_x0 = 1;
+        return fnt_vect_copy(&ptr->x0, value_ptr);
+    }
+
+    if( strncmp("lower", id, 6) == 0 ) {
+        if( !ptr->has_lower_bounds ) {
+            fnt_vect_calloc(&ptr->lower_bounds, ptr->n);
+        }
+        ptr->has_lower_bounds = 1;
+        return fnt_vect_copy(&ptr->lower_bounds, value_ptr);
+    }
+
+    if( strncmp("upper", id, 6) == 0 ) {
+        if( !ptr->has_upper_bounds ) {
+            fnt_vect_calloc(&ptr->upper_bounds, ptr->n);
+        }
+        ptr->has_upper_bounds = 1;
+        return fnt_vect_copy(&ptr->upper_bounds, value_ptr);
+    }
+
+    ERROR("No hyper-parameter named '%s'.\n", id);
+
+    return FNT_FAILURE;
+}
+
+
+/* \brief Get any hyper-parameters values form the method.
+ * \param handle Pointer to the method handle.
+ * \param id The name of the hyper-parameter.
+ * \param value_ptr A pointer to the value being set.
+ * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
+ */
+static int method_hparam_get(void *handle, char *id, void *value_ptr) {
+    pso_t *ptr = (pso_t*)handle;
+    if( ptr == NULL )       { return FNT_FAILURE; }
+    if( id == NULL )        { return FNT_FAILURE; }
+    if( value_ptr == NULL ) { return FNT_FAILURE; }
+
+    FNT_HPARAM_GET("swarm", id, int, ptr->swarm, value_ptr);
+    FNT_HPARAM_GET("max_iter", id, int, ptr->max_iter, value_ptr);
+    FNT_HPARAM_GET("constriction", id, int, ptr->constriction, value_ptr);
+    FNT_HPARAM_GET("topology", id, int, ptr->topology, value_ptr);
+    FNT_HPARAM_GET("c1", id, double, ptr->c1, value_ptr);
+    FNT_HPARAM_GET("c2", id, double, ptr->c2, value_ptr);
+    FNT_HPARAM_GET("w_start", id, double, ptr->w_start, value_ptr);
+    FNT_HPARAM_GET("w_end", id, double, ptr->w_end, value_ptr);
+    if( ptr->has_x0 ) {
+        FNT_HPARAM_GET_VECT("x0", id, &ptr->x0, value_ptr);
+    }
+    if( ptr->has_lower_bounds ) {
+        FNT_HPARAM_GET_VECT("lower", id, &ptr->lower_bounds, value_ptr);
+    }
+    if( ptr->has_upper_bounds ) {
+        FNT_HPARAM_GET_VECT("upper", id, &ptr->upper_bounds, value_ptr);
+    }
+
+    ERROR("No hyper-parameter named '%s'.\n", id);
+
+    return FNT_FAILURE;
+}
+
+
+/* \brief Hands out every particle not yet handed out this iteration, up to
+ * capacity.  count is zero while the whole swarm is awaiting values.
+ */
+static int method_next_batch(void *handle, fnt_vect_t *vecs, int *tickets, int capacity, int *count) {
+    pso_t *ptr = (pso_t*)handle;
+    if( ptr == NULL )       { return FNT_FAILURE; }
+    if( vecs == NULL )      { return FNT_FAILURE; }
+    if( tickets == NULL )   { return FNT_FAILURE; }
+    if( count == NULL )     { return FNT_FAILURE; }
+
+    *count = 0;
+    if( ptr->state == pso_done ) {
+        ERROR("ERROR: No input needed, method is done.\n");
+        return FNT_FAILURE;
+    }
+    if( ptr->state == pso_initial && pso_start(ptr) != FNT_SUCCESS ) {
+        return FNT_FAILURE;
+    }
+
+    int n = ptr->n;
+    for(int i=0; i<ptr->swarm && *count < capacity; ++i) {
+        if( ptr->issued[i] )    { continue; }
+        memcpy(vecs[*count].v, &ptr->x[i * n], n * sizeof(double));
+        tickets[*count] = ptr->generation * ptr->swarm + i;
+        ptr->issued[i] = 1;
+        ++ptr->evals;
+        ++*count;
+    }
+
+    return FNT_SUCCESS;
+}
+
+
+static int method_next(void *handle, fnt_vect_t *vec) {
+    int ticket = 0, count = 0;
+
+    if( method_next_batch(handle, vec, &ticket, 1, &count) != FNT_SUCCESS ) {
+        return FNT_FAILURE;
+    }
+    if( count == 0 ) {
+        ERROR("ERROR: No particles left to hand out, values are still outstanding.\n");
+        return FNT_FAILURE;
+    }
+
+    return FNT_SUCCESS;
+}
+
+
+static int method_value_ticket(void *handle, int ticket, double value) {
+    pso_t *ptr = (pso_t*)handle;
+    if( ptr == NULL )       { return FNT_FAILURE; }
+    if( ticket < 0 )        { return FNT_FAILURE; }
+    if( ptr->state != pso_running ) {
+        ERROR("ERROR: Value received, but no particles are outstanding.\n");
+        return FNT_FAILURE;
+    }
+
+    int i = ticket % ptr->swarm;
+    if( ticket / ptr->swarm != ptr->generation || !ptr->issued[i] || ptr->known[i] ) {
+        ERROR("ERROR: Ticket %d is not outstanding.\n", ticket);
+        return FNT_FAILURE;
+    }
+    ptr->fx[i] = value;
+    ptr->known[i] = 1;
+
+    if( ++ptr->received == ptr->swarm ) {
+        return pso_update(ptr);
+    }
+
+    return FNT_SUCCESS;
+}
+
+
+/* \brief A value without a ticket belongs to the oldest outstanding particle.
+ */
+static int method_value(void *handle, fnt_vect_t *vec, double value) {
+    pso_t *ptr = (pso_t*)handle;
+    if( ptr == NULL )       { return FNT_FAILURE; }
+    (void)vec;
+
+    for(int i=0; ptr->state == pso_running && i<ptr->swarm; ++i) {
+        if( ptr->issued[i] && !ptr->known[i] ) {
+            return method_value_ticket(handle, ptr->generation * ptr->swarm + i, value);
+        }
+    }
+
+    ERROR("ERROR: Value received, but no particles are outstanding.\n");
+
+    return FNT_FAILURE;
+}
+
+
+static int method_done(void *handle) {
+    pso_t *ptr = (pso_t*)handle;
+    if( ptr == NULL )       { return FNT_FAILURE; }
+
+    if( ptr->state != pso_done ) {
+        return FNT_CONTINUE;
+    }
+
+    memcpy(ptr->minimum_x.v, &ptr->pbest[ptr->best * ptr->n], ptr->n * sizeof(double));
+    ptr->minimum_f = ptr->fpbest[ptr->best];
+
+    return FNT_DONE;
+}
+
+
+static int method_result(void *handle, char *id, void *value_ptr) {
+    pso_t *ptr = (pso_t*)handle;
+    if( ptr == NULL )       { return FNT_FAILURE; }
+
+    FNT_RESULT_GET_VECT("minimum x", id, ptr->minimum_x, value_ptr);
+    FNT_RESULT_GET("minimum f", id, double, ptr->minimum_f, value_ptr);
+    FNT_RESULT_GET("iterations", id, int, ptr->iter, value_ptr);
+    FNT_RESULT_GET("evaluations", id, int, ptr->evals, value_ptr);
+
+    ERROR("No result named '%s'.\n", id);
+
+    return FNT_FAILURE;
+}
+
+
+/* MARK: Method descriptor */
+
+fnt_method_descriptor_t fnt_method_descriptor = {
+    .abi_version       = FNT_METHOD_ABI_VERSION,
+    .capabilities      = FNT_METHOD_CAP_BATCH,
+    .name              = method_name,
+    .init              = method_init,
+    .free              = method_free,
+    .reset             = method_reset,
+    .info              = method_info,
+    .hparam_set        = method_hparam_set,
+    .hparam_get        = method_hparam_get,
+    .next              = method_next,
+    .next_batch        = method_next_batch,
+    .value             = method_value,
+    .value_ticket      = method_value_ticket,
+    .done              = method_done,
+    .result            = method_result,
+};
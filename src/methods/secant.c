@@ -45,7 +45,7 @@ typedef struct secant {
  * \param size Size of the name buffer in bytes.
  * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
  */
-int method_name(char *name, int size) {
+static int method_name(char *name, int size) {
     if( snprintf(name, size, "secant") >= size ) {
         return FNT_FAILURE;
     }
@@ -57,7 +57,7 @@ int method_name(char *name, int size) {
 /* \brief Initialize intenal state for method.
  * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
  */
-int method_init(void **handle_ptr, int dimensions) {
+static int method_init(void **handle_ptr, int dimensions) {
     if( handle_ptr == NULL )    { return FNT_FAILURE; }
     secant_t *ptr = calloc(1, sizeof(secant_t));
     if( ptr == NULL )           { return FNT_FAILURE; }
@@ -78,7 +78,7 @@ int method_init(void **handle_ptr, int dimensions) {
 }
 
 
-int method_free(void **handle_ptr) {
+static int method_free(void **handle_ptr) {
     if( handle_ptr == NULL )    { return FNT_FAILURE; }
     if( *handle_ptr == NULL )   { return FNT_FAILURE; }
     secant_t *ptr = (secant_t*)*handle_ptr;
@@ -91,10 +91,27 @@ int method_free(void **handle_ptr) {
 }
 
 
+/* \brief Return the method to its initial state, keeping hyper-parameters.
+ * \param handle Pointer to the method handle.
+ * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
+ */
+static int method_reset(void *handle) {
+    secant_t *ptr = (secant_t*)handle;
+    if( ptr == NULL )       { return FNT_FAILURE; }
+
+    ptr->state = secant_initial;
+    ptr->x_prev = ptr->fx_prev = 0.0;
+    ptr->x_next = 0.0;
+    ptr->root_x = 0.0;
+
+    return FNT_SUCCESS;
+}
+
+
 /* \brief Display information about the method to the console.
  * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
  */
-int method_info() {
+static int method_info() {
     printf(
 "The secant method is a root finding method that uses two points on the\n"
 "function to contruct a line, then extends that line to the x-axis to\n"
@@ -123,7 +140,7 @@ int method_info() {
  * \param value_ptr A pointer to the value being set.
  * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
  */
-int method_hparam_set(void *handle, char *id, void *value_ptr) {
+static int method_hparam_set(void *handle, char *id, void *value_ptr) {
     if( id == NULL )        { return FNT_FAILURE; }
     if( value_ptr == NULL ) { return FNT_FAILURE; }
     secant_t *ptr = (secant_t*)handle;
@@ -138,7 +155,7 @@ int method_hparam_set(void *handle, char *id, void *value_ptr) {
 }
 
 
-int method_hparam_get(void *handle, char *id, void *value_ptr) {
+static int method_hparam_get(void *handle, char *id, void *value_ptr) {
     if( id == NULL )        { return FNT_FAILURE; }
     if( value_ptr == NULL ) { return FNT_FAILURE; }
     secant_t *ptr = (secant_t*)handle;
@@ -153,7 +170,7 @@ int method_hparam_get(void *handle, char *id, void *value_ptr) {
 }
 
 
-int method_next(void *handle, fnt_vect_t *vec) {
+static int method_next(void *handle, fnt_vect_t *vec) {
     secant_t *ptr = (secant_t*)handle;
     if( ptr == NULL )       { return FNT_FAILURE; }
     if( vec == NULL )       { return FNT_FAILURE; }
@@ -171,7 +188,7 @@ int method_next(void *handle, fnt_vect_t *vec) {
 }
 
 
-int method_value(void *handle, fnt_vect_t *vec, double value) {
+static int method_value(void *handle, fnt_vect_t *vec, double value) {
     secant_t *ptr = (secant_t*)handle;
     if( ptr == NULL )       { return FNT_FAILURE; }
     if( vec == NULL )       { return FNT_FAILURE; }
@@ -211,7 +228,7 @@ int method_value(void *handle, fnt_vect_t *vec, double value) {
 }
 
 
-int method_done(void *handle) {
+static int method_done(void *handle) {
     secant_t *ptr = (secant_t*)handle;
     if( ptr == NULL )       { return FNT_FAILURE; }
 
@@ -235,7 +252,7 @@ int method_done(void *handle) {
 }
 
 
-int method_result(void *handle, char *id, void *value_ptr) {
+static int method_result(void *handle, char *id, void *value_ptr) {
     secant_t *ptr = (secant_t*)handle;
     if( ptr == NULL )       { return FNT_FAILURE; }
 
@@ -245,3 +262,22 @@ int method_result(void *handle, char *id, void *value_ptr) {
 
     return FNT_FAILURE;
 }
+
+
+/* MARK: Method descriptor */
+
+fnt_method_descriptor_t fnt_method_descriptor = {
+    .abi_version       = FNT_METHOD_ABI_VERSION,
+    .capabilities      = FNT_METHOD_CAP_NONE,
+    .name              = method_name,
+    .init              = method_init,
+    .free              = method_free,
+    .reset             = method_reset,
+    .info              = method_info,
+    .hparam_set        = method_hparam_set,
+    .hparam_get        = method_hparam_get,
+    .next              = method_next,
+    .value             = method_value,
+    .done              = method_done,
+    .result            = method_result,
+};
@@ -44,7 +44,7 @@ typedef struct simpson {
  * \param size Size of the name buffer in bytes.
  * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
  */
-int method_name(char *name, int size) {
+static int method_name(char *name, int size) {
     if( snprintf(name, size, "simpson") >= size ) {
         return FNT_FAILURE;
     }
@@ -58,7 +58,7 @@ int method_name(char *name, int size) {
  * \param dimensions Number of dimensions in the objactive function input.
  * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
  */
-int method_init(void **handle_ptr, int dimensions) {
+static int method_init(void **handle_ptr, int dimensions) {
     if( handle_ptr == NULL )    { return FNT_FAILURE; }
     simpson_t *ptr = calloc(1, sizeof(simpson_t));
     if( ptr == NULL )           { return FNT_FAILURE; }
@@ -76,7 +76,7 @@ int method_init(void **handle_ptr, int dimensions) {
  * \param handle_ptr Pointer to the method handle pointer.
  * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
  */
-int method_free(void **handle_ptr) {
+static int method_free(void **handle_ptr) {
     if( handle_ptr == NULL )    { return FNT_FAILURE; }
     if( *handle_ptr == NULL )   { return FNT_FAILURE; }
     simpson_t *ptr = (simpson_t*)*handle_ptr;
@@ -89,10 +89,28 @@ int method_free(void **handle_ptr) {
 }
 
 
+/* \brief Return the method to its initial state, keeping hyper-parameters.
+ * \param handle Pointer to the method handle.
+ * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
+ */
+static int method_reset(void *handle) {
+    simpson_t *ptr = (simpson_t*)handle;
+    if( ptr == NULL )       { return FNT_FAILURE; }
+
+    ptr->state = simpson_initial;
+    ptr->first_fx = ptr->last_fx = 0.0;
+    ptr->sum1 = ptr->sum2 = 0.0;
+    ptr->curr_subinterval = 0;
+    ptr->area = 0.0;
+
+    return FNT_SUCCESS;
+}
+
+
 /* \brief Display information about the method to the console.
  * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
  */
-int method_info() {
+static int method_info() {
     printf(
 "Simpson's rule is an integration method that samples the interval being\n"
 "integrated at regular subintervals and uses parabolas to estimate the\n"
@@ -122,7 +140,7 @@ int method_info() {
  * \param value_ptr A pointer to the value being set.
  * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
  */
-int method_hparam_set(void *handle, char *id, void *value_ptr) {
+static int method_hparam_set(void *handle, char *id, void *value_ptr) {
     if( id == NULL )        { return FNT_FAILURE; }
     if( value_ptr == NULL ) { return FNT_FAILURE; }
     if( handle == NULL )    { return FNT_FAILURE; }
@@ -145,7 +163,7 @@ int method_hparam_set(void *handle, char *id, void *value_ptr) {
  * \param value_ptr A pointer to the value being set.
  * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
  */
-int method_hparam_get(void *handle, char *id, void *value_ptr) {
+static int method_hparam_get(void *handle, char *id, void *value_ptr) {
     if( id == NULL )        { return FNT_FAILURE; }
     if( value_ptr == NULL ) { return FNT_FAILURE; }
     if( handle == NULL )    { return FNT_FAILURE; }
@@ -162,7 +180,7 @@ int method_hparam_get(void *handle, char *id, void *value_ptr) {
 }
 
 
-int method_next(void *handle, fnt_vect_t *vec) {
+static int method_next(void *handle, fnt_vect_t *vec) {
     if( handle == NULL )    { return FNT_FAILURE; }
     if( vec == NULL )       { return FNT_FAILURE; }
     if( vec->v == NULL )    { return FNT_FAILURE; }
@@ -189,7 +207,7 @@ int method_next(void *handle, fnt_vect_t *vec) {
 }
 
 
-int method_value(void *handle, fnt_vect_t *vec, double value) {
+static int method_value(void *handle, fnt_vect_t *vec, double value) {
     if( handle == NULL )    { return FNT_FAILURE; }
     if( vec == NULL )       { return FNT_FAILURE; }
     if( vec->v == NULL )    { return FNT_FAILURE; }
@@ -255,7 +273,7 @@ int method_value(void *handle, fnt_vect_t *vec, double value) {
 }
 
 
-int method_done(void *handle) {
+static int method_done(void *handle) {
     if( handle == NULL )    { return FNT_FAILURE; }
     simpson_t *ptr = (simpson_t*)handle;
 
@@ -267,7 +285,7 @@ int method_done(void *handle) {
 }
 
 
-int method_result(void *handle, char *id, void *value_ptr) {
+static int method_result(void *handle, char *id, void *value_ptr) {
     if( handle == NULL )    { return FNT_FAILURE; }
     simpson_t *ptr = (simpson_t*)handle;
 
@@ -283,3 +301,22 @@ int method_result(void *handle, char *id, void *value_ptr) {
 
     return FNT_FAILURE;
 }
+
+
+/* MARK: Method descriptor */
+
+fnt_method_descriptor_t fnt_method_descriptor = {
+    .abi_version       = FNT_METHOD_ABI_VERSION,
+    .capabilities      = FNT_METHOD_CAP_NONE,
+    .name              = method_name,
+    .init              = method_init,
+    .free              = method_free,
+    .reset             = method_reset,
+    .info              = method_info,
+    .hparam_set        = method_hparam_set,
+    .hparam_get        = method_hparam_get,
+    .next              = method_next,
+    .value             = method_value,
+    .done              = method_done,
+    .result            = method_result,
+};
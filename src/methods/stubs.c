@@ -37,7 +37,7 @@ typedef struct stub {
  * \param size Size of the name buffer in bytes.
  * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
  */
-int method_name(char *name, int size) {
+static int method_name(char *name, int size) {
     if( snprintf(name, size, "stub") >= size ) {
         return FNT_FAILURE;
     }
@@ -51,7 +51,7 @@ int method_name(char *name, int size) {
  * \param dimensions Number of dimensions in the objactive function input.
  * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
  */
-int method_init(void **handle_ptr, int dimensions) {
+static int method_init(void **handle_ptr, int dimensions) {
     if( handle_ptr == NULL )    { return FNT_FAILURE; }
     stub_t *ptr = calloc(1, sizeof(stub_t));
     if( ptr == NULL )           { return FNT_FAILURE; }
@@ -68,7 +68,7 @@ int method_init(void **handle_ptr, int dimensions) {
  * \param handle_ptr Pointer to the method handle pointer.
  * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
  */
-int method_free(void **handle_ptr) {
+static int method_free(void **handle_ptr) {
     if( handle_ptr == NULL )    { return FNT_FAILURE; }
     if( *handle_ptr == NULL )   { return FNT_FAILURE; }
     stub_t *ptr = (stub_t*)*handle_ptr;
@@ -81,10 +81,26 @@ int method_free(void **handle_ptr) {
 }
 
 
+/* \brief Return the method to its initial state, keeping hyper-parameters.
+ * \param handle Pointer to the method handle.
+ * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
+ */
+static int method_reset(void *handle) {
+    stub_t *ptr = (stub_t*)handle;
+    if( ptr == NULL )       { return FNT_FAILURE; }
+
+    /* return method state to what method_init left it as */
+    ptr->state = stub_initial;
+    ptr->result = 0.0;
+
+    return FNT_SUCCESS;
+}
+
+
 /* \brief Display information about the method to the console.
  * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
  */
-int method_info() {
+static int method_info() {
     printf(
 "The stub method is not a numerical method, instead it provides a starting\n"
 "point for imlementing real numerical methods.\n"
@@ -110,7 +126,7 @@ int method_info() {
  * \param value_ptr A pointer to the value being set.
  * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
  */
-int method_hparam_set(void *handle, char *id, void *value_ptr) {
+static int method_hparam_set(void *handle, char *id, void *value_ptr) {
     if( id == NULL )        { return FNT_FAILURE; }
     if( value_ptr == NULL ) { return FNT_FAILURE; }
     if( handle == NULL )    { return FNT_FAILURE; }
@@ -130,7 +146,7 @@ int method_hparam_set(void *handle, char *id, void *value_ptr) {
  * \param value_ptr A pointer to the value being set.
  * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
  */
-int method_hparam_get(void *handle, char *id, void *value_ptr) {
+static int method_hparam_get(void *handle, char *id, void *value_ptr) {
     stub_t *ptr = (stub_t*)handle;
     if( ptr == NULL )       { return FNT_FAILURE; }
     if( id == NULL )        { return FNT_FAILURE; }
@@ -144,7 +160,7 @@ int method_hparam_get(void *handle, char *id, void *value_ptr) {
 }
 
 
-int method_next(void *handle, fnt_vect_t *vec) {
+static int method_next(void *handle, fnt_vect_t *vec) {
     stub_t *ptr = (stub_t*)handle;
     if( ptr == NULL )       { return FNT_FAILURE; }
     if( vec == NULL )       { return FNT_FAILURE; }
@@ -156,7 +172,7 @@ int method_next(void *handle, fnt_vect_t *vec) {
 }
 
 
-int method_value(void *handle, fnt_vect_t *vec, double value) {
+static int method_value(void *handle, fnt_vect_t *vec, double value) {
     stub_t *ptr = (stub_t*)handle;
     if( ptr == NULL )       { return FNT_FAILURE; }
     if( vec == NULL )       { return FNT_FAILURE; }
@@ -168,7 +184,7 @@ int method_value(void *handle, fnt_vect_t *vec, double value) {
 }
 
 
-int method_value_gradient(void *handle, fnt_vect_t *vec, double value, fnt_vect_t gradient) {
+static int method_value_gradient(void *handle, fnt_vect_t *vec, double value, fnt_vect_t *gradient) {
     stub_t *ptr = (stub_t*)handle;
     if( ptr == NULL )       { return FNT_FAILURE; }
     if( vec == NULL )       { return FNT_FAILURE; }
@@ -180,7 +196,7 @@ int method_value_gradient(void *handle, fnt_vect_t *vec, double value, fnt_vect_
 }
 
 
-int method_done(void *handle) {
+static int method_done(void *handle) {
     stub_t *ptr = (stub_t*)handle;
     if( ptr == NULL )       { return FNT_FAILURE; }
 
@@ -192,7 +208,7 @@ int method_done(void *handle) {
 }
 
 
-int method_result(void *handle, char *id, void *value_ptr) {
+static int method_result(void *handle, char *id, void *value_ptr) {
     stub_t *ptr = (stub_t*)handle;
     if( ptr == NULL )       { return FNT_FAILURE; }
 
@@ -203,3 +219,23 @@ int method_result(void *handle, char *id, void *value_ptr) {
 
     return FNT_FAILURE;
 }
+
+
+/* MARK: Method descriptor */
+
+fnt_method_descriptor_t fnt_method_descriptor = {
+    .abi_version       = FNT_METHOD_ABI_VERSION,
+    .capabilities      = FNT_METHOD_CAP_NONE,
+    .name              = method_name,
+    .init              = method_init,
+    .free              = method_free,
+    .reset             = method_reset,
+    .info              = method_info,
+    .hparam_set        = method_hparam_set,
+    .hparam_get        = method_hparam_get,
+    .next              = method_next,
+    .value             = method_value,
+    .value_gradient    = method_value_gradient,
+    .done              = method_done,
+    .result            = method_result,
+};
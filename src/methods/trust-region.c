@@ -0,0 +1,939 @@
+/*
+ * trust-region.c
+ * fnt: Numerical Toolbox
+ *
+ * Copyright (c) 2024 Bryan Franklin. All rights reserved.
+ */
+#include <float.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../fnt.h"
+#include "../fnt_coro.h"
+
+
+/* MARK: Method type definitions */
+
+typedef struct trust_region {
+    int n;                  /* dimensions */
+    int m;                  /* interpolation points, 2n+1 */
+    int N;                  /* size of the KKT system, m+n+1 */
+
+    /* hyper-parameters */
+    fnt_vect_t x0;
+    fnt_vect_t lower_bounds;
+    fnt_vect_t upper_bounds;
+    int has_lower_bounds;
+    int has_upper_bounds;
+    double rho_begin;
+    double rho_end;
+    int max_evals;
+
+    /* interpolation set, points held as offsets from base */
+    fnt_vect_t base;
+    double *Y;              /* m x n, row-major */
+    double *fval;
+    int kopt;
+    int evals;
+
+    /* quadratic model, gradient at base and Hessian Gamma + sum pq_k y_k y_k^T */
+    double *gq;
+    double *hq;             /* n x n explicit part of the Hessian */
+    double *pq;             /* implicit part, one weight per point */
+
+    /* inverse of the KKT matrix of the interpolation conditions */
+    double *H;              /* N x N */
+    double *W;              /* N x N scratch for rebuilding H */
+
+    /* trust region */
+    double rho;
+    double rho_final;       /* rho_end, at most the initial rho */
+    double delta;
+
+    /* current step, with scratch vectors */
+    fnt_coro_t co;
+    int t;                  /* point being replaced */
+    double *d;              /* offset of the next point from base */
+    double *s;
+    double *g;
+    double *p;
+    double *Bp;
+    double *w;
+    double *Hw;
+    char *fixed;
+    double vquad;           /* predicted change in f along s */
+    double dnorm;
+
+    /* results */
+    fnt_vect_t minimum_x;
+    double minimum_f;
+
+} trust_region_t;
+
+
+/* MARK: Internal functions */
+
+static double tr_dot(double *a, double *b, int n) {
+    double sum = 0.0;
+    for(int i=0; i<n; ++i) { sum += a[i] * b[i]; }
+    return sum;
+}
+
+
+static double tr_lower(trust_region_t *ptr, int i) {
+    return ptr->has_lower_bounds ? FNT_VECT_ELEM(ptr->lower_bounds, i) : -DBL_MAX;
+}
+
+
+static double tr_upper(trust_region_t *ptr, int i) {
+    return ptr->has_upper_bounds ? FNT_VECT_ELEM(ptr->upper_bounds, i) : DBL_MAX;
+}
+
+
+/* out = (Gamma + sum pq_k y_k y_k^T) v, O(mn + n^2). */
+static void tr_hess_vec(trust_region_t *ptr, double *v, double *out) {
+    int n = ptr->n;
+
+    for(int i=0; i<n; ++i) { out[i] = tr_dot(&ptr->hq[i*n], v, n); }
+    for(int k=0; k<ptr->m; ++k) {
+        if( ptr->pq[k] == 0.0 ) { continue; }
+        double *y = &ptr->Y[k*n];
+        double scale = ptr->pq[k] * tr_dot(y, v, n);
+        for(int i=0; i<n; ++i) { out[i] += scale * y[i]; }
+    }
+}
+
+
+/* Model value at offset d, relative to its value at base. */
+static double tr_model(trust_region_t *ptr, double *d, double *scratch) {
+    tr_hess_vec(ptr, d, scratch);
+
+    return tr_dot(ptr->gq, d, ptr->n) + 0.5 * tr_dot(d, scratch, ptr->n);
+}
+
+
+/* w(d) is the column the point base + d would add to the KKT matrix. */
+static void tr_w(trust_region_t *ptr, double *d, double *w) {
+    int n = ptr->n, m = ptr->m;
+
+    for(int k=0; k<m; ++k) {
+        double dot = tr_dot(&ptr->Y[k*n], d, n);
+        w[k] = 0.5 * dot * dot;
+    }
+    w[m] = 1.0;
+    for(int i=0; i<n; ++i) { w[m+1+i] = d[i]; }
+}
+
+
+/* Invert the KKT matrix
+ *      [ A  1  Y ]
+ *      [ 1  0  0 ]     A_jk = (y_j^T y_k)^2 / 2
+ *      [ Y' 0  0 ]
+ * by Gauss-Jordan with partial pivoting, O(N^3).  Only done to start and
+ * after moving base, updates to H are O(N^2). */
+static int tr_rebuild(trust_region_t *ptr) {
+    int n = ptr->n, m = ptr->m, N = ptr->N;
+    double *W = ptr->W, *H = ptr->H;
+
+    memset(W, 0, (size_t)N * N * sizeof(double));
+    for(int j=0; j<m; ++j) {
+        double *yj = &ptr->Y[j*n];
+        for(int k=0; k<=j; ++k) {
+            double dot = tr_dot(yj, &ptr->Y[k*n], n);
+            W[j*N+k] = W[k*N+j] = 0.5 * dot * dot;
+        }
+        W[j*N+m] = W[m*N+j] = 1.0;
+        for(int i=0; i<n; ++i) {
+            W[j*N+m+1+i] = W[(m+1+i)*N+j] = yj[i];
+        }
+    }
+
+    for(int i=0; i<N; ++i) {
+        for(int j=0; j<N; ++j) { H[i*N+j] = i == j ? 1.0 : 0.0; }
+    }
+    for(int col=0; col<N; ++col) {
+        int pivot = col;
+        for(int i=col+1; i<N; ++i) {
+            if( fabs(W[i*N+col]) > fabs(W[pivot*N+col]) ) { pivot = i; }
+        }
+        if( W[pivot*N+col] == 0.0 ) {
+            ERROR("ERROR: Interpolation points are degenerate.\n");
+            return FNT_FAILURE;
+        }
+        if( pivot != col ) {
+            for(int j=0; j<N; ++j) {
+                double tmp;
+                tmp = W[col*N+j];   W[col*N+j] = W[pivot*N+j];  W[pivot*N+j] = tmp;
+                tmp = H[col*N+j];   H[col*N+j] = H[pivot*N+j];  H[pivot*N+j] = tmp;
+            }
+        }
+        double scale = 1.0 / W[col*N+col];
+        for(int j=0; j<N; ++j) {
+            W[col*N+j] *= scale;
+            H[col*N+j] *= scale;
+        }
+        for(int i=0; i<N; ++i) {
+            double factor = W[i*N+col];
+            if( i == col || factor == 0.0 ) { continue; }
+            for(int j=0; j<N; ++j) {
+                W[i*N+j] -= factor * W[col*N+j];
+                H[i*N+j] -= factor * H[col*N+j];
+            }
+        }
+    }
+
+    return FNT_SUCCESS;
+}
+
+
+/* Fold the implicit Hessian term of point k into the explicit part. */
+static void tr_fold(trust_region_t *ptr, int k) {
+    int n = ptr->n;
+    double *y = &ptr->Y[k*n];
+
+    if( ptr->pq[k] == 0.0 ) { return; }
+    for(int i=0; i<n; ++i) {
+        double scale = ptr->pq[k] * y[i];
+        for(int j=0; j<n; ++j) { ptr->hq[i*n+j] += scale * y[j]; }
+    }
+    ptr->pq[k] = 0.0;
+}
+
+
+/* Move base to the best point, keeping the model, once the step lengths
+ * become small next to |y_opt| and rounding would spoil the updates. */
+static int tr_rebase(trust_region_t *ptr) {
+    int n = ptr->n;
+    double *shift = ptr->s;
+
+    memcpy(shift, &ptr->Y[ptr->kopt*n], n * sizeof(double));
+    tr_hess_vec(ptr, shift, ptr->g);
+    for(int i=0; i<n; ++i) { ptr->gq[i] += ptr->g[i]; }
+    for(int k=0; k<ptr->m; ++k) { tr_fold(ptr, k); }
+    for(int k=0; k<ptr->m; ++k) {
+        for(int i=0; i<n; ++i) { ptr->Y[k*n+i] -= shift[i]; }
+    }
+    for(int i=0; i<n; ++i) { FNT_VECT_ELEM(ptr->base, i) += shift[i]; }
+    DEBUG("DEBUG: Moved model base to the best point.\n");
+
+    return tr_rebuild(ptr);
+}
+
+
+/* Replace point t with base + d and value f.  H is updated by Powell's
+ * rank-two formula, then the model changes by the Lagrange function of
+ * the new point, scaled by its interpolation error, which is the least
+ * Frobenius norm change to the Hessian.  Both are O(N^2). */
+static int tr_replace(trust_region_t *ptr, int t, double *d, double f) {
+    int n = ptr->n, m = ptr->m, N = ptr->N;
+    double *H = ptr->H, *w = ptr->w, *Hw = ptr->Hw;
+
+    double diff = (f - ptr->fval[ptr->kopt])
+                - (tr_model(ptr, d, ptr->g) - tr_model(ptr, &ptr->Y[ptr->kopt*n], ptr->g));
+
+    tr_w(ptr, d, w);
+    for(int i=0; i<N; ++i) { Hw[i] = tr_dot(&H[i*N], w, N); }
+    double dd = tr_dot(d, d, n);
+    double alpha = H[t*N+t];
+    double beta = 0.5 * dd * dd - tr_dot(w, Hw, N);
+    double tau = Hw[t];
+    double sigma = alpha * beta + tau * tau;
+    if( fabs(sigma) < 1e-300 ) {
+        WARN("WARN: Interpolation update is singular, skipping point.\n");
+        return FNT_SUCCESS;
+    }
+
+    /* H += (alpha v v^T - beta h h^T + tau (h v^T + v h^T)) / sigma, with
+     * v = e_t - H w, formed in place of H w, and h = H e_t in place of w */
+    double *v = Hw, *h = w;
+    for(int i=0; i<N; ++i) {
+        h[i] = H[i*N+t];
+        v[i] = (i == t ? 1.0 : 0.0) - Hw[i];
+    }
+    for(int i=0; i<N; ++i) {
+        double a = (alpha * v[i] + tau * h[i]) / sigma;
+        double b = (tau * v[i] - beta * h[i]) / sigma;
+        for(int j=0; j<N; ++j) {
+            H[i*N+j] += a * v[j] + b * h[j];
+        }
+    }
+
+    /* the old point's implicit Hessian term must not move with it */
+    tr_fold(ptr, t);
+    memcpy(&ptr->Y[t*n], d, n * sizeof(double));
+    ptr->fval[t] = f;
+
+    for(int k=0; k<m; ++k) { ptr->pq[k] += diff * H[k*N+t]; }
+    for(int i=0; i<n; ++i) { ptr->gq[i] += diff * H[(m+1+i)*N+t]; }
+
+    if( f < ptr->fval[ptr->kopt] )  { ptr->kopt = t; }
+
+    return FNT_SUCCESS;
+}
+
+
+/* Point to replace by base + d: the one whose replacement keeps the KKT
+ * system best conditioned, favouring points far from the best point. */
+static int tr_choose(trust_region_t *ptr, double *d, int keep_opt) {
+    int n = ptr->n, m = ptr->m, N = ptr->N;
+    double *H = ptr->H, *w = ptr->w, *Hw = ptr->Hw;
+
+    tr_w(ptr, d, w);
+    for(int i=0; i<N; ++i) { Hw[i] = tr_dot(&H[i*N], w, N); }
+    double dd = tr_dot(d, d, n);
+    double beta = 0.5 * dd * dd - tr_dot(w, Hw, N);
+    double scale = fmax(0.1 * ptr->delta, ptr->rho);
+
+    int best = -1;
+    double best_score = -1.0;
+    double *yopt = &ptr->Y[ptr->kopt*n];
+    for(int k=0; k<m; ++k) {
+        if( keep_opt && k == ptr->kopt )    { continue; }
+        double dist = 0.0;
+        for(int i=0; i<n; ++i) {
+            double diff = ptr->Y[k*n+i] - yopt[i];
+            dist += diff * diff;
+        }
+        double weight = dist > scale * scale ? pow(dist / (scale * scale), 3.0) : 1.0;
+        double sigma = H[k*N+k] * beta + Hw[k] * Hw[k];
+        double score = weight * fabs(sigma);
+        if( score > best_score ) {
+            best_score = score;
+            best = k;
+        }
+    }
+
+    return best;
+}
+
+
+/* Index of the point farthest from the best point, and its distance. */
+static int tr_farthest(trust_region_t *ptr, double *dist) {
+    int n = ptr->n;
+    double *yopt = &ptr->Y[ptr->kopt*n];
+    int far = ptr->kopt;
+
+    *dist = 0.0;
+    for(int k=0; k<ptr->m; ++k) {
+        double sum = 0.0;
+        for(int i=0; i<n; ++i) {
+            double diff = ptr->Y[k*n+i] - yopt[i];
+            sum += diff * diff;
+        }
+        if( sqrt(sum) > *dist ) {
+            *dist = sqrt(sum);
+            far = k;
+        }
+    }
+
+    return far;
+}
+
+
+/* Approximately minimize the model within the trust region and bounds by
+ * truncated conjugate gradients.  A variable reaching a bound is fixed
+ * there and the iteration restarts along the projected gradient. */
+static void tr_step(trust_region_t *ptr) {
+    int n = ptr->n;
+    double *s = ptr->s, *g = ptr->g, *p = ptr->p, *Bp = ptr->Bp;
+    double *yopt = &ptr->Y[ptr->kopt*n];
+    double delta2 = ptr->delta * ptr->delta;
+
+    /* gradient at the best point */
+    tr_hess_vec(ptr, yopt, g);
+    for(int i=0; i<n; ++i) {
+        g[i] += ptr->gq[i];
+        s[i] = 0.0;
+        double x = FNT_VECT_ELEM(ptr->base, i) + yopt[i];
+        ptr->fixed[i] = (x <= tr_lower(ptr, i) && g[i] > 0.0)
+                     || (x >= tr_upper(ptr, i) && g[i] < 0.0);
+    }
+
+    double rr_start = 0.0;
+    for(int i=0; i<n; ++i) { if( !ptr->fixed[i] ) { rr_start += g[i] * g[i]; } }
+
+    int restart = 1;
+    double rr = 0.0;
+    for(int iter=0; iter<2*n+2; ++iter) {
+        double rr_new = 0.0;
+        for(int i=0; i<n; ++i) { if( !ptr->fixed[i] ) { rr_new += g[i] * g[i]; } }
+        if( rr_new <= 1e-4 * rr_start || rr_new == 0.0 )  { break; }
+
+        for(int i=0; i<n; ++i) {
+            double dir = ptr->fixed[i] ? 0.0 : -g[i];
+            p[i] = restart ? dir : dir + (rr_new / rr) * p[i];
+        }
+        rr = rr_new;
+        restart = 0;
+
+        /* longest step within the trust region */
+        double ss = tr_dot(s, s, n), sp = tr_dot(s, p, n), pp = tr_dot(p, p, n);
+        if( pp == 0.0 ) { break; }
+        double a_tr = (sqrt(fmax(0.0, sp * sp + pp * (delta2 - ss))) - sp) / pp;
+
+        /* and within the bounds */
+        double a_bd = DBL_MAX;
+        int bound = -1;
+        for(int i=0; i<n; ++i) {
+            if( ptr->fixed[i] || p[i] == 0.0 ) { continue; }
+            double x = FNT_VECT_ELEM(ptr->base, i) + yopt[i] + s[i];
+            double room = p[i] > 0.0 ? tr_upper(ptr, i) - x : tr_lower(ptr, i) - x;
+            double a = room / p[i];
+            if( a < a_bd ) { a_bd = fmax(0.0, a);  bound = i; }
+        }
+
+        tr_hess_vec(ptr, p, Bp);
+        double pBp = tr_dot(p, Bp, n);
+        double a_cg = pBp > 0.0 ? rr / pBp : DBL_MAX;
+
+        double a = fmin(a_cg, fmin(a_tr, a_bd));
+        for(int i=0; i<n; ++i) {
+            s[i] += a * p[i];
+            g[i] += a * Bp[i];
+        }
+        if( a == a_tr ) { break; }
+        if( a == a_bd ) {
+            /* land exactly on the bound */
+            double x = FNT_VECT_ELEM(ptr->base, bound) + yopt[bound];
+            s[bound] = (p[bound] > 0.0 ? tr_upper(ptr, bound) : tr_lower(ptr, bound)) - x;
+            ptr->fixed[bound] = 1;
+            restart = 1;
+        }
+    }
+
+    ptr->dnorm = sqrt(tr_dot(s, s, n));
+    for(int i=0; i<n; ++i) { ptr->d[i] = yopt[i] + s[i]; }
+    ptr->vquad = tr_model(ptr, ptr->d, ptr->Bp) - tr_model(ptr, yopt, ptr->Bp);
+}
+
+
+/* Value at base + d of the Lagrange function of point t, column t of H. */
+static double tr_lagrange(trust_region_t *ptr, int t, double *d) {
+    int n = ptr->n, m = ptr->m, N = ptr->N;
+    double value = ptr->H[m*N+t];
+
+    for(int i=0; i<n; ++i)  { value += ptr->H[(m+1+i)*N+t] * d[i]; }
+    for(int k=0; k<m; ++k) {
+        double dot = tr_dot(&ptr->Y[k*n], d, n);
+        value += 0.5 * ptr->H[k*N+t] * dot * dot;
+    }
+
+    return value;
+}
+
+
+/* Find a replacement for point t, within radius of the best point, that
+ * makes its Lagrange function large, keeping the interpolation set well
+ * poised.  Candidates lie along the directions to the other points and
+ * along the gradient of the Lagrange function. */
+static void tr_geometry(trust_region_t *ptr, int t, double radius) {
+    int n = ptr->n, m = ptr->m, N = ptr->N;
+    double *yopt = &ptr->Y[ptr->kopt*n];
+    double *dir = ptr->p, *cand = ptr->Bp;
+    double best = -1.0;
+
+    /* gradient of the Lagrange function at the best point */
+    double *grad = ptr->g;
+    for(int i=0; i<n; ++i) { grad[i] = ptr->H[(m+1+i)*N+t]; }
+    for(int k=0; k<m; ++k) {
+        double scale = ptr->H[k*N+t] * tr_dot(&ptr->Y[k*n], yopt, n);
+        for(int i=0; i<n; ++i) { grad[i] += scale * ptr->Y[k*n+i]; }
+    }
+
+    for(int k=0; k<=m; ++k) {
+        if( k == ptr->kopt )    { continue; }
+        for(int i=0; i<n; ++i) {
+            dir[i] = k < m ? ptr->Y[k*n+i] - yopt[i] : grad[i];
+        }
+        double len = sqrt(tr_dot(dir, dir, n));
+        if( len == 0.0 )    { continue; }
+        for(int sign=1; sign>=-1; sign-=2) {
+            for(int i=0; i<n; ++i) {
+                double x = FNT_VECT_ELEM(ptr->base, i) + yopt[i] + sign * radius * dir[i] / len;
+                x = fmin(fmax(x, tr_lower(ptr, i)), tr_upper(ptr, i));
+                cand[i] = x - FNT_VECT_ELEM(ptr->base, i);
+            }
+            double value = fabs(tr_lagrange(ptr, t, cand));
+            if( value > best ) {
+                best = value;
+                memcpy(ptr->d, cand, n * sizeof(double));
+            }
+        }
+    }
+}
+
+
+/* Lower rho towards rho_end, as in NEWUOA. */
+static void tr_shrink(trust_region_t *ptr) {
+    double ratio = ptr->rho / ptr->rho_final;
+    double rho = ratio <= 16.0 ? ptr->rho_final
+               : ratio <= 250.0 ? sqrt(ratio) * ptr->rho_final
+               : 0.1 * ptr->rho;
+
+    ptr->delta = fmax(0.5 * ptr->rho, rho);
+    ptr->rho = rho;
+    DEBUG("DEBUG: Trust region lower bound now %g.\n", ptr->rho);
+}
+
+
+/* Place the 2n+1 initial points about x0, moving x0 into the bounds and
+ * keeping every point inside them as BOBYQA does. */
+static void tr_initial(trust_region_t *ptr) {
+    int n = ptr->n;
+    double rho = ptr->rho;
+
+    memset(ptr->Y, 0, (size_t)ptr->m * n * sizeof(double));
+    for(int i=0; i<n; ++i) {
+        double x = FNT_VECT_ELEM(ptr->x0, i);
+        double lo = tr_lower(ptr, i), hi = tr_upper(ptr, i);
+        double step_a = rho, step_b = -rho;
+        if( x <= lo + 0.5 * rho ) {
+            x = lo;
+            step_b = 2.0 * rho;
+        } else if( x < lo + rho ) {
+            x = lo + rho;
+        } else if( x >= hi - 0.5 * rho ) {
+            x = hi;
+            step_a = -rho;
+            step_b = -2.0 * rho;
+        } else if( x > hi - rho ) {
+            x = hi - rho;
+        }
+        FNT_VECT_ELEM(ptr->base, i) = x;
+        ptr->Y[(1+i)*n+i] = step_a;
+        ptr->Y[(1+n+i)*n+i] = step_b;
+    }
+}
+
+
+/* Build the first model, the interpolant with least Frobenius norm
+ * Hessian, from column-wise products of H with the values. */
+static void tr_first_model(trust_region_t *ptr) {
+    int n = ptr->n, m = ptr->m, N = ptr->N;
+
+    memset(ptr->hq, 0, (size_t)n * n * sizeof(double));
+    for(int k=0; k<m; ++k) { ptr->pq[k] = tr_dot(&ptr->H[k*N], ptr->fval, m); }
+    for(int i=0; i<n; ++i) { ptr->gq[i] = tr_dot(&ptr->H[(m+1+i)*N], ptr->fval, m); }
+}
+
+
+/* Queue base + d, clipped to the bounds. */
+static void tr_push(trust_region_t *ptr) {
+    fnt_vect_t *x = fnt_coro_push(&ptr->co);
+
+    for(int i=0; i<ptr->n; ++i) {
+        double xi = FNT_VECT_ELEM(ptr->base, i) + ptr->d[i];
+        FNT_VECT_ELEM(*x, i) = fmin(fmax(xi, tr_lower(ptr, i)), tr_upper(ptr, i));
+        ptr->d[i] = FNT_VECT_ELEM(*x, i) - FNT_VECT_ELEM(ptr->base, i);
+    }
+    ++ptr->evals;
+}
+
+
+/* \brief Method logic, run as a coroutine.
+ * The initial interpolation points are requested as one batch, after which
+ * each trust region or geometry step needs a single value.
+ */
+static int tr_body(void *self) {
+    trust_region_t *ptr = (trust_region_t*)self;
+    fnt_coro_t *co = &ptr->co;
+    int n = ptr->n;
+
+    FNT_CORO_BEGIN(co);
+
+    ptr->rho = ptr->rho_begin;
+    for(int i=0; i<n; ++i) {
+        if( ptr->has_lower_bounds && ptr->has_upper_bounds ) {
+            double room = 0.5 * (tr_upper(ptr, i) - tr_lower(ptr, i));
+            if( room <= 0.0 ) {
+                ERROR("ERROR: Upper bound must exceed lower bound in dimension %d.\n", i);
+                return FNT_FAILURE;
+            }
+            ptr->rho = fmin(ptr->rho, room);
+        }
+    }
+    ptr->rho_final = fmin(ptr->rho_end, ptr->rho);
+    ptr->delta = ptr->rho;
+    ptr->evals = 0;
+    tr_initial(ptr);
+
+    for(ptr->t=0; ptr->t<ptr->m; ++ptr->t) {
+        memcpy(ptr->d, &ptr->Y[ptr->t*n], n * sizeof(double));
+        tr_push(ptr);
+    }
+    FNT_CORO_YIELD(co);
+
+    ptr->kopt = 0;
+    for(int k=0; k<ptr->m; ++k) {
+        ptr->fval[k] = co->values[k];
+        if( ptr->fval[k] < ptr->fval[ptr->kopt] ) { ptr->kopt = k; }
+    }
+    if( tr_rebuild(ptr) != FNT_SUCCESS )    { return FNT_FAILURE; }
+    tr_first_model(ptr);
+
+    while( ptr->evals < ptr->max_evals ) {
+        if( tr_dot(&ptr->Y[ptr->kopt*n], &ptr->Y[ptr->kopt*n], n) > 1e3 * ptr->delta * ptr->delta ) {
+            if( tr_rebase(ptr) != FNT_SUCCESS ) { return FNT_FAILURE; }
+        }
+
+        tr_step(ptr);
+        if( ptr->dnorm >= 0.5 * ptr->rho && ptr->vquad < 0.0 ) {
+            tr_push(ptr);
+            FNT_CORO_YIELD(co);
+
+            {
+                double f = co->values[0];
+                double fopt = ptr->fval[ptr->kopt];
+                double ratio = (f - fopt) / ptr->vquad;
+                if( ratio <= 0.1 ) {
+                    ptr->delta = 0.5 * ptr->dnorm;
+                } else if( ratio <= 0.7 ) {
+                    ptr->delta = fmax(0.5 * ptr->delta, ptr->dnorm);
+                } else {
+                    ptr->delta = fmax(0.5 * ptr->delta, 2.0 * ptr->dnorm);
+                }
+                if( ptr->delta <= 1.5 * ptr->rho )  { ptr->delta = ptr->rho; }
+
+                int t = tr_choose(ptr, ptr->d, f >= fopt);
+                if( tr_replace(ptr, t, ptr->d, f) != FNT_SUCCESS )  { return FNT_FAILURE; }
+                if( ratio >= 0.1 )  { continue; }
+            }
+        }
+
+        /* poor or short step, improve a distant point or shrink rho */
+        {
+            double dist = 0.0;
+            ptr->t = tr_farthest(ptr, &dist);
+            if( dist > 2.0 * ptr->delta ) {
+                tr_geometry(ptr, ptr->t, fmax(fmin(0.1 * dist, 0.5 * ptr->delta), ptr->rho));
+            } else if( ptr->dnorm >= 0.5 * ptr->rho && ptr->vquad < 0.0
+                       && ptr->delta > ptr->rho ) {
+                continue;
+            } else if( ptr->rho <= ptr->rho_final ) {
+                break;
+            } else {
+                tr_shrink(ptr);
+                continue;
+            }
+        }
+        tr_push(ptr);
+        FNT_CORO_YIELD(co);
+        if( tr_replace(ptr, ptr->t, ptr->d, co->values[0]) != FNT_SUCCESS ) {
+            return FNT_FAILURE;
+        }
+    }
+
+    for(int i=0; i<n; ++i) {
+        FNT_VECT_ELEM(ptr->minimum_x, i) = FNT_VECT_ELEM(ptr->base, i) + ptr->Y[ptr->kopt*n+i];
+    }
+    ptr->minimum_f = ptr->fval[ptr->kopt];
+
+    FNT_CORO_END(co);
+}
+
+
+/* MARK: Functions called by FNT */
+
+/* \brief Provides the name of the method.
+ * \param name Allocated buffer to hold the name.
+ * \param size Size of the name buffer in bytes.
+ * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
+ */
+static int method_name(char *name, int size) {
+    if( snprintf(name, size, "trust-region") >= size ) {
+        return FNT_FAILURE;
+    }
+
+    return FNT_SUCCESS;
+}
+
+
+static int method_free(void **handle_ptr);
+
+
+/* \brief Initialize intenal state for method.
+ * \param handle_ptr Pointer to the method handle pointer.
+ * \param dimensions Number of dimensions in the objactive function input.
+ * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
+ */
+static int method_init(void **handle_ptr, int dimensions) {
+    if( handle_ptr == NULL )    { return FNT_FAILURE; }
+    if( dimensions < 1 )        { return FNT_FAILURE; }
+    trust_region_t *ptr = calloc(1, sizeof(trust_region_t));
+    if( ptr == NULL )           { return FNT_FAILURE; }
+    *handle_ptr = (void*)ptr;
+
+    int n = dimensions;
+    ptr->n = n;
+    ptr->m = 2 * n + 1;
+    ptr->N = ptr->m + n + 1;
+    ptr->rho_begin = 0.5;
+    ptr->rho_end = 1e-6;
+    ptr->max_evals = 500 * n;
+
+    if( fnt_coro_init(&ptr->co, tr_body, ptr, ptr->m, n) != FNT_SUCCESS ) {
+        free(ptr);  *handle_ptr = NULL;
+        return FNT_FAILURE;
+    }
+
+    ptr->Y = calloc((size_t)ptr->m * n, sizeof(double));
+    ptr->fval = calloc(ptr->m, sizeof(double));
+    ptr->gq = calloc(n, sizeof(double));
+    ptr->hq = calloc((size_t)n * n, sizeof(double));
+    ptr->pq = calloc(ptr->m, sizeof(double));
+    ptr->H = calloc((size_t)ptr->N * ptr->N, sizeof(double));
+    ptr->W = calloc((size_t)ptr->N * ptr->N, sizeof(double));
+    ptr->d = calloc(n, sizeof(double));
+    ptr->s = calloc(n, sizeof(double));
+    ptr->g = calloc(n, sizeof(double));
+    ptr->p = calloc(n, sizeof(double));
+    ptr->Bp = calloc(n, sizeof(double));
+    ptr->w = calloc(ptr->N, sizeof(double));
+    ptr->Hw = calloc(ptr->N, sizeof(double));
+    ptr->fixed = calloc(n, 1);
+    if( ptr->Y == NULL || ptr->fval == NULL || ptr->gq == NULL || ptr->hq == NULL
+        || ptr->pq == NULL || ptr->H == NULL || ptr->W == NULL || ptr->d == NULL
+        || ptr->s == NULL || ptr->g == NULL || ptr->p == NULL || ptr->Bp == NULL
+        || ptr->w == NULL || ptr->Hw == NULL || ptr->fixed == NULL ) {
+        ERROR("ERROR: Failed to allocate model for %d dimensions.\n", n);
+        method_free(handle_ptr);
+        return FNT_FAILURE;
+    }
+
+    fnt_vect_calloc(&ptr->x0, n);
+    fnt_vect_calloc(&ptr->base, n);
+    fnt_vect_calloc(&ptr->minimum_x, n);
+
+    return FNT_SUCCESS;
+}
+
+
+/* \brief Free any resources allocated for the method.
+ * \param handle_ptr Pointer to the method handle pointer.
+ * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
+ */
+static int method_free(void **handle_ptr) {
+    if( handle_ptr == NULL )    { return FNT_FAILURE; }
+    if( *handle_ptr == NULL )   { return FNT_FAILURE; }
+    trust_region_t *ptr = (trust_region_t*)*handle_ptr;
+
+    fnt_coro_free(&ptr->co);
+    free(ptr->Y);   free(ptr->fval);
+    free(ptr->gq);  free(ptr->hq);  free(ptr->pq);
+    free(ptr->H);   free(ptr->W);
+    free(ptr->d);   free(ptr->s);   free(ptr->g);
+    free(ptr->p);   free(ptr->Bp);
+    free(ptr->w);   free(ptr->Hw);
+    free(ptr->fixed);
+    fnt_vect_free(&ptr->x0);
+    fnt_vect_free(&ptr->base);
+    fnt_vect_free(&ptr->minimum_x);
+    if( ptr->has_lower_bounds ) { fnt_vect_free(&ptr->lower_bounds); }
+    if( ptr->has_upper_bounds ) { fnt_vect_free(&ptr->upper_bounds); }
+
+    free(ptr);  *handle_ptr = ptr = NULL;
+
+    return FNT_SUCCESS;
+}
+
+
+/* \brief Return the method to its initial state, keeping hyper-parameters.
+ * \param handle Pointer to the method handle.
+ * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
+ */
+static int method_reset(void *handle) {
+    trust_region_t *ptr = (trust_region_t*)handle;
+    if( ptr == NULL )       { return FNT_FAILURE; }
+
+    fnt_coro_reset(&ptr->co);
+    ptr->evals = ptr->kopt = 0;
+    fnt_vect_reset(&ptr->minimum_x);
+    ptr->minimum_f = 0.0;
+
+    return FNT_SUCCESS;
+}
+
+
+/* \brief Display information about the method to the console.
+ * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
+ */
+static int method_info() {
+    printf(
+"A derivative-free trust region method in the style of Powell's NEWUOA and\n"
+"BOBYQA.  A quadratic model interpolates the objective at 2n+1 points, and\n"
+"is minimized within a trust region to choose each new point.  Every new\n"
+"point replaces one old one, changing the model Hessian by the least\n"
+"Frobenius norm, and costs O(n^2) work.  The initial points are requested\n"
+"as one batch.\n"
+"\n"
+"Hyper-parameters:\n"
+"name\t\trequired\ttype\t\tDefault\tDescription\n"
+"x0\t\toptional\tfnt_vect_t\tzeros\tStarting point.\n"
+"lower\t\toptional\tfnt_vect_t\tnone\tLower bounds on search region.\n"
+"upper\t\toptional\tfnt_vect_t\tnone\tUpper bounds on search region.\n"
+"rho_begin\toptional\tdouble\t\t0.5\tInitial trust region radius.\n"
+"rho_end\t\toptional\tdouble\t\t1e-6\tFinal trust region radius.\n"
+"max_evals\toptional\tint\t\t500*n\tMaximum number of evaluations.\n"
+"\n"
+"Results:\n"
+"name\t\ttype\t\tDescription\n"
+"minimum x\tfnt_vect_t\tBest point found.\n"
+"minimum f\tdouble\t\tObjective value at minimum x.\n"
+"evaluations\tint\t\tNumber of points requested.\n"
+"\n"
+"References:\n"
+"M. J. D. Powell, The NEWUOA software for unconstrained optimization\n"
+"\twithout derivatives, DAMTP 2004/NA05, University of Cambridge (2004).\n"
+"M. J. D. Powell, The BOBYQA algorithm for bound constrained optimization\n"
+"\twithout derivatives, DAMTP 2009/NA06, University of Cambridge (2009).\n"
+);
+    return FNT_SUCCESS;
+}
+
+
+/* \brief Set any hyper-parameters needed for the method.
+ * \param handle Pointer to the method handle.
+ * \param id The name of the hyper-parameter.
+ * \param value_ptr A pointer to the value being set.
+ * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
+ */
+static int method_hparam_set(void *handle, char *id, void *value_ptr) {
+    if( id == NULL )        { return FNT_FAILURE; }
+    if( value_ptr == NULL ) { return FNT_FAILURE; }
+    if( handle == NULL )    { return FNT_FAILURE; }
+    trust_region_t *ptr = (trust_region_t*)handle;
+
+    FNT_HPARAM_SET_VECT("x0", id, value_ptr, &ptr->x0);
+    FNT_HPARAM_SET("rho_begin", id, double, value_ptr, ptr->rho_begin);
+    FNT_HPARAM_SET("rho_end", id, double, value_ptr, ptr->rho_end);
+    FNT_HPARAM_SET("max_evals", id, int, value_ptr, ptr->max_evals);
+
+    if( strncmp("lower", id, 6) == 0 ) {
+        if( !ptr->has_lower_bounds ) {
+            fnt_vect_calloc(&ptr->lower_bounds, ptr->n);
+        }
+        ptr->has_lower_bounds = 1;
+        return fnt_vect_copy(&ptr->lower_bounds, value_ptr);
+    }
+
+    if( strncmp("upper", id, 6) == 0 ) {
+        if( !ptr->has_upper_bounds ) {
+            fnt_vect_calloc(&ptr->upper_bounds, ptr->n);
+        }
+        ptr->has_upper_bounds = 1;
+        return fnt_vect_copy(&ptr->upper_bounds, value_ptr);
+    }
+
+    ERROR("No hyper-parameter named '%s'.\n", id);
+
+    return FNT_FAILURE;
+}
+
+
+/* \brief Get any hyper-parameters values form the method.
+ * \param handle Pointer to the method handle.
+ * \param id The name of the hyper-parameter.
+ * \param value_ptr A pointer to the value being set.
+ * \return FNT_SUCCESS on success, FNT_FAILURE otherwise.
+ */
+static int method_hparam_get(void *handle, char *id, void *value_ptr) {
+    trust_region_t *ptr = (trust_region_t*)handle;
+    if( ptr == NULL )       { return FNT_FAILURE; }
+    if( id == NULL )        { return FNT_FAILURE; }
+    if( value_ptr == NULL ) { return FNT_FAILURE; }
+
+    FNT_HPARAM_GET_VECT("x0", id, &ptr->x0, value_ptr);
+    FNT_HPARAM_GET("rho_begin", id, double, ptr->rho_begin, value_ptr);
+    FNT_HPARAM_GET("rho_end", id, double, ptr->rho_end, value_ptr);
+    FNT_HPARAM_GET("max_evals", id, int, ptr->max_evals, value_ptr);
+    if( ptr->has_lower_bounds ) {
+        FNT_HPARAM_GET_VECT("lower", id, &ptr->lower_bounds, value_ptr);
+    }
+    if( ptr->has_upper_bounds ) {
+        FNT_HPARAM_GET_VECT("upper", id, &ptr->upper_bounds, value_ptr);
+    }
+
+    ERROR("No hyper-parameter named '%s'.\n", id);
+
+    return FNT_FAILURE;
+}
+
+
+static int method_next(void *handle, fnt_vect_t *vec) {
+    trust_region_t *ptr = (trust_region_t*)handle;
+    if( ptr == NULL )       { return FNT_FAILURE; }
+    if( vec == NULL )       { return FNT_FAILURE; }
+    if( vec->v == NULL )    { return FNT_FAILURE; }
+
+    return fnt_coro_next(&ptr->co, vec);
+}
+
+
+static int method_next_batch(void *handle, fnt_vect_t *vecs, int *tickets, int capacity, int *count) {
+    trust_region_t *ptr = (trust_region_t*)handle;
+    if( ptr == NULL )       { return FNT_FAILURE; }
+
+    return fnt_coro_next_batch(&ptr->co, vecs, tickets, capacity, count);
+}
+
+
+static int method_value(void *handle, fnt_vect_t *vec, double value) {
+    trust_region_t *ptr = (trust_region_t*)handle;
+    if( ptr == NULL )       { return FNT_FAILURE; }
+    if( vec == NULL )       { return FNT_FAILURE; }
+    if( vec->v == NULL )    { return FNT_FAILURE; }
+
+    return fnt_coro_value(&ptr->co, value);
+}
+
+
+static int method_value_ticket(void *handle, int ticket, double value) {
+    trust_region_t *ptr = (trust_region_t*)handle;
+    if( ptr == NULL )       { return FNT_FAILURE; }
+
+    return fnt_coro_value_ticket(&ptr->co, ticket, value);
+}
+
+
+static int method_done(void *handle) {
+    trust_region_t *ptr = (trust_region_t*)handle;
+    if( ptr == NULL )       { return FNT_FAILURE; }
+
+    return fnt_coro_done(&ptr->co);
+}
+
+
+static int method_result(void *handle, char *id, void *value_ptr) {
+    trust_region_t *ptr = (trust_region_t*)handle;
+    if( ptr == NULL )       { return FNT_FAILURE; }
+
+    FNT_RESULT_GET_VECT("minimum x", id, ptr->minimum_x, value_ptr);
+    FNT_RESULT_GET("minimum f", id, double, ptr->minimum_f, value_ptr);
+    FNT_RESULT_GET("evaluations", id, int, ptr->evals, value_ptr);
+
+    ERROR("No result named '%s'.\n", id);
+
+    return FNT_FAILURE;
+}
+
+
+/* MARK: Method descriptor */
+
+fnt_method_descriptor_t fnt_method_descriptor = {
+    .abi_version       = FNT_METHOD_ABI_VERSION,
+    .capabilities      = FNT_METHOD_CAP_BATCH,
+    .name              = method_name,
+    .init              = method_init,
+    .free              = method_free,
+    .reset             = method_reset,
+    .info              = method_info,
+    .hparam_set        = method_hparam_set,
+    .hparam_get        = method_hparam_get,
+    .next              = method_next,
+    .next_batch        = method_next_batch,
+    .value             = method_value,
+    .value_ticket      = method_value_ticket,
+    .done              = method_done,
+    .result            = method_result,
+};
@@ -0,0 +1,190 @@
+/*
+ * asha_test.c
+ * fnt: Numerical Toolbox
+ *
+ * Copyright (c) 2024 Bryan Franklin. All rights reserved.
+ */
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "../fnt.h"
+
+#ifndef FNT_METHODS_DIR
+#define FNT_METHODS_DIR "."
+#endif /* FNT_METHODS_DIR */
+
+#define DIMS        4
+#define MAX_FIDELITY 81.0
+#define CAPACITY    8
+
+/* the converged objective, minimum of zero at x_i = 0.3 */
+double exact(fnt_vect_t *x) {
+    double sum = 0.0;
+    for(int i=0; i<DIMS; ++i) {
+        double d = FNT_VECT_ELEM(*x, i) - 0.3;
+        sum += d * d;
+    }
+    return sum;
+}
+
+/* a simulation run for r steps, whose error shrinks as 1/sqrt(r) */
+double simulate(fnt_vect_t *x, double r) {
+    double error = 0.0;
+    for(int i=0; i<DIMS; ++i) {
+        error += sin(10.0 * FNT_VECT_ELEM(*x, i) + i);
+    }
+    return exact(x) + 0.05 * error / sqrt(r);
+}
+
+int main() {
+
+    int failures = 0;
+    void *fnt = NULL;
+
+    srand(1);
+    fnt_verbose(FNT_INFO); /* request informative output */
+    fnt_init(&fnt, FNT_METHODS_DIR "/methods");
+
+    /* load differential evolution to minimize at full fidelity only */
+    if( fnt_set_method(fnt, "differential evolution", DIMS) == FNT_FAILURE ) {
+        return 1;
+    }
+
+    /* display info */
+    fnt_info(fnt);
+
+    /* search within [0, 1]^DIMS */
+    int np = 20, iters = 200;
+    fnt_hparam_set(fnt, "NP", &np);
+    fnt_hparam_set(fnt, "iters", &iters);
+    fnt_vect_t x[CAPACITY];
+    int tickets[CAPACITY];
+    for(int i=0; i<CAPACITY; ++i) { fnt_vect_calloc(&x[i], DIMS + 1); }
+    fnt_vect_t point;
+    fnt_vect_calloc(&point, DIMS);
+    fnt_hparam_set(fnt, "lower", &point);
+    for(int j=0; j<DIMS; ++j) { FNT_VECT_ELEM(point, j) = 1.0; }
+    fnt_hparam_set(fnt, "upper", &point);
+
+    /* find the cost of reaching the target, each evaluation costing
+     * MAX_FIDELITY, judging the point with the best value seen */
+    double target = 0.01, full = 0.0, best = INFINITY, best_f = INFINITY;
+    while( best_f > target && fnt_done(fnt) == FNT_CONTINUE ) {
+        if( fnt_next(fnt, &point) != FNT_SUCCESS )  { break; }
+        double f = simulate(&point, MAX_FIDELITY);
+        full += MAX_FIDELITY;
+        if( f < best ) {
+            best = f;
+            best_f = exact(&point);
+        }
+        fnt_set_value(fnt, &point, f);
+    }
+    printf("full fidelity differential evolution: cost %g to reach %g\n", full, best_f);
+    if( best_f > target ) {
+        printf("\tDifferential evolution did not reach the target!\n");
+        return 1;
+    }
+
+    /* again for a tenth of that cost */
+    double budget = full / 10.0;
+    int max_evals = (int)(budget / MAX_FIDELITY);
+    fnt_hparam_set(fnt, "max_evals", &max_evals);
+    fnt_reset(fnt);
+    while( fnt_done(fnt) == FNT_CONTINUE ) {
+        if( fnt_next(fnt, &point) != FNT_SUCCESS )  { break; }
+        fnt_set_value(fnt, &point, simulate(&point, MAX_FIDELITY));
+    }
+    fnt_result(fnt, "minimum x", &point);
+    double reached = exact(&point);
+    printf("full fidelity differential evolution: %g after cost %g\n", reached, budget);
+
+    fnt_vect_free(&point);
+    fnt_free(&fnt);
+
+    /* load asha, with the fidelity as the last element of every input */
+    fnt_init(&fnt, FNT_METHODS_DIR "/methods");
+    if( fnt_set_method(fnt, "asha", DIMS + 1) == FNT_FAILURE ) {
+        return 1;
+    }
+    fnt_info(fnt);
+
+    /* spend the same tenth within [0, 1]^DIMS */
+    double max_fidelity = MAX_FIDELITY;
+    fnt_hparam_set(fnt, "max_fidelity", &max_fidelity);
+    fnt_hparam_set(fnt, "budget", &budget);
+    fnt_vect_reset(&x[0]);
+    fnt_hparam_set(fnt, "lower", &x[0]);
+    for(int j=0; j<DIMS; ++j) { FNT_VECT_ELEM(x[0], j) = 1.0; }
+    fnt_hparam_set(fnt, "upper", &x[0]);
+
+    /* try each way of sampling new configurations */
+    char *names[] = { "random", "sobol", "differential evolution" };
+    for(int sampler=0; sampler<3; ++sampler) {
+        fnt_hparam_set(fnt, "sampler", &sampler);
+        fnt_reset(fnt);
+
+        /* keep the workers busy, finishing the cheapest outstanding job
+         * first, so values arrive out of order */
+        int count = 0;
+        while( fnt_done(fnt) == FNT_CONTINUE ) {
+            int more = 0;
+            if( fnt_next_batch(fnt, &x[count], &tickets[count], CAPACITY - count, &more) != FNT_SUCCESS
+                || count + more == 0 ) {
+                printf("\tNo jobs handed out!\n");
+                return 1;
+            }
+            count += more;
+
+            int cheapest = 0;
+            for(int k=1; k<count; ++k) {
+                if( FNT_VECT_ELEM(x[k], DIMS) < FNT_VECT_ELEM(x[cheapest], DIMS) ) { cheapest = k; }
+            }
+            double f = simulate(&x[cheapest], FNT_VECT_ELEM(x[cheapest], DIMS));
+            fnt_set_value_ticket(fnt, tickets[cheapest], &x[cheapest], f);
+
+            /* move the last job into the freed slot */
+            --count;
+            fnt_vect_t tmp = x[cheapest];   x[cheapest] = x[count];   x[count] = tmp;
+            tickets[cheapest] = tickets[count];
+        }
+
+        /* judge the minimum by the converged objective */
+        int configs = 0, evals = 0;
+        double cost = 0.0, f = -1.0;
+        fnt_result(fnt, "minimum x", &x[0]);
+        fnt_result(fnt, "configurations", &configs);
+        fnt_result(fnt, "evaluations", &evals);
+        fnt_result(fnt, "cost", &cost);
+        if( FNT_VECT_ELEM(x[0], DIMS) == MAX_FIDELITY ) { f = exact(&x[0]); }
+        printf("asha, %s sampler: %d configurations, %d evaluations, cost %g, minimum %g\n",
+                names[sampler], configs, evals, cost, f);
+        if( f < 0.0 ) {
+            printf("\tNo configuration reached the full fidelity!\n");
+            ++failures;
+        }
+        if( cost > budget + MAX_FIDELITY ) {
+            printf("\tSpent more than the budget!\n");
+            ++failures;
+        }
+
+        /* screening evenly spread or evolved configurations at low fidelity
+         * beats spending the same on full fidelity, and guided by
+         * differential evolution it reaches the target */
+        if( sampler != 0 && f > reached ) {
+            printf("\tDid worse than full fidelity for the same cost!\n");
+            ++failures;
+        }
+        if( sampler == 2 && f > target ) {
+            printf("\tDid not reach the target for a tenth of the cost!\n");
+            ++failures;
+        }
+    }
+
+    /* free input vectors */
+    for(int i=0; i<CAPACITY; ++i) { fnt_vect_free(&x[i]); }
+
+    /* free the method */
+    fnt_free(&fnt);
+
+    return failures;
+}
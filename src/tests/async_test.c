@@ -0,0 +1,139 @@
+/*
+ * async_test.c
+ * fnt: Numerical Toolbox
+ *
+ * Copyright (c) 2024 Bryan Franklin. All rights reserved.
+ */
+#include <math.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "../fnt.h"
+#include "../fnt_problems.h"
+
+#ifndef FNT_METHODS_DIR
+#define FNT_METHODS_DIR "."
+#endif /* FNT_METHODS_DIR */
+
+#define THREADS     8
+#define GRAD_DIMS   32
+
+double objective(fnt_vect_t *x) {
+    if( x->n == 2 ) {
+        return rosenbrock_2d(FNT_VECT_ELEM(*x, 0), FNT_VECT_ELEM(*x, 1));
+    }
+
+    /* sum of i * x_i^2 */
+    double sum = 0.0;
+    for(int i=0; i<x->n; ++i) {
+        sum += i * FNT_VECT_ELEM(*x, i) * FNT_VECT_ELEM(*x, i);
+    }
+    return sum;
+}
+
+/* Worker thread, evaluates inputs until the method is done. */
+void *worker(void *async) {
+    long evals = 0;
+
+    for(;;) {
+        fnt_vect_t *x = NULL;
+        int ticket = 0;
+        int ret = fnt_async_take(async, &x, &ticket);
+
+        if( ret == FNT_CONTINUE )       { sched_yield(); continue; }
+        if( ret != FNT_SUCCESS )        { break; }
+
+        fnt_async_put(async, ticket, objective(x));
+        ++evals;
+    }
+
+    return (void*)evals;
+}
+
+/* Set up a context for method, ready to run. */
+void *setup(char *method, int dims) {
+    void *fnt = NULL;
+    fnt_init(&fnt, FNT_METHODS_DIR "/methods");
+    if( fnt_set_method(fnt, method, dims) == FNT_FAILURE ) {
+        fnt_free(&fnt);
+        return NULL;
+    }
+
+    if( dims == GRAD_DIMS ) {
+        fnt_vect_t x0;
+        fnt_vect_calloc(&x0, dims);
+        for(int i=0; i<dims; ++i) { FNT_VECT_ELEM(x0, i) = 1.0; }
+        fnt_hparam_set(fnt, "x0", &x0);
+        fnt_vect_free(&x0);
+    }
+
+    /* use the same random sequence for every run */
+    srand(1);
+
+    return fnt;
+}
+
+int main() {
+
+    char *methods[] = { "gradient estimate", "nelder-mead", "differential evolution" };
+    int dims[] = { GRAD_DIMS, 2, 2 };
+    char *results[] = { "gradient", "minimum x", "minimum x" };
+    int failures = 0;
+
+    for(int m=0; m<3; ++m) {
+        fnt_vect_t sequential, threaded;
+        fnt_vect_calloc(&sequential, dims[m]);
+        fnt_vect_calloc(&threaded, dims[m]);
+
+        /* MARK: Sequential reference */
+        void *fnt = setup(methods[m], dims[m]);
+        if( fnt == NULL )   { return 1; }
+        fnt_vect_t x;
+        fnt_vect_calloc(&x, dims[m]);
+        while( fnt_done(fnt) == FNT_CONTINUE ) {
+            if( fnt_next(fnt, &x) != FNT_SUCCESS ) { break; }
+            fnt_set_value(fnt, &x, objective(&x));
+        }
+        fnt_result(fnt, results[m], &sequential);
+        fnt_vect_free(&x);
+        fnt_free(&fnt);
+
+        /* MARK: Worker threads */
+        fnt = setup(methods[m], dims[m]);
+        void *async = NULL;
+        if( fnt_async_init(&async, fnt, 2*THREADS) != FNT_SUCCESS ) {
+            return 1;
+        }
+
+        pthread_t threads[THREADS];
+        for(int i=0; i<THREADS; ++i) {
+            pthread_create(&threads[i], NULL, worker, async);
+        }
+        long evals = 0;
+        for(int i=0; i<THREADS; ++i) {
+            void *count = NULL;
+            pthread_join(threads[i], &count);
+            evals += (long)count;
+        }
+        fnt_result(fnt, results[m], &threaded);
+        fnt_async_free(&async);
+        fnt_free(&fnt);
+
+        printf("%s: %ld evaluations on %d threads\n", methods[m], evals, THREADS);
+        for(int i=0; i<dims[m]; ++i) {
+            if( FNT_VECT_ELEM(sequential, i) != FNT_VECT_ELEM(threaded, i) ) {
+                fnt_vect_print(&sequential, "\tsequential: ", NULL);
+                fnt_vect_print(&threaded, "\n\tthreaded:   ", NULL);
+                printf("\n\tResults differ!\n");
+                ++failures;
+                break;
+            }
+        }
+
+        fnt_vect_free(&sequential);
+        fnt_vect_free(&threaded);
+    }
+
+    return failures;
+}
@@ -0,0 +1,134 @@
+/*
+ * batch_test.c
+ * fnt: Numerical Toolbox
+ *
+ * Copyright (c) 2024 Bryan Franklin. All rights reserved.
+ */
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "../fnt.h"
+#include "../fnt_problems.h"
+
+#ifndef FNT_METHODS_DIR
+#define FNT_METHODS_DIR "."
+#endif /* FNT_METHODS_DIR */
+
+#define DIMS        3
+#define CAPACITY    8
+
+double objective(fnt_vect_t *x) {
+    // x_0^2 + 2 x_1 + x_0 x_2
+    double x_0 = FNT_VECT_ELEM(*x, 0);
+    double x_1 = FNT_VECT_ELEM(*x, 1);
+    double x_2 = FNT_VECT_ELEM(*x, 2);
+    return x_0*x_0 + 2*x_1 + x_0*x_2;
+}
+
+/* Estimate the gradient, one input at a time or in batches whose values
+ * are reported in reverse order. */
+int estimate(int use_batch, fnt_vect_t *gradient, int *batches) {
+
+    void *fnt = NULL;
+    fnt_init(&fnt, FNT_METHODS_DIR "/methods");
+    if( fnt_set_method(fnt, "gradient estimate", DIMS) == FNT_FAILURE ) {
+        return FNT_FAILURE;
+    }
+
+    fnt_vect_t x0;
+    fnt_vect_calloc(&x0, DIMS);
+    FNT_VECT_ELEM(x0, 0) = 1.0;
+    FNT_VECT_ELEM(x0, 1) = 2.0;
+    FNT_VECT_ELEM(x0, 2) = 3.0;
+    fnt_hparam_set(fnt, "x0", &x0);
+
+    fnt_vect_t x[CAPACITY];
+    int tickets[CAPACITY];
+    for(int i=0; i<CAPACITY; ++i) { fnt_vect_calloc(&x[i], DIMS); }
+
+    *batches = 0;
+    while( fnt_done(fnt) == FNT_CONTINUE ) {
+        if( use_batch ) {
+            int count = 0;
+            if( fnt_next_batch(fnt, x, tickets, CAPACITY, &count) != FNT_SUCCESS ) { break; }
+
+            for(int i=count-1; i>=0; --i) {
+                fnt_set_value_ticket(fnt, tickets[i], &x[i], objective(&x[i]));
+            }
+        } else {
+            if( fnt_next(fnt, &x[0]) != FNT_SUCCESS ) { break; }
+            fnt_set_value(fnt, &x[0], objective(&x[0]));
+        }
+        ++*batches;
+    }
+
+    int ret = fnt_result(fnt, "gradient", gradient);
+
+    for(int i=0; i<CAPACITY; ++i) { fnt_vect_free(&x[i]); }
+    fnt_vect_free(&x0);
+    fnt_free(&fnt);
+
+    return ret;
+}
+
+int main() {
+
+    int failures = 0;
+
+    /* MARK: Batched method */
+    fnt_vect_t sequential, batched;
+    fnt_vect_calloc(&sequential, DIMS);
+    fnt_vect_calloc(&batched, DIMS);
+    int sequential_rounds = 0, batched_rounds = 0;
+
+    estimate(0, &sequential, &sequential_rounds);
+    estimate(1, &batched, &batched_rounds);
+
+    fnt_vect_print(&sequential, "gradient estimate, sequential: ", NULL);
+    printf(" in %d rounds\n", sequential_rounds);
+    fnt_vect_print(&batched, "gradient estimate, batched:    ", NULL);
+    printf(" in %d rounds\n", batched_rounds);
+
+    for(int i=0; i<DIMS; ++i) {
+        if( FNT_VECT_ELEM(sequential, i) != FNT_VECT_ELEM(batched, i) ) {
+            printf("\tResults differ!\n");
+            ++failures;
+            break;
+        }
+    }
+    if( batched_rounds != 1 ) {
+        printf("\tExpected a single batch!\n");
+        ++failures;
+    }
+    fnt_vect_free(&sequential);
+    fnt_vect_free(&batched);
+
+    /* MARK: Method without batch support, one input per batch */
+    void *fnt = NULL;
+    fnt_init(&fnt, FNT_METHODS_DIR "/methods");
+    if( fnt_set_method(fnt, "nelder-mead", 2) == FNT_FAILURE ) {
+        return 1;
+    }
+    fnt_vect_t x[CAPACITY];
+    int tickets[CAPACITY];
+    for(int i=0; i<CAPACITY; ++i) { fnt_vect_calloc(&x[i], 2); }
+    while( fnt_done(fnt) == FNT_CONTINUE ) {
+        int count = 0;
+        if( fnt_next_batch(fnt, x, tickets, CAPACITY, &count) != FNT_SUCCESS ) { break; }
+        if( count != 1 ) {
+            printf("\tUnexpected batch of %d!\n", count);
+            ++failures;
+            break;
+        }
+        double fx = rosenbrock_2d(FNT_VECT_ELEM(x[0], 0), FNT_VECT_ELEM(x[0], 1));
+        fnt_set_value_ticket(fnt, tickets[0], &x[0], fx);
+    }
+    double min_fx = 0.0;
+    fnt_result(fnt, "minimum f", &min_fx);
+    printf("nelder-mead, batches of one: minimum %g\n", min_fx);
+
+    for(int i=0; i<CAPACITY; ++i) { fnt_vect_free(&x[i]); }
+    fnt_free(&fnt);
+
+    return failures;
+}
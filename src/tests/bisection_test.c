@@ -78,5 +78,55 @@ int main() {
     /* free the method */
     fnt_free(&fnt);
 
-    return 0;
+    /* MARK: k-section, one round of k-1 interior points per batch */
+    int failures = 0;
+    double roots[2] = { 0.0, 0.0 };
+    int rounds[2] = { 0, 0 };
+    int sections[2] = { 2, 8 };
+    fnt_verbose(FNT_WARN);
+    for(int run=0; run<2; ++run) {
+        fnt_init(&fnt, FNT_METHODS_DIR "/methods");
+        if( fnt_set_method(fnt, "bisection", 1) == FNT_FAILURE ) {
+            return 1;
+        }
+        fnt_hparam_set(fnt, "f_tol", &f_tol);
+        fnt_hparam_set(fnt, "x_tol", &x_tol);
+        fnt_hparam_set(fnt, "upper", &x_0);
+        fnt_hparam_set(fnt, "lower", &x_1);
+        fnt_hparam_set(fnt, "k", &sections[run]);
+
+        fnt_vect_t batch[8];
+        int tickets[8];
+        for(int i=0; i<8; ++i) { fnt_vect_calloc(&batch[i], 1); }
+
+        while( fnt_done(fnt) == FNT_CONTINUE ) {
+            int count = 0;
+            if( fnt_next_batch(fnt, batch, tickets, 8, &count) != FNT_SUCCESS
+                || count == 0 ) {
+                break;
+            }
+            for(int i=count-1; i>=0; --i) {
+                fnt_set_value_ticket(fnt, tickets[i], &batch[i],
+                        polynomial(FNT_VECT_ELEM(batch[i], 0)));
+            }
+            ++rounds[run];
+        }
+        fnt_result(fnt, "root", &roots[run]);
+        printf("k=%d: root found at x = %.6f after %d rounds\n",
+                sections[run], roots[run], rounds[run]);
+
+        for(int i=0; i<8; ++i) { fnt_vect_free(&batch[i]); }
+        fnt_free(&fnt);
+    }
+
+    if( fabs(roots[0] - x_root) > x_tol || fabs(roots[1] - x_root) > x_tol ) {
+        printf("\tk-section roots disagree with bisection!\n");
+        ++failures;
+    }
+    if( rounds[1] >= rounds[0] ) {
+        printf("\tk=%d took %d rounds, k=2 took %d!\n", sections[1], rounds[1], rounds[0]);
+        ++failures;
+    }
+
+    return failures;
 }
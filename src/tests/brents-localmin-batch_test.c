@@ -0,0 +1,104 @@
+/*
+ * brents-localmin-batch_test.c
+ * fnt: Numerical Toolbox
+ *
+ * Copyright (c) 2024 Bryan Franklin. All rights reserved.
+ */
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "../fnt.h"
+#include "../fnt_problems.h"
+
+#ifndef FNT_METHODS_DIR
+#define FNT_METHODS_DIR "."
+#endif /* FNT_METHODS_DIR */
+
+#define CAPACITY    16
+
+/* function defined in equation 6.1 of Brent. */
+double function_61(double x) {
+    double sum = 0.0;
+    for(int i=1; i<=20; ++i) {
+        sum += pow( (2*i - 5) / (x - i*i), 2.0);
+    }
+    return sum;
+}
+
+/* Minimize function_61 on [2, 3], returning the number of rounds of
+ * evaluations needed. */
+int minimize(char *method, int k, double *min_x, int *evals) {
+
+    void *fnt = NULL;
+    fnt_init(&fnt, FNT_METHODS_DIR "/methods");
+    if( fnt_set_method(fnt, method, 1) == FNT_FAILURE ) {
+        fprintf(stderr, "Failed to initialize method.\n");
+        return -1;
+    }
+
+    double x_0 = 2;
+    double x_1 = 3;
+    double eps = 1e-6;
+    double t = 1e-6;
+    fnt_hparam_set(fnt, "x_0", &x_0);
+    fnt_hparam_set(fnt, "x_1", &x_1);
+    fnt_hparam_set(fnt, "eps", &eps);
+    fnt_hparam_set(fnt, "t", &t);
+    if( k > 0 ) { fnt_hparam_set(fnt, "k", &k); }
+
+    fnt_vect_t x[CAPACITY];
+    int tickets[CAPACITY];
+    for(int i=0; i<CAPACITY; ++i) { fnt_vect_calloc(&x[i], 1); }
+
+    int rounds = 0;
+    *evals = 0;
+    while( fnt_done(fnt) == FNT_CONTINUE ) {
+        int count = 0;
+        if( fnt_next_batch(fnt, x, tickets, CAPACITY, &count) != FNT_SUCCESS
+            || count == 0 ) {
+            break;
+        }
+        for(int i=0; i<count; ++i) {
+            fnt_set_value_ticket(fnt, tickets[i], &x[i], function_61(FNT_VECT_ELEM(x[i], 0)));
+        }
+        ++rounds;
+        *evals += count;
+    }
+    fnt_result(fnt, "minimum x", min_x);
+
+    for(int i=0; i<CAPACITY; ++i) { fnt_vect_free(&x[i]); }
+    fnt_free(&fnt);
+
+    return rounds;
+}
+
+int main() {
+
+    int failures = 0;
+
+    double brent_x = 0.0;
+    int brent_evals = 0;
+    int brent_rounds = minimize("brents-localmin", 0, &brent_x, &brent_evals);
+    printf("brents-localmin: minimum at %.8f, %d rounds of %d evaluations\n",
+            brent_x, brent_rounds, brent_evals);
+
+    int ks[] = { 2, 4, 8 };
+    for(int i=0; i<3; ++i) {
+        double min_x = 0.0;
+        int evals = 0;
+        int rounds = minimize("brents-localmin-batch", ks[i], &min_x, &evals);
+        printf("brents-localmin-batch (k=%d): minimum at %.8f, %d rounds of %d evaluations\n",
+                ks[i], min_x, rounds, evals);
+
+        if( rounds < 0 || fabs(min_x - brent_x) > 1e-5 ) {
+            printf("\tMinimum differs from brents-localmin!\n");
+            ++failures;
+        }
+        if( ks[i] >= 4 && rounds >= brent_rounds ) {
+            printf("\tNo fewer rounds than brents-localmin!\n");
+            ++failures;
+        }
+    }
+
+    return failures;
+}
@@ -0,0 +1,108 @@
+/*
+ * broyden_test.c
+ * fnt: Numerical Toolbox
+ *
+ * Copyright (c) 2024 Bryan Franklin. All rights reserved.
+ */
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "../fnt.h"
+
+#ifndef FNT_METHODS_DIR
+#define FNT_METHODS_DIR "."
+#endif /* FNT_METHODS_DIR */
+
+#define DIMS    50
+
+/* Broyden's tridiagonal system, r_i = (3 - 2 x_i) x_i - x_{i-1} - 2 x_{i+1} + 1,
+ * with x_0 = x_{n+1} = 0.  The Jacobian is filled in when jacobian is not NULL. */
+void tridiagonal(fnt_vect_t *x, fnt_vect_t *r, fnt_vect_t *jacobian) {
+    int n = x->n;
+    for(int i=0; i<n; ++i) {
+        double xi = FNT_VECT_ELEM(*x, i);
+        double prev = i > 0 ? FNT_VECT_ELEM(*x, i-1) : 0.0;
+        double next = i < n-1 ? FNT_VECT_ELEM(*x, i+1) : 0.0;
+        FNT_VECT_ELEM(*r, i) = (3.0 - 2.0 * xi) * xi - prev - 2.0 * next + 1.0;
+    }
+    if( jacobian == NULL )  { return; }
+
+    fnt_vect_reset(jacobian);
+    for(int i=0; i<n; ++i) {
+        FNT_VECT_ELEM(*jacobian, i*n+i) = 3.0 - 4.0 * FNT_VECT_ELEM(*x, i);
+        if( i > 0 )     { FNT_VECT_ELEM(*jacobian, i*n+i-1) = -1.0; }
+        if( i < n-1 )   { FNT_VECT_ELEM(*jacobian, i*n+i+1) = -2.0; }
+    }
+}
+
+int main() {
+
+    int failures = 0;
+    void *fnt = NULL;
+
+    fnt_verbose(FNT_INFO); /* request informative output */
+    fnt_init(&fnt, FNT_METHODS_DIR "/methods");
+
+    /* load broyden to find a root of the tridiagonal system */
+    if( fnt_set_method(fnt, "broyden", DIMS) == FNT_FAILURE ) {
+        fprintf(stderr, "Failed to initialize method.\n");
+        return 1;
+    }
+
+    /* display info */
+    fnt_info(fnt);
+
+    /* allocate input, residual and Jacobian */
+    fnt_vect_t x, r, jacobian;
+    fnt_vect_calloc(&x, DIMS);
+    fnt_vect_calloc(&r, DIMS);
+    fnt_vect_calloc(&jacobian, DIMS*DIMS);
+
+    /* start every run from x_i = -1 */
+    for(int i=0; i<DIMS; ++i) { FNT_VECT_ELEM(x, i) = -1.0; }
+    fnt_hparam_set(fnt, "x0", &x);
+
+    /* solve with each update rule, keeping the start point across resets */
+    char *names[] = { "good Broyden", "bad Broyden", "Newton" };
+    for(int update=0; update<3; ++update) {
+        fnt_hparam_set(fnt, "update", &update);
+        fnt_reset(fnt);
+
+        /* only Newton updates need the Jacobian */
+        fnt_vect_t *jac = update == 2 ? &jacobian : NULL;
+
+        int evals = 0;
+        while( fnt_done(fnt) == FNT_CONTINUE ) {
+            if( fnt_next(fnt, &x) != FNT_SUCCESS ) { break; }
+            tridiagonal(&x, &r, jac);
+            if( fnt_set_value_residual(fnt, &x, &r, jac) != FNT_SUCCESS ) { break; }
+            ++evals;
+        }
+
+        /* check the residual at the root found */
+        if( fnt_result(fnt, "root", &x) != FNT_SUCCESS ) {
+            printf("\t%s run failed!\n", names[update]);
+            ++failures;
+            continue;
+        }
+        double norm = 0.0;
+        tridiagonal(&x, &r, NULL);
+        fnt_vect_l2norm(&r, &norm);
+        printf("%s: |r| = %g after %d residual evaluations\n",
+                names[update], norm, evals);
+        if( norm > 1e-8 ) {
+            printf("\t%s did not converge!\n", names[update]);
+            ++failures;
+        }
+    }
+
+    /* free input, residual and Jacobian */
+    fnt_vect_free(&x);
+    fnt_vect_free(&r);
+    fnt_vect_free(&jacobian);
+
+    /* free the method */
+    fnt_free(&fnt);
+
+    return failures;
+}
@@ -0,0 +1,104 @@
+/*
+ * cpp-wrapper_test.cpp
+ * fnt: Numerical Toolbox
+ *
+ * Copyright (c) 2024 Bryan Franklin. All rights reserved.
+ */
+#include <cstdio>
+#include <cstdlib>
+#include "../fnt.hpp"
+#include "../fnt_problems.h"
+
+#ifndef FNT_METHODS_DIR
+#define FNT_METHODS_DIR "."
+#endif /* FNT_METHODS_DIR */
+
+/* fixed size kernels are evaluated entirely at compile time */
+constexpr fnt::vec<3> a{{1.0, 2.0, 3.0}};
+constexpr fnt::vec<3> b{{4.0, 5.0, 6.0}};
+static_assert(fnt::dot(a, b) == 32.0, "dot product");
+static_assert((b - a)[2] == 3.0, "difference");
+static_assert((2.0 * a + b)[0] == 6.0, "scale and add");
+
+int main() {
+
+    int failures = 0;
+    srand(1);
+
+    /* MARK: Typed hyper-parameters and ask/tell iteration */
+    fnt::context fnt(FNT_METHODS_DIR "/methods", "differential evolution", 2);
+    fnt.set("iters", 200);
+    fnt.set("NP", 20);
+    fnt.set("F", 0.6);
+    fnt.set("lower", fnt::vec<2>{{-2.0, -2.0}});
+    fnt.set("upper", fnt::vec<2>{{2.0, 2.0}});
+
+    if( fnt.get<int>("NP") != 20 || fnt.get<double>("F") != 0.6 ) {
+        printf("\tHyper-parameters did not round trip!\n");
+        ++failures;
+    }
+    auto upper = fnt.get<fnt::vec<2>>("upper");
+    if( upper[0] != 2.0 || upper[1] != 2.0 ) {
+        printf("\tVector hyper-parameter did not round trip!\n");
+        ++failures;
+    }
+
+    int evals = 0;
+    for(auto trial : fnt.trials()) {
+        trial.tell(rosenbrock_2d(trial[0], trial[1]));
+        ++evals;
+    }
+
+    auto min_x = fnt.result<fnt::vec<2>>("minimum x");
+    double min_fx = fnt.result<double>("minimum f");
+    printf("differential evolution: f(%g, %g) = %g after %d evaluations\n", min_x[0], min_x[1], min_fx, evals);
+    if( min_fx > 1e-2 ) {
+        printf("\tMinimum not found!\n");
+        ++failures;
+    }
+
+    /* MARK: Explicit ask/tell with a run time sized vector */
+    fnt::context nm(FNT_METHODS_DIR "/methods", "nelder-mead", 2);
+    nm.warm_start(fnt);
+    fnt::vec<fnt::dynamic> x(2);
+    while( !nm.done() ) {
+        nm.next(x);
+        nm.tell(x, rosenbrock_2d(x[0], x[1]));
+    }
+    double refined_fx = nm.result<double>("minimum f");
+    printf("nelder-mead (warm): minimum %g\n", refined_fx);
+    if( refined_fx > min_fx ) {
+        printf("\tRefined result is worse!\n");
+        ++failures;
+    }
+
+    /* MARK: Results that are not one element per dimension */
+    fnt::context powell(FNT_METHODS_DIR "/methods", "powell", 2);
+    for(auto trial : powell.trials()) {
+        trial.tell(rosenbrock_2d(trial[0], trial[1]));
+    }
+    auto dirs = powell.result<fnt::vec<fnt::dynamic>>("directions", 4);
+    auto fixed = powell.result<fnt::vec<4>>("directions");
+    printf("powell: directions (%g, %g), (%g, %g)\n", dirs[0], dirs[1], dirs[2], dirs[3]);
+    if( dirs.size() != 4 || dirs[3] != fixed[3] ) {
+        printf("\tDirection set was not fetched!\n");
+        ++failures;
+    }
+
+    /* MARK: Ownership and errors */
+    fnt::context moved = std::move(nm);
+    if( nm.get() != nullptr || moved.get() == nullptr ) {
+        printf("\tMove did not transfer ownership!\n");
+        ++failures;
+    }
+
+    try {
+        fnt::context missing(FNT_METHODS_DIR "/methods", "no such method", 2);
+        printf("\tMissing method did not throw!\n");
+        ++failures;
+    } catch( const fnt::error &e ) {
+        printf("missing method: %s\n", e.what());
+    }
+
+    return failures;
+}
@@ -0,0 +1,96 @@
+/*
+ * de-budget_test.c
+ * fnt: Numerical Toolbox
+ *
+ * Copyright (c) 2024 Bryan Franklin. All rights reserved.
+ */
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "../fnt.h"
+#include "../fnt_problems.h"
+
+#ifndef FNT_METHODS_DIR
+#define FNT_METHODS_DIR "."
+#endif /* FNT_METHODS_DIR */
+
+#define NP  10
+
+int main() {
+
+    int failures = 0;
+    void *fnt = NULL;
+
+    srand(1);
+    fnt_verbose(FNT_INFO); /* request informative output */
+    fnt_init(&fnt, FNT_METHODS_DIR "/methods");
+
+    /* load differential evolution to minimize Rosenbrock function */
+    if( fnt_set_method(fnt, "differential evolution", 2) == FNT_FAILURE ) {
+        fprintf(stderr, "Failed to initialize method.\n");
+        return 1;
+    }
+
+    /* display info */
+    fnt_info(fnt);
+
+    /* more generations than any budget below allows */
+    int population = NP;
+    int iterations = 1000;
+    fnt_hparam_set(fnt, "NP", &population);
+    fnt_hparam_set(fnt, "iters", &iterations);
+
+    /* allocate input for objective function */
+    fnt_vect_t x, best_x;
+    fnt_vect_calloc(&x, 2);
+    fnt_vect_calloc(&best_x, 2);
+
+    /* budgets ending with the first generation, on a later generation
+     * boundary, and part way through a generation */
+    int budgets[] = { NP, 3*NP, 3*NP + 7 };
+    for(int k=0; k<3; ++k) {
+        fnt_hparam_set(fnt, "max_evals", &budgets[k]);
+        fnt_reset(fnt);
+
+        /* remember the best point evaluated */
+        double best_f = INFINITY;
+        while( fnt_done(fnt) == FNT_CONTINUE ) {
+            if( fnt_next(fnt, &x) != FNT_SUCCESS ) { break; }
+            double fx = rosenbrock_2d(FNT_VECT_ELEM(x, 0), FNT_VECT_ELEM(x, 1));
+            if( fx < best_f ) {
+                best_f = fx;
+                fnt_vect_copy(&best_x, &x);
+            }
+            if( fnt_set_value(fnt, &x, fx) != FNT_SUCCESS ) { break; }
+        }
+
+        /* the reported minimum must be the best point seen */
+        double min_fx = 0.0;
+        int evals = 0;
+        fnt_result(fnt, "minimum x", &x);
+        fnt_result(fnt, "minimum f", &min_fx);
+        fnt_result(fnt, "evaluations", &evals);
+        printf("max_evals %d: %d evaluations, ", budgets[k], evals);
+        fnt_vect_print(&x, "minimum f(", NULL);
+        printf(") = %g, best seen %g\n", min_fx, best_f);
+        if( evals != budgets[k] ) {
+            printf("\tDid not stop on the budget!\n");
+            ++failures;
+        }
+        if( min_fx != best_f
+            || FNT_VECT_ELEM(x, 0) != FNT_VECT_ELEM(best_x, 0)
+            || FNT_VECT_ELEM(x, 1) != FNT_VECT_ELEM(best_x, 1) ) {
+            printf("\tReported minimum is not the best point evaluated!\n");
+            ++failures;
+        }
+    }
+
+    /* free input vectors */
+    fnt_vect_free(&x);
+    fnt_vect_free(&best_x);
+
+    /* free the method */
+    fnt_free(&fnt);
+
+    return failures;
+}
@@ -0,0 +1,164 @@
+/*
+ * de-mixed_test.c
+ * fnt: Numerical Toolbox
+ *
+ * Copyright (c) 2024 Bryan Franklin. All rights reserved.
+ */
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../fnt.h"
+
+#ifndef FNT_METHODS_DIR
+#define FNT_METHODS_DIR "."
+#endif /* FNT_METHODS_DIR */
+
+#define DIMS        4
+#define NP          20
+#define ITERS       100
+#define MAX_TRIALS  (NP * (ITERS + 1))
+
+/* three integers in [0, 10] and a category in [0, 3],
+ * minimum of zero at (7, 3, 5, 2) */
+double mixed(fnt_vect_t *x) {
+    double cost[] = { 3.0, 1.0, 0.0, 2.0 };
+    double a = FNT_VECT_ELEM(*x, 0) - 7.0;
+    double b = FNT_VECT_ELEM(*x, 1) - 3.0;
+    double c = FNT_VECT_ELEM(*x, 2) - 5.0;
+
+    return a * a + b * b + c * c + cost[(int)FNT_VECT_ELEM(*x, 3)];
+}
+
+/* two binary variables, minimum of zero at (1, 0) */
+double corner(fnt_vect_t *x, void *user) {
+    return fabs(FNT_VECT_ELEM(*x, 0) - 1.0) + FNT_VECT_ELEM(*x, 1);
+}
+
+int main() {
+
+    int failures = 0;
+    srand(1);
+
+    void *fnt = NULL;
+    fnt_init(&fnt, FNT_METHODS_DIR "/methods");
+    if( fnt_set_method(fnt, "differential evolution", DIMS) == FNT_FAILURE ) {
+        fprintf(stderr, "Failed to initialize method.\n");
+        return 1;
+    }
+
+    int iterations = ITERS, np = NP;
+    fnt_hparam_set(fnt, "iters", &iterations);
+    fnt_hparam_set(fnt, "NP", &np);
+
+    fnt_vect_t v;
+    fnt_vect_calloc(&v, DIMS);
+    double types[] = { 1, 1, 1, 2 };
+    double lower[] = { 0, 0, 0, 0 };
+    double upper[] = { 10, 10, 10, 3 };
+    memcpy(v.v, types, sizeof(types));  fnt_hparam_set(fnt, "types", &v);
+    memcpy(v.v, lower, sizeof(lower));  fnt_hparam_set(fnt, "lower", &v);
+    memcpy(v.v, upper, sizeof(upper));  fnt_hparam_set(fnt, "upper", &v);
+
+    /* record every configuration handed out */
+    static double handed[MAX_TRIALS][DIMS];
+    int trials = 0, invalid = 0;
+    fnt_vect_t x;
+    fnt_vect_calloc(&x, DIMS);
+    while( fnt_done(fnt) == FNT_CONTINUE ) {
+        if( fnt_next(fnt, &x) != FNT_SUCCESS )  { break; }
+        for(int j=0; j<DIMS; ++j) {
+            double xj = FNT_VECT_ELEM(x, j);
+            if( xj != round(xj) || xj < lower[j] || xj > upper[j] ) { ++invalid; }
+        }
+        if( trials < MAX_TRIALS ) {
+            memcpy(handed[trials++], x.v, sizeof(handed[0]));
+        }
+        fnt_set_value(fnt, &x, mixed(&x));
+    }
+
+    int repeats = 0;
+    for(int i=0; i<trials; ++i) {
+        for(int k=0; k<i; ++k) {
+            if( memcmp(handed[i], handed[k], sizeof(handed[0])) == 0 ) {
+                ++repeats;
+                break;
+            }
+        }
+    }
+
+    double min_f = -1.0;
+    int duplicates = 0, evaluations = 0;
+    fnt_result(fnt, "minimum x", &x);
+    fnt_result(fnt, "minimum f", &min_f);
+    fnt_result(fnt, "duplicates", &duplicates);
+    fnt_result(fnt, "evaluations", &evaluations);
+    printf("%d evaluations, %d duplicate trials skipped, ", trials, duplicates);
+    fnt_vect_println(&x, "minimum at ", NULL);
+
+    if( invalid > 0 ) {
+        printf("\t%d elements were not integers within bounds!\n", invalid);
+        ++failures;
+    }
+    if( repeats > 0 ) {
+        printf("\t%d configurations were evaluated more than once!\n", repeats);
+        ++failures;
+    }
+    if( duplicates == 0 ) {
+        printf("\tNo duplicate trials were found to skip!\n");
+        ++failures;
+    }
+
+    /* values settled from the cache are not evaluations */
+    if( evaluations != trials ) {
+        printf("\tReported %d evaluations for %d handed out!\n", evaluations, trials);
+        ++failures;
+    }
+    if( min_f != 0.0 ) {
+        printf("\tMinimum %g found instead of 0!\n", min_f);
+        ++failures;
+    }
+
+    fnt_vect_free(&x);
+    fnt_vect_free(&v);
+    fnt_free(&fnt);
+
+    /* a space of four configurations runs out of new trials, settling
+     * duplicates finishes the run while inputs are being handed out */
+    fnt_init(&fnt, FNT_METHODS_DIR "/methods");
+    if( fnt_set_method(fnt, "differential evolution", 2) == FNT_FAILURE ) {
+        fprintf(stderr, "Failed to initialize method.\n");
+        return 1;
+    }
+    iterations = 20;
+    np = 3;
+    fnt_hparam_set(fnt, "iters", &iterations);
+    fnt_hparam_set(fnt, "NP", &np);
+    fnt_vect_calloc(&v, 2);
+    FNT_VECT_ELEM(v, 0) = FNT_VECT_ELEM(v, 1) = 1;
+    fnt_hparam_set(fnt, "types", &v);
+    fnt_hparam_set(fnt, "upper", &v);
+    FNT_VECT_ELEM(v, 0) = FNT_VECT_ELEM(v, 1) = 0;
+    fnt_hparam_set(fnt, "lower", &v);
+
+    void *sched = NULL;
+    fnt_sched_init(&sched, 2);
+    if( fnt_sched_minimize(sched, fnt, corner, NULL) != FNT_SUCCESS ) {
+        printf("\tScheduled run failed when duplicates finished it!\n");
+        ++failures;
+    }
+    fnt_vect_calloc(&x, 2);
+    fnt_result(fnt, "minimum x", &x);
+    fnt_vect_println(&x, "scheduled minimum at ", NULL);
+    if( FNT_VECT_ELEM(x, 0) != 1.0 || FNT_VECT_ELEM(x, 1) != 0.0 ) {
+        printf("\tScheduled run did not find the minimum!\n");
+        ++failures;
+    }
+    fnt_sched_free(&sched);
+
+    fnt_vect_free(&x);
+    fnt_vect_free(&v);
+    fnt_free(&fnt);
+
+    return failures;
+}
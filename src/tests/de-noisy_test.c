@@ -0,0 +1,164 @@
+/*
+ * de-noisy_test.c
+ * fnt: Numerical Toolbox
+ *
+ * Copyright (c) 2024 Bryan Franklin. All rights reserved.
+ */
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "../fnt.h"
+
+#ifndef FNT_METHODS_DIR
+#define FNT_METHODS_DIR "."
+#endif /* FNT_METHODS_DIR */
+
+#define DIMS        4
+#define CAPACITY    16
+#define RUNS        8
+#define BUDGET      10000
+
+/* noise free objective, a benchmark time of one plus a shifted sphere */
+double cost(fnt_vect_t *x) {
+    double sum = 1.0;
+    for(int i=0; i<x->n; ++i) {
+        double d = FNT_VECT_ELEM(*x, i) - 0.5;
+        sum += d * d;
+    }
+    return sum;
+}
+
+/* the benchmark, measured with 3% normally distributed noise */
+double measure(fnt_vect_t *x) {
+    double u1 = (rand() + 1.0) / (RAND_MAX + 2.0);
+    double u2 = (rand() + 1.0) / (RAND_MAX + 2.0);
+    double z = sqrt(-2.0 * log(u1)) * cos(6.283185307179586 * u2);
+
+    return cost(x) * (1.0 + 0.03 * z);
+}
+
+int main() {
+
+    int failures = 0;
+    void *fnt = NULL;
+
+    srand(1);
+    fnt_verbose(FNT_INFO); /* request informative output */
+    fnt_init(&fnt, FNT_METHODS_DIR "/methods");
+
+    /* load differential evolution to minimize a noisy benchmark */
+    if( fnt_set_method(fnt, "differential evolution", DIMS) == FNT_FAILURE ) {
+        fprintf(stderr, "Failed to initialize method.\n");
+        return 1;
+    }
+
+    /* display info */
+    fnt_info(fnt);
+
+    /* stop on the evaluation budget, before running out of generations */
+    int NP = 20;
+    int iterations = BUDGET;
+    int max_evals = BUDGET;
+    fnt_hparam_set(fnt, "NP", &NP);
+    fnt_hparam_set(fnt, "iters", &iterations);
+    fnt_hparam_set(fnt, "max_evals", &max_evals);
+
+    /* search within [-5, 5]^DIMS */
+    fnt_vect_t x[CAPACITY];
+    int tickets[CAPACITY];
+    for(int i=0; i<CAPACITY; ++i) { fnt_vect_calloc(&x[i], DIMS); }
+    for(int j=0; j<DIMS; ++j) { FNT_VECT_ELEM(x[0], j) = -5.0; }
+    fnt_hparam_set(fnt, "lower", &x[0]);
+    for(int j=0; j<DIMS; ++j) { FNT_VECT_ELEM(x[0], j) = 5.0; }
+    fnt_hparam_set(fnt, "upper", &x[0]);
+
+    /* only report problems during the repeated runs */
+    fnt_verbose(FNT_WARN);
+
+    /* greedy selection, then noise-aware selection, each given the same
+     * number of evaluations, averaged over several runs as single runs are
+     * at the mercy of the noise */
+    double excess[2] = { 0.0, 0.0 }, optimism[2] = { 0.0, 0.0 };
+    int evals[2] = { 0, 0 }, resamples[2] = { 0, 0 }, largest[2] = { 0, 0 };
+    for(int noisy=0; noisy<2; ++noisy) {
+        fnt_hparam_set(fnt, "noisy", &noisy);
+
+        for(int run=0; run<RUNS; ++run) {
+            fnt_reset(fnt);
+
+            /* evaluate batches as handed out */
+            while( fnt_done(fnt) == FNT_CONTINUE ) {
+                int count = 0;
+                if( fnt_next_batch(fnt, x, tickets, CAPACITY, &count) != FNT_SUCCESS
+                    || count < 1 ) {
+                    printf("\tNo inputs handed out.\n");
+                    return 1;
+                }
+                if( count > largest[noisy] )    { largest[noisy] = count; }
+                for(int k=count-1; k>=0; --k) {
+                    fnt_set_value_ticket(fnt, tickets[k], &x[k], measure(&x[k]));
+                }
+            }
+
+            /* compare the minimum found with the value the method believes */
+            double min_fx = 0.0;
+            int count = 0, repeats = 0;
+            fnt_result(fnt, "minimum x", &x[0]);
+            fnt_result(fnt, "minimum f", &min_fx);
+            fnt_result(fnt, "evaluations", &count);
+            fnt_result(fnt, "resamples", &repeats);
+            excess[noisy] += (cost(&x[0]) - 1.0) / RUNS;
+            optimism[noisy] += (cost(&x[0]) - min_fx) / RUNS;
+            evals[noisy] += count;
+            resamples[noisy] += repeats;
+        }
+    }
+
+    char *names[] = { "greedy", "noisy" };
+    for(int k=0; k<2; ++k) {
+        printf("%s: %d evaluations (%d repeats, batches of up to %d), "
+                "mean excess %g, believed %g too low\n", names[k], evals[k] / RUNS,
+                resamples[k] / RUNS, largest[k], excess[k], optimism[k]);
+    }
+
+    /* greedy selection keeps lucky measurements, so believes too good a value */
+    if( optimism[0] < 0.03 ) {
+        printf("\tGreedy selection was not fooled by the noise!\n");
+        ++failures;
+    }
+    if( evals[0] != RUNS * BUDGET ) {
+        printf("\tGreedy selection did not stop on the budget!\n");
+        ++failures;
+    }
+    if( resamples[0] != 0 || largest[0] != 1 ) {
+        printf("\tGreedy selection should not repeat evaluations!\n");
+        ++failures;
+    }
+
+    /* noise-aware selection batches repeats, and gets closer for the same
+     * number of evaluations, give or take the last batch */
+    if( evals[1] > RUNS * (BUDGET + CAPACITY) ) {
+        printf("\tNoisy selection overspent the budget!\n");
+        ++failures;
+    }
+    if( resamples[1] == 0 || largest[1] < 2 ) {
+        printf("\tNo repeats were batched!\n");
+        ++failures;
+    }
+    if( optimism[1] > 0.75 * optimism[0] ) {
+        printf("\tNoisy selection misjudged its minimum!\n");
+        ++failures;
+    }
+    if( excess[1] > excess[0] ) {
+        printf("\tNoisy selection did no better than greedy!\n");
+        ++failures;
+    }
+
+    /* free input vectors */
+    for(int i=0; i<CAPACITY; ++i) { fnt_vect_free(&x[i]); }
+
+    /* free the method */
+    fnt_free(&fnt);
+
+    return failures;
+}
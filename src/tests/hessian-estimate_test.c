@@ -0,0 +1,127 @@
+/*
+ * hessian-estimate_test.c
+ * fnt: Numerical Toolbox
+ *
+ * Copyright (c) 2024 Bryan Franklin. All rights reserved.
+ */
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "../fnt.h"
+
+#ifndef FNT_METHODS_DIR
+#define FNT_METHODS_DIR "."
+#endif /* FNT_METHODS_DIR */
+
+#define DIMS        6
+#define CAPACITY    64
+
+/* f(x) = sum (i+1) x_i^2 + x_i x_i+1 + sin(x_i) */
+double f(fnt_vect_t *x, fnt_vect_t *gradient) {
+    double sum = 0.0;
+    for(int i=0; i<DIMS; ++i) {
+        double xi = FNT_VECT_ELEM(*x, i);
+        double next = i < DIMS-1 ? FNT_VECT_ELEM(*x, i+1) : 0.0;
+        double prev = i > 0 ? FNT_VECT_ELEM(*x, i-1) : 0.0;
+        sum += (i+1) * xi * xi + xi * next + sin(xi);
+        if( gradient != NULL ) {
+            FNT_VECT_ELEM(*gradient, i) = 2.0 * (i+1) * xi + next + prev + cos(xi);
+        }
+    }
+    return sum;
+}
+
+double exact(fnt_vect_t *x, int i, int j) {
+    if( i == j )            { return 2.0 * (i+1) - sin(FNT_VECT_ELEM(*x, i)); }
+    if( abs(i - j) == 1 )   { return 1.0; }
+    return 0.0;
+}
+
+/* Estimate the Hessian in batches, returning the number of rounds used, or
+ * -1 on failure. */
+int estimate(fnt_vect_t *x0, int use_gradient, fnt_vect_t *hessian, int *evals) {
+
+    void *fnt = NULL;
+    fnt_init(&fnt, FNT_METHODS_DIR "/methods");
+    if( fnt_set_method(fnt, "hessian estimate", DIMS) == FNT_FAILURE ) {
+        return -1;
+    }
+    fnt_hparam_set(fnt, "x0", x0);
+    fnt_hparam_set(fnt, "use_gradient", &use_gradient);
+
+    fnt_vect_t x[CAPACITY], g;
+    int tickets[CAPACITY];
+    for(int i=0; i<CAPACITY; ++i) { fnt_vect_calloc(&x[i], DIMS); }
+    fnt_vect_calloc(&g, DIMS);
+
+    int rounds = 0;
+    *evals = 0;
+    while( rounds >= 0 && fnt_done(fnt) == FNT_CONTINUE ) {
+        int count = 0;
+        if( fnt_next_batch(fnt, x, tickets, CAPACITY, &count) != FNT_SUCCESS
+            || count == 0 ) {
+            rounds = -1;
+            break;
+        }
+        for(int i=0; i<count; ++i) {
+            int ret = use_gradient
+                    ? fnt_set_value_gradient(fnt, &x[i], f(&x[i], &g), &g)
+                    : fnt_set_value_ticket(fnt, tickets[i], &x[i], f(&x[i], NULL));
+            if( ret != FNT_SUCCESS ) {
+                rounds = -1;
+                break;
+            }
+        }
+        *evals += count;
+        ++rounds;
+    }
+    if( rounds >= 0 ) {
+        fnt_result(fnt, "hessian", hessian);
+    }
+
+    for(int i=0; i<CAPACITY; ++i) { fnt_vect_free(&x[i]); }
+    fnt_vect_free(&g);
+    fnt_free(&fnt);
+
+    return rounds;
+}
+
+int main() {
+
+    int failures = 0;
+    char *names[] = { "values", "gradients" };
+    int expect_evals[] = { 1 + 2*DIMS + DIMS*(DIMS-1), 2*DIMS };
+    double tolerance[] = { 1e-5, 1e-6 };
+
+    fnt_vect_t x0, hessian;
+    fnt_vect_calloc(&x0, DIMS);
+    fnt_vect_calloc(&hessian, DIMS*(DIMS+1)/2);
+    for(int i=0; i<DIMS; ++i) { FNT_VECT_ELEM(x0, i) = 0.5 - 0.2 * i; }
+
+    for(int k=0; k<2; ++k) {
+        int evals = 0;
+        int rounds = estimate(&x0, k, &hessian, &evals);
+
+        double err = 0.0;
+        for(int i=0; i<DIMS; ++i) {
+            for(int j=0; j<=i; ++j) {
+                err = fmax(err, fabs(FNT_VECT_ELEM(hessian, i*(i+1)/2 + j) - exact(&x0, i, j)));
+            }
+        }
+        printf("%s: %d round(s), %d evaluations, max error %g\n", names[k], rounds, evals, err);
+
+        if( rounds != 1 || evals != expect_evals[k] ) {
+            printf("\tExpected one round of %d evaluations!\n", expect_evals[k]);
+            ++failures;
+        }
+        if( err > tolerance[k] ) {
+            printf("\tHessian estimate is not accurate!\n");
+            ++failures;
+        }
+    }
+
+    fnt_vect_free(&x0);
+    fnt_vect_free(&hessian);
+
+    return failures;
+}
@@ -0,0 +1,219 @@
+/*
+ * levenberg-marquardt_test.c
+ * fnt: Numerical Toolbox
+ *
+ * Copyright (c) 2024 Bryan Franklin. All rights reserved.
+ */
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "../fnt.h"
+
+#ifndef FNT_METHODS_DIR
+#define FNT_METHODS_DIR "."
+#endif /* FNT_METHODS_DIR */
+
+#define POINTS      40
+#define ROSEN_DIMS  40
+#define CAPACITY    64
+
+typedef void (*residual_t)(fnt_vect_t *x, fnt_vect_t *r, fnt_vect_t *jacobian);
+
+/* deterministic stand-in for measurement noise */
+double noise(int i) {
+    return 0.01 * sin(7.0 * i + 1.0);
+}
+
+/* y = a + b t */
+void line(fnt_vect_t *x, fnt_vect_t *r, fnt_vect_t *jacobian) {
+    for(int i=0; i<POINTS; ++i) {
+        double t = 0.1 * i;
+        double y = 1.0 + 2.0 * t + noise(i);
+        FNT_VECT_ELEM(*r, i) = FNT_VECT_ELEM(*x, 0) + FNT_VECT_ELEM(*x, 1) * t - y;
+        if( jacobian == NULL )  { continue; }
+        FNT_VECT_ELEM(*jacobian, i*2+0) = 1.0;
+        FNT_VECT_ELEM(*jacobian, i*2+1) = t;
+    }
+}
+
+/* y = a exp(-b t) + c */
+void decay(fnt_vect_t *x, fnt_vect_t *r, fnt_vect_t *jacobian) {
+    double a = FNT_VECT_ELEM(*x, 0);
+    double b = FNT_VECT_ELEM(*x, 1);
+    double c = FNT_VECT_ELEM(*x, 2);
+    for(int i=0; i<POINTS; ++i) {
+        double t = 0.1 * i;
+        double y = 5.0 * exp(-1.5 * t) + 0.5 + noise(i);
+        double e = exp(-b * t);
+        FNT_VECT_ELEM(*r, i) = a * e + c - y;
+        if( jacobian == NULL )  { continue; }
+        FNT_VECT_ELEM(*jacobian, i*3+0) = e;
+        FNT_VECT_ELEM(*jacobian, i*3+1) = -a * t * e;
+        FNT_VECT_ELEM(*jacobian, i*3+2) = 1.0;
+    }
+}
+
+/* extended Rosenbrock, r_2k = 10 (x_2k+1 - x_2k^2), r_2k+1 = 1 - x_2k */
+void rosen(fnt_vect_t *x, fnt_vect_t *r, fnt_vect_t *jacobian) {
+    for(int k=0; k<ROSEN_DIMS/2; ++k) {
+        double x0 = FNT_VECT_ELEM(*x, 2*k);
+        double x1 = FNT_VECT_ELEM(*x, 2*k+1);
+        FNT_VECT_ELEM(*r, 2*k) = 10.0 * (x1 - x0 * x0);
+        FNT_VECT_ELEM(*r, 2*k+1) = 1.0 - x0;
+    }
+}
+
+/* a single residual, x^3 + y - 10, reported as a plain value */
+double cubic(fnt_vect_t *x, void *user) {
+    return pow(FNT_VECT_ELEM(*x, 0), 3.0) + FNT_VECT_ELEM(*x, 1) - 10.0;
+}
+
+/* Fit with residuals only, in batches, or with the Jacobian, one point at a
+ * time.  Returns the number of rounds of evaluations, or -1 on failure. */
+int fit(residual_t residual, int n, int m, double start, int analytic,
+        fnt_vect_t *min_x, fnt_vect_t *covariance) {
+
+    void *fnt = NULL;
+    fnt_init(&fnt, FNT_METHODS_DIR "/methods");
+    if( fnt_set_method(fnt, "levenberg-marquardt", n) == FNT_FAILURE ) {
+        fprintf(stderr, "Failed to initialize method.\n");
+        return -1;
+    }
+
+    fnt_vect_t x[CAPACITY], r, jacobian;
+    int tickets[CAPACITY];
+    for(int i=0; i<CAPACITY; ++i) { fnt_vect_calloc(&x[i], n); }
+    fnt_vect_calloc(&r, m);
+    fnt_vect_calloc(&jacobian, m*n);
+    for(int j=0; j<n; ++j) { FNT_VECT_ELEM(x[0], j) = j % 2 ? 1.0 : start; }
+    fnt_hparam_set(fnt, "x0", &x[0]);
+
+    int rounds = 0;
+    while( rounds >= 0 && fnt_done(fnt) == FNT_CONTINUE ) {
+        int count = 1;
+        if( analytic ) {
+            if( fnt_next(fnt, &x[0]) != FNT_SUCCESS )   { rounds = -1; break; }
+        } else if( fnt_next_batch(fnt, x, tickets, CAPACITY, &count) != FNT_SUCCESS
+                   || count == 0 ) {
+            rounds = -1;
+            break;
+        }
+        for(int i=0; i<count; ++i) {
+            residual(&x[i], &r, analytic ? &jacobian : NULL);
+            if( fnt_set_value_residual(fnt, &x[i], &r, analytic ? &jacobian : NULL) != FNT_SUCCESS ) {
+                rounds = -1;
+                break;
+            }
+        }
+        ++rounds;
+    }
+    if( rounds >= 0 ) {
+        fnt_result(fnt, "minimum x", min_x);
+        if( covariance != NULL ) { fnt_result(fnt, "covariance", covariance); }
+    }
+
+    for(int i=0; i<CAPACITY; ++i) { fnt_vect_free(&x[i]); }
+    fnt_vect_free(&r);
+    fnt_vect_free(&jacobian);
+    fnt_free(&fnt);
+
+    return rounds;
+}
+
+int main() {
+
+    int failures = 0;
+
+    /* MARK: Linear fit, against the normal equations */
+    fnt_vect_t x, cov;
+    fnt_vect_calloc(&x, 2);
+    fnt_vect_calloc(&cov, 4);
+    int rounds = fit(line, 2, POINTS, 0.0, 0, &x, &cov);
+
+    double s = 0, st = 0, stt = 0, sy = 0, sty = 0;
+    for(int i=0; i<POINTS; ++i) {
+        double t = 0.1 * i, y = 1.0 + 2.0 * t + noise(i);
+        s += 1;  st += t;  stt += t * t;  sy += y;  sty += t * y;
+    }
+    double det = s * stt - st * st;
+    double a = (stt * sy - st * sty) / det;
+    double b = (s * sty - st * sy) / det;
+    double sse = 0;
+    for(int i=0; i<POINTS; ++i) {
+        double t = 0.1 * i, e = a + b * t - (1.0 + 2.0 * t + noise(i));
+        sse += e * e;
+    }
+    double s2 = sse / (POINTS - 2);
+    double expect[4] = { s2 * stt / det, -s2 * st / det, -s2 * st / det, s2 * s / det };
+
+    printf("line: %d rounds, a = %.8f, b = %.8f, var(a) = %g, var(b) = %g\n",
+            rounds, FNT_VECT_ELEM(x, 0), FNT_VECT_ELEM(x, 1),
+            FNT_VECT_ELEM(cov, 0), FNT_VECT_ELEM(cov, 3));
+    if( rounds < 0 || fabs(FNT_VECT_ELEM(x, 0) - a) > 1e-8
+        || fabs(FNT_VECT_ELEM(x, 1) - b) > 1e-8 ) {
+        printf("\tParameters differ from least squares solution (%g, %g)!\n", a, b);
+        ++failures;
+    }
+    for(int k=0; k<4; ++k) {
+        if( fabs(FNT_VECT_ELEM(cov, k) - expect[k]) > 1e-6 * fabs(expect[k]) ) {
+            printf("\tcovariance[%d] is %g, expected %g!\n", k, FNT_VECT_ELEM(cov, k), expect[k]);
+            ++failures;
+        }
+    }
+    fnt_vect_free(&x);
+    fnt_vect_free(&cov);
+
+    /* MARK: Exponential decay, finite differences against the Jacobian */
+    fnt_vect_t fd_x, jac_x;
+    fnt_vect_calloc(&fd_x, 3);
+    fnt_vect_calloc(&jac_x, 3);
+    int fd_rounds = fit(decay, 3, POINTS, 1.0, 0, &fd_x, NULL);
+    int jac_rounds = fit(decay, 3, POINTS, 1.0, 1, &jac_x, NULL);
+    printf("decay: %d batched rounds, %d rounds with Jacobian, ", fd_rounds, jac_rounds);
+    fnt_vect_println(&fd_x, "minimum x: ", NULL);
+    for(int j=0; j<3; ++j) {
+        if( fd_rounds < 0 || jac_rounds < 0
+            || fabs(FNT_VECT_ELEM(fd_x, j) - FNT_VECT_ELEM(jac_x, j)) > 1e-6 ) {
+            printf("\tParameter %d differs: %g by differences, %g with Jacobian!\n",
+                    j, FNT_VECT_ELEM(fd_x, j), FNT_VECT_ELEM(jac_x, j));
+            ++failures;
+        }
+    }
+    fnt_vect_free(&fd_x);
+    fnt_vect_free(&jac_x);
+
+    /* MARK: Extended Rosenbrock, spanning several QR panels */
+    fnt_vect_calloc(&x, ROSEN_DIMS);
+    rounds = fit(rosen, ROSEN_DIMS, ROSEN_DIMS, -1.2, 0, &x, NULL);
+    double err = 0.0;
+    for(int j=0; j<ROSEN_DIMS; ++j) { err = fmax(err, fabs(FNT_VECT_ELEM(x, j) - 1.0)); }
+    printf("extended rosenbrock (%d dims): %d rounds, max error %g\n", ROSEN_DIMS, rounds, err);
+    if( rounds < 0 || err > 1e-6 ) {
+        printf("\tDid not reach the minimum!\n");
+        ++failures;
+    }
+    fnt_vect_free(&x);
+
+    /* MARK: One residual as a value, batches evaluated by the scheduler */
+    void *sched = NULL;
+    void *fnt = NULL;
+    fnt_sched_init(&sched, 2);
+    fnt_init(&fnt, FNT_METHODS_DIR "/methods");
+    fnt_set_method(fnt, "levenberg-marquardt", 2);
+    fnt_vect_calloc(&x, 2);
+    FNT_VECT_ELEM(x, 0) = FNT_VECT_ELEM(x, 1) = 1.0;
+    fnt_hparam_set(fnt, "x0", &x);
+    int ret = fnt_sched_minimize(sched, fnt, cubic, NULL);
+    fnt_result(fnt, "minimum x", &x);
+    printf("cubic: residual %g ", cubic(&x, NULL));
+    fnt_vect_println(&x, "at ", NULL);
+    if( ret != FNT_SUCCESS || fabs(cubic(&x, NULL)) > 1e-6 ) {
+        printf("\tScalar residual was not driven to zero!\n");
+        ++failures;
+    }
+    fnt_vect_free(&x);
+    fnt_free(&fnt);
+    fnt_sched_free(&sched);
+
+    return failures;
+}
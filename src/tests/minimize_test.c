@@ -0,0 +1,109 @@
+/*
+ * minimize_test.c
+ * fnt: Numerical Toolbox
+ *
+ * Copyright (c) 2024 Bryan Franklin. All rights reserved.
+ */
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "../fnt.h"
+#include "../fnt_problems.h"
+
+#ifndef FNT_METHODS_DIR
+#define FNT_METHODS_DIR "."
+#endif /* FNT_METHODS_DIR */
+
+/* Objective passed to fnt_minimize, counting evaluations through user. */
+double objective(fnt_vect_t *x, void *user) {
+    int *evals = user;
+    ++*evals;
+
+    if( x->n == 1 ) {
+        // x^2 - 2x + 3, minimum at x=1
+        double x_0 = FNT_VECT_ELEM(*x, 0);
+        return x_0*x_0 - 2*x_0 + 3;
+    }
+
+    return rosenbrock_2d(FNT_VECT_ELEM(*x, 0), FNT_VECT_ELEM(*x, 1));
+}
+
+/* Minimize using either the ask/tell loop or fnt_minimize. */
+int minimize(char *method, int dims, int use_callback, double *min_fx, int *evals) {
+
+    void *fnt = NULL;
+    fnt_init(&fnt, FNT_METHODS_DIR "/methods");
+
+    if( fnt_set_method(fnt, method, dims) == FNT_FAILURE ) {
+        fprintf(stderr, "Failed to initialize method.\n");
+        return FNT_FAILURE;
+    }
+    if( dims == 1 ) {
+        double x_0 = -2.0;
+        double x_1 = 3.0;
+        double eps = 1e-6;
+        double t = 1e-6;
+        fnt_hparam_set(fnt, "x_0", &x_0);
+        fnt_hparam_set(fnt, "x_1", &x_1);
+        fnt_hparam_set(fnt, "eps", &eps);
+        fnt_hparam_set(fnt, "t", &t);
+    }
+
+    /* use the same random sequence for both runs */
+    srand(1);
+    *evals = 0;
+
+    int ret = FNT_SUCCESS;
+    if( use_callback ) {
+        ret = fnt_minimize(fnt, objective, evals);
+    } else {
+        fnt_vect_t x;
+        fnt_vect_calloc(&x, dims);
+        while( fnt_done(fnt) == FNT_CONTINUE ) {
+            if( fnt_next(fnt, &x) != FNT_SUCCESS ) { ret = FNT_FAILURE; break; }
+
+            double fx = objective(&x, evals);
+
+            if( fnt_set_value(fnt, &x, fx) != FNT_SUCCESS ) { ret = FNT_FAILURE; break; }
+        }
+        fnt_vect_free(&x);
+    }
+
+    if( ret == FNT_SUCCESS ) {
+        ret = fnt_result(fnt, "minimum f", min_fx);
+    }
+    fnt_free(&fnt);
+
+    return ret;
+}
+
+int main() {
+
+    /* the first two drive the loop themselves, the last uses the core loop */
+    char *methods[] = { "differential evolution", "nelder-mead", "brents-localmin" };
+    int dims[] = { 2, 2, 1 };
+    int failures = 0;
+
+    for(int i=0; i<3; ++i) {
+        double ask_fx = 0.0, callback_fx = 0.0;
+        int ask_evals = 0, callback_evals = 0;
+
+        if( minimize(methods[i], dims[i], 0, &ask_fx, &ask_evals) != FNT_SUCCESS
+            || minimize(methods[i], dims[i], 1, &callback_fx, &callback_evals) != FNT_SUCCESS ) {
+            printf("%s: failed to run!\n", methods[i]);
+            ++failures;
+            continue;
+        }
+
+        printf("%s:\n", methods[i]);
+        printf("\task/tell: minimum %g after %d evaluations\n", ask_fx, ask_evals);
+        printf("\tcallback: minimum %g after %d evaluations\n", callback_fx, callback_evals);
+
+        if( ask_fx != callback_fx || ask_evals != callback_evals ) {
+            printf("\tResults differ!\n");
+            ++failures;
+        }
+    }
+
+    return failures;
+}
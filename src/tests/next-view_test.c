@@ -0,0 +1,101 @@
+/*
+ * next-view_test.c
+ * fnt: Numerical Toolbox
+ *
+ * Copyright (c) 2024 Bryan Franklin. All rights reserved.
+ */
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "../fnt.h"
+#include "../fnt_problems.h"
+
+#ifndef FNT_METHODS_DIR
+#define FNT_METHODS_DIR "."
+#endif /* FNT_METHODS_DIR */
+
+/* Minimize the Rosenbrock function, either copying each input vector or
+ * borrowing the method's own buffer. */
+int minimize(char *method, int use_view, fnt_vect_t *min_x, double *min_fx) {
+
+    void *fnt = NULL;
+    fnt_init(&fnt, FNT_METHODS_DIR "/methods");
+
+    if( fnt_set_method(fnt, method, 2) == FNT_FAILURE ) {
+        fprintf(stderr, "Failed to initialize method.\n");
+        return FNT_FAILURE;
+    }
+
+    /* allocate input for objective function */
+    fnt_vect_t x;
+    fnt_vect_calloc(&x, 2);
+
+    /* use the same random sequence for both runs */
+    srand(1);
+
+    /* loop as long as method is not complete */
+    while( fnt_done(fnt) == FNT_CONTINUE ) {
+
+        if( use_view ) {
+            /* borrow the next vector and hand the same one back */
+            fnt_vect_t *view = NULL;
+            if( fnt_next_view(fnt, &view) != FNT_SUCCESS ) { break; }
+
+            double fx = rosenbrock_2d(FNT_VECT_ELEM(*view, 0), FNT_VECT_ELEM(*view, 1));
+
+            if( fnt_set_value(fnt, view, fx) != FNT_SUCCESS ) { break; }
+        } else {
+            if( fnt_next(fnt, &x) != FNT_SUCCESS ) { break; }
+
+            double fx = rosenbrock_2d(FNT_VECT_ELEM(x, 0), FNT_VECT_ELEM(x, 1));
+
+            if( fnt_set_value(fnt, &x, fx) != FNT_SUCCESS ) { break; }
+        }
+    }
+
+    /* Get best result. */
+    int ret = FNT_SUCCESS;
+    if( fnt_result(fnt, "minimum x", min_x) != FNT_SUCCESS
+        || fnt_result(fnt, "minimum f", min_fx) != FNT_SUCCESS ) {
+        ret = FNT_FAILURE;
+    }
+
+    fnt_vect_free(&x);
+    fnt_free(&fnt);
+
+    return ret;
+}
+
+int main() {
+
+    char *methods[] = { "differential evolution", "nelder-mead" };
+    int failures = 0;
+
+    for(int i=0; i<2; ++i) {
+        fnt_vect_t copied_x, viewed_x;
+        double copied_fx = 0.0, viewed_fx = 0.0;
+        fnt_vect_calloc(&copied_x, 2);
+        fnt_vect_calloc(&viewed_x, 2);
+
+        minimize(methods[i], 0, &copied_x, &copied_fx);
+        minimize(methods[i], 1, &viewed_x, &viewed_fx);
+
+        printf("%s:\n", methods[i]);
+        fnt_vect_print(&copied_x, "\tcopied:   f(", NULL);
+        printf(") = %g\n", copied_fx);
+        fnt_vect_print(&viewed_x, "\tborrowed: f(", NULL);
+        printf(") = %g\n", viewed_fx);
+
+        if( copied_fx != viewed_fx
+            || FNT_VECT_ELEM(copied_x, 0) != FNT_VECT_ELEM(viewed_x, 0)
+            || FNT_VECT_ELEM(copied_x, 1) != FNT_VECT_ELEM(viewed_x, 1) ) {
+            printf("\tResults differ!\n");
+            ++failures;
+        }
+
+        fnt_vect_free(&copied_x);
+        fnt_vect_free(&viewed_x);
+    }
+
+    return failures;
+}
@@ -0,0 +1,146 @@
+/*
+ * parallel-tempering_test.c
+ * fnt: Numerical Toolbox
+ *
+ * Copyright (c) 2024 Bryan Franklin. All rights reserved.
+ */
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "../fnt.h"
+
+#ifndef FNT_METHODS_DIR
+#define FNT_METHODS_DIR "."
+#endif /* FNT_METHODS_DIR */
+
+#define DIMS        4
+#define CAPACITY    8
+
+/* Rastrigin function, many local minima, global minimum of zero at 0 */
+double rastrigin(fnt_vect_t *x) {
+    double sum = 10.0 * x->n;
+    for(int i=0; i<x->n; ++i) {
+        double xi = FNT_VECT_ELEM(*x, i);
+        sum += xi * xi - 10.0 * cos(6.283185307179586 * xi);
+    }
+    return sum;
+}
+
+int main() {
+
+    int failures = 0;
+    void *fnt = NULL;
+
+    fnt_verbose(FNT_INFO); /* request informative output */
+    fnt_init(&fnt, FNT_METHODS_DIR "/methods");
+
+    /* load parallel-tempering to minimize the Rastrigin function */
+    if( fnt_set_method(fnt, "parallel-tempering", DIMS) == FNT_FAILURE ) {
+        return 1;
+    }
+
+    /* display info */
+    fnt_info(fnt);
+
+    /* start from (3, ..., 3) within [-5.12, 5.12]^DIMS */
+    fnt_vect_t x[CAPACITY];
+    int tickets[CAPACITY];
+    for(int i=0; i<CAPACITY; ++i) { fnt_vect_calloc(&x[i], DIMS); }
+    for(int j=0; j<DIMS; ++j) { FNT_VECT_ELEM(x[0], j) = 3.0; }
+    fnt_hparam_set(fnt, "x0", &x[0]);
+    for(int j=0; j<DIMS; ++j) { FNT_VECT_ELEM(x[0], j) = -5.12; }
+    fnt_hparam_set(fnt, "lower", &x[0]);
+    for(int j=0; j<DIMS; ++j) { FNT_VECT_ELEM(x[0], j) = 5.12; }
+    fnt_hparam_set(fnt, "upper", &x[0]);
+
+    /* a single walk, kept cold */
+    int replicas = 1, max_rounds = 20000;
+    double t_min = 0.05, t_max = 20.0;
+    fnt_hparam_set(fnt, "replicas", &replicas);
+    fnt_hparam_set(fnt, "max_rounds", &max_rounds);
+    fnt_hparam_set(fnt, "t_min", &t_min);
+    fnt_hparam_set(fnt, "t_max", &t_min);
+
+    while( fnt_done(fnt) == FNT_CONTINUE ) {
+        if( fnt_next(fnt, &x[0]) != FNT_SUCCESS ) { break; }
+        if( fnt_set_value(fnt, &x[0], rastrigin(&x[0])) != FNT_SUCCESS ) { break; }
+    }
+
+    double cold_f = 0.0;
+    fnt_result(fnt, "minimum x", &x[0]);
+    fnt_result(fnt, "minimum f", &cold_f);
+    printf("single cold walk: minimum %g at ", cold_f);
+    fnt_vect_println(&x[0], NULL, NULL);
+
+    /* the cold walk stays in a local minimum */
+    if( cold_f < 1.0 ) {
+        printf("\tSingle cold walk unexpectedly found the global minimum!\n");
+        ++failures;
+    }
+
+    /* 8 replicas up to a hot temperature, each round as one batch */
+    replicas = 8;
+    fnt_hparam_set(fnt, "replicas", &replicas);
+    fnt_hparam_set(fnt, "t_max", &t_max);
+    fnt_reset(fnt);
+
+    while( fnt_done(fnt) == FNT_CONTINUE ) {
+        int count = 0;
+        if( fnt_next_batch(fnt, x, tickets, CAPACITY, &count) != FNT_SUCCESS
+            || count != replicas ) {
+            printf("\tExpected %d proposals, got %d.\n", replicas, count);
+            return 1;
+        }
+        for(int k=0; k<count; ++k) {
+            fnt_set_value_ticket(fnt, tickets[k], &x[k], rastrigin(&x[k]));
+        }
+    }
+
+    double min_f = 0.0;
+    int swaps = 0;
+    fnt_result(fnt, "minimum x", &x[0]);
+    fnt_result(fnt, "minimum f", &min_f);
+    fnt_result(fnt, "swaps", &swaps);
+    printf("8 replicas: %d swaps, minimum %g at ", swaps, min_f);
+    fnt_vect_println(&x[0], NULL, NULL);
+
+    /* tempering reaches the global minimum */
+    if( min_f > 0.01 ) {
+        printf("\tParallel tempering did not find the global minimum!\n");
+        ++failures;
+    }
+
+    /* again, reporting each round last to first */
+    fnt_reset(fnt);
+
+    while( fnt_done(fnt) == FNT_CONTINUE ) {
+        int count = 0;
+        if( fnt_next_batch(fnt, x, tickets, CAPACITY, &count) != FNT_SUCCESS
+            || count != replicas ) {
+            printf("\tExpected %d proposals, got %d.\n", replicas, count);
+            return 1;
+        }
+        for(int k=count-1; k>=0; --k) {
+            fnt_set_value_ticket(fnt, tickets[k], &x[k], rastrigin(&x[k]));
+        }
+    }
+
+    double reversed_f = 0.0;
+    fnt_result(fnt, "minimum f", &reversed_f);
+    fnt_result(fnt, "swaps", &swaps);
+    printf("8 replicas, reversed: %d swaps, minimum %g\n", swaps, reversed_f);
+
+    /* per-replica generators make the run independent of evaluation order */
+    if( reversed_f != min_f ) {
+        printf("\tReversed run differs from the in order run!\n");
+        ++failures;
+    }
+
+    /* free input vectors */
+    for(int i=0; i<CAPACITY; ++i) { fnt_vect_free(&x[i]); }
+
+    /* free the method */
+    fnt_free(&fnt);
+
+    return failures;
+}
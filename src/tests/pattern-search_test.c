@@ -0,0 +1,240 @@
+/*
+ * pattern-search_test.c
+ * fnt: Numerical Toolbox
+ *
+ * Copyright (c) 2024 Bryan Franklin. All rights reserved.
+ */
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "../fnt.h"
+
+#ifndef FNT_METHODS_DIR
+#define FNT_METHODS_DIR "."
+#endif /* FNT_METHODS_DIR */
+
+#define DIMS        10
+#define CAPACITY    (2*DIMS)
+
+/* non-smooth, minimum at x_i = 0.1*(i+1) */
+double l1(fnt_vect_t *x) {
+    double sum = 0.0;
+    for(int i=0; i<x->n; ++i) {
+        sum += fabs(FNT_VECT_ELEM(*x, i) - 0.1 * (i+1));
+    }
+    return sum;
+}
+
+int main() {
+
+    int failures = 0;
+    void *fnt = NULL;
+
+    fnt_verbose(FNT_INFO); /* request informative output */
+    fnt_init(&fnt, FNT_METHODS_DIR "/methods");
+
+    /* load pattern-search to minimize a non-smooth function */
+    if( fnt_set_method(fnt, "pattern-search", DIMS) == FNT_FAILURE ) {
+        return 1;
+    }
+
+    /* display info */
+    fnt_info(fnt);
+
+    /* allocate inputs for objective function */
+    fnt_vect_t x[CAPACITY];
+    int tickets[CAPACITY];
+    for(int i=0; i<CAPACITY; ++i) { fnt_vect_calloc(&x[i], DIMS); }
+
+    /* complete polls, taking 4 points at a time and reporting each batch
+     * last to first */
+    int opportunistic = 0;
+    fnt_hparam_set(fnt, "opportunistic", &opportunistic);
+    int capacity = 4;
+    int rounds = 0, evals = 0;
+    double err;
+    while( fnt_done(fnt) == FNT_CONTINUE ) {
+        int count = 0;
+        if( fnt_next_batch(fnt, x, tickets, capacity, &count) != FNT_SUCCESS
+            || count == 0 ) {
+            break;
+        }
+        for(int k=count-1; k>=0; --k) {
+            fnt_set_value_ticket(fnt, tickets[k], &x[k], l1(&x[k]));
+        }
+        ++rounds;
+    }
+    fnt_result(fnt, "minimum x", &x[0]);
+    fnt_result(fnt, "evaluations", &evals);
+    err = 0.0;
+    for(int i=0; i<DIMS; ++i) {
+        err = fmax(err, fabs(FNT_VECT_ELEM(x[0], i) - 0.1 * (i+1)));
+    }
+    printf("complete polls, 4 wide: %d rounds, %d evaluations, max error %g\n", rounds, evals, err);
+    if( err > 1e-5 ) {
+        printf("\tDid not reach the minimum!\n");
+        ++failures;
+    }
+    int complete_evals = evals;
+
+    /* accepting the first improvement skips the rest of the poll */
+    opportunistic = 1;
+    fnt_hparam_set(fnt, "opportunistic", &opportunistic);
+    fnt_reset(fnt);
+    rounds = 0;
+    while( fnt_done(fnt) == FNT_CONTINUE ) {
+        int count = 0;
+        if( fnt_next_batch(fnt, x, tickets, capacity, &count) != FNT_SUCCESS
+            || count == 0 ) {
+            break;
+        }
+        for(int k=count-1; k>=0; --k) {
+            fnt_set_value_ticket(fnt, tickets[k], &x[k], l1(&x[k]));
+        }
+        ++rounds;
+    }
+    fnt_result(fnt, "minimum x", &x[0]);
+    fnt_result(fnt, "evaluations", &evals);
+    err = 0.0;
+    for(int i=0; i<DIMS; ++i) {
+        err = fmax(err, fabs(FNT_VECT_ELEM(x[0], i) - 0.1 * (i+1)));
+    }
+    printf("opportunistic, 4 wide: %d rounds, %d evaluations, max error %g\n", rounds, evals, err);
+    if( err > 1e-5 ) {
+        printf("\tDid not reach the minimum!\n");
+        ++failures;
+    }
+    if( evals >= complete_evals ) {
+        printf("\tOpportunistic polling took %d evaluations, complete polls %d!\n",
+                evals, complete_evals);
+        ++failures;
+    }
+
+    /* whole polls in one batch */
+    capacity = CAPACITY;
+    fnt_reset(fnt);
+    rounds = 0;
+    while( fnt_done(fnt) == FNT_CONTINUE ) {
+        int count = 0;
+        if( fnt_next_batch(fnt, x, tickets, capacity, &count) != FNT_SUCCESS
+            || count == 0 ) {
+            break;
+        }
+        for(int k=count-1; k>=0; --k) {
+            fnt_set_value_ticket(fnt, tickets[k], &x[k], l1(&x[k]));
+        }
+        ++rounds;
+    }
+    fnt_result(fnt, "minimum x", &x[0]);
+    fnt_result(fnt, "evaluations", &evals);
+    err = 0.0;
+    for(int i=0; i<DIMS; ++i) {
+        err = fmax(err, fabs(FNT_VECT_ELEM(x[0], i) - 0.1 * (i+1)));
+    }
+    printf("opportunistic, whole polls: %d rounds, %d evaluations, max error %g\n", rounds, evals, err);
+    if( err > 1e-5 ) {
+        printf("\tDid not reach the minimum!\n");
+        ++failures;
+    }
+
+    /* randomly oriented polls */
+    int mads = 1;
+    fnt_hparam_set(fnt, "mads", &mads);
+    fnt_reset(fnt);
+    rounds = 0;
+    while( fnt_done(fnt) == FNT_CONTINUE ) {
+        int count = 0;
+        if( fnt_next_batch(fnt, x, tickets, capacity, &count) != FNT_SUCCESS
+            || count == 0 ) {
+            break;
+        }
+        for(int k=count-1; k>=0; --k) {
+            fnt_set_value_ticket(fnt, tickets[k], &x[k], l1(&x[k]));
+        }
+        ++rounds;
+    }
+    fnt_result(fnt, "minimum x", &x[0]);
+    fnt_result(fnt, "evaluations", &evals);
+    err = 0.0;
+    for(int i=0; i<DIMS; ++i) {
+        err = fmax(err, fabs(FNT_VECT_ELEM(x[0], i) - 0.1 * (i+1)));
+    }
+    printf("mads: %d rounds, %d evaluations, max error %g\n", rounds, evals, err);
+    if( err > 1e-5 ) {
+        printf("\tDid not reach the minimum!\n");
+        ++failures;
+    }
+
+    /* below an upper bound of 0.5, which cuts off the later coordinates */
+    mads = 0;
+    fnt_hparam_set(fnt, "mads", &mads);
+    for(int i=0; i<DIMS; ++i) { FNT_VECT_ELEM(x[0], i) = 0.5; }
+    fnt_hparam_set(fnt, "upper", &x[0]);
+    fnt_reset(fnt);
+    rounds = 0;
+    while( fnt_done(fnt) == FNT_CONTINUE ) {
+        int count = 0;
+        if( fnt_next_batch(fnt, x, tickets, capacity, &count) != FNT_SUCCESS
+            || count == 0 ) {
+            break;
+        }
+        for(int k=count-1; k>=0; --k) {
+            fnt_set_value_ticket(fnt, tickets[k], &x[k], l1(&x[k]));
+        }
+        ++rounds;
+    }
+    fnt_result(fnt, "minimum x", &x[0]);
+    fnt_result(fnt, "evaluations", &evals);
+    err = 0.0;
+    for(int i=0; i<DIMS; ++i) {
+        err = fmax(err, fabs(FNT_VECT_ELEM(x[0], i) - fmin(0.1 * (i+1), 0.5)));
+    }
+    printf("opportunistic, bounded: %d rounds, %d evaluations, max error %g\n", rounds, evals, err);
+    if( err > 1e-5 ) {
+        printf("\tDid not reach the minimum!\n");
+        ++failures;
+    }
+
+    /* bounds that pin every coordinate fold the whole poll onto the centre,
+     * which must still finish */
+    for(int i=0; i<DIMS; ++i) { FNT_VECT_ELEM(x[0], i) = 0.3; }
+    fnt_hparam_set(fnt, "lower", &x[0]);
+    fnt_hparam_set(fnt, "upper", &x[0]);
+    fnt_hparam_set(fnt, "x0", &x[0]);
+    fnt_reset(fnt);
+    rounds = 0;
+    while( fnt_done(fnt) == FNT_CONTINUE ) {
+        int count = 0;
+        if( fnt_next_batch(fnt, x, tickets, capacity, &count) != FNT_SUCCESS
+            || count == 0 ) {
+            break;
+        }
+        for(int k=count-1; k>=0; --k) {
+            fnt_set_value_ticket(fnt, tickets[k], &x[k], l1(&x[k]));
+        }
+        ++rounds;
+    }
+    fnt_result(fnt, "minimum x", &x[0]);
+    fnt_result(fnt, "evaluations", &evals);
+    err = 0.0;
+    for(int i=0; i<DIMS; ++i) {
+        err = fmax(err, fabs(FNT_VECT_ELEM(x[0], i) - 0.3));
+    }
+    printf("pinned by bounds: %d rounds, %d evaluations, max error %g\n", rounds, evals, err);
+    if( err > 0.0 ) {
+        printf("\tDid not reach the minimum!\n");
+        ++failures;
+    }
+    if( fnt_done(fnt) != FNT_DONE ) {
+        printf("\tPinned search did not finish!\n");
+        ++failures;
+    }
+
+    /* free input vectors */
+    for(int i=0; i<CAPACITY; ++i) { fnt_vect_free(&x[i]); }
+
+    /* free the method */
+    fnt_free(&fnt);
+
+    return failures;
+}
@@ -0,0 +1,125 @@
+/*
+ * powell_test.c
+ * fnt: Numerical Toolbox
+ *
+ * Copyright (c) 2024 Bryan Franklin. All rights reserved.
+ */
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "../fnt.h"
+#include "../fnt_problems.h"
+
+#ifndef FNT_METHODS_DIR
+#define FNT_METHODS_DIR "."
+#endif /* FNT_METHODS_DIR */
+
+/* coupled quadratic, minimum at all ones */
+double coupled(fnt_vect_t *x, void *user) {
+    double sum = 0.0;
+    for(int i=0; i<x->n; ++i) {
+        double d = FNT_VECT_ELEM(*x, i) - 1.0;
+        sum += (1.0 + 0.1 * i) * d * d;
+        if( i > 0 ) {
+            double c = FNT_VECT_ELEM(*x, i) - FNT_VECT_ELEM(*x, i-1);
+            sum += c * c;
+        }
+    }
+    return sum;
+}
+
+int main() {
+
+    int failures = 0;
+    void *fnt = NULL;
+
+    fnt_verbose(FNT_INFO); /* request informative output */
+    fnt_init(&fnt, FNT_METHODS_DIR "/methods");
+
+    /* load powell to minimize Rosenbrock function */
+    if( fnt_set_method(fnt, "powell", 2) == FNT_FAILURE ) {
+        return 1;
+    }
+
+    /* display info */
+    fnt_info(fnt);
+
+    /* allocate input for objective function, starting at (-1, -1) */
+    fnt_vect_t x;
+    fnt_vect_calloc(&x, 2);
+    FNT_VECT_ELEM(x, 0) = FNT_VECT_ELEM(x, 1) = -1.0;
+    fnt_hparam_set(fnt, "x0", &x);
+
+    /* loop as long as method is not complete */
+    int evals = 0;
+    while( fnt_done(fnt) == FNT_CONTINUE ) {
+
+        /* get vector to try */
+        if( fnt_next(fnt, &x) != FNT_SUCCESS ) { break; }
+
+        /* call objective function */
+        double fx = rosenbrock_2d(FNT_VECT_ELEM(x, 0), FNT_VECT_ELEM(x, 1));
+        ++evals;
+
+        /* update method */
+        if( fnt_set_value(fnt, &x, fx) != FNT_SUCCESS ) { break; }
+    }
+
+    /* Get best result. */
+    double min_fx = 0.0;
+    if( fnt_result(fnt, "minimum x", &x) != FNT_SUCCESS
+        || fnt_result(fnt, "minimum f", &min_fx) != FNT_SUCCESS ) {
+        printf("\tRosenbrock run failed!\n");
+        return 1;
+    }
+    fnt_vect_print(&x, "Minimum found at f(", NULL);
+    printf(") = %g after %d evaluations\n", min_fx, evals);
+    if( fabs(FNT_VECT_ELEM(x, 0) - 1.0) > 1e-4 || fabs(FNT_VECT_ELEM(x, 1) - 1.0) > 1e-4 ) {
+        printf("\tDid not reach the minimum!\n");
+        ++failures;
+    }
+    if( evals > 2000 ) {
+        printf("\tMore than 2000 evaluations!\n");
+        ++failures;
+    }
+
+    fnt_vect_free(&x);
+    fnt_free(&fnt);
+
+    /* load powell to minimize a 30 dimensional coupled quadratic */
+    fnt_init(&fnt, FNT_METHODS_DIR "/methods");
+    if( fnt_set_method(fnt, "powell", 30) == FNT_FAILURE ) {
+        return 1;
+    }
+
+    /* start from x_i = -2 */
+    fnt_vect_calloc(&x, 30);
+    for(int i=0; i<30; ++i) { FNT_VECT_ELEM(x, i) = -2.0; }
+    fnt_hparam_set(fnt, "x0", &x);
+
+    if( fnt_minimize(fnt, coupled, NULL) != FNT_SUCCESS
+        || fnt_result(fnt, "minimum x", &x) != FNT_SUCCESS ) {
+        printf("\tCoupled quadratic run failed!\n");
+        return 1;
+    }
+    fnt_result(fnt, "evaluations", &evals);
+    double err = 0.0;
+    for(int i=0; i<30; ++i) { err = fmax(err, fabs(FNT_VECT_ELEM(x, i) - 1.0)); }
+    printf("coupled quadratic (30 dims): %d evaluations, max error %g\n", evals, err);
+    if( err > 1e-4 ) {
+        printf("\tDid not reach the minimum!\n");
+        ++failures;
+    }
+    if( evals > 20000 ) {
+        printf("\tMore than 20000 evaluations!\n");
+        ++failures;
+    }
+
+    /* free input vector */
+    fnt_vect_free(&x);
+
+    /* free the method */
+    fnt_free(&fnt);
+
+    return failures;
+}
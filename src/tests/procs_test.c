@@ -0,0 +1,144 @@
+/*
+ * procs_test.c
+ * fnt: Numerical Toolbox
+ *
+ * Copyright (c) 2024 Bryan Franklin. All rights reserved.
+ */
+#include <math.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include "../fnt.h"
+#include "../fnt_problems.h"
+
+#ifndef FNT_METHODS_DIR
+#define FNT_METHODS_DIR "."
+#endif /* FNT_METHODS_DIR */
+
+#define WORKERS     4
+#define DIMS        16
+#define CRASH_EVERY 7
+
+pid_t parent = 0;
+int *evaluations = NULL;    /* shared by every worker */
+
+/* Stands in for a legacy objective that occasionally takes its process
+ * down.  Workers die on every CRASH_EVERY-th evaluation made by any of
+ * them, or on every evaluation when user points at a non-zero int.  The
+ * count is shared so the retry of a crashed input is never the next one to
+ * crash, however inputs are spread over the workers. */
+void maybe_crash(void *user) {
+    if( getpid() == parent )    { return; }
+    if( (user != NULL && *(int*)user)
+        || __atomic_add_fetch(evaluations, 1, __ATOMIC_RELAXED) % CRASH_EVERY == 0 ) {
+        raise(SIGKILL);
+    }
+}
+
+double quadratic(fnt_vect_t *x, void *user) {
+    maybe_crash(user);
+
+    double sum = 0.0;
+    for(int i=0; i<x->n; ++i) {
+        sum += (i+1) * FNT_VECT_ELEM(*x, i) * FNT_VECT_ELEM(*x, i);
+    }
+    return sum;
+}
+
+double banana(fnt_vect_t *x, void *user) {
+    maybe_crash(user);
+
+    return rosenbrock_2d(FNT_VECT_ELEM(*x, 0), FNT_VECT_ELEM(*x, 1));
+}
+
+/* Run method once through the worker pool and once in process, comparing
+ * the named vector result.  start names the starting point hparam, if any. */
+int compare(char *method, int dims, fnt_objective_t objective, char *start, char *result) {
+    int failures = 0;
+    void *procs = NULL;
+    if( fnt_procs_init(&procs, WORKERS, dims, objective, NULL) != FNT_SUCCESS ) {
+        printf("\tFailed to start workers!\n");
+        return 1;
+    }
+
+    void *fnt[2] = { NULL, NULL };
+    fnt_vect_t x[2];
+    for(int k=0; k<2; ++k) {
+        fnt_init(&fnt[k], FNT_METHODS_DIR "/methods");
+        if( fnt_set_method(fnt[k], method, dims) == FNT_FAILURE ) {
+            return 1;
+        }
+        fnt_vect_calloc(&x[k], dims);
+        for(int i=0; i<dims; ++i) { FNT_VECT_ELEM(x[k], i) = 1.0 + 0.1 * i; }
+        if( start != NULL ) { fnt_hparam_set(fnt[k], start, &x[k]); }
+    }
+
+    if( fnt_procs_minimize(procs, fnt[0]) != FNT_SUCCESS ) {
+        printf("\t%s failed in worker processes!\n", method);
+        ++failures;
+    }
+    fnt_minimize(fnt[1], objective, NULL);
+
+    int restarts = 0;
+    fnt_procs_restarts(procs, &restarts);
+    for(int k=0; k<2; ++k) { fnt_result(fnt[k], result, &x[k]); }
+    printf("%s: %s[0] = %g after %d worker restarts\n",
+            method, result, FNT_VECT_ELEM(x[0], 0), restarts);
+    for(int i=0; i<dims; ++i) {
+        if( FNT_VECT_ELEM(x[0], i) != FNT_VECT_ELEM(x[1], i) ) {
+            printf("\t%s[%d] differs: %g in workers, %g in process!\n",
+                    result, i, FNT_VECT_ELEM(x[0], i), FNT_VECT_ELEM(x[1], i));
+            ++failures;
+        }
+    }
+    if( restarts == 0 ) {
+        printf("\tNo worker was restarted!\n");
+        ++failures;
+    }
+
+    for(int k=0; k<2; ++k) {
+        fnt_vect_free(&x[k]);
+        fnt_free(&fnt[k]);
+    }
+    fnt_procs_free(&procs);
+
+    return failures;
+}
+
+int main() {
+
+    int failures = 0;
+    parent = getpid();
+    evaluations = mmap(NULL, sizeof(int), PROT_READ | PROT_WRITE,
+            MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if( evaluations == MAP_FAILED ) { return 1; }
+
+    /* MARK: Batches of inputs */
+    failures += compare("gradient estimate", DIMS, quadratic, "x0", "gradient");
+
+    /* MARK: Batches of one, nelder-mead does not speculate by default */
+    failures += compare("nelder-mead", 2, banana, NULL, "minimum x");
+
+    /* MARK: One input at a time, powell has no next_batch */
+    failures += compare("powell", 2, banana, "x0", "minimum x");
+
+    /* MARK: An input that always crashes its worker */
+    void *procs = NULL;
+    int always = 1;
+    fnt_procs_init(&procs, 2, DIMS, quadratic, &always);
+    void *fnt = NULL;
+    fnt_init(&fnt, FNT_METHODS_DIR "/methods");
+    fnt_set_method(fnt, "gradient estimate", DIMS);
+    if( fnt_procs_minimize(procs, fnt) != FNT_FAILURE ) {
+        printf("\tInput that kills every worker was not reported!\n");
+        ++failures;
+    } else {
+        printf("poison input reported after repeated crashes\n");
+    }
+    fnt_free(&fnt);
+    fnt_procs_free(&procs);
+
+    return failures;
+}
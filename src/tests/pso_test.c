@@ -0,0 +1,135 @@
+/*
+ * pso_test.c
+ * fnt: Numerical Toolbox
+ *
+ * Copyright (c) 2024 Bryan Franklin. All rights reserved.
+ */
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "../fnt.h"
+#include "../fnt_problems.h"
+
+#ifndef FNT_METHODS_DIR
+#define FNT_METHODS_DIR "."
+#endif /* FNT_METHODS_DIR */
+
+#define DIMS    10
+#define SWARM   30
+
+/* shifted sphere, minimum of zero at x_i = 0.1 * i */
+double shifted_sphere(fnt_vect_t *x) {
+    double sum = 0.0;
+    for(int i=0; i<x->n; ++i) {
+        double d = FNT_VECT_ELEM(*x, i) - 0.1 * i;
+        sum += d * d;
+    }
+    return sum;
+}
+
+int main() {
+
+    int failures = 0;
+    void *fnt = NULL;
+
+    srand(1);
+    fnt_verbose(FNT_INFO); /* request informative output */
+    fnt_init(&fnt, FNT_METHODS_DIR "/methods");
+
+    /* load pso to minimize a shifted sphere */
+    if( fnt_set_method(fnt, "pso", DIMS) == FNT_FAILURE ) {
+        return 1;
+    }
+
+    /* display info */
+    fnt_info(fnt);
+
+    /* set swarm size and iteration count */
+    int swarm = SWARM, max_iter = 400;
+    fnt_hparam_set(fnt, "swarm", &swarm);
+    fnt_hparam_set(fnt, "max_iter", &max_iter);
+
+    /* search within [-5, 5]^DIMS */
+    fnt_vect_t x[SWARM];
+    int tickets[SWARM];
+    for(int i=0; i<SWARM; ++i) { fnt_vect_calloc(&x[i], DIMS); }
+    for(int j=0; j<DIMS; ++j) { FNT_VECT_ELEM(x[0], j) = -5.0; }
+    fnt_hparam_set(fnt, "lower", &x[0]);
+    for(int j=0; j<DIMS; ++j) { FNT_VECT_ELEM(x[0], j) = 5.0; }
+    fnt_hparam_set(fnt, "upper", &x[0]);
+
+    /* constricted velocities with each neighbourhood topology, where
+     * sparser neighbourhoods converge more slowly */
+    char *topologies[] = { "global", "ring", "von Neumann" };
+    double tolerance[] = { 1e-10, 1e-6, 1e-8 };
+    int constriction = 1;
+    fnt_hparam_set(fnt, "constriction", &constriction);
+    for(int topology=0; topology<3; ++topology) {
+        fnt_hparam_set(fnt, "topology", &topology);
+        fnt_reset(fnt);
+
+        /* evaluate each iteration's swarm as one batch */
+        int rounds = 0, evals = 0;
+        while( fnt_done(fnt) == FNT_CONTINUE ) {
+            int count = 0;
+            if( fnt_next_batch(fnt, x, tickets, SWARM, &count) != FNT_SUCCESS
+                || count != SWARM ) {
+                printf("\tExpected the whole swarm, got %d particles.\n", count);
+                return 1;
+            }
+            for(int k=count-1; k>=0; --k) {
+                fnt_set_value_ticket(fnt, tickets[k], &x[k], shifted_sphere(&x[k]));
+            }
+            ++rounds;
+        }
+
+        double min_f = -1.0;
+        fnt_result(fnt, "minimum f", &min_f);
+        fnt_result(fnt, "evaluations", &evals);
+        printf("constriction, %s: %d rounds, %d evaluations, minimum %g\n",
+                topologies[topology], rounds, evals, min_f);
+        if( min_f < 0.0 || min_f > tolerance[topology] ) {
+            printf("\tDid not reach the minimum!\n");
+            ++failures;
+        }
+        if( rounds != 400 || evals != 400 * SWARM ) {
+            printf("\tExpected one batch of %d per iteration!\n", SWARM);
+            ++failures;
+        }
+    }
+
+    /* inertia weight instead of constriction, with the global topology */
+    int topology = 0;
+    constriction = 0;
+    fnt_hparam_set(fnt, "topology", &topology);
+    fnt_hparam_set(fnt, "constriction", &constriction);
+    fnt_reset(fnt);
+
+    /* loop as long as method is not complete */
+    while( fnt_done(fnt) == FNT_CONTINUE ) {
+        int count = 0;
+        if( fnt_next_batch(fnt, x, tickets, SWARM, &count) != FNT_SUCCESS ) { break; }
+        for(int k=0; k<count; ++k) {
+            fnt_set_value_ticket(fnt, tickets[k], &x[k], shifted_sphere(&x[k]));
+        }
+    }
+
+    /* Get best result. */
+    double min_f = -1.0;
+    fnt_result(fnt, "minimum x", &x[0]);
+    fnt_result(fnt, "minimum f", &min_f);
+    fnt_vect_print(&x[0], "inertia weight, global: minimum found at f(", "%.4f");
+    printf(") = %g\n", min_f);
+    if( min_f < 0.0 || min_f > 1e-6 ) {
+        printf("\tDid not reach the minimum!\n");
+        ++failures;
+    }
+
+    /* free input vectors */
+    for(int i=0; i<SWARM; ++i) { fnt_vect_free(&x[i]); }
+
+    /* free the method */
+    fnt_free(&fnt);
+
+    return failures;
+}
@@ -0,0 +1,141 @@
+/*
+ * reset_test.c
+ * fnt: Numerical Toolbox
+ *
+ * Copyright (c) 2024 Bryan Franklin. All rights reserved.
+ */
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "../fnt.h"
+#include "../fnt_problems.h"
+
+#ifndef FNT_METHODS_DIR
+#define FNT_METHODS_DIR "."
+#endif /* FNT_METHODS_DIR */
+
+double polynomial(double x) {
+    // 3x^3 - 5x^2 - 6x + 5
+    return 3*pow(x, 3.0) - 5*pow(x,2.0) - 6*x + 5;
+}
+
+int main() {
+
+    int failures = 0;
+    void *fnt = NULL;
+
+    fnt_verbose(FNT_INFO); /* request informative output */
+    fnt_init(&fnt, FNT_METHODS_DIR "/methods");
+
+    /* load brent-dekker to find a root of the polynomial */
+    if( fnt_set_method(fnt, "brent-dekker", 1) == FNT_FAILURE ) {
+        return 1;
+    }
+
+    /* display info */
+    fnt_info(fnt);
+
+    /* set the search region, which a reset must keep */
+    double x_0 = 2.0;
+    double x_1 = 3.0;
+    fnt_hparam_set(fnt, "x_0", &x_0);
+    fnt_hparam_set(fnt, "x_1", &x_1);
+
+    /* allocate input for objective function */
+    fnt_vect_t x;
+    fnt_vect_calloc(&x, 1);
+
+    /* find the root twice, resetting in between */
+    double roots[2];
+    int evals[2] = { 0, 0 };
+    for(int run=0; run<2; ++run) {
+        if( run > 0 && fnt_reset(fnt) != FNT_SUCCESS ) { return 1; }
+
+        while( fnt_done(fnt) == FNT_CONTINUE ) {
+            if( fnt_next(fnt, &x) != FNT_SUCCESS ) { break; }
+            double fx = polynomial(FNT_VECT_ELEM(x, 0));
+            ++evals[run];
+            if( fnt_set_value(fnt, &x, fx) != FNT_SUCCESS ) { break; }
+        }
+
+        fnt_result(fnt, "root", &roots[run]);
+        printf("brent-dekker run %d: root %.6f after %d evaluations\n", run, roots[run], evals[run]);
+    }
+    if( roots[0] != roots[1] || evals[0] != evals[1] ) {
+        printf("\tResults differ after reset!\n");
+        ++failures;
+    }
+    fnt_vect_free(&x);
+    fnt_free(&fnt);
+
+    /* load differential evolution to minimize Rosenbrock function */
+    fnt_init(&fnt, FNT_METHODS_DIR "/methods");
+    if( fnt_set_method(fnt, "differential evolution", 2) == FNT_FAILURE ) {
+        return 1;
+    }
+    fnt_info(fnt);
+
+    /* a reset must keep these generation and population settings */
+    int iterations = 200;
+    int NP = 15;
+    fnt_hparam_set(fnt, "iters", &iterations);
+    fnt_hparam_set(fnt, "NP", &NP);
+
+    /* minimize twice from the same random sequence */
+    fnt_vect_calloc(&x, 2);
+    double min_fx[2];
+    for(int run=0; run<2; ++run) {
+        if( run > 0 && fnt_reset(fnt) != FNT_SUCCESS ) { return 1; }
+
+        srand(1);
+        evals[run] = 0;
+        while( fnt_done(fnt) == FNT_CONTINUE ) {
+            if( fnt_next(fnt, &x) != FNT_SUCCESS ) { break; }
+            double fx = rosenbrock_2d(FNT_VECT_ELEM(x, 0), FNT_VECT_ELEM(x, 1));
+            ++evals[run];
+            if( fnt_set_value(fnt, &x, fx) != FNT_SUCCESS ) { break; }
+        }
+
+        fnt_result(fnt, "minimum f", &min_fx[run]);
+        printf("differential evolution run %d: minimum %g after %d evaluations\n", run, min_fx[run], evals[run]);
+    }
+    if( min_fx[0] != min_fx[1] || evals[0] != evals[1] ) {
+        printf("\tResults differ after reset!\n");
+        ++failures;
+    }
+    fnt_free(&fnt);
+
+    /* nelder-mead must rebuild the same simplex after a reset */
+    fnt_init(&fnt, FNT_METHODS_DIR "/methods");
+    if( fnt_set_method(fnt, "nelder-mead", 2) == FNT_FAILURE ) {
+        return 1;
+    }
+    fnt_info(fnt);
+
+    for(int run=0; run<2; ++run) {
+        if( run > 0 && fnt_reset(fnt) != FNT_SUCCESS ) { return 1; }
+
+        evals[run] = 0;
+        while( fnt_done(fnt) == FNT_CONTINUE ) {
+            if( fnt_next(fnt, &x) != FNT_SUCCESS ) { break; }
+            double fx = rosenbrock_2d(FNT_VECT_ELEM(x, 0), FNT_VECT_ELEM(x, 1));
+            ++evals[run];
+            if( fnt_set_value(fnt, &x, fx) != FNT_SUCCESS ) { break; }
+        }
+
+        fnt_result(fnt, "minimum f", &min_fx[run]);
+        printf("nelder-mead run %d: minimum %g after %d evaluations\n", run, min_fx[run], evals[run]);
+    }
+    if( min_fx[0] != min_fx[1] || evals[0] != evals[1] ) {
+        printf("\tResults differ after reset!\n");
+        ++failures;
+    }
+
+    /* free input vector */
+    fnt_vect_free(&x);
+
+    /* free the method */
+    fnt_free(&fnt);
+
+    return failures;
+}
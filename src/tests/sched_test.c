@@ -0,0 +1,155 @@
+/*
+ * sched_test.c
+ * fnt: Numerical Toolbox
+ *
+ * Copyright (c) 2024 Bryan Franklin. All rights reserved.
+ */
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include "../fnt.h"
+#include "../fnt_problems.h"
+
+#ifndef FNT_METHODS_DIR
+#define FNT_METHODS_DIR "."
+#endif /* FNT_METHODS_DIR */
+
+#define STARTS  8
+#define DIMS    24
+
+void *sched = NULL;
+
+/* MARK: Recursive spawning */
+
+typedef struct fib_task {
+    int n;
+    long result;
+} fib_task_t;
+
+void fib(void *arg) {
+    fib_task_t *task = arg;
+    if( task->n < 2 ) {
+        task->result = task->n;
+        return;
+    }
+
+    fib_task_t a = { task->n - 1, 0 };
+    fib_task_t b = { task->n - 2, 0 };
+    int group = 0;
+    fnt_sched_spawn(sched, &group, fib, &a);
+    fib(&b);
+    fnt_sched_wait(sched, &group);
+
+    task->result = a.result + b.result;
+}
+
+/* MARK: Multi-start gradient estimates, each a batch of DIMS+1 inputs */
+
+double objective(fnt_vect_t *x, void *user) {
+    double sum = 0.0;
+    for(int i=0; i<x->n; ++i) {
+        sum += (i+1) * FNT_VECT_ELEM(*x, i) * FNT_VECT_ELEM(*x, i);
+    }
+    return sum;
+}
+
+typedef struct start_task {
+    int start;
+    int use_sched;
+    fnt_vect_t gradient;
+    int ret;
+} start_task_t;
+
+void run_start(void *arg) {
+    start_task_t *task = arg;
+
+    void *fnt = NULL;
+    fnt_init(&fnt, FNT_METHODS_DIR "/methods");
+    if( fnt_set_method(fnt, "gradient estimate", DIMS) == FNT_FAILURE ) {
+        task->ret = FNT_FAILURE;
+        return;
+    }
+
+    fnt_vect_t x0;
+    fnt_vect_calloc(&x0, DIMS);
+    for(int i=0; i<DIMS; ++i) { FNT_VECT_ELEM(x0, i) = task->start + 0.1 * i; }
+    fnt_hparam_set(fnt, "x0", &x0);
+
+    if( task->use_sched ) {
+        task->ret = fnt_sched_minimize(sched, fnt, objective, NULL);
+    } else {
+        task->ret = fnt_minimize(fnt, objective, NULL);
+    }
+    fnt_result(fnt, "gradient", &task->gradient);
+
+    fnt_vect_free(&x0);
+    fnt_free(&fnt);
+}
+
+int main() {
+
+    int failures = 0;
+
+    if( fnt_sched_init(&sched, 4) != FNT_SUCCESS ) {
+        return 1;
+    }
+
+    fib_task_t task = { 20, 0 };
+    int group = 0;
+    fnt_sched_spawn(sched, &group, fib, &task);
+    fnt_sched_wait(sched, &group);
+    printf("fib(%d) = %ld\n", task.n, task.result);
+    if( task.result != 6765 ) {
+        printf("\tWrong result!\n");
+        ++failures;
+    }
+
+    /* with nothing to do, workers park instead of spinning */
+    clock_t used = clock();
+    usleep(200000);
+    used = clock() - used;
+    printf("idle pool used %g s of processor time in 0.2 s\n", (double)used / CLOCKS_PER_SEC);
+    if( used > CLOCKS_PER_SEC / 200 ) {
+        printf("\tIdle workers kept the processor busy!\n");
+        ++failures;
+    }
+
+    /* outer runs in parallel, each spreading its own batch over the pool */
+    start_task_t nested[STARTS], sequential[STARTS];
+    group = 0;
+    for(int i=0; i<STARTS; ++i) {
+        nested[i].start = sequential[i].start = i;
+        nested[i].use_sched = 1;
+        sequential[i].use_sched = 0;
+        fnt_vect_calloc(&nested[i].gradient, DIMS);
+        fnt_vect_calloc(&sequential[i].gradient, DIMS);
+
+        fnt_sched_spawn(sched, &group, run_start, &nested[i]);
+    }
+    fnt_sched_wait(sched, &group);
+
+    for(int i=0; i<STARTS; ++i) {
+        run_start(&sequential[i]);
+
+        printf("start %d: d/dx_0 = %g\n", i, FNT_VECT_ELEM(nested[i].gradient, 0));
+        if( nested[i].ret != FNT_SUCCESS ) {
+            printf("\tNested run failed!\n");
+            ++failures;
+        }
+        for(int j=0; j<DIMS; ++j) {
+            if( FNT_VECT_ELEM(nested[i].gradient, j) != FNT_VECT_ELEM(sequential[i].gradient, j) ) {
+                printf("\tResults differ from sequential run!\n");
+                ++failures;
+                break;
+            }
+        }
+        fnt_vect_free(&nested[i].gradient);
+        fnt_vect_free(&sequential[i].gradient);
+    }
+
+    fnt_sched_free(&sched);
+
+    return failures;
+}
@@ -0,0 +1,143 @@
+/*
+ * sparse-jacobian_test.c
+ * fnt: Numerical Toolbox
+ *
+ * Copyright (c) 2024 Bryan Franklin. All rights reserved.
+ */
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "../fnt.h"
+
+#ifndef FNT_METHODS_DIR
+#define FNT_METHODS_DIR "."
+#endif /* FNT_METHODS_DIR */
+
+#define DIMS        200
+#define CAPACITY    16
+
+/* Broyden's tridiagonal system, each residual depends on three inputs. */
+void tridiagonal(fnt_vect_t *x, fnt_vect_t *r) {
+    int n = x->n;
+    for(int i=0; i<n; ++i) {
+        double xi = FNT_VECT_ELEM(*x, i);
+        double prev = i > 0 ? FNT_VECT_ELEM(*x, i-1) : 0.0;
+        double next = i < n-1 ? FNT_VECT_ELEM(*x, i+1) : 0.0;
+        FNT_VECT_ELEM(*r, i) = (3.0 - 2.0 * xi) * xi - prev - 2.0 * next + 1.0;
+    }
+}
+
+/* Estimate the Jacobian at x0, in batches, returning the number of
+ * evaluations used or -1 on failure. */
+int estimate(fnt_vect_t *x0, fnt_vect_t *pattern, fnt_vect_t *jacobian, int *colors) {
+
+    void *fnt = NULL;
+    fnt_init(&fnt, FNT_METHODS_DIR "/methods");
+    if( fnt_set_method(fnt, "gradient estimate", DIMS) == FNT_FAILURE ) {
+        return -1;
+    }
+    double step = 1e-7;
+    fnt_hparam_set(fnt, "step", &step);
+    fnt_hparam_set(fnt, "x0", x0);
+    if( pattern != NULL && fnt_hparam_set(fnt, "sparsity", pattern) != FNT_SUCCESS ) {
+        fnt_free(&fnt);
+        return -1;
+    }
+
+    fnt_vect_t x[CAPACITY], r;
+    int tickets[CAPACITY];
+    for(int i=0; i<CAPACITY; ++i) { fnt_vect_calloc(&x[i], DIMS); }
+    fnt_vect_calloc(&r, DIMS);
+
+    int evals = 0;
+    while( evals >= 0 && fnt_done(fnt) == FNT_CONTINUE ) {
+        int count = 0;
+        if( fnt_next_batch(fnt, x, tickets, CAPACITY, &count) != FNT_SUCCESS
+            || count == 0 ) {
+            evals = -1;
+            break;
+        }
+        for(int i=0; i<count; ++i) {
+            tridiagonal(&x[i], &r);
+            if( fnt_set_value_residual(fnt, &x[i], &r, NULL) != FNT_SUCCESS ) {
+                evals = -1;
+                break;
+            }
+        }
+        evals += count;
+    }
+    if( evals >= 0 ) {
+        fnt_result(fnt, "jacobian", jacobian);
+        fnt_result(fnt, "colors", colors);
+    }
+
+    for(int i=0; i<CAPACITY; ++i) { fnt_vect_free(&x[i]); }
+    fnt_vect_free(&r);
+    fnt_free(&fnt);
+
+    return evals;
+}
+
+int main() {
+
+    int failures = 0;
+
+    fnt_vect_t x0, pattern, dense, sparse;
+    fnt_vect_calloc(&x0, DIMS);
+    fnt_vect_calloc(&pattern, 2 * (3*DIMS - 2));
+    fnt_vect_calloc(&dense, DIMS*DIMS);
+    fnt_vect_calloc(&sparse, DIMS*DIMS);
+
+    int k = 0;
+    for(int i=0; i<DIMS; ++i) {
+        FNT_VECT_ELEM(x0, i) = -1.0 + 0.01 * i;
+        for(int j=i-1; j<=i+1; ++j) {
+            if( j < 0 || j >= DIMS )    { continue; }
+            FNT_VECT_ELEM(pattern, k++) = i;
+            FNT_VECT_ELEM(pattern, k++) = j;
+        }
+    }
+
+    int dense_colors = 0, sparse_colors = 0;
+    int dense_evals = estimate(&x0, NULL, &dense, &dense_colors);
+    int sparse_evals = estimate(&x0, &pattern, &sparse, &sparse_colors);
+    printf("dense: %d evaluations, sparse: %d evaluations (%d colors)\n",
+            dense_evals, sparse_evals, sparse_colors);
+
+    if( dense_evals != DIMS + 1 || sparse_evals != 4 || sparse_colors != 3 ) {
+        printf("\tUnexpected number of evaluations!\n");
+        ++failures;
+    }
+
+    /* compare both estimates with the analytic Jacobian */
+    double dense_err = 0.0, sparse_err = 0.0;
+    for(int i=0; i<DIMS; ++i) {
+        for(int j=0; j<DIMS; ++j) {
+            double exact = 0.0;
+            if( j == i )            { exact = 3.0 - 4.0 * FNT_VECT_ELEM(x0, i); }
+            else if( j == i - 1 )   { exact = -1.0; }
+            else if( j == i + 1 )   { exact = -2.0; }
+            dense_err = fmax(dense_err, fabs(FNT_VECT_ELEM(dense, i*DIMS+j) - exact));
+            sparse_err = fmax(sparse_err, fabs(FNT_VECT_ELEM(sparse, i*DIMS+j) - exact));
+        }
+    }
+    printf("max error: dense %g, sparse %g\n", dense_err, sparse_err);
+    if( dense_err > 1e-5 || sparse_err > 1e-5 ) {
+        printf("\tJacobian estimate is not accurate!\n");
+        ++failures;
+    }
+
+    /* a pattern without entries would leave columns unperturbed */
+    fnt_vect_t empty = { x0.v, 0 };
+    if( estimate(&x0, &empty, &sparse, &sparse_colors) != -1 ) {
+        printf("\tEmpty sparsity pattern was accepted!\n");
+        ++failures;
+    }
+
+    fnt_vect_free(&x0);
+    fnt_vect_free(&pattern);
+    fnt_vect_free(&dense);
+    fnt_vect_free(&sparse);
+
+    return failures;
+}
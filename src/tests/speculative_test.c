@@ -0,0 +1,134 @@
+/*
+ * speculative_test.c
+ * fnt: Numerical Toolbox
+ *
+ * Copyright (c) 2024 Bryan Franklin. All rights reserved.
+ */
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "../fnt.h"
+#include "../fnt_problems.h"
+
+#ifndef FNT_METHODS_DIR
+#define FNT_METHODS_DIR "."
+#endif /* FNT_METHODS_DIR */
+
+#define CAPACITY    4
+
+int main() {
+
+    int failures = 0;
+    void *fnt = NULL;
+
+    fnt_verbose(FNT_INFO); /* request informative output */
+    fnt_init(&fnt, FNT_METHODS_DIR "/methods");
+
+    /* load nelder-mead to minimize Rosenbrock function */
+    if( fnt_set_method(fnt, "nelder-mead", 2) == FNT_FAILURE ) {
+        return 1;
+    }
+
+    /* display info */
+    fnt_info(fnt);
+
+    /* allocate inputs for objective function */
+    fnt_vect_t x[CAPACITY];
+    int tickets[CAPACITY];
+    for(int i=0; i<CAPACITY; ++i) { fnt_vect_calloc(&x[i], 2); }
+    fnt_vect_t serial_x, min_x;
+    fnt_vect_calloc(&serial_x, 2);
+    fnt_vect_calloc(&min_x, 2);
+
+    /* serial run, one point per round */
+    int serial_rounds = 0;
+    while( fnt_done(fnt) == FNT_CONTINUE ) {
+        if( fnt_next(fnt, &x[0]) != FNT_SUCCESS ) { break; }
+        double fx = rosenbrock_2d(FNT_VECT_ELEM(x[0], 0), FNT_VECT_ELEM(x[0], 1));
+        if( fnt_set_value(fnt, &x[0], fx) != FNT_SUCCESS ) { break; }
+        ++serial_rounds;
+    }
+    fnt_result(fnt, "minimum x", &serial_x);
+    printf("serial: %d rounds, ", serial_rounds);
+    fnt_vect_println(&serial_x, "minimum x: ", NULL);
+
+    /* speculate, reporting each round first to last, so later candidates
+     * are often discarded */
+    int speculative = 1;
+    fnt_hparam_set(fnt, "speculative", &speculative);
+    fnt_reset(fnt);
+
+    int rounds = 0, evals = 0;
+    while( fnt_done(fnt) == FNT_CONTINUE ) {
+        int count = 0;
+        if( fnt_next_batch(fnt, x, tickets, CAPACITY, &count) != FNT_SUCCESS
+            || count == 0 ) {
+            break;
+        }
+        for(int i=0; i<count; ++i) {
+            double fx = rosenbrock_2d(FNT_VECT_ELEM(x[i], 0), FNT_VECT_ELEM(x[i], 1));
+            if( fnt_set_value_ticket(fnt, tickets[i], &x[i], fx) != FNT_SUCCESS ) {
+                return 1;
+            }
+        }
+        ++rounds;
+        evals += count;
+    }
+    fnt_result(fnt, "minimum x", &min_x);
+    printf("speculative, in order: %d rounds, %d evaluations, ", rounds, evals);
+    fnt_vect_println(&min_x, "minimum x: ", NULL);
+
+    /* discarding candidates must not change the path taken */
+    if( FNT_VECT_ELEM(min_x, 0) != FNT_VECT_ELEM(serial_x, 0)
+        || FNT_VECT_ELEM(min_x, 1) != FNT_VECT_ELEM(serial_x, 1) ) {
+        printf("\tIn order result differs from the serial result!\n");
+        ++failures;
+    }
+    if( rounds >= serial_rounds ) {
+        printf("\tIn order run took %d rounds, serial took %d!\n", rounds, serial_rounds);
+        ++failures;
+    }
+
+    /* again last to first, so early candidates wait on later ones */
+    fnt_reset(fnt);
+
+    rounds = evals = 0;
+    while( fnt_done(fnt) == FNT_CONTINUE ) {
+        int count = 0;
+        if( fnt_next_batch(fnt, x, tickets, CAPACITY, &count) != FNT_SUCCESS
+            || count == 0 ) {
+            break;
+        }
+        for(int i=count-1; i>=0; --i) {
+            double fx = rosenbrock_2d(FNT_VECT_ELEM(x[i], 0), FNT_VECT_ELEM(x[i], 1));
+            if( fnt_set_value_ticket(fnt, tickets[i], &x[i], fx) != FNT_SUCCESS ) {
+                return 1;
+            }
+        }
+        ++rounds;
+        evals += count;
+    }
+    fnt_result(fnt, "minimum x", &min_x);
+    printf("speculative, reversed: %d rounds, %d evaluations, ", rounds, evals);
+    fnt_vect_println(&min_x, "minimum x: ", NULL);
+
+    if( FNT_VECT_ELEM(min_x, 0) != FNT_VECT_ELEM(serial_x, 0)
+        || FNT_VECT_ELEM(min_x, 1) != FNT_VECT_ELEM(serial_x, 1) ) {
+        printf("\tReversed result differs from the serial result!\n");
+        ++failures;
+    }
+    if( rounds >= serial_rounds ) {
+        printf("\tReversed run took %d rounds, serial took %d!\n", rounds, serial_rounds);
+        ++failures;
+    }
+
+    /* free input vectors */
+    for(int i=0; i<CAPACITY; ++i) { fnt_vect_free(&x[i]); }
+    fnt_vect_free(&serial_x);
+    fnt_vect_free(&min_x);
+
+    /* free the method */
+    fnt_free(&fnt);
+
+    return failures;
+}
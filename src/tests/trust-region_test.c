@@ -0,0 +1,161 @@
+/*
+ * trust-region_test.c
+ * fnt: Numerical Toolbox
+ *
+ * Copyright (c) 2024 Bryan Franklin. All rights reserved.
+ */
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "../fnt.h"
+#include "../fnt_problems.h"
+
+#ifndef FNT_METHODS_DIR
+#define FNT_METHODS_DIR "."
+#endif /* FNT_METHODS_DIR */
+
+/* ill-conditioned quadratic, minimum at all ones */
+double quadratic(fnt_vect_t *x, void *user) {
+    double sum = 0.0;
+    for(int i=0; i<x->n; ++i) {
+        double d = FNT_VECT_ELEM(*x, i) - 1.0;
+        sum += (i+1) * d * d;
+    }
+    return sum;
+}
+
+/* chained Rosenbrock, minimum at all ones */
+double chained(fnt_vect_t *x, void *user) {
+    double sum = 0.0;
+    for(int i=0; i<x->n-1; ++i) {
+        sum += rosenbrock_2d(FNT_VECT_ELEM(*x, i), FNT_VECT_ELEM(*x, i+1));
+    }
+    return sum;
+}
+
+int main() {
+
+    int failures = 0;
+    void *fnt = NULL;
+
+    fnt_verbose(FNT_INFO); /* request informative output */
+    fnt_init(&fnt, FNT_METHODS_DIR "/methods");
+
+    /* load trust-region to minimize a 20 dimensional quadratic */
+    if( fnt_set_method(fnt, "trust-region", 20) == FNT_FAILURE ) {
+        return 1;
+    }
+
+    /* display info */
+    fnt_info(fnt);
+
+    /* start from the origin */
+    fnt_vect_t x;
+    fnt_vect_calloc(&x, 20);
+    fnt_hparam_set(fnt, "x0", &x);
+
+    /* minimize, then check every coordinate and the cost */
+    int evals = 0;
+    double err = 0.0;
+    if( fnt_minimize(fnt, quadratic, NULL) != FNT_SUCCESS
+        || fnt_result(fnt, "minimum x", &x) != FNT_SUCCESS ) {
+        printf("\tQuadratic run failed!\n");
+        return 1;
+    }
+    fnt_result(fnt, "evaluations", &evals);
+    for(int i=0; i<20; ++i) { err = fmax(err, fabs(FNT_VECT_ELEM(x, i) - 1.0)); }
+    printf("quadratic (20 dims): %d evaluations, max error %g\n", evals, err);
+    if( err > 1e-5 ) {
+        printf("\tDid not reach the minimum!\n");
+        ++failures;
+    }
+    if( evals > 1000 ) {
+        printf("\tMore than 1000 evaluations!\n");
+        ++failures;
+    }
+
+    /* again below an upper bound of 0.5, where the minimum sits on the bound */
+    for(int i=0; i<20; ++i) { FNT_VECT_ELEM(x, i) = 0.5; }
+    fnt_hparam_set(fnt, "upper", &x);
+    fnt_reset(fnt);
+
+    if( fnt_minimize(fnt, quadratic, NULL) != FNT_SUCCESS
+        || fnt_result(fnt, "minimum x", &x) != FNT_SUCCESS ) {
+        printf("\tBounded quadratic run failed!\n");
+        return 1;
+    }
+    fnt_result(fnt, "evaluations", &evals);
+    err = 0.0;
+    for(int i=0; i<20; ++i) { err = fmax(err, fabs(FNT_VECT_ELEM(x, i) - 0.5)); }
+    printf("quadratic, bounded (20 dims): %d evaluations, max error %g\n", evals, err);
+    if( err > 1e-8 ) {
+        printf("\tDid not reach the bound!\n");
+        ++failures;
+    }
+    if( evals > 1000 ) {
+        printf("\tMore than 1000 evaluations!\n");
+        ++failures;
+    }
+
+    /* a box narrower than rho_end shrinks the radius used, but must leave
+     * the hyper-parameter as set */
+    double rho_end = 1e-6;
+    fnt_hparam_set(fnt, "rho_end", &rho_end);
+    for(int i=0; i<20; ++i) { FNT_VECT_ELEM(x, i) = 1.0; }
+    fnt_hparam_set(fnt, "lower", &x);
+    for(int i=0; i<20; ++i) { FNT_VECT_ELEM(x, i) = 1.0 + 1e-7; }
+    fnt_hparam_set(fnt, "upper", &x);
+    fnt_hparam_set(fnt, "x0", &x);
+    fnt_reset(fnt);
+
+    if( fnt_minimize(fnt, quadratic, NULL) != FNT_SUCCESS ) {
+        printf("\tNarrow box run failed!\n");
+        ++failures;
+    }
+    fnt_hparam_get(fnt, "rho_end", &rho_end);
+    printf("quadratic, narrow box: rho_end %g after the run\n", rho_end);
+    if( rho_end != 1e-6 ) {
+        printf("\tThe run changed rho_end!\n");
+        ++failures;
+    }
+
+    fnt_vect_free(&x);
+    fnt_free(&fnt);
+
+    /* load trust-region to minimize a 10 dimensional chained Rosenbrock */
+    fnt_init(&fnt, FNT_METHODS_DIR "/methods");
+    if( fnt_set_method(fnt, "trust-region", 10) == FNT_FAILURE ) {
+        return 1;
+    }
+
+    /* start from x_i = -1 */
+    fnt_vect_calloc(&x, 10);
+    for(int i=0; i<10; ++i) { FNT_VECT_ELEM(x, i) = -1.0; }
+    fnt_hparam_set(fnt, "x0", &x);
+
+    if( fnt_minimize(fnt, chained, NULL) != FNT_SUCCESS
+        || fnt_result(fnt, "minimum x", &x) != FNT_SUCCESS ) {
+        printf("\tChained Rosenbrock run failed!\n");
+        return 1;
+    }
+    fnt_result(fnt, "evaluations", &evals);
+    err = 0.0;
+    for(int i=0; i<10; ++i) { err = fmax(err, fabs(FNT_VECT_ELEM(x, i) - 1.0)); }
+    printf("chained rosenbrock (10 dims): %d evaluations, max error %g\n", evals, err);
+    if( err > 1e-4 ) {
+        printf("\tDid not reach the minimum!\n");
+        ++failures;
+    }
+    if( evals > 2000 ) {
+        printf("\tMore than 2000 evaluations!\n");
+        ++failures;
+    }
+
+    /* free input vector */
+    fnt_vect_free(&x);
+
+    /* free the method */
+    fnt_free(&fnt);
+
+    return failures;
+}
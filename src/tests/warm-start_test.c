@@ -0,0 +1,174 @@
+/*
+ * warm-start_test.c
+ * fnt: Numerical Toolbox
+ *
+ * Copyright (c) 2024 Bryan Franklin. All rights reserved.
+ */
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "../fnt.h"
+#include "../fnt_problems.h"
+
+#ifndef FNT_METHODS_DIR
+#define FNT_METHODS_DIR "."
+#endif /* FNT_METHODS_DIR */
+
+int main() {
+
+    int failures = 0;
+    srand(1);
+    fnt_verbose(FNT_INFO); /* request informative output */
+
+    /* load differential evolution for a coarse global search */
+    void *coarse = NULL;
+    fnt_init(&coarse, FNT_METHODS_DIR "/methods");
+    if( fnt_set_method(coarse, "differential evolution", 2) == FNT_FAILURE ) {
+        return 1;
+    }
+
+    /* display info */
+    fnt_info(coarse);
+
+    /* only a few generations */
+    int iterations = 20;
+    fnt_hparam_set(coarse, "iters", &iterations);
+
+    /* allocate input for objective function */
+    fnt_vect_t x;
+    fnt_vect_calloc(&x, 2);
+
+    /* loop as long as method is not complete */
+    int evals = 0;
+    while( fnt_done(coarse) == FNT_CONTINUE ) {
+        if( fnt_next(coarse, &x) != FNT_SUCCESS ) { break; }
+        double fx = rosenbrock_2d(FNT_VECT_ELEM(x, 0), FNT_VECT_ELEM(x, 1));
+        ++evals;
+        if( fnt_set_value(coarse, &x, fx) != FNT_SUCCESS ) { break; }
+    }
+    double coarse_fx = 0.0;
+    fnt_result(coarse, "minimum f", &coarse_fx);
+    printf("differential evolution: minimum %g after %d evaluations\n", coarse_fx, evals);
+
+    /* refine with nelder-mead, seeded from the population */
+    void *fine = NULL;
+    fnt_init(&fine, FNT_METHODS_DIR "/methods");
+    if( fnt_set_method(fine, "nelder-mead", 2) == FNT_FAILURE ) {
+        return 1;
+    }
+    fnt_info(fine);
+    if( fnt_warm_start(fine, coarse) != FNT_SUCCESS ) {
+        printf("\tWarm start from population failed!\n");
+        return 1;
+    }
+
+    /* the best population members must not be requested again */
+    fnt_vect_t member;
+    fnt_vect_calloc(&member, 2);
+    fnt_result(coarse, "minimum x", &member);
+    evals = 0;
+    while( fnt_done(fine) == FNT_CONTINUE ) {
+        if( fnt_next(fine, &x) != FNT_SUCCESS ) { break; }
+        if( evals == 0 && FNT_VECT_ELEM(x, 0) == FNT_VECT_ELEM(member, 0)
+            && FNT_VECT_ELEM(x, 1) == FNT_VECT_ELEM(member, 1) ) {
+            printf("\tBest point was evaluated again!\n");
+            ++failures;
+        }
+        double fx = rosenbrock_2d(FNT_VECT_ELEM(x, 0), FNT_VECT_ELEM(x, 1));
+        ++evals;
+        if( fnt_set_value(fine, &x, fx) != FNT_SUCCESS ) { break; }
+    }
+    double fine_fx = 0.0;
+    fnt_result(fine, "minimum f", &fine_fx);
+    printf("nelder-mead (warm): minimum %g after %d evaluations\n", fine_fx, evals);
+    if( fine_fx > coarse_fx ) {
+        printf("\tWarm started result is worse than its seed!\n");
+        ++failures;
+    }
+    fnt_free(&fine);
+    fnt_free(&coarse);
+
+    /* seed nelder-mead from a supplied, evaluated point set */
+    fnt_init(&fine, FNT_METHODS_DIR "/methods");
+    if( fnt_set_method(fine, "nelder-mead", 2) == FNT_FAILURE ) {
+        return 1;
+    }
+    fnt_vect_t points[4];
+    double values[4];
+    double coords[4][2] = { {2.0, 2.0}, {0.9, 0.8}, {1.1, 1.3}, {1.2, 1.4} };
+    for(int i=0; i<4; ++i) {
+        fnt_vect_calloc(&points[i], 2);
+        FNT_VECT_ELEM(points[i], 0) = coords[i][0];
+        FNT_VECT_ELEM(points[i], 1) = coords[i][1];
+        values[i] = rosenbrock_2d(coords[i][0], coords[i][1]);
+        fnt_vect_print(&points[i], "seed: f(", NULL);
+        printf(") = %g\n", values[i]);
+    }
+    if( fnt_warm_start_points(fine, points, values, 4) != FNT_SUCCESS ) {
+        printf("\tWarm start from points failed!\n");
+        return 1;
+    }
+
+    /* the worst seed is dropped, so the first request must be a new point */
+    evals = 0;
+    while( fnt_done(fine) == FNT_CONTINUE ) {
+        if( fnt_next(fine, &x) != FNT_SUCCESS ) { break; }
+        for(int i=0; i<4 && evals==0; ++i) {
+            if( FNT_VECT_ELEM(x, 0) == coords[i][0]
+                && FNT_VECT_ELEM(x, 1) == coords[i][1] ) {
+                printf("\tSeed %d was evaluated again!\n", i);
+                ++failures;
+            }
+        }
+        double fx = rosenbrock_2d(FNT_VECT_ELEM(x, 0), FNT_VECT_ELEM(x, 1));
+        ++evals;
+        if( fnt_set_value(fine, &x, fx) != FNT_SUCCESS ) { break; }
+    }
+    fnt_result(fine, "minimum f", &fine_fx);
+    printf("nelder-mead (seeded): minimum %g after %d evaluations\n", fine_fx, evals);
+    if( fine_fx > values[1] ) {
+        printf("\tSeeded result is worse than the best seed!\n");
+        ++failures;
+    }
+    fnt_free(&fine);
+
+    /* seed differential evolution from the same points, not evaluated */
+    fnt_init(&fine, FNT_METHODS_DIR "/methods");
+    if( fnt_set_method(fine, "differential evolution", 2) == FNT_FAILURE ) {
+        return 1;
+    }
+    if( fnt_warm_start_points(fine, points, NULL, 4) != FNT_SUCCESS ) {
+        printf("\tWarm start from unevaluated points failed!\n");
+        return 1;
+    }
+
+    /* every point is evaluated before any random member */
+    evals = 0;
+    while( fnt_done(fine) == FNT_CONTINUE ) {
+        if( fnt_next(fine, &x) != FNT_SUCCESS ) { break; }
+        if( evals < 4 && (FNT_VECT_ELEM(x, 0) != coords[evals][0]
+                          || FNT_VECT_ELEM(x, 1) != coords[evals][1]) ) {
+            printf("\tSeed %d was not evaluated first!\n", evals);
+            ++failures;
+        }
+        double fx = rosenbrock_2d(FNT_VECT_ELEM(x, 0), FNT_VECT_ELEM(x, 1));
+        ++evals;
+        if( fnt_set_value(fine, &x, fx) != FNT_SUCCESS ) { break; }
+    }
+    fnt_result(fine, "minimum f", &fine_fx);
+    printf("differential evolution (seeded): minimum %g after %d evaluations\n", fine_fx, evals);
+    if( fine_fx > values[1] ) {
+        printf("\tSeeded result is worse than the best seed!\n");
+        ++failures;
+    }
+
+    /* free input vectors */
+    for(int i=0; i<4; ++i) { fnt_vect_free(&points[i]); }
+    fnt_vect_free(&x);
+    fnt_vect_free(&member);
+
+    /* free the method */
+    fnt_free(&fine);
+
+    return failures;
+}